@@ -0,0 +1,46 @@
+/*
+ * Copyright (C) 2021 Canonical, Ltd.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; version 3.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include <multipass/cloud_init_iso.h>
+
+#include <benchmark/benchmark.h>
+
+#include <QDir>
+#include <QTemporaryDir>
+
+#include <string>
+
+namespace mp = multipass;
+
+namespace
+{
+void bench_cloud_init_iso_write(benchmark::State& state)
+{
+    QTemporaryDir temp_dir;
+    const auto iso_path = QDir{temp_dir.path()}.filePath("bench.iso");
+
+    mp::CloudInitIso iso;
+    iso.add_file("meta-data", "instance-id: bench\nlocal-hostname: bench\n");
+    iso.add_file("user-data", std::string(4096, 'x'));
+    iso.add_file("vendor-data", std::string(2048, 'y'));
+
+    for (auto _ : state)
+        iso.write_to(iso_path);
+}
+} // namespace
+
+BENCHMARK(bench_cloud_init_iso_write);
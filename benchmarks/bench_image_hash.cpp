@@ -0,0 +1,59 @@
+/*
+ * Copyright (C) 2021 Canonical, Ltd.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; version 3.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include <multipass/vm_image_vault.h>
+
+#include <benchmark/benchmark.h>
+
+#include <QDir>
+#include <QFile>
+#include <QTemporaryDir>
+
+namespace mp = multipass;
+
+namespace
+{
+// 64M of incompressible-ish data stands in for an image; enough to measure the
+// per-byte cost without making the suite annoying to run
+QString make_image_file(const QString& dir_path)
+{
+    const auto path = QDir{dir_path}.filePath("bench.img");
+
+    QFile file{path};
+    file.open(QIODevice::WriteOnly);
+    QByteArray chunk(1024 * 1024, '\0');
+    for (int i = 0; i < chunk.size(); ++i)
+        chunk[i] = static_cast<char>(i * 31);
+    for (auto written = 0; written < 64; ++written)
+        file.write(chunk);
+
+    return path;
+}
+
+void bench_vault_image_hash(benchmark::State& state)
+{
+    QTemporaryDir temp_dir;
+    const auto image_path = make_image_file(temp_dir.path());
+
+    for (auto _ : state)
+        benchmark::DoNotOptimize(mp::vault::compute_image_hash(image_path));
+
+    state.SetBytesProcessed(state.iterations() * 64 * 1024 * 1024);
+}
+} // namespace
+
+BENCHMARK(bench_vault_image_hash);
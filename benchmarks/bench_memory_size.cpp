@@ -0,0 +1,46 @@
+/*
+ * Copyright (C) 2021 Canonical, Ltd.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; version 3.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include <multipass/memory_size.h>
+
+#include <benchmark/benchmark.h>
+
+namespace mp = multipass;
+
+namespace
+{
+void bench_memory_size_parse(benchmark::State& state)
+{
+    for (auto _ : state)
+    {
+        mp::MemorySize size{"1536M"};
+        benchmark::DoNotOptimize(size.in_bytes());
+    }
+}
+
+void bench_memory_size_parse_bare_bytes(benchmark::State& state)
+{
+    for (auto _ : state)
+    {
+        mp::MemorySize size{"1073741824"};
+        benchmark::DoNotOptimize(size.in_bytes());
+    }
+}
+} // namespace
+
+BENCHMARK(bench_memory_size_parse);
+BENCHMARK(bench_memory_size_parse_bare_bytes);
@@ -0,0 +1,34 @@
+/*
+ * Copyright (C) 2021 Canonical, Ltd.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; version 3.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "src/petname/petname.h"
+
+#include <benchmark/benchmark.h>
+
+namespace mp = multipass;
+
+namespace
+{
+void bench_petname_generation(benchmark::State& state)
+{
+    mp::Petname petname{mp::Petname::NumWords::TWO};
+    for (auto _ : state)
+        benchmark::DoNotOptimize(petname.make_name());
+}
+} // namespace
+
+BENCHMARK(bench_petname_generation);
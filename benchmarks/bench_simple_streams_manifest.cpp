@@ -0,0 +1,43 @@
+/*
+ * Copyright (C) 2021 Canonical, Ltd.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; version 3.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include <multipass/simple_streams_manifest.h>
+
+#include <benchmark/benchmark.h>
+
+#include <QFile>
+
+namespace mp = multipass;
+
+namespace
+{
+QByteArray load_manifest()
+{
+    QFile file{QStringLiteral(MULTIPASS_BENCH_DATA_DIR "/good_manifest.json")};
+    file.open(QIODevice::ReadOnly);
+    return file.readAll();
+}
+
+void bench_manifest_from_json(benchmark::State& state)
+{
+    const auto json = load_manifest();
+    for (auto _ : state)
+        benchmark::DoNotOptimize(mp::SimpleStreamsManifest::fromJson(json, ""));
+}
+} // namespace
+
+BENCHMARK(bench_manifest_from_json);
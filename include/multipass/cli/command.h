@@ -21,6 +21,7 @@
 #include <multipass/callable_traits.h>
 #include <multipass/cli/return_codes.h>
 #include <multipass/format.h>
+#include <multipass/optional.h>
 #include <multipass/rpc/multipass.grpc.pb.h>
 #include <multipass/terminal.h>
 #include <multipass/utils.h>
@@ -30,6 +31,10 @@
 
 #include <grpc++/grpc++.h>
 
+#include <cassert>
+#include <chrono>
+#include <functional>
+
 namespace multipass
 {
 class ArgParser;
@@ -62,6 +67,14 @@ public:
     virtual QString description() const = 0;
 
 protected:
+    // How long this command is willing to wait on the daemon; bounded queries override
+    // this so a wedged instance cannot hang them, while open-ended commands (launch,
+    // start, ...) keep no deadline
+    virtual optional<std::chrono::milliseconds> rpc_deadline() const
+    {
+        return nullopt;
+    }
+
     template <typename RpcFunc, typename Request, typename SuccessCallable, typename FailureCallable,
               typename StreamingCallback>
     ReturnCode dispatch(RpcFunc&& rpc_func, const Request& request, SuccessCallable&& on_success,
@@ -76,6 +89,8 @@ protected:
         auto rpc_method = std::bind(rpc_func, stub, std::placeholders::_1, std::placeholders::_2);
 
         grpc::ClientContext context;
+        if (const auto deadline = rpc_deadline())
+            context.set_deadline(std::chrono::system_clock::now() + *deadline);
         std::unique_ptr<grpc::ClientReader<ReplyType>> reader = rpc_method(&context, request);
 
         while (reader->Read(&reply))
@@ -157,6 +172,47 @@ private:
         static_assert(std::is_same<FailureCallableArgType, grpc::Status&>::value, "");
     }
 };
+
+// A registry slot for a Command. Aliases are declared up front so the requested command
+// can be resolved by name alone; the Command itself (and the help metadata hanging off
+// it) is only constructed when something actually needs it, keeping invocations that
+// settle on a single command from paying for the other twenty.
+class LazyCommand
+{
+public:
+    using Factory = std::function<Command::UPtr()>;
+
+    LazyCommand(std::vector<std::string> aliases, Factory make)
+        : command_aliases{std::move(aliases)}, make{std::move(make)}
+    {
+    }
+
+    const std::string& name() const
+    {
+        return command_aliases.front();
+    }
+
+    const std::vector<std::string>& aliases() const
+    {
+        return command_aliases;
+    }
+
+    Command* get() const
+    {
+        if (!instance)
+        {
+            instance = make();
+            assert(instance->aliases() == command_aliases && "registered aliases out of sync with the command's");
+        }
+
+        return instance.get();
+    }
+
+private:
+    std::vector<std::string> command_aliases;
+    Factory make;
+    mutable Command::UPtr instance;
+};
 } // namespace cmd
 } // namespace multipass
 #endif // MULTIPASS_COMMAND_H
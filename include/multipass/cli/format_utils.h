@@ -35,6 +35,9 @@ namespace format
 {
 std::string status_string_for(const InstanceStatus& status);
 std::string image_string_for(const multipass::FindReply_AliasInfo& alias);
+// "1.5G"-style rendering of a byte count, computed with integer arithmetic only and
+// memoized per thread, since the same few sizes repeat across rows and calls
+std::string human_readable_size(long long bytes);
 Formatter* formatter_for(const std::string& format);
 
 template <typename Instances>
@@ -33,6 +33,14 @@ class Formatter
 public:
     virtual ~Formatter() = default;
     virtual std::string format(const InfoReply& reply) const = 0;
+    // Incremental variant, called once per streamed reply fragment, with first flagging
+    // the opening fragment for formats that need a preamble. Formats whose output can be
+    // emitted piecewise override this; the empty default tells callers to assemble the
+    // fragments and use format() on the whole at the end.
+    virtual std::string format_partial(const InfoReply& reply, bool first) const
+    {
+        return {};
+    }
     virtual std::string format(const ListReply& reply) const = 0;
     virtual std::string format(const NetworksReply& reply) const = 0;
     virtual std::string format(const FindReply& reply) const = 0;
@@ -26,6 +26,7 @@ class YamlFormatter final : public Formatter
 {
 public:
     std::string format(const InfoReply& info) const override;
+    std::string format_partial(const InfoReply& info, bool first) const override;
     std::string format(const ListReply& list) const override;
     std::string format(const NetworksReply& list) const override;
     std::string format(const FindReply& list) const override;
@@ -21,17 +21,26 @@
 #include <multipass/cert_store.h>
 #include <multipass/path.h>
 
+#include <memory>
+
 namespace multipass
 {
 class ClientCertStore : public CertStore
 {
 public:
     explicit ClientCertStore(const multipass::Path& cert_dir);
+    ~ClientCertStore();
     void add_cert(const std::string& pem_cert) override;
     std::string PEM_cert_chain() const override;
 
 private:
     Path cert_dir;
+
+    // Chain file contents and their parsed certificates, re-read only when the file's
+    // mtime changes
+    struct ParsedChain;
+    const ParsedChain& load_chain() const;
+    mutable std::unique_ptr<ParsedChain> chain_cache;
 };
 } // namespace multipass
 #endif // MULTIPASS_CLIENT_CERT_STORE_H
@@ -32,6 +32,7 @@ class CloudInitIso
 public:
     void add_file(const std::string& name, const std::string& data);
     void write_to(const Path& path);
+    std::string content_hash() const;
 
 private:
     struct FileEntry
@@ -44,6 +44,7 @@ constexpr auto autostart_key = "client.gui.autostart"; // idem
 constexpr auto winterm_key = "client.apps.windows-terminal.profiles"; // idem
 constexpr auto hotkey_key = "client.gui.hotkey";                      // idem
 constexpr auto hotkey_default = "Ctrl+Alt+U";                         // idem; translates to Cmd+Opt+U on macOS
+constexpr auto log_levels_key = "local.log.levels"; // idem; "category=level;..." overrides for the file log sink
 } // namespace multipass
 
 #endif // MULTIPASS_CONSTANTS_H
@@ -18,11 +18,11 @@
 #ifndef MULTIPASS_DELAYED_SHUTDOWN_TIMER_H
 #define MULTIPASS_DELAYED_SHUTDOWN_TIMER_H
 
+#include <multipass/shutdown_scheduler.h>
 #include <multipass/ssh/ssh_session.h>
 #include <multipass/virtual_machine.h>
 
 #include <QObject>
-#include <QTimer>
 
 #include <chrono>
 #include <functional>
@@ -46,14 +46,18 @@ signals:
     void finished();
 
 private:
+    void schedule_next_tick(const std::chrono::milliseconds interval);
+    void on_tick();
     void shutdown_instance();
 
-    QTimer shutdown_timer;
     VirtualMachine* virtual_machine;
     optional<SSHSession> ssh_session;
     const StopMounts stop_mounts;
     std::chrono::milliseconds delay;
     std::chrono::milliseconds time_remaining;
+    std::chrono::minutes time_elapsed{1};
+    ShutdownScheduler::TaskId task_id{0};
+    bool active{false}; // a tick is scheduled and the shutdown has not fired yet
 };
 } // namespace multipass
 #endif // MULTIPASS_DELAYED_SHUTDOWN_TIMER_H
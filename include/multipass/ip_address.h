@@ -20,8 +20,12 @@
 #ifndef MULTIPASS_IP_ADDRESS_H
 #define MULTIPASS_IP_ADDRESS_H
 
+#include <multipass/optional.h>
+
 #include <array>
+#include <cstdint>
 #include <string>
+#include <vector>
 
 namespace multipass
 {
@@ -45,6 +49,33 @@ struct IPAddress
 
     std::array<uint8_t, 4> octets;
 };
+
+// Tracks which addresses of an inclusive range are in use, one bit per address. Marking
+// is O(1) and finding a free address scans a word (64 addresses) at a time, so pool
+// operations stay cheap even on /16-sized ranges.
+class SubnetIndex
+{
+public:
+    SubnetIndex() = default; // an empty range; every operation is a no-op
+    SubnetIndex(const IPAddress& first, const IPAddress& last);
+
+    void mark_in_use(const IPAddress& address); // addresses outside the range are ignored
+    void mark_free(const IPAddress& address);
+    void clear();
+
+    bool in_use(const IPAddress& address) const;
+    int num_in_use() const;
+    int capacity() const;
+    optional<IPAddress> first_free() const;
+    std::vector<IPAddress> addresses_in_use() const;
+
+private:
+    bool contains(uint32_t value) const;
+
+    uint32_t first_value{1};
+    uint32_t last_value{0};
+    std::vector<uint64_t> words;
+};
 }
 
 #endif // MULTIPASS_IP_ADDRESS_H
@@ -0,0 +1,63 @@
+/*
+ * Copyright (C) 2021 Canonical, Ltd.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; version 3.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#ifndef MULTIPASS_FILE_LOGGER_H
+#define MULTIPASS_FILE_LOGGER_H
+
+#include <multipass/logging/logger.h>
+
+#include <QString>
+
+#include <cstdio>
+#include <mutex>
+#include <unordered_map>
+
+namespace multipass
+{
+namespace logging
+{
+
+// Decorates another logger with a rolling file sink. Every message still reaches the
+// wrapped logger (journald/stderr) at its own level; the file additionally keeps
+// everything up to its - typically more verbose - level, so debugging does not depend
+// on journald queries. Segments rotate by size, rotated segments are compressed on a
+// background thread, and individual categories can be raised or quietened via the
+// "cat=level;cat2=level" spec handed to the constructor (fed from settings).
+class FileLogger : public Logger
+{
+public:
+    FileLogger(UPtr upstream, const QString& log_directory, Level file_level, const std::string& category_levels);
+    ~FileLogger();
+
+    void log(Level level, CString category, CString message) const override;
+
+private:
+    void rotate() const; // pre: mutex held
+
+    const UPtr upstream;
+    const QString log_directory;
+    const Level file_level;
+    std::unordered_map<std::string, Level> category_overrides;
+
+    mutable std::mutex mutex;
+    mutable std::FILE* current{nullptr};
+    mutable long long current_bytes{0};
+};
+} // namespace logging
+} // namespace multipass
+
+#endif // MULTIPASS_FILE_LOGGER_H
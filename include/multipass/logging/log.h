@@ -22,6 +22,20 @@
 #include <multipass/logging/level.h>
 #include <multipass/logging/logger.h>
 
+#include <multipass/format.h>
+
+#include <utility>
+
+// Statements above this level compile away entirely; override it to keep trace
+// instrumentation in release builds
+#ifndef MULTIPASS_COMPILE_TIME_LOG_LEVEL
+#ifdef NDEBUG
+#define MULTIPASS_COMPILE_TIME_LOG_LEVEL multipass::logging::Level::debug
+#else
+#define MULTIPASS_COMPILE_TIME_LOG_LEVEL multipass::logging::Level::trace
+#endif
+#endif
+
 namespace multipass
 {
 namespace logging
@@ -30,6 +44,52 @@ void log(Level level, CString category, CString message);
 void set_logger(std::shared_ptr<Logger> logger);
 Level get_logging_level();
 Logger* get_logger(); // for tests, don't rely on it lasting
+
+namespace detail
+{
+// Formats into a per-thread scratch buffer reused across calls, so a formatted log
+// costs no heap allocation. The result is only valid until the next formatted log on
+// the same thread; sinks must copy what they keep (they all do).
+template <typename... Args>
+CString format_into_scratch(const char* format_string, Args&&... args)
+{
+    thread_local fmt::memory_buffer buffer;
+    buffer.clear();
+    fmt::format_to(buffer, format_string, std::forward<Args>(args)...);
+    buffer.push_back('\0');
+    return CString{buffer.data()};
+}
+} // namespace detail
+
+/**
+ * Logs a formatted message without the intermediate std::string that
+ * `log(level, cat, fmt::format(...))` would build and discard; hot paths emitting
+ * millions of messages format into a reused thread-local buffer instead. Requires at
+ * least one format argument so that plain literals (which may contain braces) keep
+ * going through the unformatted overload.
+ */
+template <typename Arg0, typename... Args>
+void log(Level level, CString category, const char* format_string, Arg0&& arg0, Args&&... args)
+{
+    log(level, category,
+        detail::format_into_scratch(format_string, std::forward<Arg0>(arg0), std::forward<Args>(args)...));
+}
+
+/**
+ * Logs a formatted message with the level fixed at compile time. Below the
+ * compile-time threshold the whole statement - including argument evaluation and
+ * formatting - compiles to nothing, so hot loops can carry dense trace logging at
+ * zero release cost. Messages that are compiled in are forwarded unconditionally,
+ * leaving level filtering to the sinks as with the plain overload.
+ */
+template <Level level, typename... Args>
+void log(CString category, const char* format_string, Args&&... args)
+{
+    if constexpr (level <= MULTIPASS_COMPILE_TIME_LOG_LEVEL)
+    {
+        log(level, category, detail::format_into_scratch(format_string, std::forward<Args>(args)...));
+    }
+}
 } // namespace logging
 } // namespace multipass
 #endif // MULTIPASS_LOG_H
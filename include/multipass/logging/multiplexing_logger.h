@@ -20,8 +20,13 @@
 
 #include "logger.h"
 
+#include <condition_variable>
+#include <deque>
 #include <memory>
+#include <mutex>
 #include <shared_mutex>
+#include <string>
+#include <thread>
 #include <vector>
 
 namespace multipass
@@ -32,14 +37,34 @@ class MultiplexingLogger : public Logger
 {
 public:
     explicit MultiplexingLogger(UPtr system_logger);
+    ~MultiplexingLogger();
     void log(Level level, CString category, CString message) const override;
     void add_logger(const Logger* logger);
     void remove_logger(const Logger* logger);
 
 private:
+    struct LogEntry
+    {
+        Level level;
+        std::string category;
+        std::string message;
+    };
+
+    void worker_main();
+
     UPtr system_logger;
     mutable std::shared_timed_mutex mutex;
     std::vector<const Logger*> loggers;
+    // Producers only append to a bounded queue; a dedicated thread writes entries to the
+    // system sink, so logging on hot paths never waits on stderr. Client loggers write
+    // into gRPC streams owned by the calling thread and so stay synchronous. Entries
+    // beyond the bound are dropped and accounted for once the queue drains.
+    mutable std::mutex queue_mutex;
+    mutable std::condition_variable queue_cv;
+    mutable std::deque<LogEntry> queue;
+    mutable std::size_t dropped_entries{0};
+    bool stopping{false};
+    std::thread worker;
 };
 } // namespace logging
 } // namespace multipass
@@ -18,37 +18,152 @@
 #ifndef MULTIPASS_MEMORY_SIZE_H
 #define MULTIPASS_MEMORY_SIZE_H
 
+#include <multipass/exceptions/invalid_memory_size_exception.h>
+
 #include <string>
 
 namespace multipass
 {
+class MemorySize;
+
+inline namespace literals
+{
+constexpr MemorySize operator""_KiB(unsigned long long val);
+constexpr MemorySize operator""_MiB(unsigned long long val);
+constexpr MemorySize operator""_GiB(unsigned long long val);
+} // namespace literals
+
 class MemorySize
 {
 public:
-    friend bool operator==(const MemorySize& a, const MemorySize& b);
-    friend bool operator!=(const MemorySize& a, const MemorySize& b);
-    friend bool operator<(const MemorySize& a, const MemorySize& b);
-    friend bool operator>(const MemorySize& a, const MemorySize& b);
-    friend bool operator<=(const MemorySize& a, const MemorySize& b);
-    friend bool operator>=(const MemorySize& a, const MemorySize& b);
-
-    MemorySize();
+    constexpr MemorySize() noexcept : bytes{0LL}
+    {
+    }
+
+    // Parses "<digits>[K|M|G][B]", case insensitive. The parser is constexpr, so sizes
+    // spelled as literals in code are folded at compile time and cost nothing at runtime.
+    constexpr explicit MemorySize(const char* val) : bytes{parse(val)}
+    {
+    }
+
     explicit MemorySize(const std::string& val);
-    long long in_bytes() const noexcept;
-    long long in_kilobytes() const noexcept;
-    long long in_megabytes() const noexcept;
-    long long in_gigabytes() const noexcept;
+
+    constexpr long long in_bytes() const noexcept
+    {
+        return bytes;
+    }
+
+    constexpr long long in_kilobytes() const noexcept
+    {
+        return bytes / kilo; // integer division to floor
+    }
+
+    constexpr long long in_megabytes() const noexcept
+    {
+        return bytes / mega; // integer division to floor
+    }
+
+    constexpr long long in_gigabytes() const noexcept
+    {
+        return bytes / giga; // integer division to floor
+    }
+
+    friend constexpr bool operator==(const MemorySize& a, const MemorySize& b)
+    {
+        return a.bytes == b.bytes;
+    }
+
+    friend constexpr bool operator!=(const MemorySize& a, const MemorySize& b)
+    {
+        return a.bytes != b.bytes;
+    }
+
+    friend constexpr bool operator<(const MemorySize& a, const MemorySize& b)
+    {
+        return a.bytes < b.bytes;
+    }
+
+    friend constexpr bool operator>(const MemorySize& a, const MemorySize& b)
+    {
+        return a.bytes > b.bytes;
+    }
+
+    friend constexpr bool operator<=(const MemorySize& a, const MemorySize& b)
+    {
+        return a.bytes <= b.bytes;
+    }
+
+    friend constexpr bool operator>=(const MemorySize& a, const MemorySize& b)
+    {
+        return a.bytes >= b.bytes;
+    }
 
 private:
+    static constexpr auto kilo = 1024LL;
+    static constexpr auto mega = kilo * kilo;
+    static constexpr auto giga = mega * kilo;
+
+    static constexpr long long parse(const char* val)
+    {
+        const auto* p = val;
+
+        long long digits = 0;
+        bool any_digits = false;
+        while (*p >= '0' && *p <= '9')
+        {
+            digits = digits * 10 + (*p - '0');
+            ++p;
+            any_digits = true;
+        }
+
+        if (!any_digits)
+            throw InvalidMemorySizeException{val};
+
+        long long multiplier = 1;
+        if (*p == 'K' || *p == 'k')
+            multiplier = kilo, ++p;
+        else if (*p == 'M' || *p == 'm')
+            multiplier = mega, ++p;
+        else if (*p == 'G' || *p == 'g')
+            multiplier = giga, ++p;
+
+        if (*p == 'B' || *p == 'b')
+            ++p;
+
+        if (*p != '\0')
+            throw InvalidMemorySizeException{val};
+
+        return digits * multiplier;
+    }
+
+    constexpr explicit MemorySize(long long bytes) noexcept : bytes{bytes}
+    {
+    }
+
+    friend constexpr MemorySize literals::operator""_KiB(unsigned long long);
+    friend constexpr MemorySize literals::operator""_MiB(unsigned long long);
+    friend constexpr MemorySize literals::operator""_GiB(unsigned long long);
+
     long long bytes;
 };
 
-bool operator==(const MemorySize& a, const MemorySize& b);
-bool operator!=(const MemorySize& a, const MemorySize& b);
-bool operator<(const MemorySize& a, const MemorySize& b);
-bool operator>(const MemorySize& a, const MemorySize& b);
-bool operator<=(const MemorySize& a, const MemorySize& b);
-bool operator>=(const MemorySize& a, const MemorySize& b);
+inline namespace literals
+{
+constexpr MemorySize operator""_KiB(unsigned long long val)
+{
+    return MemorySize{static_cast<long long>(val) * 1024LL};
+}
+
+constexpr MemorySize operator""_MiB(unsigned long long val)
+{
+    return MemorySize{static_cast<long long>(val) * 1024LL * 1024LL};
+}
+
+constexpr MemorySize operator""_GiB(unsigned long long val)
+{
+    return MemorySize{static_cast<long long>(val) * 1024LL * 1024LL * 1024LL};
+}
+} // namespace literals
 
 } // namespace multipass
 
@@ -18,13 +18,23 @@
 #ifndef MULTIPASS_NETWORK_ACCESS_MANAGER_H
 #define MULTIPASS_NETWORK_ACCESS_MANAGER_H
 
+#include <QLocalSocket>
 #include <QNetworkAccessManager>
 #include <QNetworkRequest>
 
+#include <functional>
 #include <memory>
+#include <string>
+#include <unordered_map>
+#include <vector>
 
 namespace multipass
 {
+using UploadProgressCallback = std::function<void(qint64 bytes_sent, qint64 bytes_total)>;
+
+// Requests carrying a body can attach an UploadProgressCallback under this attribute;
+// the local socket transport invokes it as the body streams out
+constexpr auto upload_progress_attribute = QNetworkRequest::User;
 
 class NetworkAccessManager : public QNetworkAccessManager
 {
@@ -33,11 +43,21 @@ public:
     using UPtr = std::unique_ptr<NetworkAccessManager>;
 
     NetworkAccessManager(QObject* parent = nullptr);
+    ~NetworkAccessManager();
 
 protected:
     QNetworkReply* createRequest(Operation op, const QNetworkRequest& orig_request,
                                  QIODevice* outgoingData = nullptr) override;
+
+private:
+    std::unique_ptr<QLocalSocket> checkout_socket(const QString& socket_path);
+    void recycle_socket(const QString& socket_path, std::unique_ptr<QLocalSocket> socket);
+
+    // Idle keep-alive connections, keyed by local socket path, reused across requests
+    std::unordered_map<std::string, std::vector<std::unique_ptr<QLocalSocket>>> idle_sockets;
 };
 } // namespace multipass
 
+Q_DECLARE_METATYPE(multipass::UploadProgressCallback)
+
 #endif // MULTIPASS_NETWORK_ACCESS_MANAGER_H
@@ -73,6 +73,9 @@ VirtualMachineFactory::UPtr vm_backend(const Path& data_dir);
 logging::Logger::UPtr make_logger(logging::Level level);
 UpdatePrompt::UPtr make_update_prompt();
 std::unique_ptr<Process> make_sshfs_server_process(const SSHFSServerConfig& config);
+// A spare sshfs_server spawned ahead of need, taking its config over stdin; null where
+// per-mount confinement rules that strategy out
+std::unique_ptr<Process> make_pooled_sshfs_server_process();
 std::unique_ptr<Process> make_process(std::unique_ptr<ProcessSpec>&& process_spec);
 int chown(const char* path, unsigned int uid, unsigned int gid);
 bool symlink(const char* target, const char* link, bool is_dir);
@@ -84,6 +84,7 @@ private:
     void handle_started();
     void run_and_wait_until_finished(const int timeout);
     qint64 pid = 0;
+    qint64 stderr_bytes_logged = 0; // of the currently buffered (peeked, unread) stderr
 };
 
 } // namespace multipass
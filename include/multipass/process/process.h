@@ -20,6 +20,7 @@
 
 #include <QProcessEnvironment>
 #include <QStringList>
+#include <functional>
 #include <memory>
 #include <multipass/optional.h>
 
@@ -100,6 +101,16 @@ public:
     virtual QByteArray read_all_standard_output() = 0;
     virtual QByteArray read_all_standard_error() = 0;
 
+    using LineCallback = std::function<void(const QByteArray& line)>;
+
+    // Streams the given channel to callback one record at a time, draining the process'
+    // buffer as data arrives so memory use stays constant however much the child writes.
+    // Records end at '\n' or '\r' (qemu-img paints progress with carriage returns); a
+    // record outgrowing the bounded carry buffer is flushed in chunks. Set up before
+    // start(); streamed data is consumed and no longer visible to read_all_standard_*.
+    void stream_standard_output(LineCallback callback);
+    void stream_standard_error(LineCallback callback);
+
     virtual qint64 write(const QByteArray& data) = 0;
     virtual void close_write_channel() = 0;
     virtual void set_process_channel_mode(QProcess::ProcessChannelMode mode) = 0;
@@ -0,0 +1,70 @@
+/*
+ * Copyright (C) 2021 Canonical, Ltd.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; version 3.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#ifndef MULTIPASS_QEMUIMG_JOB_QUEUE_H
+#define MULTIPASS_QEMUIMG_JOB_QUEUE_H
+
+#include <multipass/process/process.h>
+#include <multipass/process/qemuimg_process_spec.h>
+#include <multipass/singleton.h>
+
+#include <QByteArray>
+#include <QThreadPool>
+
+#include <memory>
+
+#define MP_QEMUIMG_QUEUE multipass::QemuImgJobQueue::instance()
+
+namespace multipass
+{
+
+// All qemu-img invocations funnel through here, so disk-heavy image work runs with
+// bounded parallelism instead of however many launches or maintenance passes happen to
+// be in flight. Callers still block for their result; the queue orders the work, with
+// interactive jobs (someone is waiting at a prompt) ahead of background ones.
+
+class QemuImgJobQueue : public Singleton<QemuImgJobQueue>
+{
+public:
+    enum class Priority
+    {
+        background = 0,
+        interactive = 1,
+    };
+
+    struct Result
+    {
+        ProcessState state;
+        QByteArray output;       // standard output
+        QByteArray error_output; // standard error
+    };
+
+    QemuImgJobQueue(const Singleton<QemuImgJobQueue>::PrivatePass&);
+
+    // When output_line_callback is set, standard output is dispatched to it record by
+    // record as qemu-img produces it (so "-p" progress arrives during the job, not after)
+    // and Result::output comes back empty; the callback runs on the job's pool thread.
+    virtual Result run(std::unique_ptr<QemuImgProcessSpec>&& spec, Priority priority, int timeout = 30000,
+                       Process::LineCallback output_line_callback = nullptr);
+
+private:
+    QThreadPool job_pool;
+};
+
+} // namespace multipass
+
+#endif // MULTIPASS_QEMUIMG_JOB_QUEUE_H
@@ -0,0 +1,80 @@
+/*
+ * Copyright (C) 2021 Canonical, Ltd.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; version 3.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#ifndef MULTIPASS_SCROLLBACK_BUFFER_H
+#define MULTIPASS_SCROLLBACK_BUFFER_H
+
+#include <algorithm>
+#include <cstring>
+#include <string>
+#include <vector>
+
+namespace multipass
+{
+// Fixed-capacity scrollback for console/monitor output: writes past the capacity
+// overwrite the oldest bytes in place, so capture allocates nothing after construction
+// and a chatty instance holds the same memory after a month as after a minute. Not
+// thread safe; the daemon only touches it from its event loop.
+class ScrollbackBuffer
+{
+public:
+    explicit ScrollbackBuffer(std::size_t capacity) : buffer(capacity)
+    {
+    }
+
+    void append(const char* data, std::size_t len)
+    {
+        if (len >= buffer.size())
+        {
+            // only the tail fits anyway; take it and start over
+            std::memcpy(buffer.data(), data + (len - buffer.size()), buffer.size());
+            next = 0;
+            filled = buffer.size();
+            return;
+        }
+
+        const auto until_end = std::min(len, buffer.size() - next);
+        std::memcpy(buffer.data() + next, data, until_end);
+        std::memcpy(buffer.data(), data + until_end, len - until_end);
+        next = (next + len) % buffer.size();
+        filled = std::min(buffer.size(), filled + len);
+    }
+
+    // Oldest-first copy of what is currently held
+    std::string contents() const
+    {
+        std::string out;
+        out.reserve(filled);
+        if (filled == buffer.size())
+            out.append(buffer.data() + next, buffer.size() - next);
+        out.append(buffer.data(), next);
+        return out;
+    }
+
+    void clear()
+    {
+        next = 0;
+        filled = 0;
+    }
+
+private:
+    std::vector<char> buffer;
+    std::size_t next{0};   // where the next byte lands
+    std::size_t filled{0}; // how much of the buffer holds data
+};
+} // namespace multipass
+#endif // MULTIPASS_SCROLLBACK_BUFFER_H
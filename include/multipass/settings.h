@@ -24,12 +24,16 @@
 #include <QString>
 #include <QVariant>
 
+#include <functional>
 #include <map>
+#include <memory>
 #include <mutex>
 #include <set>
 
 #define MP_SETTINGS multipass::Settings::instance()
 
+class QFileSystemWatcher;
+
 namespace multipass
 {
 class Settings : public Singleton<Settings>
@@ -44,6 +48,10 @@ public:
     template <typename T>
     T get_as(const QString& key) const;
 
+    /// Invokes the handler (on the event loop) whenever the daemon settings file changes
+    /// on disk; also keeps this instance's cache coherent with external writers
+    void monitor_external_changes(std::function<void()> handler);
+
     static QString get_daemon_settings_file_path(); // temporary
     static QString get_client_settings_file_path(); // idem
 
@@ -52,8 +60,15 @@ protected:
 
 private:
     void set_aux(const QString& key, QString val);
+    bool watch_file_for(const QString& key) const;
 
     std::map<QString, QString> defaults;
+    // Reads are served from the cache; the watcher drops it when a settings file
+    // changes on disk, so gets avoid the QSettings round trip on hot paths
+    mutable std::map<QString, QString> cache;
+    mutable std::set<QString> watched_files;
+    mutable std::unique_ptr<QFileSystemWatcher> watcher;
+    std::function<void()> external_change_handler;
     mutable std::mutex mutex;
 };
 } // namespace multipass
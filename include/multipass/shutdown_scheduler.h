@@ -0,0 +1,65 @@
+/*
+ * Copyright (C) 2021 Canonical, Ltd.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; version 3.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#ifndef MULTIPASS_SHUTDOWN_SCHEDULER_H
+#define MULTIPASS_SHUTDOWN_SCHEDULER_H
+
+#include <multipass/singleton.h>
+
+#include <QTimer>
+
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <map>
+
+#define MP_SHUTDOWN_SCHEDULER multipass::ShutdownScheduler::instance()
+
+namespace multipass
+{
+
+// One shared timer for every delayed operation in the daemon: tasks queue on a
+// deadline-ordered schedule and a single QTimer arms itself for the earliest one, so a
+// fleet of pending shutdowns costs one live timer instead of one each. Tasks run on
+// the thread driving the Qt event loop; everything here must be called from it.
+
+class ShutdownScheduler : public Singleton<ShutdownScheduler>
+{
+public:
+    using TaskId = uint64_t;
+
+    ShutdownScheduler(const Singleton<ShutdownScheduler>::PrivatePass&);
+
+    virtual TaskId schedule(std::chrono::milliseconds delay, std::function<void()> task);
+    virtual void cancel(TaskId id); // no-op if the task already ran
+
+private:
+    void tick();
+    void arm(); // (re)starts the timer for the earliest deadline, or stops it when idle
+
+    struct ScheduledTask
+    {
+        TaskId id;
+        std::function<void()> task;
+    };
+
+    QTimer tick_timer;
+    std::multimap<std::chrono::steady_clock::time_point, ScheduledTask> tasks;
+    TaskId last_id{0};
+};
+} // namespace multipass
+#endif // MULTIPASS_SHUTDOWN_SCHEDULER_H
@@ -23,10 +23,11 @@
 #include <multipass/vm_image_info.h>
 
 #include <QByteArray>
-#include <QMap>
+#include <QHash>
 #include <QString>
 
 #include <memory>
+#include <utility>
 #include <vector>
 
 namespace multipass
@@ -40,7 +41,8 @@ struct SimpleStreamsManifest
 
     const QString updated_at;
     const std::vector<VMImageInfo> products;
-    const QMap<QString, const VMImageInfo*> image_records;
+    const QHash<QString, const VMImageInfo*> image_records; // aliases and full hashes, for O(1) resolution
+    const std::vector<std::pair<QString, const VMImageInfo*>> sorted_ids; // hashes in order, for prefix searches
 };
 }
 #endif // MULTIPASS_SIMPLE_STREAMS_MANIFEST_H
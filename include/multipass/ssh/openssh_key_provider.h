@@ -22,7 +22,10 @@
 #include <multipass/ssh/ssh_key_provider.h>
 
 #include <QDir>
+#include <future>
 #include <memory>
+#include <mutex>
+#include <string>
 
 namespace multipass
 {
@@ -41,8 +44,16 @@ public:
     ssh_key private_key() const override;
 
 private:
+    const KeyUPtr& key() const;
+
     QDir ssh_key_dir;
-    KeyUPtr priv_key;
+
+    // Key generation runs in the background from the constructor and is joined on first
+    // use, so a first daemon start is not held up generating the keypair up front
+    mutable std::future<KeyUPtr> pending_key;
+    mutable KeyUPtr priv_key;
+    mutable std::string public_key_cache;
+    mutable std::mutex key_mutex;
 };
 }
 #endif // MULTIPASS_OPENSSH_KEY_PROVIDER_H
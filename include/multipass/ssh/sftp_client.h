@@ -39,10 +39,15 @@ public:
 
     void push_file(const std::string& source_path, const std::string& destination_path);
     void pull_file(const std::string& source_path, const std::string& destination_path);
+    void push_dir(const std::string& source_path, const std::string& destination_path);
+    void pull_dir(const std::string& source_path, const std::string& destination_path);
+    bool is_remote_dir(const std::string& path);
     void stream_file(const std::string& destination_path, std::istream& cin);
     void stream_file(const std::string& source_path, std::ostream& cout);
 
 private:
+    void make_remote_dir_tree(const std::string& path);
+
     SSHSessionUPtr ssh_session;
     SFTPSessionUPtr sftp;
 };
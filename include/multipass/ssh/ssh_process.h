@@ -23,6 +23,7 @@
 #include <libssh/libssh.h>
 
 #include <chrono>
+#include <functional>
 #include <memory>
 #include <string>
 
@@ -35,10 +36,17 @@ public:
 
     SSHProcess(ssh_session ssh_session, const std::string& cmd);
 
+    using OutputSink = std::function<void(const char* data, std::size_t size)>;
+
     int exit_code(std::chrono::milliseconds timeout = std::chrono::seconds(5));
     std::string read_std_output();
     std::string read_std_error();
 
+    // Feed output to the sink chunk by chunk as it arrives, for consumers that do not
+    // need the whole output materialized in one contiguous string
+    void drain_std_output(const OutputSink& sink);
+    void drain_std_error(const OutputSink& sink);
+
 private:
     enum class StreamType
     {
@@ -47,6 +55,7 @@ private:
     };
 
     std::string read_stream(StreamType type, int timeout = -1);
+    void drain_stream(StreamType type, const OutputSink& sink, int timeout = -1);
     ssh_channel release_channel();
 
     ssh_session session;
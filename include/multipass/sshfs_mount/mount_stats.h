@@ -0,0 +1,39 @@
+/*
+ * Copyright (C) 2021 Canonical, Ltd.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; version 3.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#ifndef MULTIPASS_MOUNT_STATS_H
+#define MULTIPASS_MOUNT_STATS_H
+
+#include <cstdint>
+
+namespace multipass
+{
+// Cumulative I/O counters for one mount, as counted by its SftpServer. Latencies are
+// per-category sums in microseconds; divide by the op count for averages.
+struct MountStats
+{
+    std::uint64_t read_ops{0};
+    std::uint64_t read_bytes{0};
+    std::uint64_t read_usecs{0};
+    std::uint64_t write_ops{0};
+    std::uint64_t write_bytes{0};
+    std::uint64_t write_usecs{0};
+    std::uint64_t other_ops{0};
+    std::uint64_t other_usecs{0};
+};
+} // namespace multipass
+#endif // MULTIPASS_MOUNT_STATS_H
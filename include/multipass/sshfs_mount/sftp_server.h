@@ -19,11 +19,21 @@
 #define MULTIPASS_SFTP_SERVER_H
 
 #include <multipass/ssh/ssh_session.h>
+#include <multipass/sshfs_mount/mount_stats.h>
 
 #include <libssh/sftp.h>
 
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <deque>
 #include <memory>
+#include <mutex>
+#include <thread>
 #include <unordered_map>
+#include <unordered_set>
+#include <utility>
+#include <vector>
 
 #include <QFile>
 #include <QFileInfo>
@@ -32,6 +42,7 @@ namespace multipass
 {
 class SSHSession;
 class SSHProcess;
+class UringWriteQueue;
 
 class SftpServer
 {
@@ -45,15 +56,51 @@ public:
     void run();
     void stop();
 
+    // Snapshot of the cumulative I/O counters, safe to call from any thread
+    MountStats stats() const;
+
+    const std::string& target() const
+    {
+        return target_path;
+    }
+
+    // The sshfs invocation this server runs in the guest; cached by the daemon so later
+    // mounts can skip resolving it again
+    const std::string& sshfs_exec() const
+    {
+        return sshfs_exec_line;
+    }
+
     using SSHSessionUptr = std::unique_ptr<ssh_session_struct, decltype(ssh_free)*>;
     using SftpSessionUptr = std::unique_ptr<sftp_session_struct, decltype(sftp_free)*>;
     using SSHFSProcUptr = std::unique_ptr<SSHProcess>;
+    using MsgUPtr = std::unique_ptr<sftp_client_message_struct, decltype(sftp_client_message_free)*>;
+    // The id maps are tiny and fixed for the mount's lifetime, so they are compiled into
+    // sorted flat arrays at construction - a binary search over a couple of cache lines,
+    // consulted on every message, beats hashing into node-based buckets.
+    using IdMap = std::vector<std::pair<int, int>>;
 
 private:
     void process_message(sftp_client_message msg);
+    void start_worker_threads();
+    void stop_worker_threads();
+    void worker_main();
+    void dispatch(void* handle, MsgUPtr msg);
+    void drain_dispatched_work();
+    bool flush_write_cache_for(void* id);
+    void flush_all_write_caches();
     sftp_attributes_struct attr_from(const QFileInfo& file_info);
     int mapped_uid_for(const int uid);
     int mapped_gid_for(const int gid);
+    int reverse_uid_for(const int uid);
+    int reverse_gid_for(const int gid);
+    QFileInfo cached_file_info_for(const std::string& path);
+    void remember_attrs_for(const QFileInfo& info);
+    void invalidate_attrs_for(const std::string& path);
+    void park_handle(std::unique_ptr<QFile> file);
+    std::unique_ptr<QFile> take_parked_handle(const std::string& path, QIODevice::OpenMode mode);
+    void preload_small_file(QFile& file);
+    void evict_parked_handles_for(const std::string& path);
 
     int handle_close(sftp_client_message msg);
     int handle_fstat(sftp_client_message msg);
@@ -78,14 +125,92 @@ private:
     SftpSessionUptr sftp_server_session;
     const std::string source_path;
     const std::string target_path;
+    // Per-handle readahead state for sequential reads; guarded by read_cache_mutex for
+    // map structure, while each entry is only touched by its handle's in-flight request.
+    struct ReadCache
+    {
+        std::vector<char> buffer;
+        qint64 buffer_offset{0};
+        qint64 buffer_size{0};
+        qint64 expected_offset{-1};
+        bool holds_eof{false}; // the buffer reaches end of file (whole file preloaded)
+    };
+
     std::unordered_map<void*, std::unique_ptr<QFileInfoList>> open_dir_handles;
     std::unordered_map<void*, std::unique_ptr<QFile>> open_file_handles;
-    const std::unordered_map<int, int> gid_map;
-    const std::unordered_map<int, int> uid_map;
+    // Recently closed files are parked here, still open, and donated back when the same
+    // path is reopened with the same flags; compilers and VCS tools revisit the same
+    // files constantly, and a warm fd spares an open/close syscall pair per revisit.
+    // Only touched from the message-processing thread, like the handle maps above.
+    struct ParkedHandle
+    {
+        std::string path;
+        QIODevice::OpenMode mode;
+        std::unique_ptr<QFile> file;
+    };
+    std::deque<ParkedHandle> parked_handles; // most recently parked at the back
+    // Per-handle write-behind buffer: contiguous writes are coalesced and acknowledged
+    // immediately, with any flush failure reported on the next write or on close.
+    struct WriteCache
+    {
+        std::vector<char> buffer;
+        qint64 start_offset{0};
+        bool failed{false};
+    };
+
+    bool flush_write_cache(QFile* file, void* id, WriteCache& cache);
+
+    // Short-lived attribute cache: the server sees every instance-side mutation of the
+    // share, so stats of unchanged paths can be answered from memory, with a short TTL
+    // bounding staleness against host-side changes. Collapses the stat storms VCS tools
+    // produce when walking a mounted tree.
+    struct CachedAttrs
+    {
+        QFileInfo info;
+        std::chrono::steady_clock::time_point stamp;
+    };
+
+    std::unordered_map<void*, ReadCache> read_caches;
+    std::mutex read_cache_mutex;
+    std::unordered_map<std::string, CachedAttrs> attr_cache;
+    std::mutex attr_cache_mutex;
+    std::unordered_map<void*, WriteCache> write_caches;
+    std::mutex write_cache_mutex;
+    // Kernel write-behind queue (io_uring) for cache flushes; null where unavailable, in
+    // which case flushes fall back to synchronous writes
+    std::unique_ptr<UringWriteQueue> uring_queue;
+    // Per-message-category counters, updated by the workers and read by the stats reporter
+    struct
+    {
+        std::atomic<std::uint64_t> read_ops{0};
+        std::atomic<std::uint64_t> read_bytes{0};
+        std::atomic<std::uint64_t> read_usecs{0};
+        std::atomic<std::uint64_t> write_ops{0};
+        std::atomic<std::uint64_t> write_bytes{0};
+        std::atomic<std::uint64_t> write_usecs{0};
+        std::atomic<std::uint64_t> other_ops{0};
+        std::atomic<std::uint64_t> other_usecs{0};
+    } io_counters;
+    const IdMap gid_map;
+    const IdMap uid_map;
+    const IdMap reverse_gid_map; // instance-side ids back to host ids, for setstat/chown
+    const IdMap reverse_uid_map;
     const int default_uid;
     const int default_gid;
     const std::string sshfs_exec_line;
     bool stop_invoked{false};
+
+    // Data requests (read/write/readdir) are dispatched to a small worker pool so independent
+    // file operations overlap; ordering is preserved per handle and replies are serialized.
+    std::vector<std::thread> workers;
+    std::deque<std::pair<void*, MsgUPtr>> work_queue;
+    std::unordered_set<void*> busy_handles;
+    std::mutex work_mutex;
+    std::mutex reply_mutex;
+    std::condition_variable work_cv;
+    std::condition_variable idle_cv;
+    int in_flight{0};
+    bool workers_stopping{false};
 };
 } // namespace multipass
 #endif // MULTIPASS_SFTP_SERVER_H
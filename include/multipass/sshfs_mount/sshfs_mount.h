@@ -18,6 +18,8 @@
 #ifndef MULTIPASS_SSHFS_MOUNT
 #define MULTIPASS_SSHFS_MOUNT
 
+#include <multipass/sshfs_mount/mount_stats.h>
+
 #include <memory>
 #include <thread>
 #include <unordered_map>
@@ -29,13 +31,20 @@ class SftpServer;
 class SshfsMount
 {
 public:
+    // A non-empty known_sshfs_exec skips the guest-side resolution of the sshfs
+    // invocation and uses the given one as-is
     SshfsMount(SSHSession&& session, const std::string& source, const std::string& target,
-               const std::unordered_map<int, int>& gid_map, const std::unordered_map<int, int>& uid_map);
+               const std::unordered_map<int, int>& gid_map, const std::unordered_map<int, int>& uid_map,
+               const std::string& known_sshfs_exec = {});
     SshfsMount(SshfsMount&& other);
     ~SshfsMount();
 
     void stop();
 
+    MountStats stats() const;
+    const std::string& target() const;
+    const std::string& sshfs_exec_line() const;
+
 private:
     // sftp_server Doesn't need to be a pointer, but done for now to avoid bringing sftp.h
     // which has an error with -pedantic.
@@ -18,13 +18,20 @@
 #ifndef MULTIPASS_SSHFSMOUNTS_H
 #define MULTIPASS_SSHFSMOUNTS_H
 
+#include <deque>
 #include <memory>
 #include <string>
 #include <unordered_map>
+#include <vector>
 
+#include <multipass/optional.h>
 #include <multipass/process/process.h>
+#include <multipass/sshfs_mount/mount_stats.h>
 #include <multipass/qt_delete_later_unique_ptr.h>
 #include <multipass/ssh/ssh_key_provider.h>
+#include <multipass/sshfs_server_config.h>
+
+class QEventLoop;
 
 namespace multipass
 {
@@ -34,20 +41,88 @@ class SSHFSMounts : public QObject
 {
     Q_OBJECT
 public:
+    // A mount whose sshfs_server has been launched but whose handshake has not been
+    // waited on yet; several of these can be in flight for one instance at a time
+    struct PendingMount
+    {
+        qt_delete_later_unique_ptr<Process> process;
+        std::string target_path;
+        QByteArray output;
+        bool connected{false};
+        QEventLoop* waiting_loop{nullptr};
+        QMetaObject::Connection ready_conn;
+    };
+    using PendingMountPtr = std::unique_ptr<PendingMount>;
+
     explicit SSHFSMounts(const SSHKeyProvider& ssh_key_provider);
 
     void start_mount(VirtualMachine* vm, const std::string& source_path, const std::string& target_path,
                      const std::unordered_map<int, int>& gid_map, const std::unordered_map<int, int>& uid_map);
 
+    PendingMountPtr launch_mount_process(VirtualMachine* vm, const std::string& source_path,
+                                         const std::string& target_path, const std::unordered_map<int, int>& gid_map,
+                                         const std::unordered_map<int, int>& uid_map);
+
+    // One share of a consolidated launch
+    struct MountSpec
+    {
+        std::string source_path;
+        std::string target_path;
+        std::unordered_map<int, int> gid_map;
+        std::unordered_map<int, int> uid_map;
+    };
+
+    // Launches a single sshfs_server process serving all the given shares, registered
+    // under the first target with the rest as aliases; stopping any one of them stops
+    // the process, and with it all of them
+    PendingMountPtr launch_consolidated_mount_process(VirtualMachine* vm, const std::vector<MountSpec>& mount_specs);
+
+    void wait_until_mount_ready(VirtualMachine* vm, PendingMountPtr pending);
+
     bool stop_mount(const std::string& instance, const std::string& path);
     void stop_all_mounts_for_instance(const std::string& instance);
 
     bool has_instance_already_mounted(const std::string& instance, const std::string& path) const;
 
+    // Latest I/O counters reported by the mount's sshfs_server, if it has reported any yet
+    optional<MountStats> stats_for(const std::string& instance, const std::string& target) const;
+
+    // Seed (or, with an empty line, drop) the instance's cached sshfs invocation; new
+    // servers for the instance are handed it and skip the guest-side probes
+    void set_sshfs_exec_line(const std::string& instance, const std::string& exec_line);
+
+signals:
+    // A server resolved (or failed with) the instance's sshfs invocation; the daemon
+    // persists this in the instance's metadata, an empty line clearing it
+    void sshfs_exec_line_learned(const std::string& instance, const std::string& exec_line);
+
 private:
+    PendingMountPtr launch_process(VirtualMachine* vm, SSHFSServerConfig config);
+    qt_delete_later_unique_ptr<Process> take_warm_server();
+    void replenish_warm_server();
+    void ingest_server_output(const std::string& instance, const QByteArray& line);
+    void update_sshfs_exec_line(const std::string& instance, const std::string& exec_line);
+
     const std::string key;
     std::unordered_map<std::string, std::unordered_map<std::string, qt_delete_later_unique_ptr<Process>>>
         mount_processes;
+    // targets served by a consolidated process, mapped to the target it is registered under
+    std::unordered_map<std::string, std::unordered_map<std::string, std::string>> consolidated_aliases;
+    // latest stats line per instance and target, plus partial stdout awaiting a newline
+    std::unordered_map<std::string, std::unordered_map<std::string, MountStats>> mount_stats;
+    std::unordered_map<std::string, QByteArray> output_buffers;
+    // per-instance sshfs invocation verdicts, learned from servers or seeded from metadata
+    std::unordered_map<std::string, std::string> sshfs_exec_lines;
+    // A spare sshfs_server kept running ahead of need, so starting a mount costs a
+    // config message instead of an exec plus runtime init; empty where the platform
+    // cannot pre-spawn (per-mount confinement) or until the first mount warms it up
+    struct WarmServer
+    {
+        qt_delete_later_unique_ptr<Process> process;
+        QMetaObject::Connection exit_conn;
+    };
+    std::deque<WarmServer> warm_servers;
+    bool warm_spawning_unsupported{false};
 };
 
 } // namespace multipass
@@ -20,10 +20,22 @@
 
 #include <string>
 #include <unordered_map>
+#include <vector>
 
 namespace multipass
 {
 
+// An additional share served from the same sshfs_server process. Consolidation is opt-in:
+// it trades per-mount process isolation for one process per instance instead of one per
+// mount, and all shares of a process live and die together.
+struct SSHFSExtraMount
+{
+    std::string source_path;
+    std::string target_path;
+    std::unordered_map<int, int> gid_map;
+    std::unordered_map<int, int> uid_map;
+};
+
 struct SSHFSServerConfig
 {
     std::string host;
@@ -35,6 +47,10 @@ struct SSHFSServerConfig
     std::string target_path;
     std::unordered_map<int, int> gid_map;
     std::unordered_map<int, int> uid_map;
+    std::vector<SSHFSExtraMount> extra_mounts;
+    // The sshfs invocation resolved by a previous server for this instance; when set, the
+    // guest-side probes for it (snap env, which, version) are skipped
+    std::string sshfs_exec_line;
 };
 
 } // namespace multipass
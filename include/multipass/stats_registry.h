@@ -0,0 +1,84 @@
+/*
+ * Copyright (C) 2021 Canonical, Ltd.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; version 3.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#ifndef MULTIPASS_STATS_REGISTRY_H
+#define MULTIPASS_STATS_REGISTRY_H
+
+#include <multipass/singleton.h>
+
+#include <array>
+#include <chrono>
+#include <cstdint>
+#include <map>
+#include <mutex>
+#include <string>
+
+#define MP_STATS multipass::StatsRegistry::instance()
+
+namespace multipass
+{
+
+// Process-wide counters and latency histograms for the daemon's hot paths. Recording is
+// a mutex-guarded bucket increment, cheap enough to leave on unconditionally; durations
+// land in power-of-two microsecond buckets, from which the dump derives percentiles.
+// Nothing here ever leaves the machine - this feeds a local stats RPC only.
+
+class StatsRegistry : public Singleton<StatsRegistry>
+{
+public:
+    StatsRegistry(const Singleton<StatsRegistry>::PrivatePass&);
+
+    virtual void count(const std::string& name, uint64_t amount = 1);
+    virtual void record(const std::string& name, std::chrono::microseconds elapsed);
+    virtual std::string dump() const; // JSON, one entry per counter/histogram
+
+private:
+    struct Histogram
+    {
+        std::array<uint64_t, 64> buckets{};
+        uint64_t samples{0};
+        uint64_t total_us{0};
+        uint64_t max_us{0};
+    };
+
+    mutable std::mutex mutex;
+    std::map<std::string, uint64_t> counters;
+    std::map<std::string, Histogram> histograms;
+};
+
+// Times a scope into the histogram named after the stage it covers
+class StageTimer
+{
+public:
+    explicit StageTimer(std::string name) : name{std::move(name)}, start{std::chrono::steady_clock::now()}
+    {
+    }
+
+    ~StageTimer()
+    {
+        MP_STATS.record(name,
+                        std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start));
+    }
+
+private:
+    const std::string name;
+    const std::chrono::steady_clock::time_point start;
+};
+
+} // namespace multipass
+
+#endif // MULTIPASS_STATS_REGISTRY_H
@@ -0,0 +1,82 @@
+/*
+ * Copyright (C) 2021 Canonical, Ltd.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; version 3.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#ifndef MULTIPASS_TRACING_H
+#define MULTIPASS_TRACING_H
+
+#include <multipass/singleton.h>
+
+#include <chrono>
+#include <deque>
+#include <fstream>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#define MP_TRACER multipass::Tracer::instance()
+
+namespace multipass
+{
+
+// Records named spans covering the launch pipeline's phases. Spans are kept in a small
+// in-memory ring, from which a per-launch breakdown can be rendered, and - when
+// MULTIPASS_TRACE_FILE points somewhere writable - are also appended as Chrome tracing
+// ("X") events, loadable in chrome://tracing or Perfetto.
+
+class Tracer : public Singleton<Tracer>
+{
+public:
+    struct Span
+    {
+        std::string name;
+        std::chrono::steady_clock::time_point start;
+        std::chrono::steady_clock::time_point end;
+    };
+
+    Tracer(const Singleton<Tracer>::PrivatePass&);
+
+    virtual void record(const std::string& name, std::chrono::steady_clock::time_point start,
+                        std::chrono::steady_clock::time_point end);
+    virtual std::vector<Span> spans_since(std::chrono::steady_clock::time_point t) const;
+
+private:
+    mutable std::mutex mutex;
+    std::deque<Span> recent_spans;
+    std::ofstream trace_file; // only open when tracing to file was requested
+};
+
+// Spans a scope; the recording happens on destruction
+class TracedSpan
+{
+public:
+    explicit TracedSpan(std::string name) : name{std::move(name)}, start{std::chrono::steady_clock::now()}
+    {
+    }
+
+    ~TracedSpan()
+    {
+        MP_TRACER.record(name, start, std::chrono::steady_clock::now());
+    }
+
+private:
+    const std::string name;
+    const std::chrono::steady_clock::time_point start;
+};
+
+} // namespace multipass
+
+#endif // MULTIPASS_TRACING_H
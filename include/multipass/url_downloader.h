@@ -26,19 +26,38 @@
 
 #include <atomic>
 #include <chrono>
+#include <functional>
 
 class QUrl;
 class QString;
 namespace multipass
 {
+// Receives download data as it arrives; returning false aborts the transfer.
+using DataSink = std::function<bool(const QByteArray&)>;
+
 class URLDownloader
 {
 public:
+    // Marks every download started on this thread while alive as background class:
+    // single-stream, small read buffer, and paused (via TCP backpressure) whenever an
+    // interactive transfer is in flight, so update checks never crowd out a launch.
+    class BackgroundPriorityScope
+    {
+    public:
+        BackgroundPriorityScope();
+        ~BackgroundPriorityScope();
+
+        BackgroundPriorityScope(const BackgroundPriorityScope&) = delete;
+        BackgroundPriorityScope& operator=(const BackgroundPriorityScope&) = delete;
+    };
+
     URLDownloader(std::chrono::milliseconds timeout);
     URLDownloader(const Path& cache_dir, std::chrono::milliseconds timeout);
     virtual ~URLDownloader() = default;
     virtual void download_to(const QUrl& url, const QString& file_name, int64_t size, const int download_type,
                              const ProgressMonitor& monitor);
+    virtual void download_to_sink(const QUrl& url, int64_t size, const int download_type,
+                                  const ProgressMonitor& monitor, const DataSink& sink);
     virtual QByteArray download(const QUrl& url);
     virtual QDateTime last_modified(const QUrl& url);
     virtual void abort_all_downloads();
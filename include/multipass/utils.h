@@ -86,6 +86,7 @@ bool process_log_on_error(const QString& program, const QStringList& arguments,
 
 // networking helpers
 void validate_server_address(const std::string& value);
+QString heartbeat_file_path(const std::string& server_address); // empty unless a unix socket address
 bool valid_hostname(const std::string& name_string);
 std::string generate_mac_address();
 bool valid_mac_address(const std::string& mac);
@@ -25,6 +25,7 @@
 #include <condition_variable>
 #include <memory>
 #include <mutex>
+#include <stdexcept>
 #include <string>
 #include <vector>
 
@@ -70,6 +71,26 @@ public:
     virtual void wait_until_ssh_up(std::chrono::milliseconds timeout) = 0;
     virtual void ensure_vm_is_running() = 0;
     virtual void update_state() = 0;
+    // Backends with a memory balloon can return idle guest RAM to the host and take it
+    // back when the instance is used again; the defaults are no-ops for those without
+    virtual void reclaim_idle_memory(){};
+    virtual void restore_reclaimed_memory(){};
+    // Backends whose image format supports named snapshots can capture and revert disk
+    // state in place; others throw so the daemon can report the capability gap
+    virtual void take_snapshot(const std::string& /*snapshot_name*/)
+    {
+        throw std::runtime_error("snapshots are not supported by this driver");
+    };
+    virtual void restore_snapshot(const std::string& /*snapshot_name*/)
+    {
+        throw std::runtime_error("snapshots are not supported by this driver");
+    };
+    // Backends that capture their hypervisor's console/monitor output can return the
+    // recent tail for diagnostics; the default is empty for those that don't
+    virtual std::string console_scrollback()
+    {
+        return {};
+    };
 
     VirtualMachine::State state;
     const std::string vm_name;
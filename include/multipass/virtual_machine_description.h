@@ -49,7 +49,12 @@ public:
     YAML::Node meta_data_config;
     YAML::Node user_data_config;
     YAML::Node vendor_data_config;
-    YAML::Node network_data_config;
+    // Unlike the configs above, which get merged per launch, the network config is
+    // assembled from fixed netplan fragments and carried pre-rendered; empty when the
+    // default interface suffices
+    std::string network_data_config;
+    std::string cpuset; // host CPUs the instance is confined to, cpuset list format; empty means no pinning
+    std::string cpu_model; // CPU model profile ("host"/"portable"); empty means host passthrough
 };
 } // namespace multipass
 
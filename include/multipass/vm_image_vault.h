@@ -29,6 +29,7 @@
 
 #include <functional>
 #include <memory>
+#include <stdexcept>
 #include <string>
 #include <unordered_map>
 #include <utility>
@@ -78,6 +79,12 @@ public:
     virtual ~VMImageVault() = default;
     virtual VMImage fetch_image(const FetchType& fetch_type, const Query& query, const PrepareAction& prepare,
                                 const ProgressMonitor& monitor) = 0;
+    // Vaults whose image format supports copy-on-write can fork an instance's disk
+    // without copying it; others throw so the daemon can report the capability gap
+    virtual VMImage clone_instance_image(const std::string& /*source_name*/, const std::string& /*destination_name*/)
+    {
+        throw std::runtime_error("cloning instances is not supported by this image vault");
+    };
     virtual void remove(const std::string& name) = 0;
     virtual bool has_record_for(const std::string& name) = 0;
     virtual void prune_expired_images() = 0;
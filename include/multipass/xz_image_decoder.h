@@ -22,6 +22,7 @@
 #include <multipass/progress_monitor.h>
 
 #include <memory>
+#include <vector>
 
 #include <QFile>
 
@@ -33,14 +34,21 @@ class XzImageDecoder
 {
 public:
     XzImageDecoder(const Path& xz_file_path);
+    XzImageDecoder(); // incremental mode, fed via decode_chunk
 
     void decode_to(const Path& decoded_file_path, const ProgressMonitor& monitor);
 
+    // Decodes a chunk of xz data as it arrives, appending output to decoded_file.
+    // Returns false once the end of the xz stream has been reached.
+    bool decode_chunk(const char* data, qint64 size, QFile& decoded_file);
+
     using XzDecoderUPtr = std::unique_ptr<xz_dec, decltype(xz_dec_end)*>;
 
 private:
     QFile xz_file;
     XzDecoderUPtr xz_decoder;
+    std::vector<char> chunk_out_buf;
+    bool stream_ended{false};
 };
 } // namespace multipass
 #endif // MULTIPASS_XZ_IMAGE_DECODER_H
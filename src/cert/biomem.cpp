@@ -18,7 +18,6 @@
 #include "biomem.h"
 
 #include <stdexcept>
-#include <vector>
 
 namespace mp = multipass;
 
@@ -28,16 +27,19 @@ mp::BIOMem::BIOMem() : bio{BIO_new(BIO_s_mem()), BIO_free}
         throw std::runtime_error("Failed to create BIO structure");
 }
 
-mp::BIOMem::BIOMem(const std::string& pem_source) : BIOMem()
+mp::BIOMem::BIOMem(const std::string& pem_source)
+    : bio{BIO_new_mem_buf(pem_source.data(), pem_source.size()), BIO_free}
 {
-    BIO_write(bio.get(), pem_source.data(), pem_source.size());
+    if (bio == nullptr)
+        throw std::runtime_error("Failed to create BIO structure");
 }
 
 std::string mp::BIOMem::as_string() const
 {
-    std::vector<char> pem(BIO_number_written(bio.get()));
-    BIO_read(bio.get(), pem.data(), pem.size());
-    return {pem.begin(), pem.end()};
+    // Read straight out of the BIO's own buffer, one copy into the returned string
+    char* data{nullptr};
+    const auto size = BIO_get_mem_data(bio.get(), &data);
+    return {data, data + size};
 }
 
 BIO* mp::BIOMem::get() const
@@ -29,6 +29,7 @@ class BIOMem
 {
 public:
     BIOMem();
+    // Wraps pem_source read-only without copying; the source must outlive this BIOMem
     BIOMem(const std::string& pem_source);
     std::string as_string() const;
     BIO* get() const;
@@ -23,10 +23,13 @@
 #include <openssl/pem.h>
 #include <openssl/x509.h>
 
+#include <QDateTime>
 #include <QDir>
 #include <QFile>
+#include <QFileInfo>
 
 #include <stdexcept>
+#include <vector>
 
 namespace mp = multipass;
 
@@ -34,24 +37,65 @@ namespace
 {
 constexpr auto chain_name = "multipass_client_certs.pem";
 
-void validate_certificate(const std::string& pem_cert)
+using X509UPtr = std::unique_ptr<X509, decltype(X509_free)*>;
+
+X509UPtr parse_certificate(const std::string& pem_cert)
 {
     mp::BIOMem bio{pem_cert};
-    auto raw_cert = PEM_read_bio_X509(bio.get(), nullptr, nullptr, nullptr);
-    std::unique_ptr<X509, decltype(X509_free)*> x509{raw_cert, X509_free};
+    X509UPtr x509{PEM_read_bio_X509(bio.get(), nullptr, nullptr, nullptr), X509_free};
 
-    if (raw_cert == nullptr)
+    if (x509 == nullptr)
         throw std::runtime_error("invalid certificate data");
+
+    return x509;
 }
 } // namespace
 
+struct mp::ClientCertStore::ParsedChain
+{
+    std::string pem;
+    QDateTime last_modified;
+    std::vector<X509UPtr> certs;
+};
+
 mp::ClientCertStore::ClientCertStore(const multipass::Path& cert_dir) : cert_dir{cert_dir}
 {
 }
 
+mp::ClientCertStore::~ClientCertStore() = default;
+
+auto mp::ClientCertStore::load_chain() const -> const ParsedChain&
+{
+    QDir dir{cert_dir};
+    const QFileInfo chain_file{dir.filePath(chain_name)};
+    const auto last_modified = chain_file.exists() ? chain_file.lastModified() : QDateTime{};
+
+    if (chain_cache && chain_cache->last_modified == last_modified)
+        return *chain_cache;
+
+    auto chain = std::make_unique<ParsedChain>();
+    chain->last_modified = last_modified;
+    if (chain_file.exists())
+    {
+        chain->pem = mp::utils::contents_of(chain_file.filePath());
+        BIOMem bio{chain->pem};
+        while (auto cert = PEM_read_bio_X509(bio.get(), nullptr, nullptr, nullptr))
+            chain->certs.emplace_back(cert, X509_free);
+    }
+
+    chain_cache = std::move(chain);
+    return *chain_cache;
+}
+
 void mp::ClientCertStore::add_cert(const std::string& pem_cert)
 {
-    validate_certificate(pem_cert);
+    auto cert = parse_certificate(pem_cert);
+
+    const auto& chain = load_chain();
+    for (const auto& known : chain.certs)
+        if (X509_cmp(known.get(), cert.get()) == 0)
+            return; // already in the chain; nothing to append
+
     QDir dir{cert_dir};
     QFile file{dir.filePath(chain_name)};
     auto opened = file.open(QIODevice::WriteOnly | QIODevice::Append);
@@ -61,13 +105,15 @@ void mp::ClientCertStore::add_cert(const std::string& pem_cert)
     size_t written = file.write(pem_cert.data(), pem_cert.size());
     if (written != pem_cert.size())
         throw std::runtime_error("failed to write certificate");
+    file.close();
+
+    // fold the new certificate into the cache rather than re-reading the file
+    chain_cache->pem.append(pem_cert);
+    chain_cache->certs.push_back(std::move(cert));
+    chain_cache->last_modified = QFileInfo{file.fileName()}.lastModified();
 }
 
 std::string mp::ClientCertStore::PEM_cert_chain() const
 {
-    QDir dir{cert_dir};
-    auto path = dir.filePath(chain_name);
-    if (QFile::exists(path))
-        return mp::utils::contents_of(path);
-    return {};
+    return load_chain().pem;
 }
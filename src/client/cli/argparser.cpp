@@ -38,17 +38,17 @@ namespace cmd = multipass::cmd;
 
 namespace
 {
-auto max_command_string_length(const std::vector<cmd::Command::UPtr>& commands)
+auto max_command_string_length(const std::vector<cmd::LazyCommand>& commands)
 {
     auto ret = 0ul;
 
     if (!commands.empty())
     {
-        auto string_len_compare = [](const cmd::Command::UPtr& a, const cmd::Command::UPtr& b) {
-            return a->name().length() < b->name().length();
+        auto string_len_compare = [](const cmd::LazyCommand& a, const cmd::LazyCommand& b) {
+            return a.name().length() < b.name().length();
         };
         const auto& max_elem = *std::max_element(commands.begin(), commands.end(), string_len_compare);
-        ret = max_elem->name().length();
+        ret = max_elem.name().length();
     }
 
     return ret;
@@ -59,14 +59,15 @@ auto format_into_column(const std::string& name, std::string::size_type column_s
     return fmt::format("  {:<{}}  ", name, column_size);
 }
 
-QString format_short_help_for(const std::vector<cmd::Command::UPtr>& commands)
+QString format_short_help_for(const std::vector<cmd::LazyCommand>& commands)
 {
+    // Only here does every command get constructed; short help has to come from each one
     const auto column_size = max_command_string_length(commands);
     QString output;
     for (const auto& c : commands)
     {
-        output += QString::fromStdString(format_into_column(c->name(), column_size));
-        output += c->short_help() + "\n";
+        output += QString::fromStdString(format_into_column(c.name(), column_size));
+        output += c.get()->short_help() + "\n";
     }
     return output;
 }
@@ -88,7 +89,7 @@ auto verbosity_level_in(const QStringList& arguments)
 }
 } // namespace
 
-mp::ArgParser::ArgParser(const QStringList& arguments, const std::vector<cmd::Command::UPtr>& commands,
+mp::ArgParser::ArgParser(const QStringList& arguments, const std::vector<cmd::LazyCommand>& commands,
                          std::ostream& cout, std::ostream& cerr)
     : arguments(arguments), commands(commands), chosen_command(nullptr), help_requested(false), cout(cout), cerr(cerr)
 {
@@ -283,9 +284,11 @@ cmd::Command* mp::ArgParser::chosenCommand() const
 
 cmd::Command* mp::ArgParser::findCommand(const QString& command) const
 {
+    // Aliases are registered alongside the factories, so resolution by itself does not
+    // construct anything; only the command that matches gets instantiated
     for (const auto& c : commands)
     {
-        for (const auto& alias : c->aliases())
+        for (const auto& alias : c.aliases())
         {
             if (command.toStdString() == alias)
             {
@@ -297,7 +300,7 @@ cmd::Command* mp::ArgParser::findCommand(const QString& command) const
     return nullptr;
 }
 
-const std::vector<cmd::Command::UPtr>& mp::ArgParser::getCommands() const
+const std::vector<cmd::LazyCommand>& mp::ArgParser::getCommands() const
 {
     return commands;
 }
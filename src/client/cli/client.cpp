@@ -16,6 +16,7 @@
  */
 
 #include "client.h"
+#include "cmd/console_log.h"
 #include "cmd/delete.h"
 #include "cmd/exec.h"
 #include "cmd/find.h"
@@ -26,12 +27,14 @@
 #include "cmd/list.h"
 #include "cmd/mount.h"
 #include "cmd/networks.h"
+#include "cmd/ping.h"
 #include "cmd/purge.h"
 #include "cmd/recover.h"
 #include "cmd/restart.h"
 #include "cmd/set.h"
 #include "cmd/shell.h"
 #include "cmd/start.h"
+#include "cmd/stats.h"
 #include "cmd/stop.h"
 #include "cmd/suspend.h"
 #include "cmd/transfer.h"
@@ -54,34 +57,37 @@ mp::Client::Client(ClientConfig& config)
       stub{mp::Rpc::NewStub(rpc_channel)},
       term{config.term}
 {
-    add_command<cmd::Launch>();
-    add_command<cmd::Purge>();
-    add_command<cmd::Exec>();
-    add_command<cmd::Find>();
-    add_command<cmd::Get>();
-    add_command<cmd::Help>();
-    add_command<cmd::Info>();
-    add_command<cmd::List>();
-    add_command<cmd::Networks>();
-    add_command<cmd::Mount>();
-    add_command<cmd::Recover>();
-    add_command<cmd::Set>();
-    add_command<cmd::Shell>();
-    add_command<cmd::Start>();
-    add_command<cmd::Stop>();
-    add_command<cmd::Suspend>();
-    add_command<cmd::Transfer>();
-    add_command<cmd::Restart>();
-    add_command<cmd::Delete>();
-    add_command<cmd::Umount>();
-    add_command<cmd::Version>();
+    add_command<cmd::Launch>({"launch"});
+    add_command<cmd::Purge>({"purge"});
+    add_command<cmd::Exec>({"exec"});
+    add_command<cmd::Find>({"find"});
+    add_command<cmd::Get>({"get"});
+    add_command<cmd::Help>({"help"});
+    add_command<cmd::Info>({"info"});
+    add_command<cmd::List>({"list", "ls"});
+    add_command<cmd::Networks>({"networks"});
+    add_command<cmd::Ping>({"ping"});
+    add_command<cmd::Mount>({"mount"});
+    add_command<cmd::Recover>({"recover"});
+    add_command<cmd::Set>({"set"});
+    add_command<cmd::Shell>({"shell", "sh", "connect"});
+    add_command<cmd::Start>({"start"});
+    add_command<cmd::Stats>({"stats"});
+    add_command<cmd::Stop>({"stop"});
+    add_command<cmd::Suspend>({"suspend"});
+    add_command<cmd::Transfer>({"transfer", "copy-files"});
+    add_command<cmd::Restart>({"restart"});
+    add_command<cmd::Delete>({"delete"});
+    add_command<cmd::Umount>({"umount", "unmount"});
+    add_command<cmd::Version>({"version"});
+    add_command<cmd::ConsoleLog>({"console-log"});
 
     sort_commands();
 }
 
 void mp::Client::sort_commands()
 {
-    auto name_sort = [](cmd::Command::UPtr& a, cmd::Command::UPtr& b) { return a->name() < b->name(); };
+    auto name_sort = [](const cmd::LazyCommand& a, const cmd::LazyCommand& b) { return a.name() < b.name(); };
     std::sort(commands.begin(), commands.end(), name_sort);
 }
 
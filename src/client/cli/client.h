@@ -47,7 +47,7 @@ public:
 
 protected:
     template <typename T>
-    void add_command();
+    void add_command(std::vector<std::string> aliases);
     void sort_commands();
 
 private:
@@ -55,17 +55,19 @@ private:
     std::shared_ptr<grpc::Channel> rpc_channel;
     std::unique_ptr<multipass::Rpc::Stub> stub;
 
-    std::vector<cmd::Command::UPtr> commands;
+    std::vector<cmd::LazyCommand> commands;
 
     Terminal* term;
 };
 } // namespace multipass
 
+// Commands register as a factory under their aliases; construction waits until one is
+// actually chosen (or help needs them all)
 template <typename T>
-void multipass::Client::add_command()
+void multipass::Client::add_command(std::vector<std::string> aliases)
 {
-    auto cmd = std::make_unique<T>(*rpc_channel, *stub, term);
-    commands.push_back(std::move(cmd));
+    commands.emplace_back(std::move(aliases),
+                          [this]() -> cmd::Command::UPtr { return std::make_unique<T>(*rpc_channel, *stub, term); });
 }
 
 #endif // MULTIPASS_CLIENT_H
@@ -48,12 +48,19 @@ void mp::AnimatedSpinner::start(const std::string& start_message)
     if (!running)
     {
         running = true;
+        current_message = start_message;
+        progress = -1;
         clear_line(cout);
         cout << start_message << "  " << std::flush;
         t = std::thread(&AnimatedSpinner::draw, this);
     }
 }
 
+void mp::AnimatedSpinner::update_progress(int percent)
+{
+    progress.store(percent, std::memory_order_relaxed);
+}
+
 void mp::AnimatedSpinner::stop()
 {
     std::unique_lock<decltype(mutex)> lock{mutex};
@@ -72,11 +79,24 @@ void mp::AnimatedSpinner::draw()
 {
     std::unique_lock<decltype(mutex)> lock{mutex};
     auto it = spinner.begin();
+    auto last_drawn_progress = -1;
     while (running)
     {
-        if (++it == spinner.end())
-            it = spinner.begin();
-        cout << "\b" << *it << std::flush;
+        const auto percent = progress.load(std::memory_order_relaxed);
+        if (percent >= 0)
+        {
+            if (percent != last_drawn_progress)
+            {
+                cout << "\r" << current_message << percent << "%  " << std::flush;
+                last_drawn_progress = percent;
+            }
+        }
+        else
+        {
+            if (++it == spinner.end())
+                it = spinner.begin();
+            cout << "\b" << *it << std::flush;
+        }
         cv.wait_for(lock, std::chrono::milliseconds(100));
     }
     cout << "\b"
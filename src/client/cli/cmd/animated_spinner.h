@@ -20,6 +20,7 @@
 #ifndef MULTIPASS_ANIMATED_SPINNER_H
 #define MULTIPASS_ANIMATED_SPINNER_H
 
+#include <atomic>
 #include <future>
 #include <string>
 #include <vector>
@@ -35,11 +36,17 @@ public:
     void start(const std::string& message);
     void stop();
 
+    // Cheap to call at any rate: just stores the value, which the draw thread samples
+    // and renders at its own fixed frequency, so per-chunk callbacks never redraw
+    void update_progress(int percent);
+
 private:
     void draw();
     const std::vector<char> spinner;
     std::ostream& cout;
     bool running;
+    std::string current_message;
+    std::atomic<int> progress{-1};
     std::mutex mutex;
     std::condition_variable cv;
     std::thread t;
@@ -0,0 +1,84 @@
+/*
+ * Copyright (C) 2021 Canonical, Ltd.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; version 3.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "console_log.h"
+#include "common_cli.h"
+
+#include <multipass/cli/argparser.h>
+
+namespace mp = multipass;
+namespace cmd = multipass::cmd;
+using RpcMethod = mp::Rpc::Stub;
+
+mp::ReturnCode cmd::ConsoleLog::run(mp::ArgParser* parser)
+{
+    auto ret = parse_args(parser);
+    if (ret != ParseCode::Ok)
+    {
+        return parser->returnCodeFrom(ret);
+    }
+
+    auto on_success = [this](mp::ConsoleLogReply& reply) {
+        cout << reply.scrollback();
+        return ReturnCode::Ok;
+    };
+
+    auto on_failure = [this](grpc::Status& status) { return standard_failure_handler_for(name(), cerr, status); };
+
+    request.set_verbosity_level(parser->verbosityLevel());
+    return dispatch(&RpcMethod::console_log, request, on_success, on_failure);
+}
+
+std::string cmd::ConsoleLog::name() const
+{
+    return "console-log";
+}
+
+QString cmd::ConsoleLog::short_help() const
+{
+    return QStringLiteral("Show an instance's recent console output");
+}
+
+QString cmd::ConsoleLog::description() const
+{
+    return QStringLiteral("Show the recent hypervisor console and monitor output captured\n"
+                          "for an instance, most useful for diagnosing boot failures. The\n"
+                          "daemon keeps a bounded scrollback per instance, so only the\n"
+                          "latest output is available.");
+}
+
+mp::ParseCode cmd::ConsoleLog::parse_args(mp::ArgParser* parser)
+{
+    parser->addPositionalArgument("name", "Name of the instance to show the console output for", "<name>");
+
+    auto status = parser->commandParse(this);
+
+    if (status != ParseCode::Ok)
+    {
+        return status;
+    }
+
+    if (parser->positionalArguments().count() != 1)
+    {
+        cerr << "Name argument is required\n";
+        return ParseCode::CommandLineError;
+    }
+
+    request.set_instance_name(parser->positionalArguments().first().toStdString());
+
+    return status;
+}
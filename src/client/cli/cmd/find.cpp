@@ -33,8 +33,32 @@ mp::ReturnCode cmd::Find::run(mp::ArgParser* parser)
         return parser->returnCodeFrom(ret);
     }
 
-    auto on_success = [this](FindReply& reply) {
-        cout << chosen_formatter->format(reply);
+    FindReply accumulated_reply;
+    auto painted_rows = false;
+
+    // The daemon streams a reply per remote; for table output each batch is painted as it
+    // arrives (fixed column widths keep batches aligned, the header comes with the first),
+    // while structured formats need the complete set before they can be rendered
+    auto streaming_callback = [this, &accumulated_reply, &painted_rows](FindReply& reply) {
+        if (!stream_table_rows)
+        {
+            accumulated_reply.mutable_images_info()->MergeFrom(reply.images_info());
+            return;
+        }
+
+        if (reply.images_info().empty())
+            return;
+
+        auto output = chosen_formatter->format(reply);
+        if (painted_rows)
+            output.erase(0, output.find('\n') + 1);
+        painted_rows = true;
+        cout << output << std::flush;
+    };
+
+    auto on_success = [this, &accumulated_reply, &painted_rows](FindReply& reply) {
+        if (!painted_rows)
+            cout << chosen_formatter->format(accumulated_reply);
 
         return ReturnCode::Ok;
     };
@@ -42,7 +66,7 @@ mp::ReturnCode cmd::Find::run(mp::ArgParser* parser)
     auto on_failure = [this](grpc::Status& status) { return standard_failure_handler_for(name(), cerr, status); };
 
     request.set_verbosity_level(parser->verbosityLevel());
-    return dispatch(&RpcMethod::find, request, on_success, on_failure);
+    return dispatch(&RpcMethod::find, request, on_success, on_failure, streaming_callback);
 }
 
 std::string cmd::Find::name() const
@@ -71,7 +95,10 @@ mp::ParseCode cmd::Find::parse_args(mp::ArgParser* parser)
                                   "Ubuntu release version, codename or alias.",
                                   "[<remote:>][<string>]");
     QCommandLineOption unsupportedOption("show-unsupported", "Show unsupported cloud images as well");
-    parser->addOptions({unsupportedOption});
+    QCommandLineOption limitOption("limit", "Stop after listing the given number of images", "number");
+    QCommandLineOption prefixOption("prefix", "Only list images with an alias beginning with the given prefix",
+                                    "prefix");
+    parser->addOptions({unsupportedOption, limitOption, prefixOption});
 
     QCommandLineOption formatOption(
         "format", "Output list in the requested format.\nValid formats are: table (default), json, csv and yaml",
@@ -117,7 +144,25 @@ mp::ParseCode cmd::Find::parse_args(mp::ArgParser* parser)
         request.set_allow_unsupported(true);
     }
 
+    if (parser->isSet(limitOption))
+    {
+        bool ok;
+        const auto limit = parser->value(limitOption).toInt(&ok);
+        if (!ok || limit < 1)
+        {
+            cerr << "Invalid limit supplied\n";
+            return ParseCode::CommandLineError;
+        }
+        request.set_limit(limit);
+    }
+
+    if (parser->isSet(prefixOption))
+    {
+        request.set_alias_prefix(parser->value(prefixOption).toStdString());
+    }
+
     status = handle_format_option(parser, &chosen_formatter, cerr);
+    stream_table_rows = parser->value(formatOption) == "table";
 
     return status;
 }
@@ -42,6 +42,7 @@ private:
     ParseCode parse_args(ArgParser* parser) override;
 
     Formatter* chosen_formatter;
+    bool stream_table_rows{false}; // paint table output as replies arrive
 };
 }
 }
@@ -33,8 +33,30 @@ mp::ReturnCode cmd::Info::run(mp::ArgParser* parser)
         return parser->returnCodeFrom(ret);
     }
 
-    auto on_success = [this](mp::InfoReply& reply) {
-        cout << chosen_formatter->format(reply);
+    // The daemon streams each instance's entry as soon as it is ready; formats that can
+    // print piecewise do so right away, the rest get the assembled reply at the end
+    mp::InfoReply assembled;
+    auto streamed_fragments = 0;
+    auto streaming_callback = [this, &assembled, &streamed_fragments](mp::InfoReply& reply) {
+        if (reply.info().empty())
+            return;
+
+        auto fragment = chosen_formatter->format_partial(reply, streamed_fragments == 0);
+        if (!fragment.empty())
+        {
+            cout << (streamed_fragments++ ? "\n" : "") << fragment;
+            cout.flush();
+        }
+        else
+        {
+            for (const auto& info : reply.info())
+                assembled.add_info()->CopyFrom(info);
+        }
+    };
+
+    auto on_success = [this, &assembled, &streamed_fragments](mp::InfoReply& reply) {
+        if (!streamed_fragments)
+            cout << chosen_formatter->format(assembled);
 
         return ReturnCode::Ok;
     };
@@ -42,7 +64,7 @@ mp::ReturnCode cmd::Info::run(mp::ArgParser* parser)
     auto on_failure = [this](grpc::Status& status) { return standard_failure_handler_for(name(), cerr, status); };
 
     request.set_verbosity_level(parser->verbosityLevel());
-    return dispatch(&RpcMethod::info, request, on_success, on_failure);
+    return dispatch(&RpcMethod::info, request, on_success, on_failure, streaming_callback);
 }
 
 std::string cmd::Info::name() const { return "info"; }
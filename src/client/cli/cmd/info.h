@@ -42,6 +42,12 @@ private:
     InfoRequest request;
     Formatter* chosen_formatter;
 
+    // bounded: past this the daemon streams wedged instances as partial entries
+    optional<std::chrono::milliseconds> rpc_deadline() const override
+    {
+        return std::chrono::minutes{2};
+    }
+
     ParseCode parse_args(ArgParser *parser) override;
 };
 }
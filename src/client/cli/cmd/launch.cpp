@@ -121,7 +121,7 @@ mp::ReturnCode cmd::Launch::run(mp::ArgParser* parser)
     request.set_time_zone(QTimeZone::systemTimeZoneId().toStdString());
 
     auto ret = request_launch();
-    if (ret == ReturnCode::Ok && request.instance_name() == petenv_name.toStdString())
+    if (ret == ReturnCode::Ok && request.count() <= 1 && request.instance_name() == petenv_name.toStdString())
     {
         QString mount_source{};
         try
@@ -195,6 +195,23 @@ mp::ParseCode cmd::Launch::parse_args(mp::ArgParser* parser)
         "name");
     QCommandLineOption cloudInitOption("cloud-init", "Path to a user-data cloud-init configuration, or '-' for stdin",
                                        "file");
+    QCommandLineOption cpusetOption(
+        "cpuset",
+        "Set of host CPUs to pin the instance to, in cpuset list format (e.g. \"0-3,8\"). The instance's virtual "
+        "CPUs and I/O threads are confined to these host CPUs.",
+        "cpus");
+    QCommandLineOption cpuModelOption(
+        "cpu-model",
+        "CPU model profile for the instance. \"host\" (the default) passes the host CPU through, exposing its full "
+        "feature set to the guest; \"portable\" picks a conservative model whose suspended images can resume on "
+        "different host silicon.",
+        "model");
+    QCommandLineOption countOption("count",
+                                   "Number of instances to launch. The image is fetched and prepared once and the "
+                                   "instances are created in parallel from it. With --name, instances are named "
+                                   "<name>-1 through <name>-N; otherwise each gets a generated name.",
+                                   "count", "1");
+    QCommandLineOption timingOption("timing", "Show a per-phase timing breakdown once the launch completes");
     QCommandLineOption networkOption("network",
                                      "Add a network interface to the instance, where <spec> is in the "
                                      "\"key=value,key=value\" format, with the following keys available:\n"
@@ -205,7 +222,8 @@ mp::ParseCode cmd::Launch::parse_args(mp::ArgParser* parser)
                                      "You can also use a shortcut of \"<name>\" to mean \"name=<name>\".",
                                      "spec");
 
-    parser->addOptions({cpusOption, diskOption, memOption, nameOption, cloudInitOption, networkOption});
+    parser->addOptions({cpusOption, diskOption, memOption, nameOption, cloudInitOption, networkOption, cpusetOption,
+                        cpuModelOption, countOption, timingOption});
 
     auto status = parser->commandParse(this);
 
@@ -260,6 +278,42 @@ mp::ParseCode cmd::Launch::parse_args(mp::ArgParser* parser)
         request.set_num_cores(parser->value(cpusOption).toInt());
     }
 
+    if (parser->isSet(cpusetOption))
+    {
+        const auto cpuset = parser->value(cpusetOption).toStdString();
+        if (!std::regex_match(cpuset, std::regex{"\\d+(-\\d+)?(,\\d+(-\\d+)?)*"}))
+        {
+            cerr << "error: --cpuset expects a cpuset list, e.g. \"0-3,8\"\n";
+            return ParseCode::CommandLineError;
+        }
+        request.set_cpuset(cpuset);
+    }
+
+    if (parser->isSet(cpuModelOption))
+    {
+        const auto cpu_model = parser->value(cpuModelOption).toStdString();
+        if (cpu_model != "host" && cpu_model != "portable")
+        {
+            cerr << "error: --cpu-model expects \"host\" or \"portable\"\n";
+            return ParseCode::CommandLineError;
+        }
+        request.set_cpu_model(cpu_model);
+    }
+
+    if (parser->isSet(countOption))
+    {
+        bool converts;
+        const auto count = parser->value(countOption).toInt(&converts);
+        if (!converts || count < 1)
+        {
+            cerr << "error: --count expects a positive integer\n";
+            return ParseCode::CommandLineError;
+        }
+        request.set_count(count);
+    }
+
+    request.set_timing(parser->isSet(timingOption));
+
     if (parser->isSet(memOption))
     {
         request.set_mem_size(parser->value(memOption).toStdString());
@@ -374,7 +428,11 @@ mp::ReturnCode cmd::Launch::request_launch()
             return request_launch();
         }
 
-        cout << "Launched: " << reply.vm_instance_name() << "\n";
+        if (request.count() <= 1) // instances already announced themselves when launching several
+            cout << "Launched: " << reply.vm_instance_name() << "\n";
+
+        if (!reply.timing_breakdown().empty())
+            cout << reply.timing_breakdown();
 
         if (term->is_live() && update_available(reply.update_info()))
         {
@@ -418,7 +476,7 @@ mp::ReturnCode cmd::Launch::request_launch()
         return standard_failure_handler_for(name(), cerr, status, error_details);
     };
 
-    auto streaming_callback = [this, &spinner](mp::LaunchReply& reply) {
+    auto streaming_callback = [this, &spinner, spinner_message = std::string{}](mp::LaunchReply& reply) mutable {
         std::unordered_map<int, std::string> progress_messages{
             {LaunchProgress_ProgressTypes_IMAGE, "Retrieving image: "},
             {LaunchProgress_ProgressTypes_KERNEL, "Retrieving kernel image: "},
@@ -427,29 +485,40 @@ mp::ReturnCode cmd::Launch::request_launch()
             {LaunchProgress_ProgressTypes_VERIFY, "Verifying image: "},
             {LaunchProgress_ProgressTypes_WAITING, "Preparing image: "}};
 
-        if (reply.create_oneof_case() == mp::LaunchReply::CreateOneofCase::kLaunchProgress)
+        // with --count, each instance announces itself as it comes up; the final reply
+        // then carries no name of its own
+        if (request.count() > 1 && reply.create_oneof_case() == mp::LaunchReply::CreateOneofCase::kVmInstanceName)
+        {
+            spinner.stop();
+            spinner_message.clear();
+            cout << "\rLaunched: " << reply.vm_instance_name() << "\n";
+        }
+        else if (reply.create_oneof_case() == mp::LaunchReply::CreateOneofCase::kLaunchProgress)
         {
+            // percentages are only stored here; the spinner's draw thread samples and
+            // renders them at its own pace, keeping redraws off the streaming path
             auto& progress_message = progress_messages[reply.launch_progress().type()];
-            if (reply.launch_progress().percent_complete() != "-1")
-            {
-                spinner.stop();
-                cout << "\r";
-                cout << progress_message << reply.launch_progress().percent_complete() << "%" << std::flush;
-            }
-            else
+            if (progress_message != spinner_message)
             {
                 spinner.stop();
                 spinner.start(progress_message);
+                spinner_message = progress_message;
             }
+
+            const auto& percent = reply.launch_progress().percent_complete();
+            if (percent != "-1")
+                spinner.update_progress(std::stoi(percent));
         }
         else if (reply.create_oneof_case() == mp::LaunchReply::CreateOneofCase::kCreateMessage)
         {
             spinner.stop();
+            spinner_message.clear();
             spinner.start(reply.create_message());
         }
         else if (!reply.reply_message().empty())
         {
             spinner.stop();
+            spinner_message.clear();
             spinner.start(reply.reply_message());
         }
     };
@@ -20,11 +20,51 @@
 
 #include <multipass/cli/argparser.h>
 #include <multipass/cli/formatter.h>
+#include <multipass/optional.h>
+#include <multipass/standard_paths.h>
+
+#include <QDir>
+#include <QFile>
+#include <QSaveFile>
 
 namespace mp = multipass;
 namespace cmd = multipass::cmd;
 using RpcMethod = mp::Rpc::Stub;
 
+namespace
+{
+QString list_cache_path()
+{
+    return QDir{MP_STDPATHS.writableLocation(mp::StandardPaths::CacheLocation)}.filePath("multipass_list.cache");
+}
+
+mp::optional<mp::ListReply> load_cached_reply()
+{
+    QFile cache_file{list_cache_path()};
+    if (!cache_file.open(QIODevice::ReadOnly))
+        return mp::nullopt;
+
+    mp::ListReply reply;
+    if (!reply.ParseFromString(cache_file.readAll().toStdString()))
+        return mp::nullopt;
+
+    return reply;
+}
+
+void store_cached_reply(const mp::ListReply& reply)
+{
+    QDir{MP_STDPATHS.writableLocation(mp::StandardPaths::CacheLocation)}.mkpath(".");
+
+    QSaveFile cache_file{list_cache_path()};
+    if (cache_file.open(QIODevice::WriteOnly))
+    {
+        auto serialized = reply.SerializeAsString();
+        cache_file.write(serialized.data(), serialized.size());
+        cache_file.commit();
+    }
+}
+} // namespace
+
 mp::ReturnCode cmd::List::run(mp::ArgParser* parser)
 {
     auto ret = parse_args(parser);
@@ -33,8 +73,56 @@ mp::ReturnCode cmd::List::run(mp::ArgParser* parser)
         return parser->returnCodeFrom(ret);
     }
 
-    auto on_success = [this](ListReply& reply) {
-        cout << chosen_formatter->format(reply);
+    // Names-only asks the dedicated RPC, answered straight from the daemon's in-memory
+    // map — no state queries, no formatting; shell completion depends on this being fast
+    if (names_only)
+    {
+        auto on_names = [this](InstanceNamesReply& reply) {
+            for (const auto& name : reply.name())
+                cout << name << "\n";
+
+            return ReturnCode::Ok;
+        };
+
+        auto on_names_failure = [this](grpc::Status& status) {
+            return standard_failure_handler_for(name(), cerr, status);
+        };
+
+        InstanceNamesRequest names_request;
+        names_request.set_verbosity_level(parser->verbosityLevel());
+        return dispatch(&RpcMethod::instance_names, names_request, on_names, on_names_failure);
+    }
+
+    // The daemon stamps every reply with a generation token; presenting it back lets the
+    // daemon answer "unchanged" instead of querying each instance again
+    mp::optional<mp::ListReply> cached_reply;
+    if (use_cached)
+    {
+        cached_reply = load_cached_reply();
+        if (cached_reply)
+            request.set_known_generation(cached_reply->generation());
+    }
+
+    auto on_success = [this, &cached_reply](ListReply& reply) {
+        if (reply.unchanged() && cached_reply)
+        {
+            cout << chosen_formatter->format(*cached_reply);
+        }
+        else
+        {
+            // A pre-rendered payload already went through the formatter daemon-side; the
+            // copy cached for later runs drops it, as those may ask for another format
+            if (!reply.prerendered().empty())
+                cout << reply.prerendered();
+            else
+                cout << chosen_formatter->format(reply);
+
+            if (reply.generation())
+            {
+                reply.clear_prerendered();
+                store_cached_reply(reply);
+            }
+        }
 
         if (term->is_live() && update_available(reply.update_info()))
             cout << update_notice(reply.update_info());
@@ -77,7 +165,14 @@ mp::ParseCode cmd::List::parse_args(mp::ArgParser* parser)
     QCommandLineOption noIpv4Option("no-ipv4", "Do not query the instances for the IPv4's they are using");
     noIpv4Option.setFlags(QCommandLineOption::HiddenFromHelp);
 
-    parser->addOptions({formatOption, noIpv4Option});
+    QCommandLineOption cachedOption("cached",
+                                    "Reuse the last list output when the daemon reports nothing has changed");
+
+    QCommandLineOption namesOnlyOption("names-only",
+                                       "Print one instance name per line, nothing else. Answered without "
+                                       "querying instance state. Intended for shell completion.");
+
+    parser->addOptions({formatOption, noIpv4Option, cachedOption, namesOnlyOption});
 
     auto status = parser->commandParse(this);
 
@@ -93,8 +188,15 @@ mp::ParseCode cmd::List::parse_args(mp::ArgParser* parser)
     }
 
     request.set_request_ipv4(!parser->isSet(noIpv4Option));
+    use_cached = parser->isSet(cachedOption);
+    names_only = parser->isSet(namesOnlyOption);
 
     status = handle_format_option(parser, &chosen_formatter, cerr);
 
+    // Machine formats are rendered daemon-side in one pass; the table layout stays local
+    const auto format_value = parser->value(formatOption).toStdString();
+    if (status == ParseCode::Ok && format_value != "table")
+        request.set_format(format_value);
+
     return status;
 }
@@ -40,8 +40,16 @@ public:
 private:
     ParseCode parse_args(ArgParser *parser) override;
 
+    // bounded: list answers from daemon-side state, so half a minute is generous
+    optional<std::chrono::milliseconds> rpc_deadline() const override
+    {
+        return std::chrono::seconds{30};
+    }
+
     ListRequest request;
     Formatter* chosen_formatter;
+    bool use_cached{false};
+    bool names_only{false};
 };
 }
 }
@@ -19,12 +19,42 @@
 #include "common_cli.h"
 
 #include <multipass/cli/argparser.h>
+#include <multipass/cli/client_common.h>
 #include <multipass/cli/formatter.h>
+#include <multipass/optional.h>
+
+#include <QFile>
+
+#include <cstring>
 
 namespace mp = multipass;
 namespace cmd = multipass::cmd;
 using RpcMethod = mp::Rpc::Stub;
 
+namespace
+{
+// The daemon publishes its latest networks answer next to its unix socket; reading it
+// costs one file open, so callers that tolerate slight staleness (shell completion)
+// can skip the RPC altogether
+mp::optional<mp::NetworksReply> load_published_reply()
+{
+    constexpr auto unix_scheme = "unix:";
+    const auto server_address = mp::client::get_server_address();
+    if (server_address.rfind(unix_scheme, 0) != 0)
+        return mp::nullopt;
+
+    QFile cache_file{QString::fromStdString(server_address.substr(strlen(unix_scheme)) + ".networks")};
+    if (!cache_file.open(QIODevice::ReadOnly))
+        return mp::nullopt;
+
+    mp::NetworksReply reply;
+    if (!reply.ParseFromString(cache_file.readAll().toStdString()))
+        return mp::nullopt;
+
+    return reply;
+}
+} // namespace
+
 mp::ReturnCode cmd::Networks::run(mp::ArgParser* parser)
 {
     auto ret = parse_args(parser);
@@ -33,6 +63,16 @@ mp::ReturnCode cmd::Networks::run(mp::ArgParser* parser)
         return parser->returnCodeFrom(ret);
     }
 
+    if (use_cached)
+    {
+        if (auto reply = load_published_reply())
+        {
+            cout << chosen_formatter->format(*reply);
+            return ReturnCode::Ok;
+        }
+        // nothing published (old daemon, or no query served yet); fall back to the RPC
+    }
+
     auto on_success = [this](NetworksReply& reply) {
         cout << chosen_formatter->format(reply);
 
@@ -76,7 +116,11 @@ mp::ParseCode cmd::Networks::parse_args(mp::ArgParser* parser)
         "format", "Output list in the requested format.\nValid formats are: table (default), json, csv and yaml",
         "format", "table");
 
-    parser->addOption(formatOption);
+    QCommandLineOption cachedOption("cached",
+                                    "Use the daemon-published cache when available, skipping the query; may be "
+                                    "slightly stale. Intended for shell completion.");
+
+    parser->addOptions({formatOption, cachedOption});
 
     auto status = parser->commandParse(this);
 
@@ -91,6 +135,8 @@ mp::ParseCode cmd::Networks::parse_args(mp::ArgParser* parser)
         return ParseCode::CommandLineError;
     }
 
+    use_cached = parser->isSet(cachedOption);
+
     status = handle_format_option(parser, &chosen_formatter, cerr);
 
     return status;
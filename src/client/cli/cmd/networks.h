@@ -41,6 +41,7 @@ private:
     ParseCode parse_args(ArgParser* parser) override;
 
     Formatter* chosen_formatter;
+    bool use_cached{false};
 };
 } // namespace cmd
 } // namespace multipass
@@ -0,0 +1,119 @@
+/*
+ * Copyright (C) 2021 Canonical, Ltd.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; version 3.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "ping.h"
+#include "common_cli.h"
+
+#include <multipass/cli/argparser.h>
+#include <multipass/utils.h>
+
+#include <QDateTime>
+#include <QFile>
+
+namespace mp = multipass;
+namespace cmd = multipass::cmd;
+
+namespace
+{
+// the daemon refreshes every five seconds; allow a couple of missed beats before crying wolf
+constexpr auto max_heartbeat_age_secs = 15;
+} // namespace
+
+mp::ReturnCode cmd::Ping::run(mp::ArgParser* parser)
+{
+    auto ret = parse_args(parser);
+    if (ret != ParseCode::Ok)
+    {
+        return parser->returnCodeFrom(ret);
+    }
+
+    if (fast)
+    {
+        // Read the heartbeat the daemon maintains next to its socket; no connection, no
+        // TLS handshake - suitable for health checks that run every few seconds.
+        const auto heartbeat_path = mp::utils::heartbeat_file_path(mp::client::get_server_address());
+        QFile heartbeat_file{heartbeat_path};
+        if (!heartbeat_path.isEmpty() && heartbeat_file.open(QIODevice::ReadOnly))
+        {
+            const auto beat = heartbeat_file.readAll().trimmed().toLongLong();
+            if (beat > 0 && QDateTime::currentSecsSinceEpoch() - beat <= max_heartbeat_age_secs)
+            {
+                cout << "OK\n";
+                return ReturnCode::Ok;
+            }
+
+            cerr << "ping failed: stale daemon heartbeat\n";
+            return ReturnCode::CommandFail;
+        }
+
+        cerr << "ping failed: no daemon heartbeat\n";
+        return ReturnCode::CommandFail;
+    }
+
+    // ping is a unary rpc, so it bypasses the streaming dispatch the other commands use
+    grpc::ClientContext context;
+    mp::PingRequest request;
+    mp::PingReply reply;
+    auto status = stub->ping(&context, request, &reply);
+    if (status.ok())
+    {
+        cout << "OK\n";
+        return ReturnCode::Ok;
+    }
+
+    return standard_failure_handler_for(name(), cerr, status);
+}
+
+std::string cmd::Ping::name() const
+{
+    return "ping";
+}
+
+QString cmd::Ping::short_help() const
+{
+    return QStringLiteral("Check whether the daemon is running");
+}
+
+QString cmd::Ping::description() const
+{
+    return QStringLiteral("Check whether the multipass daemon is running and responsive.\n"
+                          "With --fast, only the daemon's heartbeat file is consulted,\n"
+                          "avoiding a connection altogether; suited to frequent health checks.");
+}
+
+mp::ParseCode cmd::Ping::parse_args(mp::ArgParser* parser)
+{
+    QCommandLineOption fastOption("fast", "Check the daemon's heartbeat file instead of connecting");
+    parser->addOption(fastOption);
+
+    auto status = parser->commandParse(this);
+
+    if (status != ParseCode::Ok)
+    {
+        return status;
+    }
+
+    if (parser->positionalArguments().count() > 0)
+    {
+        cerr << "This command takes no arguments\n";
+        return ParseCode::CommandLineError;
+    }
+
+    fast = parser->isSet(fastOption);
+
+    return status;
+}
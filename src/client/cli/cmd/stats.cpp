@@ -0,0 +1,80 @@
+/*
+ * Copyright (C) 2021 Canonical, Ltd.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; version 3.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "stats.h"
+#include "common_cli.h"
+
+#include <multipass/cli/argparser.h>
+
+namespace mp = multipass;
+namespace cmd = multipass::cmd;
+using RpcMethod = mp::Rpc::Stub;
+
+mp::ReturnCode cmd::Stats::run(mp::ArgParser* parser)
+{
+    auto ret = parse_args(parser);
+    if (ret != ParseCode::Ok)
+    {
+        return parser->returnCodeFrom(ret);
+    }
+
+    auto on_success = [this](mp::StatsReply& reply) {
+        cout << reply.stats_json();
+        return ReturnCode::Ok;
+    };
+
+    auto on_failure = [this](grpc::Status& status) { return standard_failure_handler_for(name(), cerr, status); };
+
+    mp::StatsRequest request;
+    request.set_verbosity_level(parser->verbosityLevel());
+    return dispatch(&RpcMethod::get_stats, request, on_success, on_failure);
+}
+
+std::string cmd::Stats::name() const
+{
+    return "stats";
+}
+
+QString cmd::Stats::short_help() const
+{
+    return QStringLiteral("Dump daemon performance counters");
+}
+
+QString cmd::Stats::description() const
+{
+    return QStringLiteral("Dump the daemon's internal performance counters and latency\n"
+                          "histograms as JSON. The numbers accumulate since the daemon\n"
+                          "started and never leave the machine.");
+}
+
+mp::ParseCode cmd::Stats::parse_args(mp::ArgParser* parser)
+{
+    auto status = parser->commandParse(this);
+
+    if (status != ParseCode::Ok)
+    {
+        return status;
+    }
+
+    if (parser->positionalArguments().count() > 0)
+    {
+        cerr << "This command takes no arguments\n";
+        return ParseCode::CommandLineError;
+    }
+
+    return status;
+}
@@ -24,6 +24,8 @@
 
 #include <QFileInfo>
 
+#include <unordered_map>
+
 namespace mp = multipass;
 namespace cmd = multipass::cmd;
 namespace mcp = multipass::cli::platform;
@@ -37,6 +39,7 @@ const char streaming_symbol{'-'};
 mp::ReturnCode cmd::Transfer::run(mp::ArgParser* parser)
 {
     streaming_enabled = false;
+    recursive_enabled = false;
     auto ret = parse_args(parser);
     if (ret != ParseCode::Ok)
     {
@@ -48,40 +51,44 @@ mp::ReturnCode cmd::Transfer::run(mp::ArgParser* parser)
         if (reply.ssh_info().empty())
             return ReturnCode::Ok;
 
+        // One client per instance for the whole batch, so every file shares a single
+        // ssh+sftp session instead of paying the connection setup per transfer
+        std::unordered_map<std::string, std::unique_ptr<mp::SFTPClient>> sftp_clients;
+
         for (const auto& source : sources)
         {
-            mp::SSHInfo ssh_info;
-            if (!source.first.empty())
-            {
-                ssh_info = reply.ssh_info().find(source.first)->second;
-            }
-            else if (!destination.first.empty())
-            {
-                ssh_info = reply.ssh_info().find(destination.first)->second;
-            }
-
-            auto host = ssh_info.host();
-            auto port = ssh_info.port();
-            auto username = ssh_info.username();
-            auto priv_key_blob = ssh_info.priv_key_base64();
+            const auto& instance_name = !source.first.empty() ? source.first : destination.first;
 
             try
             {
-                mp::SFTPClient sftp_client{host, port, username, priv_key_blob};
+                auto& sftp_client = sftp_clients[instance_name];
+                if (!sftp_client)
+                {
+                    const auto& ssh_info = reply.ssh_info().find(instance_name)->second;
+                    sftp_client = std::make_unique<mp::SFTPClient>(ssh_info.host(), ssh_info.port(),
+                                                                   ssh_info.username(), ssh_info.priv_key_base64());
+                }
 
                 if (streaming_enabled)
                 {
                     if (destination.first.empty())
-                        sftp_client.stream_file(source.second, term->cout());
+                        sftp_client->stream_file(source.second, term->cout());
+                    else
+                        sftp_client->stream_file(destination.second, term->cin());
+                }
+                else if (!destination.first.empty())
+                {
+                    if (recursive_enabled && QFileInfo(QString::fromStdString(source.second)).isDir())
+                        sftp_client->push_dir(source.second, destination.second);
                     else
-                        sftp_client.stream_file(destination.second, term->cin());
+                        sftp_client->push_file(source.second, destination.second);
                 }
                 else
                 {
-                    if (!destination.first.empty())
-                        sftp_client.push_file(source.second, destination.second);
+                    if (recursive_enabled && sftp_client->is_remote_dir(source.second))
+                        sftp_client->pull_dir(source.second, destination.second);
                     else
-                        sftp_client.pull_file(source.second, destination.second);
+                        sftp_client->pull_file(source.second, destination.second);
                 }
             }
             catch (const std::exception& e)
@@ -132,10 +139,15 @@ mp::ParseCode cmd::Transfer::parse_args(mp::ArgParser* parser)
                                   "a path inside the instance, or '-' for stdout",
                                   "<destination>");
 
+    QCommandLineOption recursive_option({"r", "recursive"}, "Recursively copy entire directories");
+    parser->addOption(recursive_option);
+
     auto status = parser->commandParse(this);
     if (status != ParseCode::Ok)
         return status;
 
+    recursive_enabled = parser->isSet(recursive_option);
+
     if (parser->positionalArguments().count() < 2)
     {
         cerr << "Not enough arguments given\n";
@@ -146,6 +158,12 @@ mp::ParseCode cmd::Transfer::parse_args(mp::ArgParser* parser)
     const auto num_streaming_symbols = std::count(std::begin(args), std::end(args), streaming_symbol);
     const bool allow_streaming = (args.count() == 2);
 
+    if (recursive_enabled && num_streaming_symbols)
+    {
+        cerr << fmt::format("Cannot use --recursive with '{}'\n", streaming_symbol);
+        return ParseCode::CommandLineError;
+    }
+
     if (num_streaming_symbols && !allow_streaming)
     {
         cerr << fmt::format("Only two arguments allowed when using '{}'\n", streaming_symbol);
@@ -206,7 +224,15 @@ mp::ParseCode cmd::Transfer::parse_sources(mp::ArgParser* parser)
                 return ParseCode::CommandLineError;
             }
 
-            if (!source.isFile())
+            if (source.isDir())
+            {
+                if (!recursive_enabled)
+                {
+                    cerr << "Source path is a directory, use -r to transfer recursively\n";
+                    return ParseCode::CommandLineError;
+                }
+            }
+            else if (!source.isFile())
             {
                 cerr << "Source path must be a file\n";
                 return ParseCode::CommandLineError;
@@ -43,6 +43,7 @@ private:
     std::vector<std::pair<std::string, std::string>> sources;
     std::pair<std::string, std::string> destination;
     bool streaming_enabled;
+    bool recursive_enabled;
 
     ParseCode parse_args(ArgParser* parser) override;
     ParseCode parse_sources(ArgParser* parser);
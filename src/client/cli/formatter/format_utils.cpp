@@ -23,6 +23,8 @@
 #include <multipass/cli/table_formatter.h>
 #include <multipass/cli/yaml_formatter.h>
 
+#include <unordered_map>
+
 namespace mp = multipass;
 
 namespace
@@ -90,6 +92,37 @@ std::string mp::format::image_string_for(const mp::FindReply_AliasInfo& alias)
     return alias.remote_name().empty() ? alias.alias() : fmt::format("{}:{}", alias.remote_name(), alias);
 }
 
+std::string mp::format::human_readable_size(long long bytes)
+{
+    // The same few sizes repeat across rows (instances share their totals) and across
+    // renderings of cached snapshots, so answers are memoized per thread; the cap just
+    // keeps long-lived processes from accumulating every usage value ever seen
+    static thread_local std::unordered_map<long long, std::string> memo;
+    if (auto it = memo.find(bytes); it != memo.end())
+        return it->second;
+
+    const auto render = [](long long bytes) -> std::string {
+        constexpr auto kilo = 1024LL;
+        constexpr auto mega = kilo * 1024;
+        constexpr auto giga = mega * 1024;
+        constexpr auto tera = giga * 1024;
+
+        if (bytes < kilo)
+            return fmt::format("{}B", bytes);
+
+        // one decimal via integer arithmetic: value in tenths of the unit, rounded
+        const auto unit = bytes < mega ? kilo : bytes < giga ? mega : bytes < tera ? giga : tera;
+        const auto suffix = bytes < mega ? 'K' : bytes < giga ? 'M' : bytes < tera ? 'G' : 'T';
+        const auto tenths = (bytes * 10 + unit / 2) / unit;
+        return fmt::format("{}.{}{}", tenths / 10, tenths % 10, suffix);
+    };
+
+    if (memo.size() > 1024)
+        memo.clear();
+
+    return memo.emplace(bytes, render(bytes)).first->second;
+}
+
 mp::Formatter* mp::format::formatter_for(const std::string& format)
 {
     auto entry = formatters.find(format);
@@ -98,6 +98,20 @@ std::string mp::JsonFormatter::format(const InfoReply& reply) const
             entry.insert("gid_mappings", mount_gids);
             entry.insert("source_path", QString::fromStdString(mount.source_path()));
 
+            if (mount.has_io_stats())
+            {
+                QJsonObject io_stats;
+                io_stats.insert("read_ops", QString::number(mount.io_stats().read_ops()));
+                io_stats.insert("read_bytes", QString::number(mount.io_stats().read_bytes()));
+                io_stats.insert("read_usecs", QString::number(mount.io_stats().read_usecs()));
+                io_stats.insert("write_ops", QString::number(mount.io_stats().write_ops()));
+                io_stats.insert("write_bytes", QString::number(mount.io_stats().write_bytes()));
+                io_stats.insert("write_usecs", QString::number(mount.io_stats().write_usecs()));
+                io_stats.insert("other_ops", QString::number(mount.io_stats().other_ops()));
+                io_stats.insert("other_usecs", QString::number(mount.io_stats().other_usecs()));
+                entry.insert("io_stats", io_stats);
+            }
+
             mounts.insert(QString::fromStdString(mount.target_path()), entry);
         }
         instance_info.insert("mounts", mounts);
@@ -106,7 +120,7 @@ std::string mp::JsonFormatter::format(const InfoReply& reply) const
     }
     info_json.insert("info", info_obj);
 
-    return QString(QJsonDocument(info_json).toJson()).toStdString();
+    return QJsonDocument(info_json).toJson().toStdString(); // toJson is already UTF-8; no QString round-trip
 }
 
 std::string mp::JsonFormatter::format(const ListReply& reply) const
@@ -132,7 +146,7 @@ std::string mp::JsonFormatter::format(const ListReply& reply) const
 
     list_json.insert("list", instances);
 
-    return QString(QJsonDocument(list_json).toJson()).toStdString();
+    return QJsonDocument(list_json).toJson().toStdString();
 }
 
 std::string mp::JsonFormatter::format(const NetworksReply& reply) const
@@ -152,7 +166,7 @@ std::string mp::JsonFormatter::format(const NetworksReply& reply) const
 
     list_json.insert("list", interfaces);
 
-    return QString(QJsonDocument(list_json).toJson()).toStdString();
+    return QJsonDocument(list_json).toJson().toStdString();
 }
 
 std::string mp::JsonFormatter::format(const FindReply& reply) const
@@ -186,5 +200,5 @@ std::string mp::JsonFormatter::format(const FindReply& reply) const
 
     find_json.insert("images", images);
 
-    return QString(QJsonDocument(find_json).toJson()).toStdString();
+    return QJsonDocument(find_json).toJson().toStdString();
 }
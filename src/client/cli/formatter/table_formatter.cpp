@@ -26,27 +26,26 @@ namespace mp = multipass;
 namespace
 {
 
-auto human_readable_size(const std::string& num_in_bytes)
-{
-    auto bytes = std::stoll(num_in_bytes);
-
-    if (bytes < 1024)
-        return fmt::format("{}B", bytes);
-    if (bytes < 1048576)
-        return fmt::format("{:.1f}K", bytes / 1024.);
-    if (bytes < 1073741824)
-        return fmt::format("{:.1f}M", bytes / 1048576.);
-    if (bytes < 1099511627776)
-        return fmt::format("{:.1f}G", bytes / 1073741824.);
-
-    return fmt::format("{:.1f}T", bytes / 1099511627776.);
-}
-
 std::string to_usage(const std::string& usage, const std::string& total)
 {
     if (usage.empty() || total.empty())
         return "--";
-    return fmt::format("{} out of {}", human_readable_size(usage), human_readable_size(total));
+    return fmt::format("{} out of {}", mp::format::human_readable_size(std::stoll(usage)),
+                       mp::format::human_readable_size(std::stoll(total)));
+}
+
+// "1234 ops, 56.7M, avg 0.8ms" for one I/O category of a mount's counters
+std::string to_mount_io(uint64_t ops, uint64_t bytes, uint64_t usecs)
+{
+    if (ops == 0)
+        return "none";
+
+    auto summary = fmt::format("{} ops", ops);
+    if (bytes > 0)
+        summary += fmt::format(", {}", mp::format::human_readable_size(bytes));
+    summary += fmt::format(", avg {:.1f}ms", usecs / 1000. / ops);
+
+    return summary;
 }
 
 // Computes the column width needed to display all the elements of a range [begin, end). get_width is a function
@@ -57,72 +56,85 @@ auto column_width = [](const auto begin, const auto end, const auto get_width, i
     return std::max(get_width(*max_width) + 2, minimum_width);
 };
 
-} // namespace
-std::string mp::TableFormatter::format(const InfoReply& reply) const
+
+void format_info_block(fmt::memory_buffer& buf, const mp::InfoReply::Info& info)
 {
-    fmt::memory_buffer buf;
+    fmt::format_to(buf, "{:<16}{}\n", "Name:", info.name());
+    fmt::format_to(buf, "{:<16}{}\n", "State:", mp::format::status_string_for(info.instance_status()));
 
-    for (const auto& info : format::sorted(reply.info()))
+    int ipv4_size = info.ipv4_size();
+    fmt::format_to(buf, "{:<16}{}\n", "IPv4:", ipv4_size ? info.ipv4(0) : "--");
+
+    for (int i = 1; i < ipv4_size; ++i)
+        fmt::format_to(buf, "{:<16}{}\n", "", info.ipv4(i));
+
+    if (int ipv6_size = info.ipv6_size())
     {
-        fmt::format_to(buf, "{:<16}{}\n", "Name:", info.name());
-        fmt::format_to(buf, "{:<16}{}\n", "State:", mp::format::status_string_for(info.instance_status()));
+        fmt::format_to(buf, "{:<16}{}\n", "IPv6:", info.ipv6(0));
 
-        int ipv4_size = info.ipv4_size();
-        fmt::format_to(buf, "{:<16}{}\n", "IPv4:", ipv4_size ? info.ipv4(0) : "--");
+        for (int i = 1; i < ipv6_size; ++i)
+            fmt::format_to(buf, "{:<16}{}\n", "", info.ipv6(i));
+    }
 
-        for (int i = 1; i < ipv4_size; ++i)
-            fmt::format_to(buf, "{:<16}{}\n", "", info.ipv4(i));
+    fmt::format_to(buf, "{:<16}{}\n", "Release:", info.current_release().empty() ? "--" : info.current_release());
+    fmt::format_to(buf, "{:<16}", "Image hash:");
+    if (info.id().empty())
+        fmt::format_to(buf, "{}\n", "Not Available");
+    else
+        fmt::format_to(buf, "{}{}\n", info.id().substr(0, 12),
+                       !info.image_release().empty() ? fmt::format(" (Ubuntu {})", info.image_release()) : "");
+    fmt::format_to(buf, "{:<16}{}\n", "Load:", info.load().empty() ? "--" : info.load());
+    fmt::format_to(buf, "{:<16}{}\n", "Disk usage:", to_usage(info.disk_usage(), info.disk_total()));
+    fmt::format_to(buf, "{:<16}{}\n", "Memory usage:", to_usage(info.memory_usage(), info.memory_total()));
+
+    auto mount_paths = info.mount_info().mount_paths();
+    for (auto mount = mount_paths.cbegin(); mount != mount_paths.cend(); ++mount)
+    {
+        fmt::format_to(buf, "{:<16}{:{}} => {}\n", (mount == mount_paths.cbegin()) ? "Mounts:" : " ",
+                       mount->source_path(), info.mount_info().longest_path_len(), mount->target_path());
 
-        if (int ipv6_size = info.ipv6_size())
+        for (auto uid_map = mount->mount_maps().uid_map().cbegin(); uid_map != mount->mount_maps().uid_map().cend();
+             ++uid_map)
         {
-            fmt::format_to(buf, "{:<16}{}\n", "IPv6:", info.ipv6(0));
-
-            for (int i = 1; i < ipv6_size; ++i)
-                fmt::format_to(buf, "{:<16}{}\n", "", info.ipv6(i));
+            fmt::format_to(
+                buf, "{:>{}}{}:{}{}{}", (uid_map == mount->mount_maps().uid_map().cbegin()) ? "UID map: " : "",
+                (uid_map == mount->mount_maps().uid_map().cbegin()) ? 29 : 0, std::to_string(uid_map->first),
+                (uid_map->second == mp::default_id) ? "default" : std::to_string(uid_map->second),
+                (std::next(uid_map) != mount->mount_maps().uid_map().cend()) ? ", " : "",
+                (std::next(uid_map) == mount->mount_maps().uid_map().cend()) ? "\n" : "");
         }
-
-        fmt::format_to(buf, "{:<16}{}\n", "Release:", info.current_release().empty() ? "--" : info.current_release());
-        fmt::format_to(buf, "{:<16}", "Image hash:");
-        if (info.id().empty())
-            fmt::format_to(buf, "{}\n", "Not Available");
-        else
-            fmt::format_to(buf, "{}{}\n", info.id().substr(0, 12),
-                           !info.image_release().empty() ? fmt::format(" (Ubuntu {})", info.image_release()) : "");
-        fmt::format_to(buf, "{:<16}{}\n", "Load:", info.load().empty() ? "--" : info.load());
-        fmt::format_to(buf, "{:<16}{}\n", "Disk usage:", to_usage(info.disk_usage(), info.disk_total()));
-        fmt::format_to(buf, "{:<16}{}\n", "Memory usage:", to_usage(info.memory_usage(), info.memory_total()));
-
-        auto mount_paths = info.mount_info().mount_paths();
-        for (auto mount = mount_paths.cbegin(); mount != mount_paths.cend(); ++mount)
+        for (auto gid_map = mount->mount_maps().gid_map().cbegin(); gid_map != mount->mount_maps().gid_map().cend();
+             ++gid_map)
         {
-            fmt::format_to(buf, "{:<16}{:{}} => {}\n", (mount == mount_paths.cbegin()) ? "Mounts:" : " ",
-                           mount->source_path(), info.mount_info().longest_path_len(), mount->target_path());
-
-            for (auto uid_map = mount->mount_maps().uid_map().cbegin(); uid_map != mount->mount_maps().uid_map().cend();
-                 ++uid_map)
-            {
-                fmt::format_to(
-                    buf, "{:>{}}{}:{}{}{}", (uid_map == mount->mount_maps().uid_map().cbegin()) ? "UID map: " : "",
-                    (uid_map == mount->mount_maps().uid_map().cbegin()) ? 29 : 0, std::to_string(uid_map->first),
-                    (uid_map->second == mp::default_id) ? "default" : std::to_string(uid_map->second),
-                    (std::next(uid_map) != mount->mount_maps().uid_map().cend()) ? ", " : "",
-                    (std::next(uid_map) == mount->mount_maps().uid_map().cend()) ? "\n" : "");
-            }
-            for (auto gid_map = mount->mount_maps().gid_map().cbegin(); gid_map != mount->mount_maps().gid_map().cend();
-                 ++gid_map)
-            {
-                fmt::format_to(
-                    buf, "{:>{}}{}:{}{}{}", (gid_map == mount->mount_maps().gid_map().cbegin()) ? "GID map: " : "",
-                    (gid_map == mount->mount_maps().gid_map().cbegin()) ? 29 : 0, std::to_string(gid_map->first),
-                    (gid_map->second == mp::default_id) ? "default" : std::to_string(gid_map->second),
-                    (std::next(gid_map) != mount->mount_maps().gid_map().cend()) ? ", " : "",
-                    (std::next(gid_map) == mount->mount_maps().gid_map().cend()) ? "\n" : "");
-            }
+            fmt::format_to(
+                buf, "{:>{}}{}:{}{}{}", (gid_map == mount->mount_maps().gid_map().cbegin()) ? "GID map: " : "",
+                (gid_map == mount->mount_maps().gid_map().cbegin()) ? 29 : 0, std::to_string(gid_map->first),
+                (gid_map->second == mp::default_id) ? "default" : std::to_string(gid_map->second),
+                (std::next(gid_map) != mount->mount_maps().gid_map().cend()) ? ", " : "",
+                (std::next(gid_map) == mount->mount_maps().gid_map().cend()) ? "\n" : "");
         }
 
-        fmt::format_to(buf, "\n");
+        if (mount->has_io_stats())
+        {
+            const auto& io = mount->io_stats();
+            fmt::format_to(buf, "{:>26}{}\n", "Reads: ", to_mount_io(io.read_ops(), io.read_bytes(), io.read_usecs()));
+            fmt::format_to(buf, "{:>27}{}\n",
+                           "Writes: ", to_mount_io(io.write_ops(), io.write_bytes(), io.write_usecs()));
+            fmt::format_to(buf, "{:>29}{}\n", "Other ops: ", to_mount_io(io.other_ops(), 0, io.other_usecs()));
+        }
     }
 
+    fmt::format_to(buf, "\n");
+}
+
+} // namespace
+std::string mp::TableFormatter::format(const InfoReply& reply) const
+{
+    fmt::memory_buffer buf;
+
+    for (const auto& info : format::sorted(reply.info()))
+        format_info_block(buf, info);
+
     auto output = fmt::to_string(buf);
     if (!reply.info().empty())
         output.pop_back();
@@ -132,6 +144,20 @@ std::string mp::TableFormatter::format(const InfoReply& reply) const
     return output;
 }
 
+std::string mp::TableFormatter::format_partial(const InfoReply& reply, bool /*first*/) const
+{
+    fmt::memory_buffer buf;
+
+    for (const auto& info : format::sorted(reply.info()))
+        format_info_block(buf, info);
+
+    auto output = fmt::to_string(buf);
+    if (!output.empty())
+        output.pop_back(); // callers put the separating blank line between fragments
+
+    return output;
+}
+
 std::string mp::TableFormatter::format(const ListReply& reply) const
 {
     fmt::memory_buffer buf;
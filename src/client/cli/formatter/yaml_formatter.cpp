@@ -28,90 +28,113 @@
 namespace mp = multipass;
 namespace mpu = multipass::utils;
 
-std::string mp::YamlFormatter::format(const InfoReply& reply) const
+namespace
 {
-    YAML::Node info_node;
+YAML::Node instance_node_for(const mp::InfoReply_Info& info)
+{
+    YAML::Node instance_node;
 
-    info_node["errors"].push_back(YAML::Null);
+    instance_node["state"] = mp::format::status_string_for(info.instance_status());
+    instance_node["image_hash"] = info.id();
+    instance_node["image_release"] = info.image_release();
+    if (info.current_release().empty())
+        instance_node["release"] = YAML::Null;
+    else
+        instance_node["release"] = info.current_release();
 
-    for (const auto& info : format::sorted(reply.info()))
+    if (!info.load().empty())
     {
-        YAML::Node instance_node;
+        // The VM returns load info in the default C locale
+        auto current_loc = std::locale();
+        std::locale::global(std::locale("C"));
+        auto loads = mp::utils::split(info.load(), " ");
+        for (const auto& entry : loads)
+            instance_node["load"].push_back(entry);
+        std::locale::global(current_loc);
+    }
 
-        instance_node["state"] = mp::format::status_string_for(info.instance_status());
-        instance_node["image_hash"] = info.id();
-        instance_node["image_release"] = info.image_release();
-        if (info.current_release().empty())
-            instance_node["release"] = YAML::Null;
-        else
-            instance_node["release"] = info.current_release();
+    YAML::Node disk;
+    disk["used"] = YAML::Null;
+    disk["total"] = YAML::Null;
+    if (!info.disk_usage().empty())
+        disk["used"] = info.disk_usage();
+    if (!info.disk_total().empty())
+        disk["total"] = info.disk_total();
+
+    // TODO: disk name should come from daemon
+    YAML::Node disk_node;
+    disk_node["sda1"] = disk;
+    instance_node["disks"].push_back(disk_node);
+
+    YAML::Node memory;
+    memory["usage"] = YAML::Null;
+    memory["total"] = YAML::Null;
+    if (!info.memory_usage().empty())
+        memory["usage"] = std::stoll(info.memory_usage());
+    if (!info.memory_total().empty())
+        memory["total"] = std::stoll(info.memory_total());
+
+    instance_node["memory"] = memory;
+
+    instance_node["ipv4"] = YAML::Node(YAML::NodeType::Sequence);
+    for (const auto& ip : info.ipv4())
+        instance_node["ipv4"].push_back(ip);
+
+    YAML::Node mounts;
+    for (const auto& mount : info.mount_info().mount_paths())
+    {
+        YAML::Node mount_node;
 
-        if (!info.load().empty())
+        for (const auto& uid_map : mount.mount_maps().uid_map())
         {
-            // The VM returns load info in the default C locale
-            auto current_loc = std::locale();
-            std::locale::global(std::locale("C"));
-            auto loads = mp::utils::split(info.load(), " ");
-            for (const auto& entry : loads)
-                instance_node["load"].push_back(entry);
-            std::locale::global(current_loc);
+            mount_node["uid_mappings"].push_back(
+                fmt::format("{}:{}", std::to_string(uid_map.first),
+                            (uid_map.second == mp::default_id) ? "default" : std::to_string(uid_map.second)));
         }
-
-        YAML::Node disk;
-        disk["used"] = YAML::Null;
-        disk["total"] = YAML::Null;
-        if (!info.disk_usage().empty())
-            disk["used"] = info.disk_usage();
-        if (!info.disk_total().empty())
-            disk["total"] = info.disk_total();
-
-        // TODO: disk name should come from daemon
-        YAML::Node disk_node;
-        disk_node["sda1"] = disk;
-        instance_node["disks"].push_back(disk_node);
-
-        YAML::Node memory;
-        memory["usage"] = YAML::Null;
-        memory["total"] = YAML::Null;
-        if (!info.memory_usage().empty())
-            memory["usage"] = std::stoll(info.memory_usage());
-        if (!info.memory_total().empty())
-            memory["total"] = std::stoll(info.memory_total());
-
-        instance_node["memory"] = memory;
-
-        instance_node["ipv4"] = YAML::Node(YAML::NodeType::Sequence);
-        for (const auto& ip : info.ipv4())
-            instance_node["ipv4"].push_back(ip);
-
-        YAML::Node mounts;
-        for (const auto& mount : info.mount_info().mount_paths())
+        for (const auto& gid_map : mount.mount_maps().gid_map())
         {
-            YAML::Node mount_node;
-
-            for (const auto& uid_map : mount.mount_maps().uid_map())
-            {
-                mount_node["uid_mappings"].push_back(
-                    fmt::format("{}:{}", std::to_string(uid_map.first),
-                                (uid_map.second == mp::default_id) ? "default" : std::to_string(uid_map.second)));
-            }
-            for (const auto& gid_map : mount.mount_maps().gid_map())
-            {
-                mount_node["gid_mappings"].push_back(
-                    fmt::format("{}:{}", std::to_string(gid_map.first),
-                                (gid_map.second == mp::default_id) ? "default" : std::to_string(gid_map.second)));
-            }
-
-            mount_node["source_path"] = mount.source_path();
-            mounts[mount.target_path()] = mount_node;
+            mount_node["gid_mappings"].push_back(
+                fmt::format("{}:{}", std::to_string(gid_map.first),
+                            (gid_map.second == mp::default_id) ? "default" : std::to_string(gid_map.second)));
         }
-        instance_node["mounts"] = mounts;
 
-        info_node[info.name()].push_back(instance_node);
+        mount_node["source_path"] = mount.source_path();
+        mounts[mount.target_path()] = mount_node;
     }
+    instance_node["mounts"] = mounts;
+
+    return instance_node;
+}
+} // namespace
+
+std::string mp::YamlFormatter::format(const InfoReply& reply) const
+{
+    YAML::Node info_node;
+
+    info_node["errors"].push_back(YAML::Null);
+
+    for (const auto& info : format::sorted(reply.info()))
+        info_node[info.name()].push_back(instance_node_for(info));
+
     return mpu::emit_yaml(info_node);
 }
 
+std::string mp::YamlFormatter::format_partial(const InfoReply& reply, bool first) const
+{
+    // Each fragment is a handful of top-level map entries, so the whole document is never
+    // held as one node tree and the first instances print as soon as they arrive. The
+    // blank lines the caller puts between fragments are insignificant in YAML.
+    YAML::Node fragment_node;
+
+    if (first)
+        fragment_node["errors"].push_back(YAML::Null);
+
+    for (const auto& info : format::sorted(reply.info()))
+        fragment_node[info.name()].push_back(instance_node_for(info));
+
+    return mpu::emit_yaml(fragment_node);
+}
+
 std::string mp::YamlFormatter::format(const ListReply& reply) const
 {
     YAML::Node list;
@@ -24,6 +24,8 @@
 
 #include <QCoreApplication>
 
+#include <iostream>
+
 namespace mp = multipass;
 
 namespace
@@ -33,6 +35,12 @@ int main_impl(int argc, char* argv[])
     QCoreApplication app(argc, argv);
     QCoreApplication::setApplicationName(mp::client_name);
 
+    // Let the C++ streams use their own (larger) buffers instead of writing through
+    // stdio; piped structured output then goes out in a few big writes. Prompts stay
+    // safe: cin's tie to cout still flushes before any read, and interactive paths
+    // flush explicitly.
+    std::ios_base::sync_with_stdio(false);
+
     mp::Console::setup_environment();
     auto term = mp::Terminal::make_terminal();
 
@@ -25,6 +25,10 @@
 #include <multipass/logging/log.h>
 #include <multipass/logging/standard_logger.h>
 
+#include <grpc/grpc_security.h>
+
+#include <QFile>
+
 namespace mp = multipass;
 namespace mpl = multipass::logging;
 
@@ -34,6 +38,22 @@ mp::ReturnCode return_code_for(const grpc::StatusCode& code)
 {
     return code == grpc::StatusCode::UNAVAILABLE ? mp::ReturnCode::DaemonFail : mp::ReturnCode::CommandFail;
 }
+
+// The daemon publishes an authenticated-plaintext sibling of its unix socket; when it
+// is there, a local client can use it and skip the TLS handshake. Whether it exists on
+// the filesystem also tells an old daemon apart from a new one, with no probe RPC.
+std::string local_peer_address_for(const std::string& server_address)
+{
+    constexpr auto unix_scheme = "unix:";
+    if (server_address.rfind(unix_scheme, 0) != 0)
+        return {};
+
+    auto peer_address = server_address + ".peer";
+    if (!QFile::exists(QString::fromStdString(peer_address.substr(std::string{unix_scheme}.size()))))
+        return {};
+
+    return peer_address;
+}
 } // namespace
 
 mp::ReturnCode mp::cmd::standard_failure_handler_for(const std::string& command, std::ostream& cerr,
@@ -56,9 +76,21 @@ std::shared_ptr<grpc::Channel> mp::client::make_channel(const std::string& serve
                                                         mp::RpcConnectionType conn_type,
                                                         mp::CertProvider& cert_provider)
 {
+    grpc::ChannelArguments channel_args;
+    // Retry connects against a (re)starting daemon from 100ms rather than gRPC's default second
+    channel_args.SetInt(GRPC_ARG_INITIAL_RECONNECT_BACKOFF_MS, 100);
+
     std::shared_ptr<grpc::ChannelCredentials> creds;
     if (conn_type == mp::RpcConnectionType::ssl)
     {
+        // Same-host clients skip TLS entirely: on the daemon's plaintext sibling socket
+        // the kernel's permission check is what authenticates the peer - just as on the
+        // TLS socket, where neither side verifies the other's certificate - and there is
+        // no handshake left to pay. The TLS path remains for everything else.
+        const auto peer_address = local_peer_address_for(server_address);
+        if (!peer_address.empty())
+            return grpc::CreateCustomChannel(peer_address, grpc::experimental::LocalCredentials(UDS), channel_args);
+
         auto opts = grpc::SslCredentialsOptions();
         opts.server_certificate_request = GRPC_SSL_REQUEST_SERVER_CERTIFICATE_BUT_DONT_VERIFY;
         opts.pem_cert_chain = cert_provider.PEM_certificate();
@@ -73,7 +105,24 @@ std::shared_ptr<grpc::Channel> mp::client::make_channel(const std::string& serve
     {
         throw std::runtime_error("Unknown connection type");
     }
-    return grpc::CreateChannel(server_address, creds);
+
+    if (conn_type == mp::RpcConnectionType::ssl)
+    {
+        // One process-wide TLS session cache, so subsequent channels and reconnects resume
+        // the daemon session instead of paying a full handshake. gRPC keeps the tickets to
+        // itself, so the cache cannot be persisted across CLI invocations.
+        static auto* session_cache = grpc_ssl_session_cache_create_lru(16);
+        const auto cache_arg = grpc_ssl_session_cache_create_channel_arg(session_cache);
+        channel_args.SetPointerWithVtable(GRPC_SSL_SESSION_CACHE_ARG, cache_arg.value.pointer.p,
+                                          cache_arg.value.pointer.vtable);
+    }
+
+    // Remote daemons deflate their large replies (the channel advertises acceptance by
+    // default); compress our own messages to match. The local peer channel above skips
+    // this - no network to save.
+    channel_args.SetCompressionAlgorithm(GRPC_COMPRESS_DEFLATE);
+
+    return grpc::CreateCustomChannel(server_address, creds, channel_args);
 }
 
 std::string mp::client::get_server_address()
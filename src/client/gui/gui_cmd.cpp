@@ -167,74 +167,99 @@ void cmd::GuiCmd::create_actions()
     });
 }
 
-void cmd::GuiCmd::update_menu()
+void cmd::GuiCmd::start_watch_stream()
 {
-    std::vector<std::string> instances_to_remove;
-
-    auto reply = list_future.result();
-
-    handle_petenv_instance(reply.instances());
-
-    for (auto it = instances_entries.cbegin(); it != instances_entries.cend(); ++it)
+    if (failure_action.isVisible())
     {
-        auto instance = std::find_if(reply.instances().cbegin(), reply.instances().cend(),
-                                     [it](const ListVMInstance& instance) { return it->first == instance.name(); });
-
-        if (instance == reply.instances().cend())
-        {
-            instances_to_remove.push_back(it->first);
-        }
+        tray_icon_menu.removeAction(&failure_action);
     }
 
-    for (const auto& instance : instances_to_remove)
-    {
-        instances_entries.erase(instance);
-    }
+    watch_context = std::make_unique<grpc::ClientContext>();
+    watch_future = QtConcurrent::run(this, &GuiCmd::watch_instances);
+    future_synchronizer.addFuture(watch_future);
+}
 
-    for (const auto& instance : reply.instances())
-    {
-        auto name = instance.name();
-        auto state = instance.instance_status();
+// Runs on its own thread, parked in the stream: the daemon dumps every instance's
+// state when the stream opens and pushes a delta on each transition, so an idle tray
+// costs it nothing — no list polling on this side, no rendering on that one
+void cmd::GuiCmd::watch_instances()
+{
+    WatchRequest request;
+    WatchReply reply;
 
-        auto it = instances_entries.find(name);
+    auto reader = stub->watch(watch_context.get(), request);
+    while (reader->Read(&reply))
+        emit watch_event(QString::fromStdString(reply.name()), static_cast<int>(reply.instance_status().status()));
 
-        if (it != instances_entries.end())
-        {
-            auto instance_state = it->second.state;
-            if (name == current_petenv_name || state.status() == InstanceStatus::DELETED)
-            {
-                instances_entries.erase(name);
-            }
-            else if (instance_state.status() != state.status())
-            {
-                auto& instance_menu = instances_entries.at(name).menu;
-
-                instance_menu->setTitle(set_title_string_for(name, state));
-                set_input_state_for(instance_menu->actions(), state);
-                instances_entries[name].state = state;
-            }
-
-            continue;
-        }
+    reader->Finish();
+    emit watch_stream_ended();
+}
 
-        if (name == current_petenv_name)
-            continue;
+// Differential update on the GUI thread: only the entry named in the event is touched,
+// so a state change re-renders one menu instead of rebuilding them all
+void cmd::GuiCmd::apply_watch_event(const QString& event_name, int status)
+{
+    const auto name = event_name.toStdString();
+    InstanceStatus state;
+    state.set_status(static_cast<InstanceStatus::Status>(status));
 
-        if (state.status() != InstanceStatus::DELETED)
+    const auto petenv_name = MP_SETTINGS.get(petenv_key).toStdString();
+    if (name == petenv_name)
+    {
+        if (petenv_state.status() != state.status() || petenv_name != current_petenv_name)
         {
-            create_menu_actions_for(name, state);
-            instances_entries[name].state = state;
+            petenv_start_action.setText(set_title_string_for(fmt::format("Start \"{}\"", petenv_name), state));
+
+            set_input_state_for({&petenv_start_action, &petenv_shell_action, &petenv_stop_action}, state);
+            petenv_state = state;
+            current_petenv_name = petenv_name;
         }
     }
-
-    if (instances_entries.empty())
+    else if (auto it = instances_entries.find(name); it != instances_entries.end())
     {
-        about_separator->setVisible(false);
+        if (state.status() == InstanceStatus::DELETED)
+        {
+            instances_entries.erase(it);
+        }
+        else if (it->second.state.status() != state.status())
+        {
+            auto& instance_menu = it->second.menu;
+
+            instance_menu->setTitle(set_title_string_for(name, state));
+            set_input_state_for(instance_menu->actions(), state);
+            it->second.state = state;
+        }
     }
-    else
+    else if (state.status() != InstanceStatus::DELETED)
     {
-        about_separator->setVisible(true);
+        create_menu_actions_for(name, state);
+        instances_entries[name].state = state;
     }
+
+    about_separator->setVisible(!instances_entries.empty());
+}
+
+void cmd::GuiCmd::handle_watch_stream_end()
+{
+    // The daemon went away; show the failure marker, drop the now-unverifiable entries
+    // and retry — the reconnected stream's initial dump rebuilds the menu from scratch
+    tray_icon_menu.insertAction(about_separator, &failure_action);
+    instances_entries.clear();
+    about_separator->setVisible(false);
+    reset_petenv_actions();
+
+    QTimer::singleShot(5s, this, [this] { start_watch_stream(); });
+}
+
+void cmd::GuiCmd::reset_petenv_actions()
+{
+    petenv_start_action.setText("Start");
+    petenv_start_action.setEnabled(false);
+    petenv_shell_action.setEnabled(true);
+    petenv_stop_action.setEnabled(false);
+
+    current_petenv_name = MP_SETTINGS.get(petenv_key).toStdString();
+    petenv_state = InstanceStatus{};
 }
 
 void cmd::GuiCmd::update_about_menu()
@@ -270,12 +295,13 @@ void cmd::GuiCmd::create_menu()
 
     tray_icon.setIcon(QIcon{":images/multipass-icon.png"});
 
-    QObject::connect(&list_watcher, &QFutureWatcher<ListReply>::finished, this, &GuiCmd::update_menu);
-
-    QObject::connect(&menu_update_timer, &QTimer::timeout, this, [this] { initiate_menu_layout(); });
+    QObject::connect(this, &GuiCmd::watch_event, this, &GuiCmd::apply_watch_event);
+    QObject::connect(this, &GuiCmd::watch_stream_ended, this, &GuiCmd::handle_watch_stream_end);
 
     // Use a singleShot here to make sure the event loop is running before the quit() runs
     QObject::connect(quit_action, &QAction::triggered, [this] {
+        if (watch_context) // unblock the watch reader so the synchronizer can finish
+            watch_context->TryCancel();
         future_synchronizer.waitForFinished();
         QTimer::singleShot(0, [] { QCoreApplication::quit(); });
     });
@@ -301,28 +327,13 @@ void cmd::GuiCmd::create_menu()
 
     tray_icon_menu.insertMenu(quit_action, &about_menu);
 
-    initiate_menu_layout();
+    reset_petenv_actions();
+    start_watch_stream();
     initiate_about_menu_layout();
 
-    menu_update_timer.start(1s);
     about_update_timer.start(24h);
 }
 
-void cmd::GuiCmd::initiate_menu_layout()
-{
-    if (failure_action.isVisible())
-    {
-        tray_icon_menu.removeAction(&failure_action);
-    }
-
-    if (!list_future.isRunning())
-    {
-        list_future = QtConcurrent::run(this, &GuiCmd::retrieve_all_instances);
-        future_synchronizer.addFuture(list_future);
-        list_watcher.setFuture(list_future);
-    }
-}
-
 void cmd::GuiCmd::initiate_about_menu_layout()
 {
     if (!version_future.isRunning())
@@ -333,28 +344,6 @@ void cmd::GuiCmd::initiate_about_menu_layout()
     }
 }
 
-mp::ListReply cmd::GuiCmd::retrieve_all_instances()
-{
-    ListReply list_reply;
-    auto on_success = [&list_reply](ListReply& reply) {
-        list_reply = reply;
-
-        return ReturnCode::Ok;
-    };
-
-    auto on_failure = [this](grpc::Status& status) {
-        tray_icon_menu.insertAction(about_separator, &failure_action);
-
-        return standard_failure_handler_for(name(), cerr, status);
-    };
-
-    ListRequest request;
-    request.set_request_ipv4(false);
-    dispatch(&RpcMethod::list, request, on_success, on_failure);
-
-    return list_reply;
-}
-
 void cmd::GuiCmd::create_menu_actions_for(const std::string& instance_name, const mp::InstanceStatus& state)
 {
     auto& instance_menu = instances_entries[instance_name].menu =
@@ -380,41 +369,6 @@ void cmd::GuiCmd::create_menu_actions_for(const std::string& instance_name, cons
     tray_icon_menu.insertMenu(about_separator, instance_menu.get());
 }
 
-void cmd::GuiCmd::handle_petenv_instance(const google::protobuf::RepeatedPtrField<mp::ListVMInstance>& instances)
-{
-    auto petenv_name = MP_SETTINGS.get(petenv_key).toStdString();
-    auto petenv_instance =
-        std::find_if(instances.cbegin(), instances.cend(),
-                     [&petenv_name](const ListVMInstance& instance) { return petenv_name == instance.name(); });
-
-    // petenv doesn't exist yet
-    if (petenv_instance == instances.cend())
-    {
-        if (current_petenv_name != petenv_name)
-        {
-            petenv_start_action.setText("Start");
-            petenv_start_action.setEnabled(false);
-            petenv_shell_action.setEnabled(true);
-            petenv_stop_action.setEnabled(false);
-
-            current_petenv_name = petenv_name;
-        }
-
-        return;
-    }
-
-    auto state = petenv_instance->instance_status();
-
-    if (petenv_state.status() != state.status() || petenv_name != current_petenv_name)
-    {
-        petenv_start_action.setText(set_title_string_for(fmt::format("Start \"{}\"", petenv_name), state));
-
-        set_input_state_for({&petenv_start_action, &petenv_shell_action, &petenv_stop_action}, state);
-        petenv_state = state;
-        current_petenv_name = petenv_name;
-    }
-}
-
 void cmd::GuiCmd::start_instance_for(const std::string& instance_name)
 {
     auto on_success = [](mp::StartReply& reply) { return ReturnCode::Ok; };
@@ -62,6 +62,11 @@ public:
         return "";
     };
 
+signals:
+    // emitted from the watch stream's reader thread; queued over to the GUI thread
+    void watch_event(QString name, int status);
+    void watch_stream_ended();
+
 private:
     ParseCode parse_args(ArgParser* parser) override
     {
@@ -70,13 +75,14 @@ private:
 
     void create_actions();
     void create_menu();
-    void update_menu();
     void update_about_menu();
-    void initiate_menu_layout();
     void initiate_about_menu_layout();
-    ListReply retrieve_all_instances();
+    void start_watch_stream();
+    void watch_instances();
+    void apply_watch_event(const QString& name, int status);
+    void handle_watch_stream_end();
+    void reset_petenv_actions();
     void create_menu_actions_for(const std::string& instance_name, const InstanceStatus& state);
-    void handle_petenv_instance(const google::protobuf::RepeatedPtrField<ListVMInstance>&);
     void start_instance_for(const std::string& instance_name);
     void stop_instance_for(const std::string& instance_name);
     void suspend_instance_for(const std::string& instance_name);
@@ -111,8 +117,10 @@ private:
     };
     std::unordered_map<std::string, InstanceEntry> instances_entries;
 
-    QFuture<ListReply> list_future;
-    QFutureWatcher<ListReply> list_watcher;
+    // The daemon pushes instance state over the watch stream; the reader thread blocks
+    // in the stream and the context lets the quit path cancel it out of that read
+    std::unique_ptr<grpc::ClientContext> watch_context;
+    QFuture<void> watch_future;
 
     QFuture<VersionReply> version_future;
     QFutureWatcher<VersionReply> version_watcher;
@@ -121,7 +129,6 @@ private:
 
     QFileSystemWatcher config_watcher;
 
-    QTimer menu_update_timer;
     QTimer about_update_timer;
 
     QHotkey hotkey;
@@ -63,9 +63,13 @@ mp::DaemonConfigBuilder mp::cli::parse(const QCoreApplication& app)
                                       " a socket can be specified using unix:<socket_file>",
                                       "server_name:port"};
 
+    QCommandLineOption startup_timing_option{"startup-timing",
+                                             "log a structured breakdown of the daemon's startup phases once ready"};
+
     parser.addOption(logger_option);
     parser.addOption(verbosity_option);
     parser.addOption(address_option);
+    parser.addOption(startup_timing_option);
 
     parser.process(app);
 
@@ -85,6 +89,8 @@ mp::DaemonConfigBuilder mp::cli::parse(const QCoreApplication& app)
             throw std::runtime_error(fmt::format("invalid logger option '{}'", logger));
     }
 
+    builder.startup_timing = parser.isSet(startup_timing_option);
+
     if (parser.isSet(address_option))
     {
         auto address = parser.value(address_option).toStdString();
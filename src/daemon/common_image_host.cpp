@@ -41,7 +41,7 @@ mp::CommonVMImageHost::CommonVMImageHost(std::chrono::seconds manifest_time_to_l
     QObject::connect(&manifest_single_shot, &QTimer::timeout, [this]() {
         try
         {
-            update_manifests();
+            refresh_manifests();
         }
         catch (const std::exception& e)
         {
@@ -72,15 +72,43 @@ void mp::CommonVMImageHost::update_manifests()
     const auto now = std::chrono::steady_clock::now();
     if ((now - last_update) > manifest_time_to_live || need_extra_update)
     {
-        need_extra_update = false;
-
-        clear();
-        fetch_manifests();
+        // When we already have manifests, serve them as they are and refresh from the event
+        // loop right after the current request, so interactive paths only wait on manifest
+        // downloads while the cache is cold.
+        if (last_update != std::chrono::steady_clock::time_point{} && !manifest_single_shot.isActive())
+        {
+            manifest_single_shot.start(0);
+            return;
+        }
 
-        last_update = now;
+        refresh_manifests();
     }
 }
 
+void mp::CommonVMImageHost::refresh_manifests()
+{
+    need_extra_update = false;
+
+    resolution_cache.clear(); // resolutions memoized against the old manifests
+    clear();
+    fetch_manifests();
+
+    last_update = std::chrono::steady_clock::now();
+}
+
+const mp::VMImageInfo* mp::CommonVMImageHost::cached_resolution(const std::string& remote_name, const std::string& key,
+                                                                bool allow_unsupported) const
+{
+    const auto it = resolution_cache.find(fmt::format("{}\n{}\n{}", remote_name, key, allow_unsupported));
+    return it == resolution_cache.end() ? nullptr : &it->second;
+}
+
+void mp::CommonVMImageHost::cache_resolution(const std::string& remote_name, const std::string& key,
+                                             bool allow_unsupported, const VMImageInfo& info)
+{
+    resolution_cache.emplace(fmt::format("{}\n{}\n{}", remote_name, key, allow_unsupported), info);
+}
+
 void mp::CommonVMImageHost::on_manifest_empty(const std::string& details)
 {
     mpl::log(mpl::Level::info, category, details);
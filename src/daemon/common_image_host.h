@@ -24,6 +24,8 @@
 #include <QTimer>
 
 #include <chrono>
+#include <string>
+#include <unordered_map>
 
 namespace multipass
 {
@@ -37,12 +39,21 @@ public:
 
 protected:
     void update_manifests();
+    void refresh_manifests();
     void on_manifest_update_failure(const std::string& details);
     void on_manifest_empty(const std::string& details);
     void check_remote_is_supported(const std::string& remote_name) const;
     void check_alias_is_supported(const std::string& alias, const std::string& remote_name) const;
     bool check_all_aliases_are_supported(const QStringList& aliases, const std::string& remote_name) const;
 
+    // Memo of resolved queries, valid for the current manifests only: refresh_manifests
+    // drops it, so back-to-back find/launch of the same release skip the repeat manifest
+    // walk. Call update_manifests() before consulting it.
+    const VMImageInfo* cached_resolution(const std::string& remote_name, const std::string& key,
+                                         bool allow_unsupported) const;
+    void cache_resolution(const std::string& remote_name, const std::string& key, bool allow_unsupported,
+                          const VMImageInfo& info);
+
     virtual void for_each_entry_do_impl(const Action& action) = 0;
     virtual VMImageInfo info_for_full_hash_impl(const std::string& full_hash) = 0;
     virtual void clear() = 0;
@@ -53,6 +64,7 @@ private:
     std::chrono::steady_clock::time_point last_update;
     bool need_extra_update = true;
     QTimer manifest_single_shot;
+    std::unordered_map<std::string, VMImageInfo> resolution_cache;
 };
 
 }
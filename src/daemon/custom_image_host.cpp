@@ -26,9 +26,11 @@
 
 #include <multipass/format.h>
 
+#include <QCryptographicHash>
 #include <QMap>
 #include <QUrl>
 
+#include <future>
 #include <utility>
 
 namespace mp = multipass;
@@ -133,11 +135,25 @@ auto map_aliases_to_vm_info_for(const std::vector<mp::VMImageInfo>& images)
     return map;
 }
 
-auto full_image_info_for(const QMap<QString, CustomImageInfo>& custom_image_info, mp::URLDownloader* url_downloader,
-                         const QString& path_prefix)
+// A built manifest along with a digest of the metadata it was built from; when the digest
+// matches the previous refresh, the manifest pointer is null and the caller reuses the old one
+struct FetchedManifest
 {
-    std::vector<mp::VMImageInfo> default_images;
+    std::unique_ptr<mp::CustomManifest> manifest;
+    QByteArray checksum;
+};
 
+FetchedManifest full_image_info_for(const QMap<QString, CustomImageInfo>& custom_image_info,
+                                    mp::URLDownloader* url_downloader, const QString& path_prefix,
+                                    const QByteArray& previous_checksum)
+{
+    std::vector<std::pair<QString, BaseImageInfo>> base_image_infos;
+    QCryptographicHash digest{QCryptographicHash::Sha256};
+
+    // Each image's last-modified probe and checksum file come over the network; fetch
+    // them all concurrently and join in map order, so one slow mirror no longer
+    // serializes the whole refresh
+    std::vector<std::pair<QString, std::future<BaseImageInfo>>> pending_infos;
     for (const auto& image_info : custom_image_info.toStdMap())
     {
         auto image_file = image_info.first;
@@ -146,7 +162,37 @@ auto full_image_info_for(const QMap<QString, CustomImageInfo>& custom_image_info
         QString image_url{prefix + image_info.first};
         QString hash_url{prefix + QStringLiteral("SHA256SUMS")};
 
-        auto base_image_info = base_image_info_for(url_downloader, image_url, hash_url, image_file);
+        pending_infos.emplace_back(
+            image_file, std::async(std::launch::async, [url_downloader, image_url, hash_url, image_file] {
+                return base_image_info_for(url_downloader, image_url, hash_url, image_file);
+            }));
+    }
+
+    for (auto& pending : pending_infos)
+    {
+        auto base_image_info = pending.second.get();
+        digest.addData(pending.first.toUtf8());
+        digest.addData(base_image_info.last_modified.toUtf8());
+        digest.addData(base_image_info.hash.toUtf8());
+        base_image_infos.emplace_back(pending.first, std::move(base_image_info));
+    }
+
+    // The downloads above are what detects changes; when nothing did change, skip
+    // rebuilding the image info structures so the previous manifest stays in place.
+    auto checksum = digest.result();
+    if (checksum == previous_checksum)
+        return {nullptr, std::move(checksum)};
+
+    std::vector<mp::VMImageInfo> default_images;
+
+    auto base_image_info_it = base_image_infos.cbegin();
+    for (const auto& image_info : custom_image_info.toStdMap())
+    {
+        auto prefix =
+            path_prefix.isEmpty() ? image_info.second.url_prefix : QUrl::fromLocalFile(path_prefix).toString();
+        QString image_url{prefix + image_info.first};
+
+        const auto& base_image_info = (base_image_info_it++)->second;
         mp::VMImageInfo full_image_info{image_info.second.aliases,
                                         image_info.second.os,
                                         image_info.second.release,
@@ -166,7 +212,8 @@ auto full_image_info_for(const QMap<QString, CustomImageInfo>& custom_image_info
 
     auto map = map_aliases_to_vm_info_for(default_images);
 
-    return std::unique_ptr<mp::CustomManifest>(new mp::CustomManifest{std::move(default_images), std::move(map)});
+    return {std::unique_ptr<mp::CustomManifest>(new mp::CustomManifest{std::move(default_images), std::move(map)}),
+            std::move(checksum)};
 }
 
 } // namespace
@@ -192,11 +239,15 @@ mp::optional<mp::VMImageInfo> mp::CustomVMImageHost::info_for(const Query& query
 
     auto custom_manifest = manifest_from(query.remote_name);
 
+    if (const auto* cached = cached_resolution(query.remote_name, query.release, query.allow_unsupported))
+        return *cached;
+
     auto it = custom_manifest->image_records.find(query.release);
 
     if (it == custom_manifest->image_records.end())
         return nullopt;
 
+    cache_resolution(query.remote_name, query.release, query.allow_unsupported, *it->second);
     return *it->second;
 }
 
@@ -250,28 +301,61 @@ std::vector<std::string> mp::CustomVMImageHost::supported_remotes()
 
 void mp::CustomVMImageHost::fetch_manifests()
 {
+    // Fetch the manifests of all remotes concurrently and join below; each download uses its
+    // own network manager, so the fetches are independent of one another.
+    std::vector<std::pair<std::string, std::future<FetchedManifest>>> fetches;
+
     for (const auto& spec :
          {std::make_pair(no_remote, multipass_image_info), std::make_pair(snapcraft_remote, snapcraft_image_info)})
     {
         try
         {
             check_remote_is_supported(spec.first);
+        }
+        catch (const mp::UnsupportedRemoteException&)
+        {
+            continue;
+        }
+
+        // only hand over the previous digest when there is a retired manifest to reuse
+        const auto previous_checksum =
+            retired_image_info.count(spec.first) ? manifest_checksums[spec.first] : QByteArray{};
+        fetches.emplace_back(spec.first, std::async(std::launch::async,
+                                                    [this, image_info = spec.second, checksum = previous_checksum] {
+                                                        return full_image_info_for(image_info, url_downloader,
+                                                                                   path_prefix, checksum);
+                                                    }));
+    }
 
-            custom_image_info.emplace(spec.first, full_image_info_for(spec.second, url_downloader, path_prefix));
+    for (auto& fetch : fetches)
+    {
+        try
+        {
+            auto fetched = fetch.second.get();
+            if (fetched.manifest == nullptr) // metadata unchanged, keep the previous manifest
+            {
+                custom_image_info.emplace(fetch.first, std::move(retired_image_info.at(fetch.first)));
+            }
+            else
+            {
+                manifest_checksums[fetch.first] = fetched.checksum;
+                custom_image_info.emplace(fetch.first, std::move(fetched.manifest));
+            }
+
+            retired_image_info.erase(fetch.first);
         }
         catch (mp::DownloadException& e)
         {
             on_manifest_update_failure(e.what());
         }
-        catch (const mp::UnsupportedRemoteException&)
-        {
-            continue;
-        }
     }
 }
 
 void mp::CustomVMImageHost::clear()
 {
+    for (auto& manifest : custom_image_info)
+        retired_image_info[manifest.first] = std::move(manifest.second);
+
     custom_image_info.clear();
 }
 
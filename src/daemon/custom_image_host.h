@@ -20,6 +20,7 @@
 
 #include "common_image_host.h"
 
+#include <QByteArray>
 #include <QString>
 
 #include <memory>
@@ -62,6 +63,9 @@ private:
     URLDownloader* const url_downloader;
     const QString path_prefix;
     std::unordered_map<std::string, std::unique_ptr<CustomManifest>> custom_image_info;
+    // Manifests kept across refreshes, reused whenever a remote's metadata is unchanged
+    std::unordered_map<std::string, std::unique_ptr<CustomManifest>> retired_image_info;
+    std::unordered_map<std::string, QByteArray> manifest_checksums;
     std::vector<std::string> remotes;
 };
 } // namespace multipass
@@ -19,6 +19,8 @@
 #include "base_cloud_init_config.h"
 #include "json_writer.h"
 
+#include <multipass/cli/format_utils.h>
+#include <multipass/cli/formatter.h>
 #include <multipass/cloud_init_iso.h>
 #include <multipass/constants.h>
 #include <multipass/exceptions/create_image_exception.h>
@@ -35,6 +37,9 @@
 #include <multipass/platform.h>
 #include <multipass/query.h>
 #include <multipass/ssh/ssh_session.h>
+#include <multipass/stats_registry.h>
+#include <multipass/tracing.h>
+#include <multipass/url_downloader.h>
 #include <multipass/utils.h>
 #include <multipass/version.h>
 #include <multipass/virtual_machine.h>
@@ -47,22 +52,35 @@
 #include <multipass/format.h>
 #include <yaml-cpp/yaml.h>
 
+#include <google/protobuf/arena.h>
+
+#include <QDateTime>
 #include <QDir>
 #include <QEventLoop>
+#include <QFile>
 #include <QFutureSynchronizer>
 #include <QJsonArray>
 #include <QJsonDocument>
 #include <QJsonObject>
 #include <QJsonParseError>
 #include <QRegularExpression>
+#include <QSaveFile>
 #include <QString>
 #include <QSysInfo>
+#include <QThread>
+#include <QTimeZone>
 #include <QtConcurrent/QtConcurrent>
 
 #include <algorithm>
 #include <cassert>
+#include <condition_variable>
+#include <cstring>
 #include <functional>
+#include <future>
+#include <limits>
+#include <mutex>
 #include <stdexcept>
+#include <unordered_map>
 #include <utility>
 #include <vector>
 
@@ -79,14 +97,36 @@ using error_string = std::string;
 
 constexpr auto category = "daemon";
 constexpr auto instance_db_name = "multipassd-vm-instances.json";
+constexpr auto warm_instances_db_name = "multipassd-warm-instances.json";
+constexpr auto instance_journal_name = "multipassd-instance-state.journal";
+constexpr auto instance_mirror_name = "multipassd-instance-state.mirror";
+constexpr auto instance_metadata_dir_name = "instance-metadata";
+constexpr auto persist_debounce_window_ms = 250;
+constexpr auto memory_reclaim_check_interval = std::chrono::minutes(5);
+constexpr auto memory_reclaim_idle_threshold = std::chrono::minutes(30);
+constexpr auto heartbeat_interval = std::chrono::seconds(5); // clients consider twice this "stale"
+// Every guest-side info metric in one exec, one per line, in the order GuestMetrics is
+// filled in: each additional exec costs a channel open/teardown round trip
+constexpr auto guest_metrics_cmd =
+    "cat /proc/loadavg | cut -d ' ' -f1-3; "
+    "free -b | sed '1d;3d' | awk '{print $3; print $2}'; "
+    "df --output=used,size `awk '$2 == \"/\" { print $1 }' /proc/mounts` -B1 | sed 1d | awk '{print $1; print $2}'; "
+    "lsb_release -ds";
+constexpr auto guest_metrics_ttl = std::chrono::seconds(5);
 constexpr auto uuid_file_name = "multipass-unique-id";
 constexpr auto metrics_opt_in_file = "multipassd-send-metrics.yaml";
 constexpr auto reboot_cmd = "sudo reboot";
+// How long daemon teardown may spend quiescing instances before degrading to hard
+// stops; sized to fit inside systemd's default TimeoutStopSec of 90s with headroom,
+// overridable (in seconds) for units with tighter limits
+constexpr auto default_shutdown_budget = std::chrono::seconds(75);
+constexpr auto shutdown_budget_env_var = "MULTIPASS_SHUTDOWN_BUDGET";
 constexpr auto up_timeout = 2min; // This may be tweaked as appropriate and used in places that wait for ssh to be up
 constexpr auto cloud_init_timeout = 5min;
 constexpr auto stop_ssh_cmd = "sudo systemctl stop ssh";
 const std::string sshfs_error_template = "Error enabling mount support in '{}'"
                                          "\n\nPlease install the 'multipass-sshfs' snap manually inside the instance.";
+constexpr auto sshfs_exec_metadata_key = "sshfs_exec_line"; // cached guest sshfs resolution, in VMSpecs metadata
 const std::unordered_set<std::string> no_bridging_images = {
     "release:10.04", "release:lucid",   "release:11.10", "release:oneiric", "release:12.04", "release:precise",
     "release:12.10", "release:quantal", "release:13.04", "release:raring",  "release:13.10", "release:saucy",
@@ -112,9 +152,32 @@ mp::Query query_from(const mp::LaunchRequest* request, const std::string& name)
     return {name, image, false, request->remote_name(), query_type, true};
 }
 
+// A launch can only adopt a warm instance if it asks for nothing beyond the defaults
+// the pool instances were built with
+bool wants_default_launch(const mp::LaunchRequest* request)
+{
+    return request->instance_name().empty() && request->image().empty() && request->remote_name().empty() &&
+           request->num_cores() <= 1 && request->mem_size().empty() && request->disk_space().empty() &&
+           request->cloud_init_user_data().empty() && request->network_options().empty();
+}
+
 auto make_cloud_init_vendor_config(const mp::SSHKeyProvider& key_provider, const std::string& time_zone,
                                    const std::string& username, const std::string& backend_version_string)
 {
+    // The vendor config only varies with the launch's timezone (the key, username and
+    // backend are fixed for the daemon's lifetime), yet it was parsed from scratch out of
+    // the base YAML and re-assembled on every launch. Keep the assembled tree per
+    // timezone and hand out clones, which callers are free to modify.
+    static std::mutex cache_mutex;
+    static std::unordered_map<std::string, YAML::Node> cache;
+
+    const auto cache_key = fmt::format("{}|{}|{}", time_zone, username, backend_version_string);
+
+    std::lock_guard<std::mutex> lock{cache_mutex};
+    auto cached = cache.find(cache_key);
+    if (cached != cache.end())
+        return YAML::Clone(cached->second);
+
     auto ssh_key_line = fmt::format("ssh-rsa {} {}@localhost", key_provider.public_key_as_base64(), username);
 
     auto config = YAML::Load(mp::base_cloud_init_config);
@@ -134,7 +197,8 @@ auto make_cloud_init_vendor_config(const mp::SSHKeyProvider& key_provider, const
 
     config["write_files"].push_back(pollinate_user_agent_node);
 
-    return config;
+    cache.emplace(cache_key, config);
+    return YAML::Clone(config);
 }
 
 auto make_cloud_init_meta_config(const std::string& name)
@@ -147,42 +211,46 @@ auto make_cloud_init_meta_config(const std::string& name)
     return meta_data;
 }
 
-auto make_cloud_init_network_config(const std::string default_mac_addr,
-                                    const std::vector<mp::NetworkInterface>& extra_interfaces)
+// Netplan only ever sees two shapes of interface stanza here, so the YAML is kept as
+// fixed fragment templates and per-instance configs are assembled by substituting names
+// and MAC addresses - no YAML tree to build and emit on every (multi-NIC) launch. The
+// assembled document feeds the ISO content hash like any other rendered file.
+std::string make_cloud_init_network_config(const std::string& default_mac_addr,
+                                           const std::vector<mp::NetworkInterface>& extra_interfaces)
 {
-    YAML::Node network_data;
-
     // Generate the cloud-init file only if there is at least one extra interface needing auto configuration.
     if (std::find_if(extra_interfaces.begin(), extra_interfaces.end(),
-                     [](const auto& iface) { return iface.auto_mode; }) != extra_interfaces.end())
-    {
-        network_data["version"] = "2";
-
-        std::string name = "default";
-        network_data["ethernets"][name]["match"]["macaddress"] = default_mac_addr;
-        network_data["ethernets"][name]["dhcp4"] = true;
-
-        for (size_t i = 0; i < extra_interfaces.size(); ++i)
-        {
-            if (extra_interfaces[i].auto_mode)
-            {
-                name = "extra" + std::to_string(i);
-                network_data["ethernets"][name]["match"]["macaddress"] = extra_interfaces[i].mac_address;
-                network_data["ethernets"][name]["dhcp4"] = true;
-                // We make the default gateway associated with the first interface.
-                network_data["ethernets"][name]["dhcp4-overrides"]["route-metric"] = 200;
-                // Make the interface optional, which means that networkd will not wait for the device to be configured.
-                network_data["ethernets"][name]["optional"] = true;
-            }
-        }
-    }
+                     [](const auto& iface) { return iface.auto_mode; }) == extra_interfaces.end())
+        return {};
 
-    return network_data;
+    constexpr auto default_fragment = "  default:\n"
+                                      "    match:\n"
+                                      "      macaddress: \"{}\"\n"
+                                      "    dhcp4: true\n";
+    // The route metric keeps the default gateway associated with the first interface;
+    // `optional` means that networkd will not wait for the device to be configured.
+    constexpr auto extra_fragment = "  extra{}:\n"
+                                    "    match:\n"
+                                    "      macaddress: \"{}\"\n"
+                                    "    dhcp4: true\n"
+                                    "    dhcp4-overrides:\n"
+                                    "      route-metric: 200\n"
+                                    "    optional: true\n";
+
+    fmt::memory_buffer network_data;
+    fmt::format_to(network_data, "#cloud-config\nversion: 2\nethernets:\n");
+    fmt::format_to(network_data, default_fragment, default_mac_addr);
+
+    for (size_t i = 0; i < extra_interfaces.size(); ++i)
+        if (extra_interfaces[i].auto_mode)
+            fmt::format_to(network_data, extra_fragment, i, extra_interfaces[i].mac_address);
+
+    return fmt::to_string(network_data);
 }
 
-auto make_cloud_init_image(const std::string& name, const QDir& instance_dir, YAML::Node& meta_data_config,
-                           YAML::Node& user_data_config, YAML::Node& vendor_data_config,
-                           YAML::Node& network_data_config)
+auto make_cloud_init_image(const std::string& name, const QDir& instance_dir, const QDir& iso_cache_dir,
+                           YAML::Node& meta_data_config, YAML::Node& user_data_config,
+                           YAML::Node& vendor_data_config, const std::string& network_data_config)
 {
     const auto cloud_init_iso = instance_dir.filePath("cloud-init-config.iso");
     if (QFile::exists(cloud_init_iso))
@@ -192,10 +260,17 @@ auto make_cloud_init_image(const std::string& name, const QDir& instance_dir, YA
     iso.add_file("meta-data", mpu::emit_cloud_config(meta_data_config));
     iso.add_file("vendor-data", mpu::emit_cloud_config(vendor_data_config));
     iso.add_file("user-data", mpu::emit_cloud_config(user_data_config));
-    if (!network_data_config.IsNull())
-        iso.add_file("network-config", mpu::emit_cloud_config(network_data_config));
+    if (!network_data_config.empty())
+        iso.add_file("network-config", network_data_config);
+
+    // Launches whose rendered configs match byte for byte are served the cached volume
+    // instead of regenerating it; the key covers everything that goes into the ISO
+    const auto cached_iso = iso_cache_dir.filePath(QString::fromStdString(iso.content_hash()) + ".iso");
+    if (QFile::exists(cached_iso) && QFile::copy(cached_iso, cloud_init_iso))
+        return cloud_init_iso;
 
     iso.write_to(cloud_init_iso);
+    QFile::copy(cloud_init_iso, cached_iso); // best effort; a failed copy only loses the caching
 
     return cloud_init_iso;
 }
@@ -216,34 +291,47 @@ mp::VirtualMachineDescription to_machine_desc(const mp::LaunchRequest* request,
                                               const std::string& mac_addr,
                                               const std::vector<mp::NetworkInterface>& extra_interfaces,
                                               const std::string& ssh_username, const mp::VMImage& image,
-                                              YAML::Node& meta_data_config, YAML::Node& user_data_config,
-                                              YAML::Node& vendor_data_config, YAML::Node& network_data_config)
+                                              const mp::Path& cloud_init_iso, YAML::Node& meta_data_config,
+                                              YAML::Node& user_data_config, YAML::Node& vendor_data_config,
+                                              const std::string& network_data_config)
 {
     const auto num_cores = request->num_cores() < std::stoi(mp::min_cpu_cores)
                                ? std::stoi(mp::default_cpu_cores)
                                : request->num_cores();
-    const auto instance_dir = mp::utils::base_dir(image.image_path);
-    const auto cloud_init_iso = make_cloud_init_image(name, instance_dir, meta_data_config, user_data_config,
-                                                      vendor_data_config, network_data_config);
 
-    return {num_cores,          mem_size,         disk_space,       name,
-            mac_addr,           extra_interfaces, ssh_username,     image,
-            cloud_init_iso,     meta_data_config, user_data_config, vendor_data_config,
-            network_data_config};
+    return {num_cores,          mem_size,          disk_space,       name,
+            mac_addr,           extra_interfaces,  ssh_username,     image,
+            cloud_init_iso,     meta_data_config,  user_data_config, vendor_data_config,
+            network_data_config, request->cpuset(), request->cpu_model()};
+}
+
+// Renders the spans recorded since a launch began into a per-phase timing table
+std::string format_timing_breakdown(std::chrono::steady_clock::time_point since)
+{
+    auto spans = MP_TRACER.spans_since(since);
+    std::sort(spans.begin(), spans.end(),
+              [](const mp::Tracer::Span& a, const mp::Tracer::Span& b) { return a.start < b.start; });
+
+    fmt::memory_buffer buf;
+    fmt::format_to(buf, "Timing breakdown:\n");
+    for (const auto& span : spans)
+        fmt::format_to(buf, "  {:>7.2f}s  {}\n", std::chrono::duration<double>(span.end - span.start).count(),
+                       span.name);
+
+    return fmt::to_string(buf);
 }
 
-template <typename T>
-auto name_from(const std::string& requested_name, mp::NameGenerator& name_gen, const T& currently_used_names)
+std::string name_from(const std::string& requested_name, mp::NameGenerator& name_gen,
+                      const mp::UsedNamesFilter& used_names)
 {
     if (requested_name.empty())
     {
-        auto name = name_gen.make_name();
         constexpr int num_retries = 100;
         for (int i = 0; i < num_retries; i++)
         {
-            if (currently_used_names.find(name) != currently_used_names.end())
-                continue;
-            return name;
+            auto name = name_gen.make_name();
+            if (!used_names.possibly_contains(name))
+                return name;
         }
         throw std::runtime_error("unable to generate a unique name");
     }
@@ -310,6 +398,15 @@ std::unordered_map<std::string, mp::VMSpecs> load_db(const mp::Path& data_path,
         auto state = record["state"].toInt();
         auto deleted = record["deleted"].toBool();
         auto metadata = record["metadata"].toObject();
+        auto cpuset = record["cpuset"].toString().toStdString();
+        auto cpu_model = record["cpu_model"].toString().toStdString();
+
+        // Metadata has per-instance record files since the split from the monolithic
+        // database; the embedded field above remains as a fallback for older databases
+        QFile metadata_file{
+            data_dir.filePath(QString{"%1/%2.json"}.arg(instance_metadata_dir_name, it.key()))};
+        if (metadata_file.open(QIODevice::ReadOnly))
+            metadata = QJsonDocument::fromJson(metadata_file.readAll()).object();
 
         if (!num_cores && !state && !deleted && ssh_username.empty() && metadata.isEmpty() &&
             !mp::MemorySize{mem_size}.in_bytes() && !mp::MemorySize{disk_space}.in_bytes())
@@ -360,8 +457,26 @@ std::unordered_map<std::string, mp::VMSpecs> load_db(const mp::Path& data_path,
                                       static_cast<mp::VirtualMachine::State>(state),
                                       mounts,
                                       deleted,
-                                      metadata};
+                                      metadata,
+                                      cpuset,
+                                      cpu_model};
+    }
+
+    // State changes between full database writes are journaled; replay them so a crash
+    // inside the debounce window does not lose the latest per-instance states.
+    QFile journal_file{data_dir.filePath(instance_journal_name)};
+    if (journal_file.open(QIODevice::ReadOnly))
+    {
+        while (!journal_file.atEnd())
+        {
+            auto entry = QJsonDocument::fromJson(journal_file.readLine()).object();
+            auto name = entry["name"].toString().toStdString();
+            auto it = reconstructed_records.find(name);
+            if (it != reconstructed_records.end())
+                it->second.state = static_cast<mp::VirtualMachine::State>(entry["state"].toInt());
+        }
     }
+
     return reconstructed_records;
 }
 
@@ -447,9 +562,9 @@ std::vector<mp::NetworkInterface> validate_extra_interfaces(const mp::LaunchRequ
 
 auto validate_create_arguments(const mp::LaunchRequest* request, const mp::VirtualMachineFactory& factory)
 {
-    static const auto min_mem = try_mem_size(mp::min_memory_size);
-    static const auto min_disk = try_mem_size(mp::min_disk_size);
-    assert(min_mem && min_disk);
+    // constexpr construction - a bad default would fail to compile
+    constexpr auto min_mem = mp::MemorySize{mp::min_memory_size};
+    constexpr auto min_disk = mp::MemorySize{mp::min_disk_size};
 
     auto mem_size_str = request->mem_size();
     auto disk_space_str = request->disk_space();
@@ -588,6 +703,7 @@ auto connect_rpc(mp::DaemonRpc& rpc, mp::Daemon& daemon)
     QObject::connect(&rpc, &mp::DaemonRpc::on_find, &daemon, &mp::Daemon::find);
     QObject::connect(&rpc, &mp::DaemonRpc::on_info, &daemon, &mp::Daemon::info);
     QObject::connect(&rpc, &mp::DaemonRpc::on_list, &daemon, &mp::Daemon::list);
+    QObject::connect(&rpc, &mp::DaemonRpc::on_instance_names, &daemon, &mp::Daemon::instance_names);
     QObject::connect(&rpc, &mp::DaemonRpc::on_networks, &daemon, &mp::Daemon::networks);
     QObject::connect(&rpc, &mp::DaemonRpc::on_mount, &daemon, &mp::Daemon::mount);
     QObject::connect(&rpc, &mp::DaemonRpc::on_recover, &daemon, &mp::Daemon::recover);
@@ -596,9 +712,14 @@ auto connect_rpc(mp::DaemonRpc& rpc, mp::Daemon& daemon)
     QObject::connect(&rpc, &mp::DaemonRpc::on_stop, &daemon, &mp::Daemon::stop);
     QObject::connect(&rpc, &mp::DaemonRpc::on_suspend, &daemon, &mp::Daemon::suspend);
     QObject::connect(&rpc, &mp::DaemonRpc::on_restart, &daemon, &mp::Daemon::restart);
+    QObject::connect(&rpc, &mp::DaemonRpc::on_snapshot, &daemon, &mp::Daemon::snapshot);
+    QObject::connect(&rpc, &mp::DaemonRpc::on_restore, &daemon, &mp::Daemon::restore);
+    QObject::connect(&rpc, &mp::DaemonRpc::on_clone, &daemon, &mp::Daemon::clone);
     QObject::connect(&rpc, &mp::DaemonRpc::on_delete, &daemon, &mp::Daemon::delet);
     QObject::connect(&rpc, &mp::DaemonRpc::on_umount, &daemon, &mp::Daemon::umount);
     QObject::connect(&rpc, &mp::DaemonRpc::on_version, &daemon, &mp::Daemon::version);
+    QObject::connect(&rpc, &mp::DaemonRpc::on_watch, &daemon, &mp::Daemon::watch);
+    QObject::connect(&rpc, &mp::DaemonRpc::on_console_log, &daemon, &mp::Daemon::console_log);
 }
 
 template <typename Instances, typename InstanceMap, typename InstanceCheck>
@@ -820,6 +941,29 @@ std::string generate_unused_mac_address(std::unordered_set<std::string>& s)
                     max_tries, s.size())};
 }
 
+// Launch admission bounds: RAM is what actually thrashes when overcommitted, so it is
+// bounded by the host total minus a reserve for the host itself; CPUs time-share well
+// and only get a loose overcommit cap
+constexpr long long host_memory_reserve_bytes = 1LL << 30;
+constexpr auto cpu_overcommit_factor = 4;
+constexpr auto admission_retry_interval_ms = 5000;
+
+long long host_memory_bytes()
+{
+    static const long long total = [] {
+        QFile meminfo{QStringLiteral("/proc/meminfo")};
+        if (meminfo.open(QIODevice::ReadOnly))
+            while (!meminfo.atEnd())
+            {
+                const auto line = QString::fromLatin1(meminfo.readLine());
+                if (line.startsWith("MemTotal:"))
+                    return line.split(' ', QString::SkipEmptyParts).value(1).toLongLong() * 1024;
+            }
+        return 0LL; // unknown; admission then only bounds CPUs
+    }();
+    return total;
+}
+
 bool is_ipv4_valid(const std::string& ipv4)
 {
     try
@@ -856,6 +1000,29 @@ void add_aliases(mp::FindReply& response, const std::string& remote_name, const
     }
 }
 
+// Publishes the latest networks answer next to the daemon's unix socket, world-readable,
+// so `networks --cached` (shell completion, mostly) can answer from one local read
+// instead of an RPC; refreshed on every served query, so it tracks the last answer given
+void publish_networks_cache(const std::string& server_address, mp::NetworksReply reply)
+{
+    constexpr auto unix_scheme = "unix:";
+    if (server_address.rfind(unix_scheme, 0) != 0)
+        return;
+
+    reply.clear_update_info(); // addressed to the querying client; not part of the published data
+
+    const auto path = QString::fromStdString(server_address.substr(strlen(unix_scheme)) + ".networks");
+    QSaveFile cache_file{path};
+    if (!cache_file.open(QIODevice::WriteOnly))
+        return;
+
+    const auto serialized = reply.SerializeAsString();
+    cache_file.write(serialized.data(), serialized.size());
+    if (cache_file.commit())
+        QFile::setPermissions(path, QFileDevice::ReadOwner | QFileDevice::WriteOwner | QFileDevice::ReadGroup |
+                                        QFileDevice::ReadOther);
+}
+
 } // namespace
 
 mp::Daemon::Daemon(std::unique_ptr<const DaemonConfig> the_config)
@@ -867,11 +1034,66 @@ mp::Daemon::Daemon(std::unique_ptr<const DaemonConfig> the_config)
       metrics_provider{"https://api.jujucharms.com/omnibus/v4/multipass/metrics", get_unique_id(config->data_directory),
                        config->data_directory},
       metrics_opt_in{get_metrics_opt_in(config->data_directory)},
-      instance_mounts{*config->ssh_key_provider}
+      instance_mounts{*config->ssh_key_provider},
+      ssh_session_pool{*config->ssh_key_provider}
 {
     connect_rpc(daemon_rpc, *this);
+
+    // Any generation the daemon hands out must be unique to one roster snapshot, also
+    // across restarts, so seed from the clock rather than starting at zero
+    list_generation = static_cast<uint64_t>(QDateTime::currentMSecsSinceEpoch());
+
+    persist_instances_task.setSingleShot(true);
+    persist_instances_task.setInterval(persist_debounce_window_ms);
+    QObject::connect(&persist_instances_task, &QTimer::timeout, [this] { persist_instances(); });
+
+    // Servers report the sshfs invocation they resolved in the guest; remember it in the
+    // instance's metadata so later mount starts skip the per-mount guest probes entirely
+    QObject::connect(&instance_mounts, &mp::SSHFSMounts::sshfs_exec_line_learned,
+                     [this](const std::string& instance, const std::string& exec_line) {
+                         auto spec_it = vm_instance_specs.find(instance);
+                         if (spec_it == vm_instance_specs.end())
+                             return;
+
+                         if (exec_line.empty())
+                             spec_it->second.metadata.remove(sshfs_exec_metadata_key);
+                         else
+                             spec_it->second.metadata.insert(sshfs_exec_metadata_key,
+                                                             QString::fromStdString(exec_line));
+                         persist_instances();
+                     });
+
+    for (const auto& entry : vm_instance_specs)
+    {
+        const auto cached_exec = entry.second.metadata.value(sshfs_exec_metadata_key).toString();
+        if (!cached_exec.isEmpty())
+            instance_mounts.set_sshfs_exec_line(entry.first, cached_exec.toStdString());
+    }
+
+    // Instance tasks spend most of their time blocked on ssh/cloud-init, so allow more of
+    // them than there are cores; background maintenance is serialized on its own thread.
+    async_task_pool.setMaxThreadCount(std::max(4, 2 * QThread::idealThreadCount()));
+    background_task_pool.setMaxThreadCount(1);
+
+    // The mmap'd state mirror survives kills that slip through the journal's
+    // open-write-close window; overlay what it holds over the reconstructed states
+    {
+        QDir mirror_dir{mp::utils::backend_directory_path(config->data_directory,
+                                                          config->factory->get_backend_directory_name())};
+        state_mirror = std::make_unique<InstanceStateMirror>(mirror_dir.filePath(instance_mirror_name));
+        for (const auto& mirrored : state_mirror->stored_states())
+        {
+            auto spec_it = vm_instance_specs.find(mirrored.first);
+            if (spec_it != vm_instance_specs.end())
+                spec_it->second.state = mirrored.second;
+            else
+                state_mirror->forget(mirrored.first);
+        }
+    }
+
     std::vector<std::string> invalid_specs;
 
+    const auto reconstruct_start = std::chrono::steady_clock::now();
     for (auto& entry : vm_instance_specs)
     {
         const auto& name = entry.first;
@@ -911,22 +1133,9 @@ mp::Daemon::Daemon(std::unique_ptr<const DaemonConfig> the_config)
                                               {},
                                               {},
                                               {},
-                                              {}};
-
-        try
-        {
-            auto& instance_record = spec.deleted ? deleted_instances : vm_instances;
-            instance_record[name] = config->factory->create_virtual_machine(vm_desc, *this);
-        }
-        catch (const std::exception& e)
-        {
-            mpl::log(mpl::Level::error, category, fmt::format("Removing instance {}: {}", name, e.what()));
-            invalid_specs.push_back(name);
-            config->vault->remove(name);
-            continue;
-        }
-
-        allocated_mac_addrs = std::move(new_macs); // Add the new macs to the daemon's list only if we got this far
+                                              {},
+                                              spec.cpuset,
+                                              spec.cpu_model};
 
         // FIXME: somehow we're writing contradictory state to disk.
         if (spec.deleted && spec.state != VirtualMachine::State::stopped)
@@ -937,16 +1146,39 @@ mp::Daemon::Daemon(std::unique_ptr<const DaemonConfig> the_config)
             spec.state = VirtualMachine::State::stopped;
         }
 
-        if (spec.state == VirtualMachine::State::running && vm_instances[name]->state != VirtualMachine::State::running)
+        if (spec.state == VirtualMachine::State::running)
         {
             assert(!spec.deleted);
-            mpl::log(mpl::Level::info, category, fmt::format("{} needs starting. Starting now...", name));
+            try
+            {
+                vm_instances[name] = config->factory->create_virtual_machine(vm_desc, *this);
+            }
+            catch (const std::exception& e)
+            {
+                mpl::log(mpl::Level::error, category, fmt::format("Removing instance {}: {}", name, e.what()));
+                invalid_specs.push_back(name);
+                config->vault->remove(name);
+                continue;
+            }
 
-            QTimer::singleShot(0, [this, &name] {
-                vm_instances[name]->start();
-                on_restart(name);
-            });
+            if (vm_instances[name]->state != VirtualMachine::State::running)
+            {
+                mpl::log(mpl::Level::info, category, fmt::format("{} needs starting. Starting now...", name));
+
+                QTimer::singleShot(0, [this, &name] {
+                    vm_instances[name]->start();
+                    on_restart(name);
+                });
+            }
+        }
+        else
+        {
+            // Everything not running stays unconstructed until a command needs the backend
+            // object, keeping daemon restart time independent of fleet size
+            deferred_vm_descs[name] = vm_desc;
         }
+
+        allocated_mac_addrs = std::move(new_macs); // Add the new macs to the daemon's list only if we got this far
     }
 
     for (const auto& bad_spec : invalid_specs)
@@ -957,7 +1189,28 @@ mp::Daemon::Daemon(std::unique_ptr<const DaemonConfig> the_config)
     if (!invalid_specs.empty())
         persist_instances();
 
-    config->vault->prune_expired_images();
+    MP_STATS.record("startup.reconstruct_instances",
+                    std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() -
+                                                                          reconstruct_start));
+
+    // seed the mirror with the post-recovery states, so the next restart needs no guessing;
+    // the surviving names also prime the used-name filter backing petname generation
+    for (const auto& entry : vm_instance_specs)
+    {
+        state_mirror->record(entry.first, entry.second.state);
+        used_names_filter.add(entry.first);
+    }
+
+    // Pruning scans the image dirs and renames the expired ones into the trash; none of
+    // that belongs on the startup path, so push it behind the background queue
+    QtConcurrent::run(&background_task_pool, [this] { config->vault->prune_expired_images(); });
+
+    warm_pool_size = qEnvironmentVariableIntValue("MULTIPASS_WARM_POOL_SIZE");
+    if (warm_pool_size > 0)
+    {
+        purge_stale_warm_instances();
+        QTimer::singleShot(0, this, &Daemon::replenish_warm_pool);
+    }
 
     // Fire timer every six hours to perform maintenance on source images such as
     // pruning expired images and updating to newly released images.
@@ -968,7 +1221,10 @@ mp::Daemon::Daemon(std::unique_ptr<const DaemonConfig> the_config)
         }
         else
         {
-            image_update_future = QtConcurrent::run([this] {
+            image_update_future = QtConcurrent::run(&background_task_pool, [this] {
+                // demote this task's downloads so a concurrent launch keeps the bandwidth
+                const mp::URLDownloader::BackgroundPriorityScope download_scope;
+
                 config->vault->prune_expired_images();
 
                 auto prepare_action = [this](const VMImage& source_image) -> VMImage {
@@ -1001,6 +1257,135 @@ mp::Daemon::Daemon(std::unique_ptr<const DaemonConfig> the_config)
         }
     });
     source_images_maintenance_task.start(config->image_refresh_timer);
+
+    // Periodically balloon down instances that have seen no client interaction for a
+    // while, returning their idle RAM to the host; it is given back on the next use
+    connect(&memory_reclaim_task, &QTimer::timeout, [this] {
+        const auto now = std::chrono::steady_clock::now();
+        for (const auto& entry : vm_instances)
+        {
+            if (entry.second->current_state() != VirtualMachine::State::running)
+                continue;
+
+            // instances running since before the daemon came up start their idle clock now
+            const auto last_seen = last_activity.emplace(entry.first, now).first->second;
+            if (now - last_seen >= memory_reclaim_idle_threshold)
+                entry.second->reclaim_idle_memory();
+        }
+    });
+    memory_reclaim_task.start(std::chrono::duration_cast<std::chrono::milliseconds>(memory_reclaim_check_interval));
+
+    // Liveness heartbeat: a timestamp file next to the unix socket lets monitoring agents
+    // confirm the daemon is alive with a single file read instead of a TLS handshake
+    const auto heartbeat_path = mp::utils::heartbeat_file_path(config->server_address);
+    if (!heartbeat_path.isEmpty())
+    {
+        auto beat = [heartbeat_path] {
+            QFile heartbeat_file{heartbeat_path};
+            if (heartbeat_file.open(QIODevice::WriteOnly | QIODevice::Truncate))
+            {
+                heartbeat_file.write(QByteArray::number(QDateTime::currentSecsSinceEpoch()));
+                heartbeat_file.setPermissions(QFile::ReadOwner | QFile::WriteOwner | QFile::ReadGroup |
+                                              QFile::ReadOther);
+            }
+        };
+        beat();
+        QObject::connect(&heartbeat_task, &QTimer::timeout, beat);
+        heartbeat_task.start(std::chrono::duration_cast<std::chrono::milliseconds>(heartbeat_interval).count());
+    }
+
+    // The socket has been accepting since daemon_rpc was constructed, with ping and version
+    // answered immediately; everything else was held back until now, when it can be served
+    daemon_rpc.mark_ready();
+}
+
+namespace
+{
+std::chrono::seconds shutdown_time_budget()
+{
+    bool ok{false};
+    const auto seconds = qEnvironmentVariableIntValue(shutdown_budget_env_var, &ok);
+    if (ok && seconds > 0)
+        return std::chrono::seconds(seconds);
+
+    return default_shutdown_budget;
+}
+} // namespace
+
+mp::Daemon::~Daemon()
+{
+    const auto budget = shutdown_time_budget();
+    const auto deadline = std::chrono::steady_clock::now() + budget;
+
+    delayed_shutdown_instances.clear(); // pending delayed shutdowns are superseded
+
+    std::vector<VirtualMachine::ShPtr> instances;
+    for (auto* map : {&vm_instances, &deleted_instances, &warm_instances})
+    {
+        for (auto& entry : *map)
+            instances.push_back(entry.second);
+        map->clear();
+    }
+
+    // Ask every running instance to save its state up front; suspend acknowledges as
+    // soon as the save is underway, so the whole fleet's saves overlap instead of
+    // running one at a time through the destructors below
+    for (auto& vm : instances)
+    {
+        try
+        {
+            if (vm->current_state() == VirtualMachine::State::running)
+                vm->suspend();
+        }
+        catch (const std::exception& e)
+        {
+            mpl::log(mpl::Level::warning, category,
+                     fmt::format("Cannot suspend {} for shutdown: {}", vm->vm_name, e.what()));
+        }
+    }
+
+    // Let the saves settle over most of the budget, keeping the rest for collection.
+    // The event loop has already exited, so pump events here - that is how the
+    // hypervisors' completion events reach the instances and move them past suspending
+    const auto degrade_deadline = deadline - budget / 5;
+    auto still_saving = [&instances] {
+        return std::any_of(instances.begin(), instances.end(), [](const VirtualMachine::ShPtr& vm) {
+            return vm->current_state() == VirtualMachine::State::suspending;
+        });
+    };
+    while (still_saving() && std::chrono::steady_clock::now() < degrade_deadline)
+        QCoreApplication::processEvents(QEventLoop::AllEvents | QEventLoop::WaitForMoreEvents, 100);
+
+    // Whatever has not settled is taken down hard - its save is forfeit, but a bounded
+    // stop beats systemd's SIGKILL tearing through every save at once
+    for (auto& vm : instances)
+    {
+        if (vm->current_state() != VirtualMachine::State::suspending)
+            continue;
+
+        mpl::log(mpl::Level::warning, category,
+                 fmt::format("{} did not finish saving state within the shutdown budget; stopping it", vm->vm_name));
+        try
+        {
+            vm->shutdown();
+        }
+        catch (const std::exception& e)
+        {
+            mpl::log(mpl::Level::warning, category, fmt::format("Cannot stop {}: {}", vm->vm_name, e.what()));
+        }
+    }
+
+    // With every save settled or degraded, the destructors have little left to do but
+    // collect their hypervisor processes. They stay on this thread - the instances are
+    // QObjects that live here - and anything overrunning the deadline regardless is
+    // logged, so an eventual SIGKILL can be traced back to its culprit
+    for (auto& vm : instances)
+    {
+        if (std::chrono::steady_clock::now() >= deadline)
+            mpl::log(mpl::Level::warning, category,
+                     fmt::format("shutdown budget exhausted with {} still to collect", vm->vm_name));
+        vm.reset();
+    }
 }
 
 void mp::Daemon::create(const CreateRequest* request, grpc::ServerWriter<CreateReply>* server,
@@ -1076,6 +1461,21 @@ try // clang-format on
         release_resources(del.first);
 
     deleted_instances.clear();
+
+    // Deleted instances that were never reconstructed this run are released straight from
+    // their specs; no need to build a backend object just to tear it down
+    for (auto it = deferred_vm_descs.begin(); it != deferred_vm_descs.end();)
+    {
+        const auto name = it->first;
+        if (vm_instance_specs.at(name).deleted)
+        {
+            it = deferred_vm_descs.erase(it);
+            release_resources(name);
+        }
+        else
+            ++it;
+    }
+
     persist_instances();
 
     status_promise->set_value(grpc::Status::OK);
@@ -1090,9 +1490,21 @@ void mp::Daemon::find(const FindRequest* request, grpc::ServerWriter<FindReply>*
 try // clang-format on
 {
     mpl::ClientLogger<FindReply> logger{mpl::level_from(request->verbosity_level()), *config->logger, server};
-    FindReply response;
+    google::protobuf::Arena arena;
+    auto& response = *google::protobuf::Arena::CreateMessage<FindReply>(&arena);
     const auto default_remote{"release"};
 
+    const auto prefix = QString::fromStdString(request->alias_prefix());
+    const auto matches_prefix = [&prefix](const mp::VMImageInfo& info) {
+        if (prefix.isEmpty())
+            return true;
+        for (const auto& alias : info.aliases)
+            if (alias.startsWith(prefix))
+                return true;
+        return false;
+    };
+    auto remaining = request->limit() > 0 ? request->limit() : std::numeric_limits<int>::max();
+
     if (!request->search_string().empty())
     {
         auto vm_images_info = config->vault->all_info_for({"", request->search_string(), false, request->remote_name(),
@@ -1100,6 +1512,10 @@ try // clang-format on
 
         for (const auto& [remote, info] : vm_images_info)
         {
+            if (remaining == 0)
+                break;
+            --remaining;
+
             std::string name;
             if (info.aliases.contains(QString::fromStdString(request->search_string())))
             {
@@ -1126,21 +1542,35 @@ try // clang-format on
     }
     else if (request->remote_name().empty())
     {
+        // One reply per remote, written as soon as that remote's manifest has been
+        // scanned, so the client can start painting while later remotes still refresh
         for (const auto& image_host : config->image_hosts)
         {
+            if (remaining == 0)
+                break;
+
+            response.Clear();
             std::unordered_set<std::string> images_found;
-            auto action = [&images_found, &default_remote, request, &response](const std::string& remote,
-                                                                               const mp::VMImageInfo& info) {
-                if ((info.supported || request->allow_unsupported()) && !info.aliases.empty() &&
+            auto action = [&images_found, &default_remote, &matches_prefix, &remaining, request,
+                           &response](const std::string& remote, const mp::VMImageInfo& info) {
+                if (remaining > 0 && (info.supported || request->allow_unsupported()) && !info.aliases.empty() &&
+                    matches_prefix(info) &&
                     images_found.find(info.release_title.toStdString()) == images_found.end())
                 {
                     add_aliases(response, remote, info, default_remote);
                     images_found.insert(info.release_title.toStdString());
+                    --remaining;
                 }
             };
 
             image_host->for_each_entry_do(action);
+
+            if (response.images_info_size() > 0)
+                server->Write(response);
         }
+
+        status_promise->set_value(grpc::Status::OK);
+        return;
     }
     else
     {
@@ -1150,7 +1580,14 @@ try // clang-format on
 
         for (const auto& info : vm_images_info)
         {
-            add_aliases(response, remote, info, "");
+            if (remaining == 0)
+                break;
+
+            if (matches_prefix(info))
+            {
+                add_aliases(response, remote, info, "");
+                --remaining;
+            }
         }
     }
     server->Write(response);
@@ -1161,18 +1598,54 @@ catch (const std::exception& e)
     status_promise->set_value(grpc::Status(grpc::StatusCode::FAILED_PRECONDITION, e.what(), ""));
 }
 
-void mp::Daemon::info(const InfoRequest* request, grpc::ServerWriter<InfoReply>* server,
+mp::Daemon::GuestMetrics mp::Daemon::guest_metrics_for(const std::string& name, mp::SSHSession& session)
+{
+    const auto now = std::chrono::steady_clock::now();
+
+    {
+        std::lock_guard<std::mutex> lock{guest_metrics_mutex};
+        auto cached = guest_metrics_cache.find(name);
+        if (cached != guest_metrics_cache.end() && now - cached->second.taken_at < guest_metrics_ttl)
+            return cached->second;
+    }
+
+    const auto lines = QString::fromStdString(mpu::run_in_ssh_session(session, guest_metrics_cmd)).split('\n');
+    const auto line_or_empty = [&lines](int index) {
+        return index < lines.count() ? lines[index].trimmed().toStdString() : std::string{};
+    };
+
+    GuestMetrics metrics;
+    metrics.load = line_or_empty(0);
+    metrics.memory_usage = line_or_empty(1);
+    metrics.memory_total = line_or_empty(2);
+    metrics.disk_usage = line_or_empty(3);
+    metrics.disk_total = line_or_empty(4);
+    metrics.current_release = line_or_empty(5);
+    metrics.taken_at = now;
+
+    std::lock_guard<std::mutex> lock{guest_metrics_mutex};
+    guest_metrics_cache[name] = metrics;
+    return metrics;
+}
+
+void mp::Daemon::info(grpc::ServerContext* context, const InfoRequest* request, grpc::ServerWriter<InfoReply>* server,
                       std::promise<grpc::Status>* status_promise) // clang-format off
 try // clang-format on
 {
     mpl::ClientLogger<InfoReply> logger{mpl::level_from(request->verbosity_level()), *config->logger, server};
-    InfoReply response;
+
+    // With no names given, the federated peers' instances are part of the answer too;
+    // they are fetched in parallel with the local collection and probes below
+    std::future<std::vector<std::pair<std::string, InfoReply>>> peer_infos;
+    if (!peer_daemons.empty() && request->instance_names().instance_name().empty())
+        peer_infos = std::async(std::launch::async, [this, request] { return peer_daemons.fetch_infos(*request); });
 
     fmt::memory_buffer errors;
     std::vector<decltype(vm_instances)::key_type> instances_for_info;
 
     if (request->instance_names().instance_name().empty())
     {
+        materialize_all_deferred_instances();
         for (auto& pair : vm_instances)
             instances_for_info.push_back(pair.first);
     }
@@ -1182,14 +1655,25 @@ try // clang-format on
             instances_for_info.push_back(name);
     }
 
+    // Resolve every requested name up front, so name errors surface before any output
+    // is streamed to the client
+    std::vector<std::pair<std::string, bool>> resolved; // name, whether deleted
     for (const auto& name : instances_for_info)
     {
-        auto it = vm_instances.find(name);
+        try
+        {
+            materialize_deferred_instance(name);
+        }
+        catch (const std::exception& e)
+        {
+            fmt::format_to(errors, "instance \"{}\" could not be reconstructed: {}\n", name, e.what());
+            continue;
+        }
+
         bool deleted{false};
-        if (it == vm_instances.end())
+        if (vm_instances.find(name) == vm_instances.end())
         {
-            it = deleted_instances.find(name);
-            if (it == deleted_instances.end())
+            if (deleted_instances.find(name) == deleted_instances.end())
             {
                 fmt::format_to(errors, "instance \"{}\" does not exist\n", name);
                 continue;
@@ -1197,8 +1681,74 @@ try // clang-format on
             deleted = true;
         }
 
-        auto info = response.add_info();
-        auto& vm = it->second;
+        resolved.emplace_back(name, deleted);
+    }
+
+    auto status = grpc_status_for(errors);
+    if (!status.ok())
+        return status_promise->set_value(status);
+
+    // An empty mask means everything; otherwise only the listed InfoReply.Info fields
+    // are collected, so e.g. a name+state query never resolves images or touches SSH
+    const auto& requested_fields = request->fields();
+    auto wants = [&requested_fields](const std::string& field) {
+        return requested_fields.empty() ||
+               std::find(requested_fields.begin(), requested_fields.end(), field) != requested_fields.end();
+    };
+    const auto wants_guest_fields = wants("load") || wants("memory_usage") || wants("memory_total") ||
+                                    wants("disk_usage") || wants("disk_total") || wants("ipv4") ||
+                                    wants("current_release");
+
+    // Host headroom goes out first, so placement tooling sees it before (and without
+    // waiting for) the per-instance entries
+    {
+        InfoReply headroom_chunk;
+        auto resources = headroom_chunk.mutable_host_resources();
+        const auto committed = committed_host_resources();
+        resources->set_cpus_total(QThread::idealThreadCount());
+        resources->set_cpus_committed(committed.cpus + admission_reserved.cpus);
+        resources->set_memory_total(static_cast<uint64_t>(host_memory_bytes()));
+        resources->set_memory_committed(
+            static_cast<uint64_t>(committed.memory_bytes + admission_reserved.memory_bytes));
+        resources->set_disk_available(
+            static_cast<uint64_t>(mp::utils::filesystem_bytes_available(config->data_directory)));
+        if (source_images_maintenance_task.isActive())
+            resources->set_image_maintenance_due(
+                QDateTime::currentSecsSinceEpoch() + source_images_maintenance_task.remainingTime() / 1000);
+        server->Write(headroom_chunk);
+    }
+
+    // Guest-side probes dominate info latency, so they are gathered below and run in
+    // parallel across instances once the daemon-side fields are filled in; each entry
+    // streams out as its own reply fragment the moment it completes, so the first
+    // results paint while the slowest instance is still being probed.
+    // State shared between the handler and its probes, owned jointly: should the call's
+    // deadline pass or the client go away, the handler returns and any still-running
+    // probes keep the state alive until they finish, writing nowhere
+    struct ProbeState
+    {
+        google::protobuf::Arena arena; // backing for all the reply fragments' strings
+        std::mutex mutex;              // guards everything below, and serializes stream writes
+        std::condition_variable probe_done;
+        int pending{0};
+        bool abandoned{false};
+        std::exception_ptr error;
+        // daemon-side snapshots of the entries under probe, taken before the probes
+        // start mutating the live chunks; one goes out marked partial for any probe
+        // that misses the deadline
+        std::vector<std::pair<InfoReply, bool>> fallbacks; // snapshot, probe finished
+    };
+    auto probe_state = std::make_shared<ProbeState>();
+    std::vector<std::function<void()>> guest_probes;
+
+    for (const auto& resolved_entry : resolved)
+    {
+        const auto& name = resolved_entry.first;
+        const auto deleted = resolved_entry.second;
+        auto& vm = deleted ? deleted_instances[name] : vm_instances[name];
+
+        auto& chunk = *google::protobuf::Arena::CreateMessage<InfoReply>(&probe_state->arena);
+        auto info = chunk.add_info();
         auto present_state = vm->current_state();
         info->set_name(name);
         if (deleted)
@@ -1210,91 +1760,228 @@ try // clang-format on
             info->mutable_instance_status()->set_status(grpc_instance_status_for(present_state));
         }
 
-        auto vm_image = fetch_image_for(name, config->factory->fetch_type(), *config->vault);
-        auto original_release = vm_image.original_release;
-
-        if (!vm_image.id.empty() && original_release.empty())
+        std::string original_release;
+        if (wants("image_release") || wants("id") || wants("current_release"))
         {
-            try
-            {
-                auto vm_image_info = config->image_hosts.back()->info_for_full_hash(vm_image.id);
-                original_release = vm_image_info.release_title.toStdString();
-            }
-            catch (const std::exception& e)
+            auto vm_image = fetch_image_for(name, config->factory->fetch_type(), *config->vault);
+            original_release = vm_image.original_release;
+
+            if (!vm_image.id.empty() && original_release.empty())
             {
-                mpl::log(mpl::Level::warning, category, fmt::format("Cannot fetch image information: {}", e.what()));
+                try
+                {
+                    auto vm_image_info = config->image_hosts.back()->info_for_full_hash(vm_image.id);
+                    original_release = vm_image_info.release_title.toStdString();
+                }
+                catch (const std::exception& e)
+                {
+                    mpl::log(mpl::Level::warning, category,
+                             fmt::format("Cannot fetch image information: {}", e.what()));
+                }
             }
-        }
 
-        info->set_image_release(original_release);
-        info->set_id(vm_image.id);
+            info->set_image_release(original_release);
+            info->set_id(vm_image.id);
+        }
 
         auto vm_specs = vm_instance_specs[name];
 
-        auto mount_info = info->mutable_mount_info();
+        if (wants("mount_info"))
+        {
+            auto mount_info = info->mutable_mount_info();
 
-        mount_info->set_longest_path_len(0);
+            mount_info->set_longest_path_len(0);
 
-        for (const auto& mount : vm_specs.mounts)
-        {
-            if (mount.second.source_path.size() > mount_info->longest_path_len())
+            for (const auto& mount : vm_specs.mounts)
             {
-                mount_info->set_longest_path_len(mount.second.source_path.size());
-            }
+                if (mount.second.source_path.size() > mount_info->longest_path_len())
+                {
+                    mount_info->set_longest_path_len(mount.second.source_path.size());
+                }
 
-            auto entry = mount_info->add_mount_paths();
-            entry->set_source_path(mount.second.source_path);
-            entry->set_target_path(mount.first);
+                auto entry = mount_info->add_mount_paths();
+                entry->set_source_path(mount.second.source_path);
+                entry->set_target_path(mount.first);
 
-            for (const auto& uid_map : mount.second.uid_map)
-            {
-                (*entry->mutable_mount_maps()->mutable_uid_map())[uid_map.first] = uid_map.second;
-            }
-            for (const auto& gid_map : mount.second.gid_map)
-            {
-                (*entry->mutable_mount_maps()->mutable_gid_map())[gid_map.first] = gid_map.second;
+                for (const auto& uid_map : mount.second.uid_map)
+                {
+                    (*entry->mutable_mount_maps()->mutable_uid_map())[uid_map.first] = uid_map.second;
+                }
+                for (const auto& gid_map : mount.second.gid_map)
+                {
+                    (*entry->mutable_mount_maps()->mutable_gid_map())[gid_map.first] = gid_map.second;
+                }
+
+                if (const auto mount_io = instance_mounts.stats_for(name, mount.first))
+                {
+                    auto io_stats = entry->mutable_io_stats();
+                    io_stats->set_read_ops(mount_io->read_ops);
+                    io_stats->set_read_bytes(mount_io->read_bytes);
+                    io_stats->set_read_usecs(mount_io->read_usecs);
+                    io_stats->set_write_ops(mount_io->write_ops);
+                    io_stats->set_write_bytes(mount_io->write_bytes);
+                    io_stats->set_write_usecs(mount_io->write_usecs);
+                    io_stats->set_other_ops(mount_io->other_ops);
+                    io_stats->set_other_usecs(mount_io->other_usecs);
+                }
             }
         }
 
-        if (mp::utils::is_running(present_state))
+        if (wants_guest_fields && mp::utils::is_running(present_state))
         {
-            mp::SSHSession session{vm->ssh_hostname(), vm->ssh_port(), vm_specs.ssh_username,
-                                   *config->ssh_key_provider};
-
-            info->set_load(mpu::run_in_ssh_session(session, "cat /proc/loadavg | cut -d ' ' -f1-3"));
-            info->set_memory_usage(mpu::run_in_ssh_session(session, "free -b | sed '1d;3d' | awk '{printf $3}'"));
-            info->set_memory_total(mpu::run_in_ssh_session(session, "free -b | sed '1d;3d' | awk '{printf $2}'"));
-            info->set_disk_usage(mpu::run_in_ssh_session(
-                session, "df --output=used `awk '$2 == \"/\" { print $1 }' /proc/mounts` -B1 | sed 1d"));
-            info->set_disk_total(mpu::run_in_ssh_session(
-                session, "df --output=size `awk '$2 == \"/\" { print $1 }' /proc/mounts` -B1 | sed 1d"));
-
-            std::string management_ip = vm->management_ipv4();
-            auto all_ipv4 = vm->get_all_ipv4(*config->ssh_key_provider);
-
-            if (is_ipv4_valid(management_ip))
-                info->add_ipv4(management_ip);
-            else if (all_ipv4.empty())
-                info->add_ipv4("N/A");
-
-            for (const auto& extra_ipv4 : all_ipv4)
-                if (extra_ipv4 != management_ip)
-                    info->add_ipv4(extra_ipv4);
-
-            auto current_release = mpu::run_in_ssh_session(session, "lsb_release -ds");
-            info->set_current_release(!current_release.empty() ? current_release : original_release);
+            auto vm_ptr = vm;
+            const auto fallback_index = probe_state->fallbacks.size();
+            probe_state->fallbacks.emplace_back(chunk, false);
+            guest_probes.push_back([this, info, &chunk, server, probe_state, fallback_index, vm_ptr, name, vm_specs,
+                                    original_release] {
+                auto pooled_session =
+                    ssh_session_pool.session_for(name, vm_ptr->ssh_hostname(), vm_ptr->ssh_port(),
+                                                 vm_specs.ssh_username);
+                auto& session = pooled_session.session;
+
+                const auto metrics = guest_metrics_for(name, session);
+                info->set_load(metrics.load);
+                info->set_memory_usage(metrics.memory_usage);
+                info->set_memory_total(metrics.memory_total);
+                info->set_disk_usage(metrics.disk_usage);
+                info->set_disk_total(metrics.disk_total);
+
+                std::string management_ip = vm_ptr->management_ipv4();
+                auto all_ipv4 = vm_ptr->get_all_ipv4(*config->ssh_key_provider);
+
+                if (is_ipv4_valid(management_ip))
+                    info->add_ipv4(management_ip);
+                else if (all_ipv4.empty())
+                    info->add_ipv4("N/A");
+
+                for (const auto& extra_ipv4 : all_ipv4)
+                    if (extra_ipv4 != management_ip)
+                        info->add_ipv4(extra_ipv4);
+
+                info->set_current_release(!metrics.current_release.empty() ? metrics.current_release
+                                                                           : original_release);
+
+                const std::lock_guard<std::mutex> lock{probe_state->mutex};
+                probe_state->fallbacks[fallback_index].second = true;
+                if (!probe_state->abandoned) // past the deadline the writer is gone
+                    server->Write(chunk);
+            });
+        }
+        else
+        {
+            server->Write(chunk); // nothing to probe; this one is ready to paint already
         }
     }
 
-    auto status = grpc_status_for(errors);
-    if (status.ok())
-        server->Write(response);
+    if (!guest_probes.empty())
+    {
+        probe_state->pending = static_cast<int>(guest_probes.size());
 
-    status_promise->set_value(status);
-}
-catch (const std::exception& e)
-{
-    status_promise->set_value(grpc::Status(grpc::StatusCode::FAILED_PRECONDITION, e.what(), ""));
+        // Each probe only touches its own reply entry and pooled ssh session; the tasks
+        // own their probe and a share of the call state, so abandoning the call leaves
+        // nothing dangling underneath them
+        for (auto& probe : guest_probes)
+        {
+            QtConcurrent::run(&async_task_pool, [probe = std::move(probe), probe_state] {
+                {
+                    const std::lock_guard<std::mutex> lock{probe_state->mutex};
+                    if (probe_state->abandoned) // nobody is listening anymore; don't even start
+                    {
+                        --probe_state->pending;
+                        return;
+                    }
+                }
+
+                try
+                {
+                    probe();
+                }
+                catch (...)
+                {
+                    const std::lock_guard<std::mutex> lock{probe_state->mutex};
+                    if (!probe_state->error)
+                        probe_state->error = std::current_exception();
+                }
+
+                const std::lock_guard<std::mutex> lock{probe_state->mutex};
+                --probe_state->pending;
+                probe_state->probe_done.notify_all();
+            });
+        }
+
+        // The client's deadline (the infinite future, if it set none) bounds the wait,
+        // and a client that went away is noticed within the poll interval; either way
+        // the outstanding probes are abandoned rather than ground on for nobody. A
+        // margin is held back from the deadline so the partial entries still flush
+        // before gRPC cancels the call outright.
+        const auto deadline = context->deadline() - std::chrono::seconds{1};
+        std::unique_lock<std::mutex> lock{probe_state->mutex};
+        while (probe_state->pending > 0 && !probe_state->abandoned)
+        {
+            const auto wait_until = std::min<std::chrono::system_clock::time_point>(
+                deadline, std::chrono::system_clock::now() + std::chrono::milliseconds{100});
+            probe_state->probe_done.wait_until(lock, wait_until);
+
+            if (probe_state->pending > 0 &&
+                (context->IsCancelled() || std::chrono::system_clock::now() >= deadline))
+                probe_state->abandoned = true;
+        }
+
+        if (probe_state->abandoned)
+        {
+            if (context->IsCancelled())
+            {
+                mpl::log(mpl::Level::info, category,
+                         fmt::format("info: client went away with {} probes outstanding; abandoning them",
+                                     probe_state->pending));
+                return status_promise->set_value(grpc::Status(grpc::StatusCode::CANCELLED, "info cancelled", ""));
+            }
+
+            // The daemon-side fields of the unprobed entries are still worth having;
+            // their snapshots go out marked partial so the client can tell a wedged
+            // instance from a slow one next time around
+            mpl::log(mpl::Level::warning, category,
+                     fmt::format("info: {} guest probes missed the deadline; streaming their entries partial",
+                                 probe_state->pending));
+            for (auto& fallback : probe_state->fallbacks)
+                if (!fallback.second)
+                {
+                    fallback.first.mutable_info(0)->set_partial(true);
+                    server->Write(fallback.first);
+                }
+
+            return status_promise->set_value(grpc::Status::OK);
+        }
+
+        if (probe_state->error)
+        {
+            lock.unlock();
+            std::rethrow_exception(probe_state->error);
+        }
+    }
+
+    // Peer entries go out last, under "<address>/<name>" like in list; the peers' own
+    // headroom chunks are dropped, as host_resources describes the serving host
+    if (peer_infos.valid())
+        for (auto& peer_info : peer_infos.get())
+        {
+            InfoReply chunk;
+            for (const auto& info_entry : peer_info.second.info())
+            {
+                auto entry = chunk.add_info();
+                entry->CopyFrom(info_entry);
+                entry->set_name(fmt::format("{}/{}", peer_info.first, info_entry.name()));
+            }
+
+            if (chunk.info_size() > 0)
+                server->Write(chunk);
+        }
+
+    status_promise->set_value(grpc::Status::OK);
+}
+catch (const std::exception& e)
+{
+    status_promise->set_value(grpc::Status(grpc::StatusCode::FAILED_PRECONDITION, e.what(), ""));
 }
 
 void mp::Daemon::list(const ListRequest* request, grpc::ServerWriter<ListReply>* server,
@@ -1302,8 +1989,58 @@ void mp::Daemon::list(const ListRequest* request, grpc::ServerWriter<ListReply>*
 try // clang-format on
 {
     mpl::ClientLogger<ListReply> logger{mpl::level_from(request->verbosity_level()), *config->logger, server};
-    ListReply response;
+
+    // Peers answer from their own caches, so their lists are fetched in parallel with
+    // building the local one
+    std::future<std::vector<std::pair<std::string, ListReply>>> peer_lists;
+    if (!peer_daemons.empty())
+        peer_lists = std::async(std::launch::async, [this, request] { return peer_daemons.fetch_lists(*request); });
+
+    // The reply is mostly small strings; an arena turns those into bump allocations that
+    // all go away together when the call ends, instead of churning the daemon's heap
+    google::protobuf::Arena arena;
+    auto& response = *google::protobuf::Arena::CreateMessage<ListReply>(&arena);
     config->update_prompt->populate_if_time_to_show(response.mutable_update_info());
+    response.set_generation(list_generation);
+
+    // A client holding a still-valid snapshot only needs to hear that nothing changed;
+    // peer rosters move without bumping the local generation, so federation disables this
+    if (peer_daemons.empty() && request->known_generation() == list_generation)
+    {
+        response.set_unchanged(true);
+        server->Write(response);
+        return status_promise->set_value(grpc::Status::OK);
+    }
+
+    // The release of an instance never changes, so resolve it through the vault and
+    // image hosts once and serve every subsequent list from the cache.
+    auto resolve_release = [this](const std::string& name) -> const std::string& {
+        auto release_it = release_cache.find(name);
+        if (release_it == release_cache.end())
+        {
+            // FIXME: Set the release to the cached current version when supported
+            auto vm_image = fetch_image_for(name, config->factory->fetch_type(), *config->vault);
+            auto current_release = vm_image.original_release;
+
+            if (!vm_image.id.empty() && current_release.empty())
+            {
+                try
+                {
+                    auto vm_image_info = config->image_hosts.back()->info_for_full_hash(vm_image.id);
+                    current_release = vm_image_info.release_title.toStdString();
+                }
+                catch (const std::exception& e)
+                {
+                    mpl::log(mpl::Level::warning, category,
+                             fmt::format("Cannot fetch image information: {}", e.what()));
+                }
+            }
+
+            release_it = release_cache.emplace(name, current_release).first;
+        }
+
+        return release_it->second;
+    };
 
     for (const auto& instance : vm_instances)
     {
@@ -1314,29 +2051,18 @@ try // clang-format on
         entry->set_name(name);
         entry->mutable_instance_status()->set_status(grpc_instance_status_for(present_state));
 
-        // FIXME: Set the release to the cached current version when supported
-        auto vm_image = fetch_image_for(name, config->factory->fetch_type(), *config->vault);
-        auto current_release = vm_image.original_release;
-
-        if (!vm_image.id.empty() && current_release.empty())
-        {
-            try
-            {
-                auto vm_image_info = config->image_hosts.back()->info_for_full_hash(vm_image.id);
-                current_release = vm_image_info.release_title.toStdString();
-            }
-            catch (const std::exception& e)
-            {
-                mpl::log(mpl::Level::warning, category, fmt::format("Cannot fetch image information: {}", e.what()));
-            }
-        }
-
-        entry->set_current_release(current_release);
+        entry->set_current_release(resolve_release(name));
 
         if (request->request_ipv4() && mp::utils::is_running(present_state))
         {
             std::string management_ip = vm->management_ipv4();
-            auto all_ipv4 = vm->get_all_ipv4(*config->ssh_key_provider);
+
+            // Addresses are stable while the instance keeps running; the cache avoids a
+            // guest-side query per instance per list and is dropped on state transitions.
+            auto ipv4_it = ipv4_cache.find(name);
+            if (ipv4_it == ipv4_cache.end())
+                ipv4_it = ipv4_cache.emplace(name, vm->get_all_ipv4(*config->ssh_key_provider)).first;
+            const auto& all_ipv4 = ipv4_it->second;
 
             if (is_ipv4_valid(management_ip))
                 entry->add_ipv4(management_ip);
@@ -1357,6 +2083,64 @@ try // clang-format on
         entry->mutable_instance_status()->set_status(mp::InstanceStatus::DELETED);
     }
 
+    // Instances that have not been reconstructed this run are reported straight from their
+    // specs; listing must not force materialization (it runs on every shell prompt for some)
+    for (const auto& deferred : deferred_vm_descs)
+    {
+        const auto& name = deferred.first;
+        const auto& spec = vm_instance_specs.at(name);
+        auto entry = response.add_instances();
+        entry->set_name(name);
+        entry->mutable_instance_status()->set_status(spec.deleted ? mp::InstanceStatus::DELETED
+                                                                  : grpc_instance_status_for(spec.state));
+        if (!spec.deleted)
+            entry->set_current_release(resolve_release(name));
+    }
+
+    // Federated instances are folded in under "<address>/<name>", keeping names
+    // unambiguous across hosts; unreachable peers were already dropped in the fan-out
+    if (peer_lists.valid())
+        for (auto& peer_list : peer_lists.get())
+            for (const auto& instance : peer_list.second.instances())
+            {
+                auto entry = response.add_instances();
+                entry->CopyFrom(instance);
+                entry->set_name(fmt::format("{}/{}", peer_list.first, instance.name()));
+            }
+
+    // Machine formats are rendered once here, straight off the assembled reply, so thin
+    // clients print the payload as-is instead of re-serializing proto to text; the
+    // structured entries still go along, keeping client-side snapshot caches usable
+    if (!request->format().empty())
+    {
+        if (auto formatter = mp::format::formatter_for(request->format()))
+            response.set_prerendered(formatter->format(response));
+        else
+            mpl::log(mpl::Level::warning, category,
+                     fmt::format("cannot pre-render unknown format \"{}\"", request->format()));
+    }
+
+    server->Write(response);
+    status_promise->set_value(grpc::Status::OK);
+}
+catch (const std::exception& e)
+{
+    status_promise->set_value(grpc::Status(grpc::StatusCode::FAILED_PRECONDITION, e.what(), ""));
+}
+
+void mp::Daemon::instance_names(const InstanceNamesRequest* request, grpc::ServerWriter<InstanceNamesReply>* server,
+                                std::promise<grpc::Status>* status_promise) // clang-format off
+try // clang-format on
+{
+    mpl::ClientLogger<InstanceNamesReply> logger{mpl::level_from(request->verbosity_level()), *config->logger, server};
+    InstanceNamesReply response;
+
+    // Names come straight from the spec map, so this answers without touching any
+    // instance — no state probes, no materialization of deferred instances; shell
+    // completion calls this on every <tab>
+    for (const auto& spec : vm_instance_specs)
+        response.add_name(spec.first);
+
     server->Write(response);
     status_promise->set_value(grpc::Status::OK);
 }
@@ -1384,6 +2168,7 @@ try // clang-format on
     }
 
     server->Write(response);
+    publish_networks_cache(config->server_address, response);
     status_promise->set_value(grpc::Status::OK);
 }
 catch (const std::exception& e)
@@ -1428,6 +2213,8 @@ try // clang-format on
     for (const auto& path_entry : request->target_paths())
     {
         const auto name = path_entry.instance_name();
+        materialize_deferred_instance(name);
+
         auto it = vm_instances.find(name);
         if (it == vm_instances.end())
         {
@@ -1469,9 +2256,9 @@ try // clang-format on
                     mount_reply.set_mount_message("Enabling support for mounting");
                     server->Write(mount_reply);
 
-                    mp::SSHSession session{vm->ssh_hostname(), vm->ssh_port(), vm_specs.ssh_username,
-                                           *config->ssh_key_provider};
-                    mp::utils::install_sshfs_for(name, session);
+                    auto pooled_session = ssh_session_pool.session_for(name, vm->ssh_hostname(), vm->ssh_port(),
+                                                                       vm_specs.ssh_username);
+                    mp::utils::install_sshfs_for(name, pooled_session.session);
                     instance_mounts.start_mount(vm.get(), request->source_path(), target_path, gid_map, uid_map);
                 }
                 catch (const mp::SSHFSMissingError&)
@@ -1511,6 +2298,9 @@ try // clang-format on
 {
     mpl::ClientLogger<RecoverReply> logger{mpl::level_from(request->verbosity_level()), *config->logger, server};
 
+    if (request->instance_names().instance_name().empty())
+        materialize_all_deferred_instances();
+
     const auto [instances, status] =
         find_requested_instances(request->instance_names().instance_name(), deleted_instances,
                                  std::bind(&Daemon::check_instance_exists, this, std::placeholders::_1));
@@ -1553,6 +2343,16 @@ try // clang-format on
 
     for (const auto& name : request->instance_name())
     {
+        if (deferred_vm_descs.find(name) != deferred_vm_descs.end())
+        {
+            // not reconstructed yet, so certainly not running; no point materializing it
+            if (vm_instance_specs.at(name).deleted)
+                return status_promise->set_value(
+                    grpc::Status{grpc::StatusCode::INVALID_ARGUMENT, fmt::format("instance \"{}\" is deleted", name)});
+            return status_promise->set_value(
+                grpc::Status(grpc::StatusCode::ABORTED, fmt::format("instance \"{}\" is not running", name)));
+        }
+
         auto it = vm_instances.find(name);
         if (it == vm_instances.end())
         {
@@ -1587,6 +2387,8 @@ try // clang-format on
             }
         }
 
+        note_instance_activity(name);
+
         mp::SSHInfo ssh_info;
         ssh_info.set_host(vm->ssh_hostname());
         ssh_info.set_port(vm->ssh_port());
@@ -1615,18 +2417,23 @@ try // clang-format on
     mp::StartError start_error;
     auto* errors = start_error.mutable_instance_errors();
 
-    std::vector<decltype(vm_instances)::key_type> vms;
+    std::vector<InstanceHandle> vms;
     for (const auto& name : request->instance_names().instance_name())
     {
+        materialize_deferred_instance(name);
+
         auto it = vm_instances.find(name);
         if (it == vm_instances.end())
             errors->insert({name, deleted_instances.find(name) == deleted_instances.end()
                                       ? mp::StartError::DOES_NOT_EXIST
                                       : mp::StartError::INSTANCE_DELETED});
         else if (it->second->current_state() == VirtualMachine::State::delayed_shutdown)
+        {
             delayed_shutdown_instances.erase(name);
+            note_instance_activity(name);
+        }
         else if (it->second->current_state() != VirtualMachine::State::running)
-            vms.push_back(name);
+            vms.push_back({name, it->second});
     }
 
     if (start_error.instance_errors_size())
@@ -1635,25 +2442,48 @@ try // clang-format on
 
     if (request->instance_names().instance_name().empty())
     {
+        materialize_all_deferred_instances();
         for (auto& pair : vm_instances)
         {
             if (pair.second->current_state() == VirtualMachine::State::running)
                 continue;
-            vms.push_back(pair.first);
+            vms.push_back({pair.first, pair.second});
         }
     }
 
-    for (const auto& name : vms)
-    {
-        auto it = vm_instances.find(name);
-        auto state = it->second->current_state();
+    // Fan the process launches out across the global pool (bounded by core count), so that
+    // starting a cold fleet scales with the host's cores rather than with the instance count.
+    // A client hint caps the fan-out below that, for fleets that want to pace the host.
+    auto start_one = [](const InstanceHandle& handle) {
+        auto state = handle.vm->current_state();
         if (state != VirtualMachine::State::starting && state != VirtualMachine::State::restarting)
-            it->second->start();
+            handle.vm->start();
+    };
+
+    if (request->parallel_hint() > 0)
+    {
+        QThreadPool bounded_pool;
+        bounded_pool.setMaxThreadCount(request->parallel_hint());
+        QFutureSynchronizer<void> start_synchronizer;
+        for (const auto& handle : vms)
+            start_synchronizer.addFuture(
+                QtConcurrent::run(&bounded_pool, [&start_one, handle] { start_one(handle); }));
+        start_synchronizer.waitForFinished();
+    }
+    else
+        QtConcurrent::blockingMap(vms, start_one);
+
+    std::vector<std::string> names;
+    names.reserve(vms.size());
+    for (const auto& handle : vms)
+    {
+        note_instance_activity(handle.name);
+        names.push_back(handle.name);
     }
 
     auto future_watcher = create_future_watcher();
     future_watcher->setFuture(
-        QtConcurrent::run(this, &Daemon::async_wait_for_ready_all<StartReply>, server, vms, status_promise));
+        QtConcurrent::run(&async_task_pool, this, &Daemon::async_wait_for_ready_all<StartReply>, server, names, status_promise));
 }
 catch (const std::exception& e)
 {
@@ -1666,20 +2496,17 @@ try // clang-format on
 {
     mpl::ClientLogger<StopReply> logger{mpl::level_from(request->verbosity_level()), *config->logger, server};
 
-    auto [instances, status] =
-        find_requested_instances(request->instance_names().instance_name(), vm_instances,
-                                 std::bind(&Daemon::check_instance_operational, this, std::placeholders::_1));
+    auto [instances, status] = resolve_instances(request->instance_names().instance_name());
 
     if (status.ok())
     {
-        std::function<grpc::Status(VirtualMachine&)> operation;
         if (request->cancel_shutdown())
-            operation = std::bind(&Daemon::cancel_vm_shutdown, this, std::placeholders::_1);
+            status = cmd_vms(instances, std::bind(&Daemon::cancel_vm_shutdown, this, std::placeholders::_1));
+        else if (request->time_minutes() > 0)
+            status = cmd_vms(instances, std::bind(&Daemon::shutdown_vm, this, std::placeholders::_1,
+                                                  std::chrono::minutes(request->time_minutes())));
         else
-            operation = std::bind(&Daemon::shutdown_vm, this, std::placeholders::_1,
-                                  std::chrono::minutes(request->time_minutes()));
-
-        status = cmd_vms(instances, operation);
+            status = shutdown_vms_now(instances);
     }
 
     status_promise->set_value(status);
@@ -1695,32 +2522,9 @@ try // clang-format on
 {
     mpl::ClientLogger<SuspendReply> logger{mpl::level_from(request->verbosity_level()), *config->logger, server};
 
-    fmt::memory_buffer errors;
-    std::vector<decltype(vm_instances)::key_type> instances_to_suspend;
-    for (const auto& name : request->instance_names().instance_name())
-    {
-        auto it = vm_instances.find(name);
-        if (it == vm_instances.end())
-        {
-            it = deleted_instances.find(name);
-            if (it == deleted_instances.end())
-                fmt::format_to(errors, "instance \"{}\" does not exist\n", name);
-            else
-                fmt::format_to(errors, "instance \"{}\" is deleted\n", name);
-            continue;
-        }
-        instances_to_suspend.push_back(name);
-    }
-
-    auto status = grpc_status_for(errors);
+    auto [instances_to_suspend, status] = resolve_instances(request->instance_names().instance_name());
     if (status.ok())
     {
-        if (instances_to_suspend.empty())
-        {
-            for (auto& pair : vm_instances)
-                instances_to_suspend.push_back(pair.first);
-        }
-
         status = cmd_vms(instances_to_suspend, [this](auto& vm) {
             vm.suspend();
             instance_mounts.stop_all_mounts_for_instance(vm.vm_name);
@@ -1741,9 +2545,7 @@ try // clang-format on
 {
     mpl::ClientLogger<RestartReply> logger{mpl::level_from(request->verbosity_level()), *config->logger, server};
 
-    auto [instances, status] =
-        find_requested_instances(request->instance_names().instance_name(), vm_instances,
-                                 std::bind(&Daemon::check_instance_operational, this, std::placeholders::_1));
+    auto [instances, status] = resolve_instances(request->instance_names().instance_name());
 
     if (!status.ok())
     {
@@ -1758,9 +2560,174 @@ try // clang-format on
         return status_promise->set_value(status);
     }
 
+    std::vector<std::string> names;
+    names.reserve(instances.size());
+    for (const auto& handle : instances)
+        names.push_back(handle.name);
+
     auto future_watcher = create_future_watcher();
     future_watcher->setFuture(
-        QtConcurrent::run(this, &Daemon::async_wait_for_ready_all<RestartReply>, server, instances, status_promise));
+        QtConcurrent::run(&async_task_pool, this, &Daemon::async_wait_for_ready_all<RestartReply>, server, names, status_promise));
+}
+catch (const std::exception& e)
+{
+    status_promise->set_value(grpc::Status(grpc::StatusCode::FAILED_PRECONDITION, e.what(), ""));
+}
+
+void mp::Daemon::snapshot(const SnapshotRequest* request, grpc::ServerWriter<SnapshotReply>* server,
+                          std::promise<grpc::Status>* status_promise) // clang-format off
+try // clang-format on
+{
+    mpl::ClientLogger<SnapshotReply> logger{mpl::level_from(request->verbosity_level()), *config->logger, server};
+
+    const auto& name = request->instance_name();
+    materialize_deferred_instance(name);
+
+    auto it = vm_instances.find(name);
+    if (it == vm_instances.end())
+    {
+        auto error = deleted_instances.find(name) == deleted_instances.end()
+                         ? fmt::format("instance \"{}\" does not exist", name)
+                         : fmt::format("instance \"{}\" is deleted", name);
+        return status_promise->set_value(grpc::Status{grpc::StatusCode::ABORTED, error, ""});
+    }
+
+    if (request->snapshot_name().empty())
+        return status_promise->set_value(
+            grpc::Status{grpc::StatusCode::INVALID_ARGUMENT, "snapshot name cannot be empty", ""});
+
+    it->second->take_snapshot(request->snapshot_name());
+
+    status_promise->set_value(grpc::Status::OK);
+}
+catch (const std::exception& e)
+{
+    status_promise->set_value(grpc::Status(grpc::StatusCode::FAILED_PRECONDITION, e.what(), ""));
+}
+
+void mp::Daemon::restore(const RestoreRequest* request, grpc::ServerWriter<RestoreReply>* server,
+                         std::promise<grpc::Status>* status_promise) // clang-format off
+try // clang-format on
+{
+    mpl::ClientLogger<RestoreReply> logger{mpl::level_from(request->verbosity_level()), *config->logger, server};
+
+    const auto& name = request->instance_name();
+    materialize_deferred_instance(name);
+
+    auto it = vm_instances.find(name);
+    if (it == vm_instances.end())
+    {
+        auto error = deleted_instances.find(name) == deleted_instances.end()
+                         ? fmt::format("instance \"{}\" does not exist", name)
+                         : fmt::format("instance \"{}\" is deleted", name);
+        return status_promise->set_value(grpc::Status{grpc::StatusCode::ABORTED, error, ""});
+    }
+
+    if (request->snapshot_name().empty())
+        return status_promise->set_value(
+            grpc::Status{grpc::StatusCode::INVALID_ARGUMENT, "snapshot name cannot be empty", ""});
+
+    it->second->restore_snapshot(request->snapshot_name());
+
+    status_promise->set_value(grpc::Status::OK);
+}
+catch (const std::exception& e)
+{
+    status_promise->set_value(grpc::Status(grpc::StatusCode::FAILED_PRECONDITION, e.what(), ""));
+}
+
+void mp::Daemon::clone(const CloneRequest* request, grpc::ServerWriter<CloneReply>* server,
+                       std::promise<grpc::Status>* status_promise) // clang-format off
+try // clang-format on
+{
+    mpl::ClientLogger<CloneReply> logger{mpl::level_from(request->verbosity_level()), *config->logger, server};
+
+    const auto& source_name = request->source_name();
+    const auto& destination_name = request->destination_name();
+
+    materialize_deferred_instance(source_name);
+
+    auto source_it = vm_instances.find(source_name);
+    if (source_it == vm_instances.end())
+    {
+        auto error = deleted_instances.find(source_name) == deleted_instances.end()
+                         ? fmt::format("instance \"{}\" does not exist", source_name)
+                         : fmt::format("instance \"{}\" is deleted", source_name);
+        return status_promise->set_value(grpc::Status{grpc::StatusCode::ABORTED, error, ""});
+    }
+
+    if (!mp::utils::valid_hostname(destination_name))
+        return status_promise->set_value(grpc::Status{
+            grpc::StatusCode::INVALID_ARGUMENT, fmt::format("invalid instance name: {}", destination_name), ""});
+
+    if (vm_instances.find(destination_name) != vm_instances.end() ||
+        deleted_instances.find(destination_name) != deleted_instances.end() ||
+        preparing_instances.find(destination_name) != preparing_instances.end() ||
+        config->vault->has_record_for(destination_name))
+        return status_promise->set_value(grpc::Status{
+            grpc::StatusCode::INVALID_ARGUMENT, fmt::format("instance \"{}\" already exists", destination_name), ""});
+
+    const auto source_state = source_it->second->current_state();
+    if (source_state != VirtualMachine::State::off && source_state != VirtualMachine::State::stopped)
+        return status_promise->set_value(
+            grpc::Status{grpc::StatusCode::FAILED_PRECONDITION,
+                         fmt::format("instance \"{}\" must be stopped to be cloned", source_name), ""});
+
+    const auto& source_spec = vm_instance_specs[source_name];
+    const auto source_image = fetch_image_for(source_name, config->factory->fetch_type(), *config->vault);
+
+    auto cloned_image = config->vault->clone_instance_image(source_name, destination_name);
+
+    // carry the cloud-init seed over unchanged: the instance-id matches what the guest
+    // already provisioned against, so cloud-init does not run again in the clone
+    const auto source_iso = mp::utils::base_dir(source_image.image_path).filePath("cloud-init-config.iso");
+    const auto cloned_iso = mp::utils::base_dir(cloned_image.image_path).filePath("cloud-init-config.iso");
+    if (QFile::exists(source_iso))
+        QFile::copy(source_iso, cloned_iso);
+
+    std::unordered_set<std::string> new_macs; // MACs must be unique, so the clone gets fresh ones
+    {
+        std::lock_guard<std::mutex> lock{mac_addrs_mutex};
+        new_macs = allocated_mac_addrs;
+    }
+    VMSpecs cloned_spec{source_spec};
+    cloned_spec.default_mac_address = generate_unused_mac_address(new_macs);
+    for (auto& interface : cloned_spec.extra_interfaces)
+        interface.mac_address = generate_unused_mac_address(new_macs);
+    cloned_spec.state = VirtualMachine::State::off;
+    cloned_spec.deleted = false;
+
+    mp::VirtualMachineDescription vm_desc{cloned_spec.num_cores,
+                                          cloned_spec.mem_size,
+                                          cloned_spec.disk_space,
+                                          destination_name,
+                                          cloned_spec.default_mac_address,
+                                          cloned_spec.extra_interfaces,
+                                          cloned_spec.ssh_username,
+                                          cloned_image,
+                                          cloned_iso,
+                                          {},
+                                          {},
+                                          {},
+                                          {},
+                                          cloned_spec.cpuset,
+                                          cloned_spec.cpu_model};
+
+    vm_instances[destination_name] = config->factory->create_virtual_machine(vm_desc, *this);
+    vm_instance_specs[destination_name] = cloned_spec;
+    used_names_filter.add(destination_name);
+
+    // Merge rather than replace: launches commit their own MACs concurrently
+    {
+        std::lock_guard<std::mutex> lock{mac_addrs_mutex};
+        allocated_mac_addrs.insert(cloned_spec.default_mac_address);
+        for (const auto& interface : cloned_spec.extra_interfaces)
+            allocated_mac_addrs.insert(interface.mac_address);
+    }
+
+    persist_instances();
+
+    status_promise->set_value(grpc::Status::OK);
 }
 catch (const std::exception& e)
 {
@@ -1773,6 +2740,12 @@ try // clang-format on
 {
     mpl::ClientLogger<DeleteReply> logger{mpl::level_from(request->verbosity_level()), *config->logger, server};
 
+    if (request->instance_names().instance_name().empty())
+        materialize_all_deferred_instances();
+    else
+        for (const auto& name : request->instance_names().instance_name())
+            materialize_deferred_instance(name);
+
     const auto [operational_instances_to_delete, trashed_instances_to_delete, status] =
         find_instances_to_delete(request->instance_names().instance_name(), vm_instances, deleted_instances);
 
@@ -1833,6 +2806,8 @@ try // clang-format on
     for (const auto& path_entry : request->target_paths())
     {
         const auto name = path_entry.instance_name();
+        materialize_deferred_instance(name);
+
         auto it = vm_instances.find(name);
         if (it == vm_instances.end())
         {
@@ -1889,6 +2864,86 @@ void mp::Daemon::version(const VersionRequest* request, grpc::ServerWriter<Versi
     status_promise->set_value(grpc::Status::OK);
 }
 
+void mp::Daemon::watch(const WatchRequest* request, grpc::ServerWriter<WatchReply>* server,
+                       std::promise<grpc::Status>* status_promise)
+{
+    // Send the current state of every instance up front, then keep the stream open:
+    // persist_state_for pushes deltas as transitions happen, so watching clients cost
+    // the daemon nothing in between. The stream's promise is only fulfilled when the
+    // client goes away, parking its gRPC handler thread until then.
+    std::lock_guard<std::mutex> lock{watch_mutex};
+
+    for (const auto& instance : vm_instances)
+    {
+        WatchReply reply;
+        reply.set_name(instance.first);
+        reply.mutable_instance_status()->set_status(grpc_instance_status_for(instance.second->current_state()));
+
+        if (!server->Write(reply))
+        {
+            status_promise->set_value(grpc::Status::OK);
+            return;
+        }
+    }
+
+    watch_subscribers.push_back({server, status_promise});
+}
+
+void mp::Daemon::console_log(const ConsoleLogRequest* request, grpc::ServerWriter<ConsoleLogReply>* server,
+                             std::promise<grpc::Status>* status_promise) // clang-format off
+try // clang-format on
+{
+    mpl::ClientLogger<ConsoleLogReply> logger{mpl::level_from(request->verbosity_level()), *config->logger, server};
+
+    const auto& name = request->instance_name();
+    if (vm_instance_specs.find(name) == vm_instance_specs.end())
+        return status_promise->set_value(
+            grpc::Status{grpc::StatusCode::NOT_FOUND, fmt::format("instance \"{}\" does not exist", name), ""});
+
+    // Whatever the backend has captured comes straight out of its in-memory ring; an
+    // instance that has not run since the daemon started simply has nothing to show.
+    // Deferred instances are served without materializing them, like in list.
+    ConsoleLogReply reply;
+    auto instance = vm_instances.find(name);
+    if (instance != vm_instances.end())
+        reply.set_scrollback(instance->second->console_scrollback());
+    else if (auto deleted = deleted_instances.find(name); deleted != deleted_instances.end())
+        reply.set_scrollback(deleted->second->console_scrollback());
+
+    server->Write(reply);
+    status_promise->set_value(grpc::Status::OK);
+}
+catch (const std::exception& e)
+{
+    status_promise->set_value(grpc::Status(grpc::StatusCode::FAILED_PRECONDITION, e.what(), ""));
+}
+
+void mp::Daemon::notify_watchers(const std::string& name, const VirtualMachine::State& state)
+{
+    std::lock_guard<std::mutex> lock{watch_mutex};
+
+    if (watch_subscribers.empty())
+        return;
+
+    WatchReply reply;
+    reply.set_name(name);
+    reply.mutable_instance_status()->set_status(grpc_instance_status_for(state));
+
+    for (auto it = watch_subscribers.begin(); it != watch_subscribers.end();)
+    {
+        if (it->writer->Write(reply))
+        {
+            ++it;
+        }
+        else
+        {
+            // The client went away; complete its rpc and drop the subscription
+            it->status_promise->set_value(grpc::Status::OK);
+            it = watch_subscribers.erase(it);
+        }
+    }
+}
+
 void mp::Daemon::on_shutdown()
 {
 }
@@ -1908,21 +2963,105 @@ void mp::Daemon::on_suspend()
 void mp::Daemon::on_restart(const std::string& name)
 {
     auto future_watcher = create_future_watcher();
-    future_watcher->setFuture(QtConcurrent::run(this, &Daemon::async_wait_for_ready_all<StartReply>, nullptr,
+    future_watcher->setFuture(QtConcurrent::run(&async_task_pool, this, &Daemon::async_wait_for_ready_all<StartReply>, nullptr,
                                                 std::vector<std::string>{name}, nullptr));
 }
 
 void mp::Daemon::persist_state_for(const std::string& name, const VirtualMachine::State& state)
 {
-    vm_instance_specs[name].state = state;
-    persist_instances();
-}
+    // Warm instances are invisible to clients; track their state apart from the database
+    auto warm_it = warm_instance_specs.find(name);
+    if (warm_it != warm_instance_specs.end())
+    {
+        warm_it->second.state = state;
+        return;
+    }
+
+    // Transitions coalesce in a queue drained once per event-loop tick: a fleet restart
+    // firing hundreds of callbacks costs one journal entry and one watcher broadcast per
+    // instance, with intermediate flaps collapsing into the final state.
+    std::lock_guard<std::mutex> lock{state_transitions_mutex};
+    pending_state_transitions.emplace_back(name, state);
+    if (!state_transitions_drain_scheduled)
+    {
+        state_transitions_drain_scheduled = true;
+        QTimer::singleShot(0, this, [this] { drain_state_transitions(); });
+    }
+}
+
+void mp::Daemon::drain_state_transitions()
+{
+    decltype(pending_state_transitions) transitions;
+    {
+        std::lock_guard<std::mutex> lock{state_transitions_mutex};
+        transitions.swap(pending_state_transitions);
+        state_transitions_drain_scheduled = false;
+    }
+
+    // Later entries win, so only each instance's final state this tick is acted upon
+    std::unordered_map<std::string, VirtualMachine::State> final_states;
+    for (const auto& [name, state] : transitions)
+        final_states[name] = state;
+
+    for (const auto& [name, state] : final_states)
+    {
+        auto spec_it = vm_instance_specs.find(name);
+        if (spec_it == vm_instance_specs.end())
+            continue; // the instance went away between the transition and this tick
+
+        spec_it->second.state = state;
+        if (!mp::utils::is_running(state))
+            ssh_session_pool.drop_session_for(name);
+        ipv4_cache.erase(name);
+        journal_state_for(name, state);
+        notify_watchers(name, state);
+    }
+
+    if (!final_states.empty())
+    {
+        ++list_generation;
+        schedule_persist_instances();
+    }
+}
+
+void mp::Daemon::schedule_persist_instances()
+{
+    if (!persist_instances_task.isActive())
+        persist_instances_task.start();
+}
+
+void mp::Daemon::journal_state_for(const std::string& name, const VirtualMachine::State& state)
+{
+    QDir data_dir{
+        mp::utils::backend_directory_path(config->data_directory, config->factory->get_backend_directory_name())};
+    QFile journal_file{data_dir.filePath(instance_journal_name)};
+    if (!journal_file.open(QIODevice::WriteOnly | QIODevice::Append))
+        return;
+
+    QJsonObject entry;
+    entry.insert("name", QString::fromStdString(name));
+    entry.insert("state", static_cast<int>(state));
+    journal_file.write(QJsonDocument{entry}.toJson(QJsonDocument::Compact) + '\n');
+
+    state_mirror->record(name, state);
+}
 
 void mp::Daemon::update_metadata_for(const std::string& name, const QJsonObject& metadata)
 {
     vm_instance_specs[name].metadata = metadata;
 
-    persist_instances();
+    // Each instance's metadata lives in its own record file, so an update rewrites one
+    // small file instead of re-serialising the whole instance database
+    QDir data_dir{
+        mp::utils::backend_directory_path(config->data_directory, config->factory->get_backend_directory_name())};
+    data_dir.mkpath(instance_metadata_dir_name);
+    QSaveFile metadata_file{
+        data_dir.filePath(QString{"%1/%2.json"}.arg(instance_metadata_dir_name, QString::fromStdString(name)))};
+    if (metadata_file.open(QIODevice::WriteOnly))
+    {
+        metadata_file.write(QJsonDocument{metadata}.toJson(QJsonDocument::Compact));
+        metadata_file.commit();
+    }
 }
 
 QJsonObject mp::Daemon::retrieve_metadata_for(const std::string& name)
@@ -1948,6 +3087,8 @@ QJsonArray to_json_array(const std::vector<mp::NetworkInterface>& extra_interfac
 
 void mp::Daemon::persist_instances()
 {
+    ++list_generation; // the roster itself may have changed, not just a state
+
     auto vm_spec_to_json = [](const mp::VMSpecs& specs) -> QJsonObject {
         QJsonObject json;
         json.insert("num_cores", specs.num_cores);
@@ -1957,6 +3098,8 @@ void mp::Daemon::persist_instances()
         json.insert("state", static_cast<int>(specs.state));
         json.insert("deleted", specs.deleted);
         json.insert("metadata", specs.metadata);
+        json.insert("cpuset", QString::fromStdString(specs.cpuset));
+        json.insert("cpu_model", QString::fromStdString(specs.cpu_model));
 
         // Write the networking information. Write first a field "mac_addr" containing the MAC address of the
         // default network interface. Then, write all the information about the rest of the interfaces.
@@ -2008,12 +3151,35 @@ void mp::Daemon::persist_instances()
     QDir data_dir{
         mp::utils::backend_directory_path(config->data_directory, config->factory->get_backend_directory_name())};
     mp::write_json(instance_records_json, data_dir.filePath(instance_db_name));
+
+    // A full write makes all journaled state changes durable; compact the journal.
+    persist_instances_task.stop();
+    QFile::remove(data_dir.filePath(instance_journal_name));
+}
+
+void mp::Daemon::note_instance_activity(const std::string& name)
+{
+    last_activity[name] = std::chrono::steady_clock::now();
+
+    auto it = vm_instances.find(name);
+    if (it != vm_instances.end())
+        it->second->restore_reclaimed_memory();
 }
 
 void mp::Daemon::release_resources(const std::string& instance)
 {
+    ssh_session_pool.drop_session_for(instance);
+    state_mirror->forget(instance);
     config->factory->remove_resources_for(instance);
     config->vault->remove(instance);
+    release_cache.erase(instance);
+    ipv4_cache.erase(instance);
+    last_activity.erase(instance);
+    {
+        const std::lock_guard<std::mutex> lock{guest_metrics_mutex};
+        guest_metrics_cache.erase(instance);
+    }
+    deferred_vm_descs.erase(instance);
 
     auto spec_it = vm_instance_specs.find(instance);
     if (spec_it != cend(vm_instance_specs))
@@ -2023,23 +3189,54 @@ void mp::Daemon::release_resources(const std::string& instance)
 
         vm_instance_specs.erase(spec_it);
     }
+
+    used_names_filter.remove(instance);
+
+    QDir data_dir{
+        mp::utils::backend_directory_path(config->data_directory, config->factory->get_backend_directory_name())};
+    QFile::remove(data_dir.filePath(QString{"%1/%2.json"}.arg(instance_metadata_dir_name,
+                                                              QString::fromStdString(instance))));
+}
+
+void mp::Daemon::materialize_deferred_instance(const std::string& name)
+{
+    auto it = deferred_vm_descs.find(name);
+    if (it == deferred_vm_descs.end())
+        return;
+
+    const auto& spec = vm_instance_specs.at(name);
+    auto& instance_record = spec.deleted ? deleted_instances : vm_instances;
+    instance_record[name] = config->factory->create_virtual_machine(it->second, *this);
+    deferred_vm_descs.erase(it);
 }
 
-std::string mp::Daemon::check_instance_operational(const std::string& instance_name) const
+void mp::Daemon::materialize_all_deferred_instances()
 {
-    if (vm_instances.find(instance_name) == std::cend(vm_instances))
+    for (auto it = deferred_vm_descs.begin(); it != deferred_vm_descs.end();)
     {
-        if (deleted_instances.find(instance_name) == std::cend(deleted_instances))
-            return fmt::format("instance \"{}\" does not exist\n", instance_name);
-        else
-            return fmt::format("instance \"{}\" is deleted\n", instance_name);
+        const auto name = it++->first; // materializing erases the entry, so advance first
+        try
+        {
+            materialize_deferred_instance(name);
+        }
+        catch (const std::exception& e)
+        {
+            mpl::log(mpl::Level::error, category, fmt::format("Failed to reconstruct instance {}: {}", name, e.what()));
+        }
     }
-
-    return {};
 }
 
-std::string mp::Daemon::check_instance_exists(const std::string& instance_name) const
+std::string mp::Daemon::check_instance_exists(const std::string& instance_name)
 {
+    try
+    {
+        materialize_deferred_instance(instance_name);
+    }
+    catch (const std::exception& e)
+    {
+        return fmt::format("instance \"{}\" could not be reconstructed: {}\n", instance_name, e.what());
+    }
+
     if (vm_instances.find(instance_name) == std::cend(vm_instances) &&
         deleted_instances.find(instance_name) == std::cend(deleted_instances))
         return fmt::format("instance \"{}\" does not exist\n", instance_name);
@@ -2047,9 +3244,56 @@ std::string mp::Daemon::check_instance_exists(const std::string& instance_name)
     return {};
 }
 
+auto mp::Daemon::resolve_instances(const google::protobuf::RepeatedPtrField<std::string>& names)
+    -> std::pair<std::vector<InstanceHandle>, grpc::Status>
+{
+    fmt::memory_buffer errors;
+    std::vector<InstanceHandle> handles;
+
+    if (names.empty())
+    { // target all instances
+        materialize_all_deferred_instances();
+        handles.reserve(vm_instances.size());
+        for (const auto& item : vm_instances)
+            handles.push_back({item.first, item.second});
+    }
+    else
+    {
+        handles.reserve(names.size());
+        for (const auto& name : names)
+        {
+            try
+            {
+                materialize_deferred_instance(name);
+            }
+            catch (const std::exception& e)
+            {
+                fmt::format_to(errors, "instance \"{}\" could not be reconstructed: {}\n", name, e.what());
+                continue;
+            }
+
+            if (auto it = vm_instances.find(name); it != vm_instances.end())
+                handles.push_back({name, it->second});
+            else if (deleted_instances.find(name) == std::cend(deleted_instances))
+                fmt::format_to(errors, "instance \"{}\" does not exist\n", name);
+            else
+                fmt::format_to(errors, "instance \"{}\" is deleted\n", name);
+        }
+    }
+
+    auto status = grpc_status_for(errors);
+    if (!status.ok())
+        handles.clear();
+
+    return {std::move(handles), status};
+}
+
 void mp::Daemon::create_vm(const CreateRequest* request, grpc::ServerWriter<CreateReply>* server,
                            std::promise<grpc::Status>* status_promise, bool start)
 {
+    const auto launch_t0 = std::chrono::steady_clock::now();
+    const auto timing = request->timing();
+
     auto checked_args = validate_create_arguments(request, *config->factory);
 
     if (!checked_args.option_errors.error_codes().empty())
@@ -2058,9 +3302,51 @@ void mp::Daemon::create_vm(const CreateRequest* request, grpc::ServerWriter<Crea
                                                       checked_args.option_errors.SerializeAsString()));
     }
 
-    auto name = name_from(checked_args.instance_name, *config->name_generator, vm_instances);
+    // Fan a multi-instance request out into independent single launches: the vault
+    // coalesces their concurrent fetches into one download/verify/prepare pass, so the
+    // instances only diverge at the per-instance copy, which runs in parallel
+    if (request->count() > 1)
+    {
+        struct FleetLaunch
+        {
+            std::vector<std::unique_ptr<CreateRequest>> requests;
+            std::vector<std::unique_ptr<std::promise<grpc::Status>>> promises;
+        };
+        auto fleet = std::make_shared<FleetLaunch>();
+
+        for (auto i = 0; i < request->count(); ++i)
+        {
+            auto instance_request = std::make_unique<CreateRequest>(*request);
+            instance_request->set_count(1);
+            if (!request->instance_name().empty())
+                instance_request->set_instance_name(fmt::format("{}-{}", request->instance_name(), i + 1));
+
+            fleet->requests.push_back(std::move(instance_request));
+            fleet->promises.push_back(std::make_unique<std::promise<grpc::Status>>());
+        }
+
+        for (auto i = std::size_t{0}; i < fleet->requests.size(); ++i)
+            create_vm(fleet->requests[i].get(), server, fleet->promises[i].get(), start);
+
+        auto future_watcher = create_future_watcher();
+        future_watcher->setFuture(QtConcurrent::run(&async_task_pool, [fleet, status_promise] {
+            fmt::memory_buffer errors;
+            for (auto& promise : fleet->promises)
+            {
+                auto status = promise->get_future().get();
+                if (!status.ok())
+                    fmt::format_to(errors, "{}\n", status.error_message());
+            }
+
+            return AsyncOperationStatus{grpc_status_for(errors), status_promise};
+        }));
+        return;
+    }
+
+    auto name = name_from(checked_args.instance_name, *config->name_generator, used_names_filter);
 
-    if (vm_instances.find(name) != vm_instances.end() || deleted_instances.find(name) != deleted_instances.end())
+    if (vm_instances.find(name) != vm_instances.end() || deleted_instances.find(name) != deleted_instances.end() ||
+        deferred_vm_descs.find(name) != deferred_vm_descs.end())
     {
         CreateError create_error;
         create_error.add_error_codes(CreateError::INSTANCE_EXISTS);
@@ -2080,16 +3366,133 @@ void mp::Daemon::create_vm(const CreateRequest* request, grpc::ServerWriter<Crea
                                                       create_error.SerializeAsString()));
     }
 
+    // Adopt a pre-booted warm-pool instance when the request matches the defaults the
+    // pool was built with; the instance keeps the name it booted under
+    if (start && !warm_instances.empty() && wants_default_launch(request))
+    {
+        auto warm_it = warm_instances.begin();
+        const auto warm_name = warm_it->first;
+
+        mpl::log(mpl::Level::info, category, fmt::format("Adopting warm instance \"{}\"", warm_name));
+
+        vm_instances[warm_name] = warm_it->second;
+        vm_instance_specs[warm_name] = warm_instance_specs.at(warm_name);
+        warm_instances.erase(warm_it);
+        warm_instance_specs.erase(warm_name);
+        persist_instances();
+        persist_warm_instance_names();
+
+        QTimer::singleShot(0, this, &Daemon::replenish_warm_pool);
+
+        LaunchReply reply;
+        reply.set_create_message("Starting " + warm_name);
+        synchronized_write(server, reply);
+
+        auto future_watcher = create_future_watcher([this, server, warm_name, timing, launch_t0] {
+            LaunchReply reply;
+            reply.set_vm_instance_name(warm_name);
+            config->update_prompt->populate_if_time_to_show(reply.mutable_update_info());
+            if (timing)
+                reply.set_timing_breakdown(format_timing_breakdown(launch_t0));
+            synchronized_write(server, reply);
+        });
+        future_watcher->setFuture(QtConcurrent::run(&async_task_pool, this,
+                                                    &Daemon::async_wait_for_ready_all<LaunchReply>, server,
+                                                    std::vector<std::string>{warm_name}, status_promise));
+        return;
+    }
+
     if (!instances_running(vm_instances))
         config->factory->hypervisor_health_check();
 
+    // Admission control: starting beyond the host's envelope makes the whole fleet
+    // thrash, so launches that would overcommit wait for capacity instead of piling on
+    const auto requested_cpus = std::max(request->num_cores(), 1);
+    const auto requested_mem = static_cast<long long>(checked_args.mem_size.in_bytes());
+    if (start)
+    {
+        const auto host_mem = host_memory_bytes();
+        const auto committed = committed_host_resources();
+        const auto mem_fits = host_mem == 0 || committed.memory_bytes + admission_reserved.memory_bytes +
+                                                       requested_mem + host_memory_reserve_bytes <=
+                                                   host_mem;
+        const auto cpus_fit = committed.cpus + admission_reserved.cpus + requested_cpus <=
+                              cpu_overcommit_factor * QThread::idealThreadCount();
+
+        if (!mem_fits || !cpus_fit)
+        {
+            // The rest of the federation may have room even when this host does not, so
+            // each capacity pass first offers the launch to the peer advertising the most
+            // headroom, and only keeps waiting when no peer can take it either. The
+            // headroom probe and the relay block on the network, so both run off-thread;
+            // bookkeeping hops back to the daemon thread.
+            if (!peer_daemons.empty())
+            {
+                QtConcurrent::run(&async_task_pool, [this, request, server, status_promise, start, requested_cpus,
+                                                     requested_mem, name] {
+                    const auto target = peer_daemons.best_peer_for(requested_cpus, requested_mem);
+                    if (!target.empty())
+                    {
+                        QTimer::singleShot(0, this, [this, request] { waiting_admissions.erase(request); });
+                        mpl::log(mpl::Level::info, category,
+                                 fmt::format("routing launch of \"{}\" to peer {}", name, target));
+                        status_promise->set_value(peer_daemons.relay_launch(target, *request, server));
+                        return;
+                    }
+
+                    // No room anywhere yet; announce that once, then keep rechecking both
+                    // the local envelope and the peers
+                    QTimer::singleShot(0, this, [this, request, server, status_promise, start, name] {
+                        if (waiting_admissions.insert(request).second)
+                        {
+                            mpl::log(mpl::Level::info, category,
+                                     fmt::format("federation is at capacity; queueing launch of \"{}\"", name));
+
+                            CreateReply reply;
+                            reply.set_create_message("Waiting for host capacity to launch " + name);
+                            synchronized_write(server, reply);
+                        }
+
+                        QTimer::singleShot(admission_retry_interval_ms, this,
+                                           [this, request, server, status_promise, start] {
+                                               create_vm(request, server, status_promise, start);
+                                           });
+                    });
+                });
+                return;
+            }
+
+            if (waiting_admissions.insert(request).second)
+            {
+                mpl::log(mpl::Level::info, category,
+                         fmt::format("host is at capacity; queueing launch of \"{}\" ({} cpus, {} bytes)", name,
+                                     requested_cpus, requested_mem));
+
+                CreateReply reply;
+                reply.set_create_message("Waiting for host capacity to launch " + name);
+                synchronized_write(server, reply);
+            }
+
+            QTimer::singleShot(admission_retry_interval_ms, this, [this, request, server, status_promise, start] {
+                create_vm(request, server, status_promise, start);
+            });
+            return;
+        }
+
+        waiting_admissions.erase(request);
+        admission_reserved.cpus += requested_cpus;
+        admission_reserved.memory_bytes += requested_mem;
+    }
+
     preparing_instances.insert(name);
+    used_names_filter.add(name);
 
     auto prepare_future_watcher = new QFutureWatcher<VirtualMachineDescription>();
 
     QObject::connect(
         prepare_future_watcher, &QFutureWatcher<VirtualMachineDescription>::finished,
-        [this, server, status_promise, name, start, prepare_future_watcher] {
+        [this, server, status_promise, name, start, prepare_future_watcher, timing, launch_t0, requested_cpus,
+         requested_mem] {
             try
             {
                 auto vm_desc = prepare_future_watcher->future().result();
@@ -2103,7 +3506,9 @@ void mp::Daemon::create_vm(const CreateRequest* request, grpc::ServerWriter<Crea
                                            VirtualMachine::State::off,
                                            {},
                                            false,
-                                           QJsonObject()};
+                                           QJsonObject(),
+                                           vm_desc.cpuset,
+                                           vm_desc.cpu_model};
                 vm_instances[name] = config->factory->create_virtual_machine(vm_desc, *this);
                 preparing_instances.erase(name);
 
@@ -2113,18 +3518,22 @@ void mp::Daemon::create_vm(const CreateRequest* request, grpc::ServerWriter<Crea
                 {
                     LaunchReply reply;
                     reply.set_create_message("Starting " + name);
-                    server->Write(reply);
+                    synchronized_write(server, reply);
 
                     auto& vm = vm_instances[name];
                     vm->start();
 
-                    auto future_watcher = create_future_watcher([this, server, name] {
+                    auto future_watcher = create_future_watcher([this, server, name, timing, launch_t0,
+                                                                 requested_cpus, requested_mem] {
+                        release_admission(requested_cpus, requested_mem); // now counted as running
                         LaunchReply reply;
                         reply.set_vm_instance_name(name);
                         config->update_prompt->populate_if_time_to_show(reply.mutable_update_info());
-                        server->Write(reply);
+                        if (timing)
+                            reply.set_timing_breakdown(format_timing_breakdown(launch_t0));
+                        synchronized_write(server, reply);
                     });
-                    future_watcher->setFuture(QtConcurrent::run(this, &Daemon::async_wait_for_ready_all<LaunchReply>,
+                    future_watcher->setFuture(QtConcurrent::run(&async_task_pool, this, &Daemon::async_wait_for_ready_all<LaunchReply>,
                                                                 server, std::vector<std::string>{name},
                                                                 status_promise));
                 }
@@ -2135,6 +3544,8 @@ void mp::Daemon::create_vm(const CreateRequest* request, grpc::ServerWriter<Crea
             }
             catch (const std::exception& e)
             {
+                if (start)
+                    release_admission(requested_cpus, requested_mem);
                 preparing_instances.erase(name);
                 release_resources(name);
                 vm_instances.erase(name);
@@ -2150,17 +3561,24 @@ void mp::Daemon::create_vm(const CreateRequest* request, grpc::ServerWriter<Crea
         {
             auto query = query_from(request, name);
 
-            auto progress_monitor = [server](int progress_type, int percentage) {
+            // the downloader reports per network chunk, mostly repeating the same integer
+            // percentage; only changes are worth a stream write
+            auto progress_monitor = [server, last_write = std::make_pair(-1, -2)](int progress_type,
+                                                                                  int percentage) mutable {
+                if (last_write == std::make_pair(progress_type, percentage))
+                    return true;
+                last_write = {progress_type, percentage};
+
                 CreateReply create_reply;
                 create_reply.mutable_launch_progress()->set_percent_complete(std::to_string(percentage));
                 create_reply.mutable_launch_progress()->set_type((CreateProgress::ProgressTypes)progress_type);
-                return server->Write(create_reply);
+                return synchronized_write(server, create_reply);
             };
 
             auto prepare_action = [this, server, &name](const VMImage& source_image) -> VMImage {
                 CreateReply reply;
                 reply.set_create_message("Preparing image for " + name);
-                server->Write(reply);
+                synchronized_write(server, reply);
 
                 return config->factory->prepare_source_image(source_image);
             };
@@ -2169,7 +3587,54 @@ void mp::Daemon::create_vm(const CreateRequest* request, grpc::ServerWriter<Crea
 
             CreateReply reply;
             reply.set_create_message("Creating " + name);
-            server->Write(reply);
+            synchronized_write(server, reply);
+
+            // MAC assignment and the cloud-init payload only depend on the request, so
+            // build them while the image is fetched and prepared
+            struct LaunchSideConfig
+            {
+                std::unordered_set<std::string> new_macs;
+                std::string default_mac_addr;
+                std::vector<NetworkInterface> extra_interfaces;
+                YAML::Node meta_data;
+                YAML::Node user_data;
+                YAML::Node vendor_data;
+                std::string network_data;
+            };
+
+            auto side_config_future = std::async(std::launch::async, [this, request, checked_args, name] {
+                LaunchSideConfig side;
+
+                // This set stores the MAC's which need to be in the allocated_mac_addrs if everything goes well.
+                {
+                    std::lock_guard<std::mutex> lock{mac_addrs_mutex};
+                    side.new_macs = allocated_mac_addrs;
+                }
+                side.extra_interfaces = checked_args.extra_interfaces;
+
+                // check for repetition of requested macs
+                for (auto& iface : side.extra_interfaces)
+                    if (!iface.mac_address.empty() && !side.new_macs.insert(iface.mac_address).second)
+                        throw std::runtime_error(fmt::format("Repeated MAC address {}", iface.mac_address));
+
+                // generate missing macs in a second pass, to avoid repeating macs that the user requested
+                for (auto& iface : side.extra_interfaces)
+                    if (iface.mac_address.empty())
+                        iface.mac_address = generate_unused_mac_address(side.new_macs);
+
+                side.default_mac_addr = generate_unused_mac_address(side.new_macs);
+                side.vendor_data =
+                    make_cloud_init_vendor_config(*config->ssh_key_provider, request->time_zone(),
+                                                  config->ssh_username,
+                                                  config->factory->get_backend_version_string().toStdString());
+                side.meta_data = make_cloud_init_meta_config(name);
+                side.user_data = YAML::Load(request->cloud_init_user_data());
+                prepare_user_data(side.user_data, side.vendor_data);
+                side.network_data = make_cloud_init_network_config(side.default_mac_addr, side.extra_interfaces);
+
+                return side;
+            });
+
             auto vm_image = config->vault->fetch_image(fetch_type, query, prepare_action, progress_monitor);
 
             const auto image_size = config->vault->minimum_image_size_for(vm_image.id);
@@ -2177,41 +3642,37 @@ void mp::Daemon::create_vm(const CreateRequest* request, grpc::ServerWriter<Crea
                 compute_final_image_size(image_size, checked_args.disk_space, config->data_directory);
 
             reply.set_create_message("Configuring " + name);
-            server->Write(reply);
+            synchronized_write(server, reply);
 
-            // This set stores the MAC's which need to be in the allocated_mac_addrs if everything goes well.
-            auto new_macs = allocated_mac_addrs;
+            auto side = side_config_future.get();
 
-            // check for repetition of requested macs
-            for (auto& iface : checked_args.extra_interfaces)
-                if (!iface.mac_address.empty() && !new_macs.insert(iface.mac_address).second)
-                    throw std::runtime_error(fmt::format("Repeated MAC address {}", iface.mac_address));
+            const auto instance_dir = mp::utils::base_dir(vm_image.image_path);
+            const auto cloud_init_iso = instance_dir.filePath("cloud-init-config.iso");
 
-            // generate missing macs in a second pass, to avoid repeating macs that the user requested
-            for (auto& iface : checked_args.extra_interfaces)
-                if (iface.mac_address.empty())
-                    iface.mac_address = generate_unused_mac_address(new_macs);
-
-            auto default_mac_addr = generate_unused_mac_address(new_macs);
-            auto vendor_data_cloud_init_config =
-                make_cloud_init_vendor_config(*config->ssh_key_provider, request->time_zone(), config->ssh_username,
-                                              config->factory->get_backend_version_string().toStdString());
-            auto meta_data_cloud_init_config = make_cloud_init_meta_config(name);
-            auto user_data_cloud_init_config = YAML::Load(request->cloud_init_user_data());
-            prepare_user_data(user_data_cloud_init_config, vendor_data_cloud_init_config);
+            auto vm_desc = to_machine_desc(request, name, checked_args.mem_size, disk_space, side.default_mac_addr,
+                                           side.extra_interfaces, config->ssh_username, vm_image, cloud_init_iso,
+                                           side.meta_data, side.user_data, side.vendor_data, side.network_data);
 
-            auto network_data_cloud_init_config =
-                make_cloud_init_network_config(default_mac_addr, checked_args.extra_interfaces);
+            const QDir iso_cache_dir{mp::utils::make_dir(config->cache_directory, "cloud-init-isos")};
 
-            auto vm_desc = to_machine_desc(request, name, checked_args.mem_size, disk_space, default_mac_addr,
-                                           checked_args.extra_interfaces, config->ssh_username, vm_image,
-                                           meta_data_cloud_init_config, user_data_cloud_init_config,
-                                           vendor_data_cloud_init_config, network_data_cloud_init_config);
+            // The ISO and the instance image are different files, so write one while the
+            // backend resizes the other
+            auto iso_future = std::async(std::launch::async, [&name, &instance_dir, &iso_cache_dir, &vm_desc] {
+                make_cloud_init_image(name, instance_dir, iso_cache_dir, vm_desc.meta_data_config,
+                                      vm_desc.user_data_config, vm_desc.vendor_data_config,
+                                      vm_desc.network_data_config);
+            });
 
             config->factory->prepare_instance_image(vm_image, vm_desc);
 
-            // Everything went well, add the MAC addresses used in this instance.
-            allocated_mac_addrs = std::move(new_macs);
+            iso_future.get();
+
+            // Everything went well, add the MAC addresses used in this instance. Merge
+            // rather than replace: parallel launches each commit their own additions.
+            {
+                std::lock_guard<std::mutex> lock{mac_addrs_mutex};
+                allocated_mac_addrs.insert(side.new_macs.begin(), side.new_macs.end());
+            }
             return vm_desc;
         }
         catch (const std::exception& e)
@@ -2220,7 +3681,158 @@ void mp::Daemon::create_vm(const CreateRequest* request, grpc::ServerWriter<Crea
         }
     };
 
-    prepare_future_watcher->setFuture(QtConcurrent::run(make_vm_description));
+    prepare_future_watcher->setFuture(QtConcurrent::run(&async_task_pool, make_vm_description));
+}
+
+void mp::Daemon::replenish_warm_pool()
+{
+    while (static_cast<int>(warm_instances.size()) + warm_instances_preparing < warm_pool_size)
+    {
+        std::string name;
+        do
+        {
+            name = config->name_generator->make_name();
+        } while (used_names_filter.possibly_contains(name));
+
+        mpl::log(mpl::Level::info, category, fmt::format("Preparing warm instance \"{}\"", name));
+
+        ++warm_instances_preparing;
+        preparing_instances.insert(name);
+        used_names_filter.add(name);
+
+        auto watcher = new QFutureWatcher<VirtualMachineDescription>();
+        QObject::connect(watcher, &QFutureWatcher<VirtualMachineDescription>::finished, [this, name, watcher] {
+            try
+            {
+                auto vm_desc = watcher->future().result();
+
+                warm_instance_specs[name] = {vm_desc.num_cores,
+                                             vm_desc.mem_size,
+                                             vm_desc.disk_space,
+                                             vm_desc.default_mac_address,
+                                             vm_desc.extra_interfaces,
+                                             config->ssh_username,
+                                             VirtualMachine::State::off,
+                                             {},
+                                             false,
+                                             QJsonObject(),
+                                             vm_desc.cpuset,
+                                             vm_desc.cpu_model};
+                auto vm = config->factory->create_virtual_machine(vm_desc, *this);
+                vm->start();
+                warm_instances[name] = vm;
+                persist_warm_instance_names();
+            }
+            catch (const std::exception& e)
+            {
+                mpl::log(mpl::Level::warning, category,
+                         fmt::format("Failed to prepare warm instance \"{}\": {}", name, e.what()));
+                warm_instance_specs.erase(name);
+                release_resources(name);
+            }
+
+            preparing_instances.erase(name);
+            --warm_instances_preparing;
+            delete watcher;
+        });
+
+        auto make_warm_description = [this, name]() -> VirtualMachineDescription {
+            Query query{name, "default", false, "", Query::Type::Alias, true};
+
+            auto progress_monitor = [](int, int) { return true; };
+            auto prepare_action = [this](const VMImage& source_image) -> VMImage {
+                return config->factory->prepare_source_image(source_image);
+            };
+
+            auto vm_image =
+                config->vault->fetch_image(config->factory->fetch_type(), query, prepare_action, progress_monitor);
+
+            const auto image_size = config->vault->minimum_image_size_for(vm_image.id);
+            const auto disk_space = compute_final_image_size(image_size, mp::nullopt, config->data_directory);
+
+            std::unordered_set<std::string> new_macs;
+            {
+                std::lock_guard<std::mutex> lock{mac_addrs_mutex};
+                new_macs = allocated_mac_addrs;
+            }
+            auto default_mac_addr = generate_unused_mac_address(new_macs);
+
+            auto vendor_data = make_cloud_init_vendor_config(
+                *config->ssh_key_provider, QTimeZone::systemTimeZoneId().toStdString(), config->ssh_username,
+                config->factory->get_backend_version_string().toStdString());
+            auto meta_data = make_cloud_init_meta_config(name);
+            auto user_data = YAML::Load("");
+            prepare_user_data(user_data, vendor_data);
+            auto network_data = make_cloud_init_network_config(default_mac_addr, std::vector<NetworkInterface>{});
+
+            const auto instance_dir = mp::utils::base_dir(vm_image.image_path);
+            const QDir iso_cache_dir{mp::utils::make_dir(config->cache_directory, "cloud-init-isos")};
+            const auto cloud_init_iso = make_cloud_init_image(name, instance_dir, iso_cache_dir, meta_data, user_data,
+                                                              vendor_data, network_data);
+
+            VirtualMachineDescription vm_desc{std::stoi(mp::default_cpu_cores),
+                                              MemorySize{mp::default_memory_size},
+                                              disk_space,
+                                              name,
+                                              default_mac_addr,
+                                              {},
+                                              config->ssh_username,
+                                              vm_image,
+                                              cloud_init_iso,
+                                              meta_data,
+                                              user_data,
+                                              vendor_data,
+                                              network_data};
+
+            config->factory->prepare_instance_image(vm_image, vm_desc);
+
+            // Merge rather than replace: launches commit their own MACs concurrently
+            {
+                std::lock_guard<std::mutex> lock{mac_addrs_mutex};
+                allocated_mac_addrs.insert(default_mac_addr);
+            }
+            return vm_desc;
+        };
+
+        watcher->setFuture(QtConcurrent::run(&background_task_pool, make_warm_description));
+    }
+}
+
+void mp::Daemon::persist_warm_instance_names()
+{
+    QJsonArray names;
+    for (const auto& entry : warm_instances)
+        names.append(QString::fromStdString(entry.first));
+
+    QDir data_dir{
+        mp::utils::backend_directory_path(config->data_directory, config->factory->get_backend_directory_name())};
+    QFile db_file{data_dir.filePath(warm_instances_db_name)};
+    if (db_file.open(QIODevice::WriteOnly))
+        db_file.write(QJsonDocument{names}.toJson(QJsonDocument::Compact));
+}
+
+void mp::Daemon::purge_stale_warm_instances()
+{
+    // Warm instances do not survive a daemon restart; reclaim whatever the previous run
+    // left behind before building the pool afresh
+    QDir data_dir{
+        mp::utils::backend_directory_path(config->data_directory, config->factory->get_backend_directory_name())};
+    QFile db_file{data_dir.filePath(warm_instances_db_name)};
+    if (!db_file.open(QIODevice::ReadOnly))
+        return;
+
+    for (const auto& entry : QJsonDocument::fromJson(db_file.readAll()).array())
+    {
+        auto name = entry.toString().toStdString();
+        if (name.empty() || vm_instances.count(name) || deleted_instances.count(name) ||
+            deferred_vm_descs.count(name))
+            continue;
+
+        mpl::log(mpl::Level::info, category, fmt::format("Removing stale warm instance \"{}\"", name));
+        release_resources(name);
+    }
+
+    db_file.remove();
 }
 
 grpc::Status mp::Daemon::reboot_vm(VirtualMachine& vm)
@@ -2232,7 +3844,7 @@ grpc::Status mp::Daemon::reboot_vm(VirtualMachine& vm)
         return grpc::Status{grpc::StatusCode::INVALID_ARGUMENT,
                             fmt::format("instance \"{}\" is not running", vm.vm_name), ""};
 
-    mpl::log(mpl::Level::debug, category, fmt::format("Rebooting {}", vm.vm_name));
+    mpl::log(mpl::Level::debug, category, "Rebooting {}", vm.vm_name);
     return ssh_reboot(vm.ssh_hostname(), vm.ssh_port(), vm.ssh_username(), *config->ssh_key_provider);
 }
 
@@ -2269,11 +3881,66 @@ grpc::Status mp::Daemon::shutdown_vm(VirtualMachine& vm, const std::chrono::mill
         shutdown_timer->start(delay);
     }
     else
-        mpl::log(mpl::Level::debug, category, fmt::format("instance \"{}\" does not need stopping", name));
+        mpl::log(mpl::Level::debug, category, "instance \"{}\" does not need stopping", name);
 
     return grpc::Status::OK;
 }
 
+grpc::Status mp::Daemon::shutdown_vms_now(const std::vector<InstanceHandle>& tgts)
+{
+    using St = VirtualMachine::State;
+    const auto skip_states = {St::off, St::stopped, St::suspended};
+
+    // An immediate stop spends almost all of its time waiting on the guest's ACPI
+    // handshake, so every shutdown is dispatched before any completion is collected;
+    // daemon-side bookkeeping stays on this thread.
+    std::vector<std::pair<std::string, std::future<void>>> pending_shutdowns;
+    for (const auto& tgt : tgts)
+    {
+        const auto& vm = tgt.vm;
+        const auto& state = vm->current_state();
+
+        if (std::none_of(cbegin(skip_states), cend(skip_states), [&state](const auto& st) { return state == st; }))
+        {
+            delayed_shutdown_instances.erase(tgt.name);
+            instance_mounts.stop_all_mounts_for_instance(tgt.name);
+
+            pending_shutdowns.emplace_back(tgt.name, std::async(std::launch::async, [this, vm] {
+                try
+                {
+                    mp::SSHSession session{vm->ssh_hostname(), vm->ssh_port(), vm->ssh_username(),
+                                           *config->ssh_key_provider};
+                    session.exec("wall The system is going down for poweroff now");
+                }
+                catch (const std::exception& e)
+                {
+                    mpl::log(mpl::Level::info, category,
+                             fmt::format("Cannot open ssh session on \"{}\" shutdown: {}", vm->vm_name, e.what()));
+                }
+
+                vm->shutdown();
+            }));
+        }
+        else
+            mpl::log(mpl::Level::debug, category, "instance \"{}\" does not need stopping", tgt.name);
+    }
+
+    fmt::memory_buffer errors;
+    for (auto& pending : pending_shutdowns)
+    {
+        try
+        {
+            pending.second.get();
+        }
+        catch (const std::exception& e)
+        {
+            fmt::format_to(errors, "error stopping instance \"{}\": {}\n", pending.first, e.what());
+        }
+    }
+
+    return grpc_status_for(errors);
+}
+
 grpc::Status mp::Daemon::cancel_vm_shutdown(const VirtualMachine& vm)
 {
     auto it = delayed_shutdown_instances.find(vm.vm_name);
@@ -2286,13 +3953,13 @@ grpc::Status mp::Daemon::cancel_vm_shutdown(const VirtualMachine& vm)
     return grpc::Status::OK;
 }
 
-grpc::Status mp::Daemon::cmd_vms(const std::vector<std::string>& tgts, std::function<grpc::Status(VirtualMachine&)> cmd)
+grpc::Status mp::Daemon::cmd_vms(const std::vector<InstanceHandle>& tgts, std::function<grpc::Status(VirtualMachine&)> cmd)
 { /* TODO: use this in commands, rather than repeating the same logic.
   std::function involves some overhead, but it should be negligible here and
   it gives clear error messages on type mismatch (!= templated callable). */
     for (const auto& tgt : tgts)
     {
-        const auto st = cmd(*vm_instances.at(tgt));
+        const auto st = cmd(*tgt.vm);
         if (!st.ok())
             return st; // Fail early
     }
@@ -2300,6 +3967,28 @@ grpc::Status mp::Daemon::cmd_vms(const std::vector<std::string>& tgts, std::func
     return grpc::Status::OK;
 }
 
+mp::Daemon::HostCommitment mp::Daemon::committed_host_resources()
+{
+    HostCommitment committed;
+    for (const auto& instance : vm_instances)
+    {
+        if (!mp::utils::is_running(instance.second->current_state()))
+            continue;
+
+        const auto& spec = vm_instance_specs[instance.first];
+        committed.cpus += std::max(spec.num_cores, 1);
+        committed.memory_bytes += static_cast<long long>(spec.mem_size.in_bytes());
+    }
+
+    return committed;
+}
+
+void mp::Daemon::release_admission(int cpus, long long memory_bytes)
+{
+    admission_reserved.cpus = std::max(0, admission_reserved.cpus - cpus);
+    admission_reserved.memory_bytes = std::max(0LL, admission_reserved.memory_bytes - memory_bytes);
+}
+
 QFutureWatcher<mp::Daemon::AsyncOperationStatus>*
 mp::Daemon::create_future_watcher(std::function<void()> const& finished_op)
 {
@@ -2332,7 +4021,7 @@ error_string mp::Daemon::async_wait_for_ssh_and_start_mounts_for(const std::stri
             {
                 Reply reply;
                 reply.set_reply_message("Waiting for initialization to complete");
-                server->Write(reply);
+                synchronized_write(server, reply);
             }
 
             mp::utils::wait_for_cloud_init(vm.get(), cloud_init_timeout, *config->ssh_key_provider);
@@ -2341,16 +4030,54 @@ error_string mp::Daemon::async_wait_for_ssh_and_start_mounts_for(const std::stri
         std::vector<std::string> invalid_mounts;
         auto& mounts = vm_instance_specs[name].mounts;
         auto& vm_specs = vm_instance_specs[name];
-        for (const auto& mount_entry : mounts)
+
+        // Opt-in: carry all of this instance's mounts in a single sshfs_server process
+        const auto consolidate = mounts.size() > 1 && qEnvironmentVariableIsSet("MULTIPASS_CONSOLIDATED_MOUNTS");
+        std::vector<mp::SSHFSMounts::MountSpec> mount_specs;
+        if (consolidate)
+            for (const auto& mount_entry : mounts)
+                mount_specs.push_back({mount_entry.second.source_path, mount_entry.first, mount_entry.second.gid_map,
+                                       mount_entry.second.uid_map});
+
+        // Launch every mount's sshfs_server before waiting on any handshake, so that
+        // bring-up costs the slowest mount rather than the sum over all of them
+        std::vector<mp::SSHFSMounts::PendingMountPtr> pending_mounts;
+        if (consolidate)
+        {
+            try
+            {
+                pending_mounts.push_back(instance_mounts.launch_consolidated_mount_process(vm.get(), mount_specs));
+            }
+            catch (const std::exception& e)
+            {
+                fmt::format_to(errors, "Mounting for \"{}\": {}\n", name, e.what());
+            }
+        }
+        else
+            for (const auto& mount_entry : mounts)
+            {
+                auto& target_path = mount_entry.first;
+                try
+                {
+                    pending_mounts.push_back(instance_mounts.launch_mount_process(
+                        vm.get(), mount_entry.second.source_path, target_path, mount_entry.second.gid_map,
+                        mount_entry.second.uid_map));
+                }
+                catch (const std::exception& e)
+                {
+                    fmt::format_to(errors, "Removing \"{}\": {}\n", target_path, e.what());
+                    invalid_mounts.push_back(target_path);
+                }
+            }
+
+        for (auto& pending : pending_mounts)
         {
-            auto& target_path = mount_entry.first;
-            auto& source_path = mount_entry.second.source_path;
-            auto& uid_map = mount_entry.second.uid_map;
-            auto& gid_map = mount_entry.second.gid_map;
+            const auto target_path = pending->target_path;
+            const auto& mount_spec = mounts.at(target_path);
 
             try
             {
-                instance_mounts.start_mount(vm.get(), source_path, target_path, gid_map, uid_map);
+                instance_mounts.wait_until_mount_ready(vm.get(), std::move(pending));
             }
             catch (const mp::SSHFSMissingError&)
             {
@@ -2360,13 +4087,18 @@ error_string mp::Daemon::async_wait_for_ssh_and_start_mounts_for(const std::stri
                     {
                         Reply reply;
                         reply.set_reply_message("Enabling support for mounting");
-                        server->Write(reply);
+                        synchronized_write(server, reply);
                     }
 
-                    mp::SSHSession session{vm->ssh_hostname(), vm->ssh_port(), vm_specs.ssh_username,
-                                           *config->ssh_key_provider};
-                    mp::utils::install_sshfs_for(name, session);
-                    instance_mounts.start_mount(vm.get(), source_path, target_path, gid_map, uid_map);
+                    auto pooled_session = ssh_session_pool.session_for(name, vm->ssh_hostname(), vm->ssh_port(),
+                                                                       vm_specs.ssh_username);
+                    mp::utils::install_sshfs_for(name, pooled_session.session);
+                    if (consolidate)
+                        instance_mounts.wait_until_mount_ready(
+                            vm.get(), instance_mounts.launch_consolidated_mount_process(vm.get(), mount_specs));
+                    else
+                        instance_mounts.start_mount(vm.get(), mount_spec.source_path, target_path, mount_spec.gid_map,
+                                                    mount_spec.uid_map);
                 }
                 catch (const mp::SSHFSMissingError&)
                 {
@@ -2406,8 +4138,24 @@ mp::Daemon::AsyncOperationStatus mp::Daemon::async_wait_for_ready_all(grpc::Serv
             }
             else
             {
-                auto future =
-                    QtConcurrent::run(this, &Daemon::async_wait_for_ssh_and_start_mounts_for<Reply>, name, server);
+                auto future = QtConcurrent::run(&async_task_pool, [this, name, server] {
+                    auto error = async_wait_for_ssh_and_start_mounts_for<Reply>(name, server);
+
+                    // Stream this instance's outcome as soon as it is known, so a batch
+                    // request reports per-instance completion instead of one aggregate
+                    // at the end
+                    if (server)
+                    {
+                        Reply reply;
+                        auto record = reply.mutable_instance_record();
+                        record->set_name(name);
+                        record->set_success(error.empty());
+                        record->set_error(error);
+                        synchronized_write(server, reply);
+                    }
+
+                    return error;
+                });
                 async_running_futures[name] = future;
                 start_synchronizer.addFuture(future);
             }
@@ -20,6 +20,9 @@
 
 #include "daemon_config.h"
 #include "daemon_rpc.h"
+#include "instance_state_mirror.h"
+#include "peer_daemons.h"
+#include "ssh_session_pool.h"
 
 #include <multipass/delayed_shutdown_timer.h>
 #include <multipass/memory_size.h>
@@ -27,9 +30,13 @@
 #include <multipass/network_interface.h>
 #include <multipass/sshfs_mount/sshfs_mounts.h>
 #include <multipass/virtual_machine.h>
+#include <multipass/virtual_machine_description.h>
 #include <multipass/vm_status_monitor.h>
 
+#include <array>
+#include <cstdint>
 #include <future>
+#include <limits>
 #include <memory>
 #include <mutex>
 #include <unordered_map>
@@ -37,6 +44,7 @@
 #include <vector>
 
 #include <QFutureWatcher>
+#include <QThreadPool>
 
 namespace multipass
 {
@@ -59,6 +67,8 @@ struct VMSpecs
     std::unordered_map<std::string, VMMount> mounts;
     bool deleted;
     QJsonObject metadata;
+    std::string cpuset;
+    std::string cpu_model; // CPU model profile ("host"/"portable"); empty means host passthrough
 };
 
 struct MetricsOptInData
@@ -67,12 +77,68 @@ struct MetricsOptInData
     int delay_opt_in_count;
 };
 
+// Constant-time membership pre-check for generated petnames, maintained incrementally
+// as instances come and go; the counting variant lets purged names be retired. A false
+// positive only costs another petname draw, while names that were added can never test
+// negative, so generation needs no walk over the rosters at any fleet size.
+class UsedNamesFilter
+{
+public:
+    void add(const std::string& name)
+    {
+        for (const auto idx : probes_for(name))
+            if (counters[idx] < max_count)
+                ++counters[idx];
+    }
+
+    void remove(const std::string& name)
+    {
+        // saturated counters stay put forever, keeping the filter conservative
+        for (const auto idx : probes_for(name))
+            if (counters[idx] > 0 && counters[idx] < max_count)
+                --counters[idx];
+    }
+
+    bool possibly_contains(const std::string& name) const
+    {
+        for (const auto idx : probes_for(name))
+            if (counters[idx] == 0)
+                return false;
+        return true;
+    }
+
+private:
+    static constexpr std::size_t num_counters = 1u << 16;
+    static constexpr auto max_count = std::numeric_limits<uint8_t>::max();
+
+    static std::array<std::size_t, 3> probes_for(const std::string& name)
+    {
+        // splitmix64-style remixing derives three independent probes from one hash
+        auto h = static_cast<uint64_t>(std::hash<std::string>{}(name));
+        std::array<std::size_t, 3> probes;
+        for (auto& probe : probes)
+        {
+            h += 0x9e3779b97f4a7c15ull;
+            auto z = h;
+            z = (z ^ (z >> 30)) * 0xbf58476d1ce4e9b5ull;
+            z = (z ^ (z >> 27)) * 0x94d049bb133111ebull;
+            probe = static_cast<std::size_t>((z ^ (z >> 31)) % num_counters);
+        }
+        return probes;
+    }
+
+    std::array<uint8_t, num_counters> counters{};
+};
+
 struct DaemonConfig;
 class Daemon : public QObject, public multipass::VMStatusMonitor
 {
     Q_OBJECT
 public:
     explicit Daemon(std::unique_ptr<const DaemonConfig> config);
+    // Quiesces the fleet within a time budget: all saves are started up front and run
+    // in parallel, with instances degraded to hard stops as the deadline approaches
+    ~Daemon();
     Daemon(const Daemon&) = delete;
     Daemon& operator=(const Daemon&) = delete;
 
@@ -99,12 +165,16 @@ public slots:
     virtual void find(const FindRequest* request, grpc::ServerWriter<FindReply>* response,
                       std::promise<grpc::Status>* status_promise);
 
-    virtual void info(const InfoRequest* request, grpc::ServerWriter<InfoReply>* response,
-                      std::promise<grpc::Status>* status_promise);
+    virtual void info(grpc::ServerContext* context, const InfoRequest* request,
+                      grpc::ServerWriter<InfoReply>* response, std::promise<grpc::Status>* status_promise);
 
     virtual void list(const ListRequest* request, grpc::ServerWriter<ListReply>* response,
                       std::promise<grpc::Status>* status_promise);
 
+    virtual void instance_names(const InstanceNamesRequest* request,
+                                grpc::ServerWriter<InstanceNamesReply>* response,
+                                std::promise<grpc::Status>* status_promise);
+
     virtual void networks(const NetworksRequest* request, grpc::ServerWriter<NetworksReply>* response,
                           std::promise<grpc::Status>* status_promise);
 
@@ -129,6 +199,15 @@ public slots:
     virtual void restart(const RestartRequest* request, grpc::ServerWriter<RestartReply>* response,
                          std::promise<grpc::Status>* status_promise);
 
+    virtual void snapshot(const SnapshotRequest* request, grpc::ServerWriter<SnapshotReply>* response,
+                          std::promise<grpc::Status>* status_promise);
+
+    virtual void restore(const RestoreRequest* request, grpc::ServerWriter<RestoreReply>* response,
+                         std::promise<grpc::Status>* status_promise);
+
+    virtual void clone(const CloneRequest* request, grpc::ServerWriter<CloneReply>* response,
+                       std::promise<grpc::Status>* status_promise);
+
     virtual void delet(const DeleteRequest* request, grpc::ServerWriter<DeleteReply>* response,
                        std::promise<grpc::Status>* status_promise);
 
@@ -138,17 +217,58 @@ public slots:
     virtual void version(const VersionRequest* request, grpc::ServerWriter<VersionReply>* response,
                          std::promise<grpc::Status>* status_promise);
 
+    virtual void watch(const WatchRequest* request, grpc::ServerWriter<WatchReply>* response,
+                       std::promise<grpc::Status>* status_promise);
+
+    virtual void console_log(const ConsoleLogRequest* request, grpc::ServerWriter<ConsoleLogReply>* response,
+                             std::promise<grpc::Status>* status_promise);
+
 private:
+    // Everything info reads from inside the guest, gathered by a single exec
+    struct GuestMetrics
+    {
+        std::string load;
+        std::string memory_usage;
+        std::string memory_total;
+        std::string disk_usage;
+        std::string disk_total;
+        std::string current_release;
+        std::chrono::steady_clock::time_point taken_at;
+    };
+
+    void notify_watchers(const std::string& name, const VirtualMachine::State& state);
+    GuestMetrics guest_metrics_for(const std::string& name, SSHSession& session);
     void persist_instances();
+    void schedule_persist_instances();
+    void journal_state_for(const std::string& name, const VirtualMachine::State& state);
+    void drain_state_transitions();
     void release_resources(const std::string& instance);
-    std::string check_instance_operational(const std::string& instance_name) const;
-    std::string check_instance_exists(const std::string& instance_name) const;
+    void note_instance_activity(const std::string& name);
+    void materialize_deferred_instance(const std::string& name);
+    void materialize_all_deferred_instances();
+    std::string check_instance_exists(const std::string& instance_name);
     void create_vm(const CreateRequest* request, grpc::ServerWriter<CreateReply>* server,
                    std::promise<grpc::Status>* status_promise, bool start);
     grpc::Status reboot_vm(VirtualMachine& vm);
     grpc::Status shutdown_vm(VirtualMachine& vm, const std::chrono::milliseconds delay);
+
+    // One resolved target of a multi-instance command: the validated name alongside its
+    // instance handle, so the rest of the handler works off the handle instead of
+    // hashing the name into the maps once per pass
+    struct InstanceHandle
+    {
+        std::string name;
+        VirtualMachine::ShPtr vm;
+    };
+    std::pair<std::vector<InstanceHandle>, grpc::Status>
+    resolve_instances(const google::protobuf::RepeatedPtrField<std::string>& names);
+
+    grpc::Status shutdown_vms_now(const std::vector<InstanceHandle>& tgts);
+    void replenish_warm_pool();
+    void persist_warm_instance_names();
+    void purge_stale_warm_instances();
     grpc::Status cancel_vm_shutdown(const VirtualMachine& vm);
-    grpc::Status cmd_vms(const std::vector<std::string>& tgts, std::function<grpc::Status(VirtualMachine&)> cmd);
+    grpc::Status cmd_vms(const std::vector<InstanceHandle>& tgts, std::function<grpc::Status(VirtualMachine&)> cmd);
     void install_sshfs(VirtualMachine* vm, const std::string& name);
 
     struct AsyncOperationStatus
@@ -157,6 +277,17 @@ private:
         std::promise<grpc::Status>* status_promise;
     };
 
+    // gRPC forbids concurrent Write calls on one reply stream, but fleet sub-launches
+    // and batch start/restart outcomes write from worker threads; such writes funnel
+    // through here. One lock for all streams: the writes are brief, and sharing saves
+    // tracking a mutex per writer
+    template <typename Reply>
+    bool synchronized_write(grpc::ServerWriter<Reply>* server, const Reply& reply)
+    {
+        std::lock_guard<std::mutex> lock{reply_writer_mutex};
+        return server->Write(reply);
+    }
+
     template <typename Reply>
     std::string async_wait_for_ssh_and_start_mounts_for(const std::string& name, grpc::ServerWriter<Reply>* server);
     template <typename Reply>
@@ -166,22 +297,85 @@ private:
     void finish_async_operation(QFuture<AsyncOperationStatus> async_future);
     QFutureWatcher<AsyncOperationStatus>* create_future_watcher(std::function<void()> const& finished_op = []() {});
 
+    // Host resources promised to instances, for launch admission control
+    struct HostCommitment
+    {
+        int cpus{0};
+        long long memory_bytes{0};
+    };
+    HostCommitment committed_host_resources();
+    void release_admission(int cpus, long long memory_bytes);
+
     std::unique_ptr<const DaemonConfig> config;
     std::unordered_map<std::string, VMSpecs> vm_instance_specs;
     std::unordered_map<std::string, VirtualMachine::ShPtr> vm_instances;
     std::unordered_map<std::string, VirtualMachine::ShPtr> deleted_instances;
     std::unordered_map<std::string, std::unique_ptr<DelayedShutdownTimer>> delayed_shutdown_instances;
     std::unordered_set<std::string> allocated_mac_addrs;
+    UsedNamesFilter used_names_filter;
+    std::mutex mac_addrs_mutex; // parallel launches assign MACs from worker threads
+    std::mutex reply_writer_mutex; // see synchronized_write
+    HostCommitment admission_reserved;                       // held by admitted launches still coming up
+    std::unordered_set<const CreateRequest*> waiting_admissions; // launches queued for host capacity
     DaemonRpc daemon_rpc;
     QTimer source_images_maintenance_task;
+    QTimer persist_instances_task;
+    QTimer memory_reclaim_task;
+    QTimer heartbeat_task;
     MetricsProvider metrics_provider;
     MetricsOptInData metrics_opt_in;
     SSHFSMounts instance_mounts;
+    SSHSessionPool ssh_session_pool;
+    PeerDaemons peer_daemons; // the other daemons of the federation, if any are configured
+    std::unique_ptr<InstanceStateMirror> state_mirror;
     std::vector<std::unique_ptr<QFutureWatcher<AsyncOperationStatus>>> async_future_watchers;
     std::unordered_map<std::string, QFuture<std::string>> async_running_futures;
+    // Open state-watch streams; each entry parks a gRPC handler thread on its promise
+    // until the client goes away
+    struct WatchSubscriber
+    {
+        grpc::ServerWriter<WatchReply>* writer;
+        std::promise<grpc::Status>* status_promise;
+    };
+    std::vector<WatchSubscriber> watch_subscribers;
+    // Caches for the expensive parts of list replies: the release title never changes for
+    // an instance, and its addresses only change across state transitions
+    std::unordered_map<std::string, std::string> release_cache;
+    std::unordered_map<std::string, std::vector<std::string>> ipv4_cache;
+    // Guest metrics keep briefly, so back-to-back info calls don't re-enter the guest;
+    // probes for different instances fill this concurrently, hence the lock
+    std::mutex guest_metrics_mutex;
+    std::unordered_map<std::string, GuestMetrics> guest_metrics_cache;
+    // When an instance last saw a client interaction; drives the idle memory reclaimer
+    std::unordered_map<std::string, std::chrono::steady_clock::time_point> last_activity;
+    // Bumped on anything that would change a list reply; lets clients revalidate a
+    // cached list with a cheap generation comparison. Seeded from the clock at startup
+    // so a daemon restart never repeats a generation with different contents.
+    uint64_t list_generation{0};
+    std::mutex watch_mutex;
+    // State transitions queue here and drain once per event-loop tick, so a burst of
+    // callbacks during a fleet operation collapses into one persistence pass and one
+    // watcher broadcast per instance
+    std::mutex state_transitions_mutex;
+    std::vector<std::pair<std::string, VirtualMachine::State>> pending_state_transitions;
+    bool state_transitions_drain_scheduled{false};
     std::mutex start_mutex;
     std::unordered_set<std::string> preparing_instances;
+    // Instances that were not running at daemon start keep only their specs in memory;
+    // their descriptions wait here and the backend objects are built on first use
+    std::unordered_map<std::string, VirtualMachineDescription> deferred_vm_descs;
+    // Opt-in warm pool: pre-booted default instances, hidden from clients until a
+    // matching launch adopts one under the name it booted with
+    std::unordered_map<std::string, VirtualMachine::ShPtr> warm_instances;
+    std::unordered_map<std::string, VMSpecs> warm_instance_specs;
+    int warm_pool_size{0};
+    int warm_instances_preparing{0};
     QFuture<void> image_update_future;
+    // Daemon work runs on dedicated pools: interactive instance tasks (waiting for ssh,
+    // preparing launches) are kept apart from background image maintenance, so neither
+    // can starve the other or the global Qt pool.
+    QThreadPool async_task_pool;
+    QThreadPool background_task_pool;
 };
 } // namespace multipass
 #endif // MULTIPASS_DAEMON_H
@@ -21,15 +21,20 @@
 #include "ubuntu_image_host.h"
 
 #include <multipass/client_cert_store.h>
+#include <multipass/constants.h>
+#include <multipass/logging/file_logger.h>
 #include <multipass/logging/log.h>
 #include <multipass/logging/standard_logger.h>
 #include <multipass/name_generator.h>
 #include <multipass/platform.h>
+#include <multipass/settings.h>
 #include <multipass/ssh/openssh_key_provider.h>
 #include <multipass/ssl_cert_provider.h>
 #include <multipass/standard_paths.h>
+#include <multipass/stats_registry.h>
 #include <multipass/utils.h>
 
+#include <QDir>
 #include <QString>
 #include <QUrl>
 
@@ -94,16 +99,6 @@ mp::DaemonConfig::~DaemonConfig()
 
 std::unique_ptr<const mp::DaemonConfig> mp::DaemonConfigBuilder::build()
 {
-    // Install logger as early as possible
-    if (logger == nullptr)
-        logger = platform::make_logger(verbosity_level);
-    // Fallback when platform does not have a logger
-    if (logger == nullptr)
-        logger = std::make_unique<mpl::StandardLogger>(verbosity_level);
-
-    auto multiplexing_logger = std::make_shared<mpl::MultiplexingLogger>(std::move(logger));
-    mpl::set_logger(multiplexing_logger);
-
     auto storage_path = QString::fromUtf8(qgetenv("MULTIPASS_STORAGE"));
 
     if (cache_directory.isEmpty())
@@ -120,6 +115,22 @@ std::unique_ptr<const mp::DaemonConfig> mp::DaemonConfigBuilder::build()
         else
             data_directory = MP_STDPATHS.writableLocation(StandardPaths::AppDataLocation);
     }
+
+    // Install logger as early as possible (the directories above are resolved first
+    // only because the file sink needs a home)
+    if (logger == nullptr)
+        logger = platform::make_logger(verbosity_level);
+    // Fallback when platform does not have a logger
+    if (logger == nullptr)
+        logger = std::make_unique<mpl::StandardLogger>(verbosity_level);
+
+    // The file sink keeps debug regardless of the daemon's verbosity; journald queries
+    // on a busy host are too slow to be the only way into mount or RPC debugging
+    logger = std::make_unique<mpl::FileLogger>(std::move(logger), QDir{data_directory}.filePath("logs"),
+                                               mpl::Level::debug, MP_SETTINGS.get(log_levels_key).toStdString());
+
+    auto multiplexing_logger = std::make_shared<mpl::MultiplexingLogger>(std::move(logger));
+    mpl::set_logger(multiplexing_logger);
     if (url_downloader == nullptr)
         url_downloader = std::make_unique<URLDownloader>(cache_directory, std::chrono::seconds{10});
     if (factory == nullptr)
@@ -138,6 +149,8 @@ std::unique_ptr<const mp::DaemonConfig> mp::DaemonConfigBuilder::build()
     }
     if (vault == nullptr)
     {
+        const mp::StageTimer timer{"startup.vault_init"};
+
         std::vector<VMImageHost*> hosts;
         for (const auto& image : image_hosts)
         {
@@ -84,6 +84,7 @@ struct DaemonConfigBuilder
     std::chrono::hours image_refresh_timer{6};
     multipass::logging::Level verbosity_level{multipass::logging::Level::info};
     RpcConnectionType connection_type{RpcConnectionType::ssl};
+    bool startup_timing{false}; // dump a startup phase breakdown once the daemon is up
 
     std::unique_ptr<const DaemonConfig> build();
 };
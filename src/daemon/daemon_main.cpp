@@ -27,6 +27,7 @@
 #include <multipass/name_generator.h>
 #include <multipass/platform.h>
 #include <multipass/platform_unix.h>
+#include <multipass/stats_registry.h>
 #include <multipass/top_catch_all.h>
 #include <multipass/utils.h>
 #include <multipass/version.h>
@@ -42,6 +43,7 @@
 #include <cstring>
 #include <grp.h>
 #include <sys/stat.h>
+#include <unistd.h>
 #include <vector>
 
 namespace mp = multipass;
@@ -70,12 +72,21 @@ void set_server_permissions(const std::string& server_address)
             break;
     }
 
+    // The plaintext sibling socket must gate on the same ownership and mode, since the
+    // socket permissions are its whole authentication story; it is absent when the
+    // daemon serves without TLS
     const auto socket_path = tokens[1];
-    if (group && chown(socket_path.c_str(), 0, group->gr_gid) == -1)
-        throw std::runtime_error("Could not set ownership of the multipass socket.");
+    for (const auto& path : {socket_path, socket_path + ".peer"})
+    {
+        if (::access(path.c_str(), F_OK) != 0)
+            continue;
+
+        if (group && chown(path.c_str(), 0, group->gr_gid) == -1)
+            throw std::runtime_error("Could not set ownership of the multipass socket.");
 
-    if (chmod(socket_path.c_str(), S_IRUSR | S_IWUSR | S_IRGRP | S_IWGRP) == -1)
-        throw std::runtime_error("Could not set permissions for the multipass socket.");
+        if (chmod(path.c_str(), S_IRUSR | S_IWUSR | S_IRGRP | S_IWGRP) == -1)
+            throw std::runtime_error("Could not set permissions for the multipass socket.");
+    }
 }
 
 class UnixSignalHandler
@@ -114,14 +125,29 @@ int main_impl(int argc, char* argv[])
     UnixSignalHandler handler;
 
     auto builder = mp::cli::parse(app);
-    auto config = builder.build();
+    const auto startup_timing = builder.startup_timing;
+
+    std::unique_ptr<const mp::DaemonConfig> config;
+    {
+        const mp::StageTimer timer{"startup.build_config"};
+        config = builder.build();
+    }
     auto server_address = config->server_address;
 
     mp::monitor_and_quit_on_settings_change(); // temporary
-    mp::Daemon daemon(std::move(config));
+
+    auto daemon = [&config] {
+        const mp::StageTimer timer{"startup.construct_daemon"};
+        return std::make_unique<mp::Daemon>(std::move(config));
+    }();
 
     set_server_permissions(server_address);
 
+    // The finer phases (vault init, instance reconstruction, rpc bind) record themselves
+    // into the same registry from where they run
+    if (startup_timing)
+        mpl::log(mpl::Level::info, "daemon", "startup timing: {}", MP_STATS.dump());
+
     mpl::log(mpl::Level::info, "daemon", fmt::format("Starting Multipass {}", mp::version_string));
     mpl::log(mpl::Level::info, "daemon", fmt::format("Daemon arguments: {}", app.arguments().join(" ")));
     auto ret = QCoreApplication::exec();
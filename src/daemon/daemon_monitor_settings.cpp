@@ -21,8 +21,6 @@
 #include <multipass/utils.h>
 
 #include <QCoreApplication>
-#include <QFileSystemWatcher>
-#include <QObject>
 
 namespace mp = multipass;
 
@@ -36,6 +34,6 @@ void multipass::monitor_and_quit_on_settings_change() // temporary
     static const auto filename = mp::Settings::get_daemon_settings_file_path();
     mp::utils::check_and_create_config_file(filename); // create if not there
 
-    static QFileSystemWatcher monitor{{filename}};
-    QObject::connect(&monitor, &QFileSystemWatcher::fileChanged, [] { QCoreApplication::exit(settings_changed_code); });
+    // Share the settings cache's own watcher rather than keeping a second one on the file
+    MP_SETTINGS.monitor_external_changes([] { QCoreApplication::exit(settings_changed_code); });
 }
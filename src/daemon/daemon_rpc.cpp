@@ -20,10 +20,16 @@
 
 #include <multipass/format.h>
 #include <multipass/logging/log.h>
+#include <multipass/stats_registry.h>
+#include <multipass/version.h>
 #include <multipass/virtual_machine_factory.h>
 
+#include <grpcpp/resource_quota.h>
+
+#include <algorithm>
 #include <chrono>
 #include <stdexcept>
+#include <thread>
 
 namespace mp = multipass;
 namespace mpl = multipass::logging;
@@ -32,6 +38,14 @@ namespace
 {
 constexpr auto category = "rpc";
 
+// The completion queues backing the server are polled by a small fixed pool instead of
+// gRPC's default of an unbounded thread per in-flight RPC, so a burst of concurrent
+// clients no longer translates into a burst of daemon threads.
+auto server_poller_count()
+{
+    return std::max(2u, std::thread::hardware_concurrency());
+}
+
 void throw_if_server_exists(const std::string& address)
 {
     auto channel = grpc::CreateChannel(address, grpc::InsecureChannelCredentials());
@@ -53,6 +67,8 @@ auto make_server(const std::string& server_address, mp::RpcConnectionType conn_t
                  const mp::CertProvider& cert_provider, const mp::CertStore& client_cert_store,
                  mp::Rpc::Service* service)
 {
+    const mp::StageTimer timer{"startup.rpc_bind"};
+
     throw_if_server_exists(server_address);
     grpc::ServerBuilder builder;
 
@@ -74,8 +90,25 @@ auto make_server(const std::string& server_address, mp::RpcConnectionType conn_t
     }
 
     builder.AddListeningPort(server_address, creds);
+
+    // A unix server socket is already authenticated by the kernel: only peers admitted
+    // by the socket's file permissions can connect at all, while the TLS layered on top
+    // verifies no certificates in either direction. Local clients therefore get a
+    // sibling plaintext listener, "<socket>.peer", and skip the per-command handshake;
+    // the TLS listener stays for remote and tcp setups.
+    if (conn_type == mp::RpcConnectionType::ssl && server_address.rfind("unix:", 0) == 0)
+        builder.AddListeningPort(server_address + ".peer", grpc::experimental::LocalServerCredentials(UDS));
+
     builder.RegisterService(service);
 
+    const auto pollers = server_poller_count();
+    grpc::ResourceQuota quota{"multipassd_rpc_quota"};
+    quota.SetMaxThreads(pollers * 2);
+    builder.SetResourceQuota(quota);
+    builder.SetSyncServerOption(grpc::ServerBuilder::SyncServerOption::NUM_CQS, pollers);
+    builder.SetSyncServerOption(grpc::ServerBuilder::SyncServerOption::MIN_POLLERS, 1);
+    builder.SetSyncServerOption(grpc::ServerBuilder::SyncServerOption::MAX_POLLERS, pollers);
+
     std::unique_ptr<grpc::Server> server{builder.BuildAndStart()};
     if (server == nullptr)
         throw std::runtime_error(fmt::format("Failed to start multipass gRPC service at {}", server_address));
@@ -83,6 +116,15 @@ auto make_server(const std::string& server_address, mp::RpcConnectionType conn_t
     return server;
 }
 
+// Large enumeration replies (find/info/list on big fleets) compress several-fold, which
+// pays off on real networks; a local unix socket would only pay the CPU, so it is left
+// alone. gRPC applies the algorithm only to clients that advertised support for it.
+void compress_large_reply(grpc::ServerContext* context)
+{
+    if (context->peer().rfind("unix:", 0) != 0)
+        context->set_compression_algorithm(GRPC_COMPRESS_DEFLATE);
+}
+
 template <typename OperationSignal>
 grpc::Status emit_signal_and_wait_for_result(OperationSignal operation_signal)
 {
@@ -102,9 +144,26 @@ mp::DaemonRpc::DaemonRpc(const std::string& server_address, mp::RpcConnectionTyp
     mpl::log(mpl::Level::info, category, fmt::format("gRPC listening on {}, SSL:{}", server_address, ssl_enabled));
 }
 
+void mp::DaemonRpc::mark_ready()
+{
+    ready = true;
+    ready_promise.set_value();
+}
+
+void mp::DaemonRpc::await_ready()
+{
+    // Blocking here (rather than in the daemon's event loop) also closes the window
+    // between the server starting to accept and the daemon connecting the signals,
+    // during which an emitted signal would have gone nowhere and hung the RPC.
+    if (!ready)
+        ready_future.wait();
+}
+
 grpc::Status mp::DaemonRpc::create(grpc::ServerContext* context, const CreateRequest* request,
                                    grpc::ServerWriter<CreateReply>* reply)
 {
+    const mp::StageTimer timer{"rpc.create"};
+    await_ready();
     return emit_signal_and_wait_for_result(
         std::bind(&DaemonRpc::on_create, this, request, reply, std::placeholders::_1));
 }
@@ -112,6 +171,8 @@ grpc::Status mp::DaemonRpc::create(grpc::ServerContext* context, const CreateReq
 grpc::Status mp::DaemonRpc::launch(grpc::ServerContext* context, const LaunchRequest* request,
                                    grpc::ServerWriter<LaunchReply>* reply)
 {
+    const mp::StageTimer timer{"rpc.launch"};
+    await_ready();
     return emit_signal_and_wait_for_result(
         std::bind(&DaemonRpc::on_launch, this, request, reply, std::placeholders::_1));
 }
@@ -119,6 +180,8 @@ grpc::Status mp::DaemonRpc::launch(grpc::ServerContext* context, const LaunchReq
 grpc::Status mp::DaemonRpc::purge(grpc::ServerContext* context, const PurgeRequest* request,
                                   grpc::ServerWriter<PurgeReply>* response)
 {
+    const mp::StageTimer timer{"rpc.purge"};
+    await_ready();
     return emit_signal_and_wait_for_result(
         std::bind(&DaemonRpc::on_purge, this, request, response, std::placeholders::_1));
 }
@@ -126,6 +189,9 @@ grpc::Status mp::DaemonRpc::purge(grpc::ServerContext* context, const PurgeReque
 grpc::Status mp::DaemonRpc::find(grpc::ServerContext* context, const FindRequest* request,
                                  grpc::ServerWriter<FindReply>* response)
 {
+    const mp::StageTimer timer{"rpc.find"};
+    compress_large_reply(context);
+    await_ready();
     return emit_signal_and_wait_for_result(
         std::bind(&DaemonRpc::on_find, this, request, response, std::placeholders::_1));
 }
@@ -133,20 +199,37 @@ grpc::Status mp::DaemonRpc::find(grpc::ServerContext* context, const FindRequest
 grpc::Status mp::DaemonRpc::info(grpc::ServerContext* context, const InfoRequest* request,
                                  grpc::ServerWriter<InfoReply>* response)
 {
+    const mp::StageTimer timer{"rpc.info"};
+    compress_large_reply(context);
+    await_ready();
     return emit_signal_and_wait_for_result(
-        std::bind(&DaemonRpc::on_info, this, request, response, std::placeholders::_1));
+        std::bind(&DaemonRpc::on_info, this, context, request, response, std::placeholders::_1));
 }
 
 grpc::Status mp::DaemonRpc::list(grpc::ServerContext* context, const ListRequest* request,
                                  grpc::ServerWriter<ListReply>* response)
 {
+    const mp::StageTimer timer{"rpc.list"};
+    compress_large_reply(context);
+    await_ready();
     return emit_signal_and_wait_for_result(
         std::bind(&DaemonRpc::on_list, this, request, response, std::placeholders::_1));
 }
 
+grpc::Status mp::DaemonRpc::instance_names(grpc::ServerContext* context, const InstanceNamesRequest* request,
+                                           grpc::ServerWriter<InstanceNamesReply>* response)
+{
+    const mp::StageTimer timer{"rpc.instance_names"};
+    await_ready();
+    return emit_signal_and_wait_for_result(
+        std::bind(&DaemonRpc::on_instance_names, this, request, response, std::placeholders::_1));
+}
+
 grpc::Status mp::DaemonRpc::networks(grpc::ServerContext* context, const NetworksRequest* request,
                                      grpc::ServerWriter<NetworksReply>* response)
 {
+    const mp::StageTimer timer{"rpc.networks"};
+    await_ready();
     return emit_signal_and_wait_for_result(
         std::bind(&DaemonRpc::on_networks, this, request, response, std::placeholders::_1));
 }
@@ -154,6 +237,8 @@ grpc::Status mp::DaemonRpc::networks(grpc::ServerContext* context, const Network
 grpc::Status mp::DaemonRpc::mount(grpc::ServerContext* context, const MountRequest* request,
                                   grpc::ServerWriter<MountReply>* response)
 {
+    const mp::StageTimer timer{"rpc.mount"};
+    await_ready();
     return emit_signal_and_wait_for_result(
         std::bind(&DaemonRpc::on_mount, this, request, response, std::placeholders::_1));
 }
@@ -161,6 +246,8 @@ grpc::Status mp::DaemonRpc::mount(grpc::ServerContext* context, const MountReque
 grpc::Status mp::DaemonRpc::recover(grpc::ServerContext* context, const RecoverRequest* request,
                                     grpc::ServerWriter<RecoverReply>* response)
 {
+    const mp::StageTimer timer{"rpc.recover"};
+    await_ready();
     return emit_signal_and_wait_for_result(
         std::bind(&DaemonRpc::on_recover, this, request, response, std::placeholders::_1));
 }
@@ -168,6 +255,8 @@ grpc::Status mp::DaemonRpc::recover(grpc::ServerContext* context, const RecoverR
 grpc::Status mp::DaemonRpc::ssh_info(grpc::ServerContext* context, const SSHInfoRequest* request,
                                      grpc::ServerWriter<SSHInfoReply>* response)
 {
+    const mp::StageTimer timer{"rpc.ssh_info"};
+    await_ready();
     return emit_signal_and_wait_for_result(
         std::bind(&DaemonRpc::on_ssh_info, this, request, response, std::placeholders::_1));
 }
@@ -175,6 +264,8 @@ grpc::Status mp::DaemonRpc::ssh_info(grpc::ServerContext* context, const SSHInfo
 grpc::Status mp::DaemonRpc::start(grpc::ServerContext* context, const StartRequest* request,
                                   grpc::ServerWriter<StartReply>* response)
 {
+    const mp::StageTimer timer{"rpc.start"};
+    await_ready();
     return emit_signal_and_wait_for_result(
         std::bind(&DaemonRpc::on_start, this, request, response, std::placeholders::_1));
 }
@@ -182,6 +273,8 @@ grpc::Status mp::DaemonRpc::start(grpc::ServerContext* context, const StartReque
 grpc::Status mp::DaemonRpc::stop(grpc::ServerContext* context, const StopRequest* request,
                                  grpc::ServerWriter<StopReply>* response)
 {
+    const mp::StageTimer timer{"rpc.stop"};
+    await_ready();
     return emit_signal_and_wait_for_result(
         std::bind(&DaemonRpc::on_stop, this, request, response, std::placeholders::_1));
 }
@@ -189,6 +282,8 @@ grpc::Status mp::DaemonRpc::stop(grpc::ServerContext* context, const StopRequest
 grpc::Status mp::DaemonRpc::suspend(grpc::ServerContext* context, const SuspendRequest* request,
                                     grpc::ServerWriter<SuspendReply>* response)
 {
+    const mp::StageTimer timer{"rpc.suspend"};
+    await_ready();
     return emit_signal_and_wait_for_result(
         std::bind(&DaemonRpc::on_suspend, this, request, response, std::placeholders::_1));
 }
@@ -196,13 +291,44 @@ grpc::Status mp::DaemonRpc::suspend(grpc::ServerContext* context, const SuspendR
 grpc::Status mp::DaemonRpc::restart(grpc::ServerContext* context, const RestartRequest* request,
                                     grpc::ServerWriter<RestartReply>* response)
 {
+    const mp::StageTimer timer{"rpc.restart"};
+    await_ready();
     return emit_signal_and_wait_for_result(
         std::bind(&DaemonRpc::on_restart, this, request, response, std::placeholders::_1));
 }
 
+grpc::Status mp::DaemonRpc::snapshot(grpc::ServerContext* context, const SnapshotRequest* request,
+                                     grpc::ServerWriter<SnapshotReply>* response)
+{
+    const mp::StageTimer timer{"rpc.snapshot"};
+    await_ready();
+    return emit_signal_and_wait_for_result(
+        std::bind(&DaemonRpc::on_snapshot, this, request, response, std::placeholders::_1));
+}
+
+grpc::Status mp::DaemonRpc::restore(grpc::ServerContext* context, const RestoreRequest* request,
+                                    grpc::ServerWriter<RestoreReply>* response)
+{
+    const mp::StageTimer timer{"rpc.restore"};
+    await_ready();
+    return emit_signal_and_wait_for_result(
+        std::bind(&DaemonRpc::on_restore, this, request, response, std::placeholders::_1));
+}
+
+grpc::Status mp::DaemonRpc::clone(grpc::ServerContext* context, const CloneRequest* request,
+                                  grpc::ServerWriter<CloneReply>* response)
+{
+    const mp::StageTimer timer{"rpc.clone"};
+    await_ready();
+    return emit_signal_and_wait_for_result(
+        std::bind(&DaemonRpc::on_clone, this, request, response, std::placeholders::_1));
+}
+
 grpc::Status mp::DaemonRpc::delet(grpc::ServerContext* context, const DeleteRequest* request,
                                   grpc::ServerWriter<DeleteReply>* response)
 {
+    const mp::StageTimer timer{"rpc.delete"};
+    await_ready();
     return emit_signal_and_wait_for_result(
         std::bind(&DaemonRpc::on_delete, this, request, response, std::placeholders::_1));
 }
@@ -210,6 +336,8 @@ grpc::Status mp::DaemonRpc::delet(grpc::ServerContext* context, const DeleteRequ
 grpc::Status mp::DaemonRpc::umount(grpc::ServerContext* context, const UmountRequest* request,
                                    grpc::ServerWriter<UmountReply>* response)
 {
+    const mp::StageTimer timer{"rpc.umount"};
+    await_ready();
     return emit_signal_and_wait_for_result(
         std::bind(&DaemonRpc::on_umount, this, request, response, std::placeholders::_1));
 }
@@ -217,11 +345,51 @@ grpc::Status mp::DaemonRpc::umount(grpc::ServerContext* context, const UmountReq
 grpc::Status mp::DaemonRpc::version(grpc::ServerContext* context, const VersionRequest* request,
                                     grpc::ServerWriter<VersionReply>* response)
 {
+    const mp::StageTimer timer{"rpc.version"};
+
+    if (!ready) // answer from here while warming up, so `multipass version` works right after host boot
+    {
+        VersionReply reply;
+        reply.set_version(multipass::version_string);
+        response->Write(reply);
+        return grpc::Status::OK;
+    }
+
     return emit_signal_and_wait_for_result(
         std::bind(&DaemonRpc::on_version, this, request, response, std::placeholders::_1));
 }
 
+grpc::Status mp::DaemonRpc::watch(grpc::ServerContext* context, const WatchRequest* request,
+                                  grpc::ServerWriter<WatchReply>* response)
+{
+    const mp::StageTimer timer{"rpc.watch"};
+    await_ready();
+    return emit_signal_and_wait_for_result(
+        std::bind(&DaemonRpc::on_watch, this, request, response, std::placeholders::_1));
+}
+
 grpc::Status mp::DaemonRpc::ping(grpc::ServerContext* context, const PingRequest* request, PingReply* response)
 {
     return grpc::Status::OK;
 }
+
+grpc::Status mp::DaemonRpc::console_log(grpc::ServerContext* context, const ConsoleLogRequest* request,
+                                        grpc::ServerWriter<ConsoleLogReply>* response)
+{
+    const mp::StageTimer timer{"rpc.console_log"};
+    await_ready();
+    return emit_signal_and_wait_for_result(
+        std::bind(&DaemonRpc::on_console_log, this, request, response, std::placeholders::_1));
+}
+
+grpc::Status mp::DaemonRpc::get_stats(grpc::ServerContext* context, const StatsRequest* request,
+                                      grpc::ServerWriter<StatsReply>* response)
+{
+    // The registry is thread safe and no daemon state is touched, so this one can serve
+    // straight from the gRPC thread instead of marshalling through the Qt loop
+    StatsReply reply;
+    reply.set_stats_json(MP_STATS.dump());
+    response->Write(reply);
+
+    return grpc::Status::OK;
+}
@@ -28,6 +28,7 @@
 
 #include <QObject>
 
+#include <atomic>
 #include <future>
 #include <memory>
 
@@ -48,6 +49,11 @@ public:
     DaemonRpc(const DaemonRpc&) = delete;
     DaemonRpc& operator=(const DaemonRpc&) = delete;
 
+    // Releases RPCs that need daemon state; until called, only ping and version are
+    // answered and everything else blocks, so the socket can accept as soon as the
+    // certificates are up while the rest of the daemon is still being brought up.
+    void mark_ready();
+
 signals:
     void on_create(const CreateRequest* request, grpc::ServerWriter<CreateReply>* reply,
                    std::promise<grpc::Status>* status_promise);
@@ -57,10 +63,12 @@ signals:
                   std::promise<grpc::Status>* status_promise);
     void on_find(const FindRequest* request, grpc::ServerWriter<FindReply>* response,
                  std::promise<grpc::Status>* status_promise);
-    void on_info(const InfoRequest* request, grpc::ServerWriter<InfoReply>* response,
+    void on_info(grpc::ServerContext* context, const InfoRequest* request, grpc::ServerWriter<InfoReply>* response,
                  std::promise<grpc::Status>* status_promise);
     void on_list(const ListRequest* request, grpc::ServerWriter<ListReply>* response,
                  std::promise<grpc::Status>* status_promise);
+    void on_instance_names(const InstanceNamesRequest* request, grpc::ServerWriter<InstanceNamesReply>* response,
+                           std::promise<grpc::Status>* status_promise);
     void on_networks(const NetworksRequest* request, grpc::ServerWriter<NetworksReply>* response,
                      std::promise<grpc::Status>* status_promise);
     void on_mount(const MountRequest* request, grpc::ServerWriter<MountReply>* response,
@@ -77,16 +85,31 @@ signals:
                     std::promise<grpc::Status>* status_promise);
     void on_restart(const RestartRequest* request, grpc::ServerWriter<RestartReply>* response,
                     std::promise<grpc::Status>* status_promise);
+    void on_snapshot(const SnapshotRequest* request, grpc::ServerWriter<SnapshotReply>* response,
+                     std::promise<grpc::Status>* status_promise);
+    void on_restore(const RestoreRequest* request, grpc::ServerWriter<RestoreReply>* response,
+                    std::promise<grpc::Status>* status_promise);
+    void on_clone(const CloneRequest* request, grpc::ServerWriter<CloneReply>* response,
+                  std::promise<grpc::Status>* status_promise);
     void on_delete(const DeleteRequest* request, grpc::ServerWriter<DeleteReply>* response,
                    std::promise<grpc::Status>* status_promise);
     void on_umount(const UmountRequest* request, grpc::ServerWriter<UmountReply>* response,
                    std::promise<grpc::Status>* status_promise);
     void on_version(const VersionRequest* request, grpc::ServerWriter<VersionReply>* response,
                     std::promise<grpc::Status>* status_promise);
+    void on_watch(const WatchRequest* request, grpc::ServerWriter<WatchReply>* response,
+                  std::promise<grpc::Status>* status_promise);
+    void on_console_log(const ConsoleLogRequest* request, grpc::ServerWriter<ConsoleLogReply>* response,
+                        std::promise<grpc::Status>* status_promise);
 
 private:
+    void await_ready();
+
     const std::string server_address;
     const std::unique_ptr<grpc::Server> server;
+    std::atomic<bool> ready{false};
+    std::promise<void> ready_promise;
+    std::shared_future<void> ready_future{ready_promise.get_future().share()};
 
 protected:
     grpc::Status create(grpc::ServerContext* context, const CreateRequest* request,
@@ -101,6 +124,8 @@ protected:
                       grpc::ServerWriter<InfoReply>* response) override;
     grpc::Status list(grpc::ServerContext* context, const ListRequest* request,
                       grpc::ServerWriter<ListReply>* response) override;
+    grpc::Status instance_names(grpc::ServerContext* context, const InstanceNamesRequest* request,
+                                grpc::ServerWriter<InstanceNamesReply>* response) override;
     grpc::Status networks(grpc::ServerContext* context, const NetworksRequest* request,
                           grpc::ServerWriter<NetworksReply>* response) override;
     grpc::Status mount(grpc::ServerContext* context, const MountRequest* request,
@@ -117,12 +142,24 @@ protected:
                          grpc::ServerWriter<SuspendReply>* response) override;
     grpc::Status restart(grpc::ServerContext* context, const RestartRequest* request,
                          grpc::ServerWriter<RestartReply>* response) override;
+    grpc::Status snapshot(grpc::ServerContext* context, const SnapshotRequest* request,
+                          grpc::ServerWriter<SnapshotReply>* response) override;
+    grpc::Status restore(grpc::ServerContext* context, const RestoreRequest* request,
+                         grpc::ServerWriter<RestoreReply>* response) override;
+    grpc::Status clone(grpc::ServerContext* context, const CloneRequest* request,
+                       grpc::ServerWriter<CloneReply>* response) override;
     grpc::Status delet(grpc::ServerContext* context, const DeleteRequest* request,
                        grpc::ServerWriter<DeleteReply>* response) override;
     grpc::Status umount(grpc::ServerContext* context, const UmountRequest* request,
                         grpc::ServerWriter<UmountReply>* response) override;
     grpc::Status version(grpc::ServerContext* context, const VersionRequest* request,
                          grpc::ServerWriter<VersionReply>* response) override;
+    grpc::Status watch(grpc::ServerContext* context, const WatchRequest* request,
+                       grpc::ServerWriter<WatchReply>* response) override;
+    grpc::Status get_stats(grpc::ServerContext* context, const StatsRequest* request,
+                           grpc::ServerWriter<StatsReply>* response) override;
+    grpc::Status console_log(grpc::ServerContext* context, const ConsoleLogRequest* request,
+                             grpc::ServerWriter<ConsoleLogReply>* response) override;
     grpc::Status ping(grpc::ServerContext* context, const PingRequest* request, PingReply* response) override;
 };
 } // namespace multipass
@@ -20,12 +20,17 @@
 
 #include <multipass/exceptions/aborted_download_exception.h>
 #include <multipass/exceptions/create_image_exception.h>
+#include <multipass/exceptions/download_exception.h>
 #include <multipass/exceptions/unsupported_image_exception.h>
 #include <multipass/logging/log.h>
 #include <multipass/platform.h>
+#include <multipass/process/qemuimg_job_queue.h>
 #include <multipass/process/qemuimg_process_spec.h>
 #include <multipass/query.h>
 #include <multipass/rpc/multipass.grpc.pb.h>
+#include <multipass/sha256_hash.h>
+#include <multipass/stats_registry.h>
+#include <multipass/tracing.h>
 #include <multipass/url_downloader.h>
 #include <multipass/utils.h>
 #include <multipass/vm_image.h>
@@ -33,13 +38,30 @@
 
 #include <multipass/format.h>
 
+#include <QCryptographicHash>
+#include <QDateTime>
 #include <QJsonArray>
 #include <QJsonDocument>
 #include <QJsonObject>
+#include <QSemaphore>
 #include <QUrl>
 #include <QtConcurrent/QtConcurrent>
 
+#include <cerrno>
+#include <condition_variable>
+#include <deque>
 #include <exception>
+#include <functional>
+#include <thread>
+
+#ifdef Q_OS_LINUX
+#include <fcntl.h>
+#include <linux/fs.h>
+#include <sys/ioctl.h>
+#include <sys/stat.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
 
 namespace mp = multipass;
 namespace mpl = multipass::logging;
@@ -49,6 +71,8 @@ namespace
 constexpr auto category = "image vault";
 constexpr auto instance_db_name = "multipassd-instance-image-records.json";
 constexpr auto image_db_name = "multipassd-image-records.json";
+constexpr auto trash_dir_name = "trash"; // removed instance/image dirs await background unlinking here
+constexpr auto boot_artifacts_dir_name = "boot-artifacts"; // content-addressed kernel/initrd blobs
 
 auto query_to_json(const mp::Query& query)
 {
@@ -89,6 +113,7 @@ auto record_to_json(const mp::VaultRecord& record)
     json.insert("image", image_to_json(record.image));
     json.insert("query", query_to_json(record.query));
     json.insert("last_accessed", static_cast<qint64>(record.last_accessed.time_since_epoch().count()));
+    json.insert("disk_hash", record.disk_hash);
     return json;
 }
 
@@ -164,26 +189,265 @@ std::unordered_map<std::string, mp::VaultRecord> load_db(const QString& db_name)
         reconstructed_records[key] = {
             {image_path, kernel_path, initrd_path, image_id, original_release, current_release, release_date, aliases},
             {"", release.toStdString(), persistent.toBool(), remote_name.toStdString(), query_type},
-            last_accessed};
+            last_accessed,
+            record["disk_hash"].toString()};
     }
     return reconstructed_records;
 }
 
+#ifdef Q_OS_LINUX
+// Copies only the allocated extents, recreating the holes with a final ftruncate; cloud
+// images are mostly holes, so this costs actual-usage I/O rather than virtual-size I/O.
+// Falls back to a dense in-kernel copy on filesystems without SEEK_DATA support.
+bool copy_data_extents(int source, int dest, loff_t size)
+{
+    auto data_start = ::lseek(source, 0, SEEK_DATA);
+    if (data_start < 0 && errno == EINVAL)
+    {
+        loff_t remaining = size;
+        if (::lseek(source, 0, SEEK_SET) != 0)
+            return false;
+        while (remaining > 0)
+        {
+            const auto copied = ::copy_file_range(source, nullptr, dest, nullptr, remaining, 0);
+            if (copied <= 0)
+                return false;
+            remaining -= copied;
+        }
+        return true;
+    }
+
+    while (data_start >= 0)
+    {
+        const auto hole_start = ::lseek(source, data_start, SEEK_HOLE);
+        if (hole_start < 0)
+            return false;
+
+        auto src_offset = data_start;
+        auto dst_offset = data_start;
+        auto remaining = hole_start - data_start;
+        while (remaining > 0)
+        {
+            const auto copied = ::copy_file_range(source, &src_offset, dest, &dst_offset, remaining, 0);
+            if (copied <= 0)
+                return false;
+            remaining -= copied;
+        }
+
+        data_start = ::lseek(source, hole_start, SEEK_DATA);
+    }
+
+    if (errno != ENXIO) // ENXIO just means there is no data past the last extent
+        return false;
+
+    return ::ftruncate(dest, size) == 0;
+}
+#endif
+
+// Try to clone instead of copying the bytes: a reflink (FICLONE) shares extents on
+// btrfs/XFS so multi-GB images materialise instantly and use no extra space, while
+// copy_file_range over the data extents at least keeps the copy in the kernel and
+// preserves the holes. Returns false if the filesystem supports neither, in which case
+// the caller falls back to a plain copy.
+bool clone_file(const QString& source_path, const QString& dest_path)
+{
+#ifdef Q_OS_LINUX
+    const auto source = ::open(source_path.toUtf8().constData(), O_RDONLY | O_CLOEXEC);
+    if (source < 0)
+        return false;
+
+    const auto dest =
+        ::open(dest_path.toUtf8().constData(), O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+    if (dest < 0)
+    {
+        ::close(source);
+        return false;
+    }
+
+    bool cloned = ::ioctl(dest, FICLONE, source) == 0;
+
+    if (!cloned)
+    {
+        struct stat st
+        {
+        };
+        cloned = ::fstat(source, &st) == 0 && copy_data_extents(source, dest, st.st_size);
+    }
+
+    ::close(source);
+    ::close(dest);
+
+    if (!cloned)
+        QFile::remove(dest_path);
+
+    return cloned;
+#else
+    return false;
+#endif
+}
+
+// The download delivers chunks from the network while hashing and xz decoding are CPU
+// bound; feed the chunks to a dedicated consumer thread through a bounded queue so the
+// transfer and the decode proceed concurrently instead of taking turns on one core.
+class DecodePipeline
+{
+public:
+    explicit DecodePipeline(std::function<void(const QByteArray&)> consume)
+        : worker{[this, consume = std::move(consume)] { consume_chunks(consume); }}
+    {
+    }
+
+    ~DecodePipeline()
+    {
+        {
+            std::lock_guard<std::mutex> lock{mutex};
+            stopping = true;
+        }
+        chunk_available.notify_all();
+        if (worker.joinable())
+            worker.join();
+    }
+
+    // Returns false once the consumer has failed, aborting the download
+    bool push(const QByteArray& chunk)
+    {
+        std::unique_lock<std::mutex> lock{mutex};
+        queue_drained.wait(lock, [this] { return queue.size() < max_queued_chunks || failure; });
+        if (failure)
+            return false;
+
+        queue.push_back(chunk);
+        lock.unlock();
+        chunk_available.notify_one();
+        return true;
+    }
+
+    // Drains the queue, joins the consumer and rethrows whatever made it fail
+    void finish()
+    {
+        {
+            std::lock_guard<std::mutex> lock{mutex};
+            stopping = true;
+        }
+        chunk_available.notify_all();
+        if (worker.joinable())
+            worker.join();
+
+        if (failure)
+            std::rethrow_exception(failure);
+    }
+
+private:
+    void consume_chunks(const std::function<void(const QByteArray&)>& consume)
+    {
+        for (;;)
+        {
+            QByteArray chunk;
+            {
+                std::unique_lock<std::mutex> lock{mutex};
+                chunk_available.wait(lock, [this] { return !queue.empty() || stopping; });
+                if (queue.empty())
+                    return;
+
+                chunk = std::move(queue.front());
+                queue.pop_front();
+            }
+            queue_drained.notify_one();
+
+            try
+            {
+                consume(chunk);
+            }
+            catch (...)
+            {
+                std::lock_guard<std::mutex> lock{mutex};
+                failure = std::current_exception();
+                queue_drained.notify_all();
+                return;
+            }
+        }
+    }
+
+    static constexpr size_t max_queued_chunks = 64;
+    std::mutex mutex;
+    std::condition_variable chunk_available;
+    std::condition_variable queue_drained;
+    std::deque<QByteArray> queue;
+    std::exception_ptr failure;
+    bool stopping{false};
+    std::thread worker;
+};
+
+// Opt-in launch mode: instead of materializing a full per-instance copy, create the
+// instance disk as a qcow2 overlay backed by the read-only prepared image. Instance
+// creation is then metadata-only and concurrent instances share the base image's page
+// cache. The base image must outlive the overlay, so this keeps the prepared image in
+// place in the vault.
+bool use_backing_image()
+{
+    return qEnvironmentVariableIsSet("MULTIPASS_BACKED_INSTANCE_DISKS");
+}
+
+QString create_overlay_image(const QString& base_image_path, const QString& overlay_path)
+{
+    auto result = MP_QEMUIMG_QUEUE.run(
+        std::make_unique<mp::QemuImgProcessSpec>(
+            QStringList{"create", "-f", "qcow2", "-F", "qcow2", "-b", base_image_path, overlay_path}, base_image_path,
+            overlay_path),
+        mp::QemuImgJobQueue::Priority::interactive);
+
+    if (!result.state.completed_successfully())
+        throw std::runtime_error(fmt::format("Cannot create backed instance image: qemu-img failed ({}) with output:\n{}",
+                                             result.state.failure_message(), result.error_output));
+
+    return overlay_path;
+}
+
+QString create_backed_image(const QString& base_image_path, const QDir& output_dir)
+{
+    return create_overlay_image(base_image_path, output_dir.filePath(QFileInfo{base_image_path}.fileName()));
+}
+
 QString copy(const QString& file_name, const QDir& output_dir)
 {
     if (file_name.isEmpty())
         return {};
 
+    const mp::StageTimer timer{"vault.copy"};
+
     if (!QFileInfo::exists(file_name))
         throw std::runtime_error(fmt::format("{} missing", file_name));
 
     QFileInfo info{file_name};
     const auto source_name = info.fileName();
     auto new_path = output_dir.filePath(source_name);
-    QFile::copy(file_name, new_path);
+    if (!clone_file(file_name, new_path))
+        QFile::copy(file_name, new_path);
     return new_path;
 }
 
+// Kernels and initrds are immutable once fetched, so instances can share a single
+// on-disk copy: hard-link the artifact into the instance directory and let removal
+// just drop a link count. Falls back to a copy when linking is not possible (other
+// platforms, or the instance directory living on a different filesystem).
+QString link_or_copy(const QString& file_name, const QDir& output_dir)
+{
+    if (file_name.isEmpty())
+        return {};
+
+    if (!QFileInfo::exists(file_name))
+        throw std::runtime_error(fmt::format("{} missing", file_name));
+
+#ifdef Q_OS_LINUX
+    const auto new_path = output_dir.filePath(QFileInfo{file_name}.fileName());
+    QFile::remove(new_path);
+    if (::link(file_name.toUtf8().constData(), new_path.toUtf8().constData()) == 0)
+        return new_path;
+#endif
+
+    return copy(file_name, output_dir);
+}
+
 void remove_source_images(const mp::VMImage& source_image, const mp::VMImage& prepared_image)
 {
     // The prepare phase may have been a no-op, check and only remove source images
@@ -207,21 +471,68 @@ void delete_image_dir(const mp::Path& image_path)
     }
 }
 
+// Demotes the calling thread to the idle I/O class, so anything interactive sharing
+// the disk wins; a no-op elsewhere
+void demote_thread_to_idle_io()
+{
+#ifdef Q_OS_LINUX
+    constexpr int ioprio_class_idle = 3;
+    constexpr int ioprio_who_process = 1;
+    constexpr int ioprio_class_shift = 13;
+    syscall(SYS_ioprio_set, ioprio_who_process, 0, ioprio_class_idle << ioprio_class_shift);
+#endif
+}
+
+constexpr auto scrub_interval = std::chrono::hours{24};
+constexpr qint64 scrub_burst_bytes = 32 * 1024 * 1024;
+constexpr auto scrub_pause = std::chrono::milliseconds{100};
+
+// Hashes an image in bursts with pauses in between; together with the idle I/O class
+// this keeps re-verifying a multi-GB image from monopolizing the disk. Returns nullopt
+// when the file cannot be read or `abort` asks to stop.
+mp::optional<QString> throttled_image_hash(const mp::Path& image_path, const std::function<bool()>& abort)
+{
+    QFile image_file{image_path};
+    if (!image_file.open(QIODevice::ReadOnly))
+        return mp::nullopt;
+
+    mp::Sha256Hash hash;
+    QByteArray buffer(1024 * 1024, '\0');
+    qint64 burst_bytes = 0;
+    for (;;)
+    {
+        if (abort())
+            return mp::nullopt;
+
+        const auto bytes_read = image_file.read(buffer.data(), buffer.size());
+        if (bytes_read < 0)
+            return mp::nullopt;
+        if (bytes_read == 0)
+            return QString{hash.result().toHex()};
+
+        hash.addData(buffer.constData(), static_cast<int>(bytes_read));
+        burst_bytes += bytes_read;
+        if (burst_bytes >= scrub_burst_bytes)
+        {
+            burst_bytes = 0;
+            std::this_thread::sleep_for(scrub_pause);
+        }
+    }
+}
+
 mp::MemorySize get_image_size(const mp::Path& image_path)
 {
     QStringList qemuimg_parameters{{"info", image_path}};
-    auto qemuimg_process =
-        mp::platform::make_process(std::make_unique<mp::QemuImgProcessSpec>(qemuimg_parameters, image_path));
-    auto process_state = qemuimg_process->execute();
+    auto result = MP_QEMUIMG_QUEUE.run(std::make_unique<mp::QemuImgProcessSpec>(qemuimg_parameters, image_path),
+                                       mp::QemuImgJobQueue::Priority::interactive);
 
-    if (!process_state.completed_successfully())
+    if (!result.state.completed_successfully())
     {
         throw std::runtime_error(fmt::format("Cannot get image info: qemu-img failed ({}) with output:\n{}",
-                                             process_state.failure_message(),
-                                             qemuimg_process->read_all_standard_error()));
+                                             result.state.failure_message(), result.error_output));
     }
 
-    const auto img_info = QString{qemuimg_process->read_all_standard_output()};
+    const auto img_info = QString{result.output};
     const auto pattern = QStringLiteral("^virtual size: .+ \\((?<size>\\d+) bytes\\)\r?$");
     const auto re = QRegularExpression{pattern, QRegularExpression::MultilineOption};
 
@@ -251,19 +562,49 @@ mp::DefaultVMImageVault::DefaultVMImageVault(std::vector<VMImageHost*> image_hos
       instances_dir(data_dir.filePath("instances")),
       images_dir(cache_dir.filePath("images")),
       days_to_expire{days_to_expire},
+      prepare_slots{static_cast<int>(std::max(2u, std::thread::hardware_concurrency() / 2))},
       prepared_image_records{load_db(cache_dir.filePath(image_db_name))},
       instance_image_records{load_db(data_dir.filePath(instance_db_name))}
 {
+    // directories left in the trash by a previous run (or an interrupted sweep) are fair game
+    for (const auto& root : {data_dir, cache_dir})
+    {
+        const QDir trash_dir{root.filePath(trash_dir_name)};
+        for (const auto& entry : trash_dir.entryInfoList(QDir::Dirs | QDir::NoDotAndDotDot))
+            enqueue_reclaim(entry.absoluteFilePath());
+    }
+
+    for (auto i = 0; i < 2; ++i)
+        reclaim_workers.emplace_back([this] { reclaim_main(); });
+
+    scrub_worker = std::thread{[this] { scrub_main(); }};
 }
 
 mp::DefaultVMImageVault::~DefaultVMImageVault()
 {
     url_downloader->abort_all_downloads();
+
+    {
+        std::lock_guard<std::mutex> lock{reclaim_mutex};
+        reclaim_stopping = true;
+    }
+    reclaim_cv.notify_all();
+    for (auto& worker : reclaim_workers)
+        worker.join(); // whatever is left queued stays in the trash for the next run
+
+    {
+        std::lock_guard<std::mutex> lock{scrub_mutex};
+        scrub_stopping = true;
+    }
+    scrub_cv.notify_all();
+    scrub_worker.join(); // an interrupted pass just resumes from scratch next time
 }
 
 mp::VMImage mp::DefaultVMImageVault::fetch_image(const FetchType& fetch_type, const Query& query,
                                                  const PrepareAction& prepare, const ProgressMonitor& monitor)
 {
+    const mp::TracedSpan span{fmt::format("vault fetch: {}", query.name)};
+
     {
         std::lock_guard<decltype(fetch_mutex)> lock{fetch_mutex};
         auto name_entry = instance_image_records.find(query.name);
@@ -332,23 +673,32 @@ mp::VMImage mp::DefaultVMImageVault::fetch_image(const FetchType& fetch_type, co
             id = QCryptographicHash::hash(query.release.c_str(), QCryptographicHash::Sha256).toHex().toStdString();
             auto last_modified = url_downloader->last_modified(image_url);
 
-            std::lock_guard<decltype(fetch_mutex)> lock{fetch_mutex};
-            auto entry = prepared_image_records.find(id);
-            if (entry != prepared_image_records.end())
+            optional<VMImage> cached_image;
             {
-                auto& record = entry->second;
-
-                if (last_modified.isValid() && (last_modified.toString().toStdString() == record.image.release_date))
+                std::lock_guard<decltype(fetch_mutex)> lock{fetch_mutex};
+                auto entry = prepared_image_records.find(id);
+                if (entry != prepared_image_records.end())
                 {
-                    return finalize_image_records(query, record.image, id);
+                    auto& record = entry->second;
+
+                    if (last_modified.isValid() &&
+                        (last_modified.toString().toStdString() == record.image.release_date))
+                        cached_image = record.image;
                 }
             }
 
-            auto running_future = get_image_future(id);
-            if (running_future)
+            // instantiation runs under the id's shard lock only, keeping other images'
+            // launches out of the cached image's way
+            if (cached_image)
+                return finalize_image_records(query, *cached_image, id);
+
+            std::lock_guard<decltype(fetch_mutex)> lock{fetch_mutex};
+            auto running_fetch = get_in_progress_fetch(id);
+            if (running_fetch)
             {
                 monitor(LaunchProgress::WAITING, -1);
-                future = *running_future;
+                running_fetch->progress->attach(monitor);
+                future = running_fetch->future;
             }
             else
             {
@@ -375,12 +725,18 @@ mp::VMImage mp::DefaultVMImageVault::fetch_image(const FetchType& fetch_type, co
                         .arg(last_modified.toString("yyyyMMdd"));
                 const auto image_dir = mp::utils::make_dir(images_dir, image_dir_name);
 
+                auto progress = std::make_shared<FetchProgressFanout>(monitor);
+                ProgressMonitor fanout_monitor = [progress](int download_type, int percentage) {
+                    return progress->report(download_type, percentage);
+                };
+
                 // Had to use std::bind here to workaround the 5 allowable function arguments constraint of
                 // QtConcurrent::run()
                 future = QtConcurrent::run(std::bind(&DefaultVMImageVault::download_and_prepare_source_image, this,
-                                                     info, source_image, image_dir, fetch_type, prepare, monitor));
+                                                     info, source_image, image_dir, fetch_type, prepare,
+                                                     fanout_monitor));
 
-                in_progress_image_fetches[id] = future;
+                in_progress_image_fetches[id] = {future, progress};
             }
         }
         else
@@ -389,9 +745,10 @@ mp::VMImage mp::DefaultVMImageVault::fetch_image(const FetchType& fetch_type, co
 
             id = info.id.toStdString();
 
-            std::lock_guard<decltype(fetch_mutex)> lock{fetch_mutex};
+            optional<std::pair<VMImage, std::string>> cached_hit; // prepared image and its id
             if (!query.name.empty())
             {
+                std::lock_guard<decltype(fetch_mutex)> lock{fetch_mutex};
                 for (auto& record : prepared_image_records)
                 {
                     if (record.second.query.remote_name != query.remote_name)
@@ -401,47 +758,63 @@ mp::VMImage mp::DefaultVMImageVault::fetch_image(const FetchType& fetch_type, co
                     if (id == record.first ||
                         std::find(aliases.cbegin(), aliases.cend(), query.release) != aliases.cend())
                     {
-                        const auto prepared_image = record.second.image;
-                        try
-                        {
-                            return finalize_image_records(query, prepared_image, record.first);
-                        }
-                        catch (const std::exception& e)
-                        {
-                            mpl::log(mpl::Level::warning, category,
-                                     fmt::format("Cannot create instance image: {}", e.what()));
-
-                            break;
-                        }
+                        cached_hit = std::make_pair(record.second.image, record.first);
+                        break;
                     }
                 }
             }
 
-            auto running_future = get_image_future(id);
-            if (running_future)
+            // instantiation runs under the id's shard lock only, keeping other images'
+            // launches out of the cached image's way
+            if (cached_hit)
+            {
+                try
+                {
+                    return finalize_image_records(query, cached_hit->first, cached_hit->second);
+                }
+                catch (const std::exception& e)
+                {
+                    mpl::log(mpl::Level::warning, category,
+                             fmt::format("Cannot create instance image: {}", e.what()));
+                    // fall through to fetching the image afresh
+                }
+            }
+
+            std::lock_guard<decltype(fetch_mutex)> lock{fetch_mutex};
+            auto running_fetch = get_in_progress_fetch(id);
+            if (running_fetch)
             {
                 monitor(LaunchProgress::WAITING, -1);
-                future = *running_future;
+                running_fetch->progress->attach(monitor);
+                future = running_fetch->future;
             }
             else
             {
                 const auto image_dir =
                     mp::utils::make_dir(images_dir, QString("%1-%2").arg(info.release).arg(info.version));
 
+                auto progress = std::make_shared<FetchProgressFanout>(monitor);
+                ProgressMonitor fanout_monitor = [progress](int download_type, int percentage) {
+                    return progress->report(download_type, percentage);
+                };
+
                 // Had to use std::bind here to workaround the 5 allowable function arguments constraint of
                 // QtConcurrent::run()
                 future = QtConcurrent::run(std::bind(&DefaultVMImageVault::download_and_prepare_source_image, this,
-                                                     info, source_image, image_dir, fetch_type, prepare, monitor));
+                                                     info, source_image, image_dir, fetch_type, prepare,
+                                                     fanout_monitor));
 
-                in_progress_image_fetches[id] = future;
+                in_progress_image_fetches[id] = {future, progress};
             }
         }
 
         try
         {
             auto prepared_image = future.result();
-            std::lock_guard<decltype(fetch_mutex)> lock{fetch_mutex};
-            in_progress_image_fetches.erase(id);
+            {
+                std::lock_guard<decltype(fetch_mutex)> lock{fetch_mutex};
+                in_progress_image_fetches.erase(id);
+            }
             return finalize_image_records(query, prepared_image, id);
         }
         catch (const AbortedDownloadException&)
@@ -457,6 +830,60 @@ mp::VMImage mp::DefaultVMImageVault::fetch_image(const FetchType& fetch_type, co
     }
 }
 
+// Forks an instance's disk without copying it: the current disk is demoted to an
+// immutable backing file and both the source and the clone get fresh qcow2 overlays on
+// top of it, so the operation is metadata-only regardless of disk size. The source
+// must be stopped while this runs (the daemon enforces that); once it writes to its
+// new overlay again, a subsequent clone just freezes the chain one level deeper.
+mp::VMImage mp::DefaultVMImageVault::clone_instance_image(const std::string& source_name,
+                                                          const std::string& destination_name)
+{
+    const auto source_entry = instance_image_records.find(source_name);
+    if (source_entry == instance_image_records.end())
+        throw std::runtime_error(fmt::format("no image record for instance \"{}\"", source_name));
+
+    if (instance_image_records.find(destination_name) != instance_image_records.end())
+        throw std::runtime_error(fmt::format("instance \"{}\" already has an image record", destination_name));
+
+    const auto& source_image = source_entry->second.image;
+    const QDir destination_dir{mp::utils::make_dir(instances_dir, QString::fromStdString(destination_name))};
+
+    // bases live outside the instance directories so that removing the source instance
+    // later cannot delete a backing file its clones still depend on
+    const QDir bases_dir{mp::utils::make_dir(data_dir, "clone-bases")};
+    const auto base_path = bases_dir.filePath(QString("%1-%2-%3")
+                                                  .arg(QString::fromStdString(source_name))
+                                                  .arg(QDateTime::currentMSecsSinceEpoch())
+                                                  .arg(QFileInfo{source_image.image_path}.fileName()));
+    if (!QFile::rename(source_image.image_path, base_path))
+        throw std::runtime_error(
+            fmt::format("Cannot demote {} to a backing image", source_image.image_path));
+
+    try
+    {
+        create_overlay_image(base_path, source_image.image_path);
+
+        VMImage cloned_image{source_image};
+        cloned_image.image_path =
+            create_overlay_image(base_path, destination_dir.filePath(QFileInfo{source_image.image_path}.fileName()));
+        cloned_image.kernel_path = link_or_copy(source_image.kernel_path, destination_dir);
+        cloned_image.initrd_path = link_or_copy(source_image.initrd_path, destination_dir);
+
+        instance_image_records[destination_name] = {cloned_image, source_entry->second.query,
+                                                    std::chrono::system_clock::now()};
+        persist_instance_records();
+
+        return cloned_image;
+    }
+    catch (const std::exception&)
+    {
+        // put the source disk back where the instance expects it
+        QFile::remove(source_image.image_path);
+        QFile::rename(base_path, source_image.image_path);
+        throw;
+    }
+}
+
 void mp::DefaultVMImageVault::remove(const std::string& name)
 {
     const auto& name_entry = instance_image_records.find(name);
@@ -465,12 +892,178 @@ void mp::DefaultVMImageVault::remove(const std::string& name)
 
     QDir instance_dir{instances_dir};
     if (instance_dir.cd(QString::fromStdString(name)))
-        instance_dir.removeRecursively();
+    {
+        // Rename into the trash so this returns in constant time; the reclaim workers do
+        // the unlink walk, which takes a while for a large, fully-allocated disk
+        const auto trash_dir = mp::utils::make_dir(data_dir, trash_dir_name);
+        const auto trashed_path = QDir{trash_dir}.filePath(
+            QString{"%1-%2"}.arg(QString::fromStdString(name)).arg(QDateTime::currentMSecsSinceEpoch()));
+        if (QDir{}.rename(instance_dir.absolutePath(), trashed_path))
+            enqueue_reclaim(trashed_path);
+        else
+            instance_dir.removeRecursively();
+    }
 
     instance_image_records.erase(name);
     persist_instance_records();
 }
 
+void mp::DefaultVMImageVault::enqueue_reclaim(const QString& path)
+{
+    {
+        std::lock_guard<decltype(reclaim_mutex)> lock{reclaim_mutex};
+        reclaim_queue.push_back(path);
+    }
+    reclaim_cv.notify_one();
+}
+
+void mp::DefaultVMImageVault::reclaim_main()
+{
+    // Unlinking multi-GB images floods the disk with metadata and discard work
+    demote_thread_to_idle_io();
+
+    for (;;)
+    {
+        QString path;
+        {
+            std::unique_lock<decltype(reclaim_mutex)> lock{reclaim_mutex};
+            reclaim_cv.wait(lock, [this] { return reclaim_stopping || !reclaim_queue.empty(); });
+            if (reclaim_stopping || reclaim_queue.empty()) // pending paths survive in the trash
+                return;
+
+            path = reclaim_queue.front();
+            reclaim_queue.pop_front();
+        }
+
+        // Hold off while image fetches are in flight; the trash keeps the space claimed
+        // either way, and a launch should not share its disk with an unlink storm
+        for (;;)
+        {
+            {
+                std::lock_guard<decltype(fetch_mutex)> fetch_lock{fetch_mutex};
+                if (in_progress_image_fetches.empty())
+                    break;
+            }
+
+            std::unique_lock<decltype(reclaim_mutex)> lock{reclaim_mutex};
+            if (reclaim_cv.wait_for(lock, std::chrono::seconds(5), [this] { return reclaim_stopping; }))
+                return; // `path` stays in the trash for the next start
+        }
+
+        if (QDir{path}.removeRecursively())
+            mpl::log(mpl::Level::debug, category, fmt::format("reclaimed '{}'", path));
+        else
+            mpl::log(mpl::Level::warning, category,
+                     fmt::format("failed to reclaim '{}'; leaving it for the next start", path));
+    }
+}
+
+void mp::DefaultVMImageVault::trash_image_dir(const Path& image_path)
+{
+    const QFileInfo image_file{image_path};
+    if (!image_file.exists())
+        return;
+
+    const auto dir_path = image_file.isDir() ? image_path : image_file.dir().absolutePath();
+    // the trash lives next to the images so the rename stays on one filesystem
+    const auto trash_dir = mp::utils::make_dir(cache_dir, trash_dir_name);
+    const auto trashed_path = QDir{trash_dir}.filePath(
+        QString{"%1-%2"}.arg(QFileInfo{dir_path}.fileName()).arg(QDateTime::currentMSecsSinceEpoch()));
+    if (QDir{}.rename(dir_path, trashed_path))
+        enqueue_reclaim(trashed_path);
+    else
+        delete_image_dir(image_path); // rename refused; take the slow path
+}
+
+void mp::DefaultVMImageVault::scrub_main()
+{
+    demote_thread_to_idle_io();
+
+    std::unique_lock<decltype(scrub_mutex)> lock{scrub_mutex};
+    for (;;)
+    {
+        if (scrub_cv.wait_for(lock, scrub_interval, [this] { return scrub_stopping; }))
+            return;
+
+        lock.unlock();
+        scrub_images();
+        lock.lock();
+    }
+}
+
+// One scrub pass over the prepared images. The recorded download hash predates the
+// prepare step, so it cannot be reused; instead the first pass records the hash of
+// each prepared image as it sits on disk and later passes verify against that. A
+// mismatch can only be corruption - prepared images are never written once finalized -
+// so the image is quarantined and the next launch that wants it fetches it afresh.
+void mp::DefaultVMImageVault::scrub_images()
+{
+    struct ScrubEntry
+    {
+        std::string id;
+        Path image_path;
+        QString expected_hash;
+    };
+
+    std::vector<ScrubEntry> entries;
+    {
+        std::lock_guard<decltype(fetch_mutex)> lock{fetch_mutex};
+        for (const auto& record : prepared_image_records)
+            if (in_progress_image_fetches.find(record.first) == in_progress_image_fetches.end())
+                entries.push_back({record.first, record.second.image.image_path, record.second.disk_hash});
+    }
+
+    const auto stopping = [this] {
+        std::lock_guard<decltype(scrub_mutex)> lock{scrub_mutex};
+        return scrub_stopping;
+    };
+
+    for (const auto& entry : entries)
+    {
+        const auto computed_hash = throttled_image_hash(entry.image_path, stopping);
+        if (stopping())
+            return;
+
+        std::lock_guard<decltype(fetch_mutex)> lock{fetch_mutex};
+        auto record_entry = prepared_image_records.find(entry.id);
+        if (record_entry == prepared_image_records.end() ||
+            record_entry->second.image.image_path != entry.image_path)
+            continue; // replaced or pruned while it was being hashed
+
+        if (!computed_hash)
+        {
+            mpl::log(mpl::Level::warning, category,
+                     fmt::format("could not read {} to verify it", entry.image_path));
+        }
+        else if (entry.expected_hash.isEmpty())
+        {
+            record_entry->second.disk_hash = *computed_hash;
+            persist_image_records();
+        }
+        else if (*computed_hash != entry.expected_hash)
+        {
+            if (use_backing_image())
+            {
+                // Instance disks may back onto this image; quarantining it would turn
+                // silent corruption into instantly broken instances
+                mpl::log(mpl::Level::error, category,
+                         fmt::format("Image {} failed verification but may back instance disks; leaving it in place",
+                                     record_entry->second.query.release));
+            }
+            else
+            {
+                mpl::log(mpl::Level::error, category,
+                         fmt::format("Image {} failed verification; quarantining it and deferring its download "
+                                     "until it is next used",
+                                     record_entry->second.query.release));
+                trash_image_dir(entry.image_path);
+                prepared_image_records.erase(record_entry);
+                persist_image_records();
+            }
+        }
+    }
+}
+
 bool mp::DefaultVMImageVault::has_record_for(const std::string& name)
 {
     return instance_image_records.find(name) != instance_image_records.end();
@@ -481,6 +1074,11 @@ void mp::DefaultVMImageVault::prune_expired_images()
     std::vector<decltype(prepared_image_records)::key_type> expired_keys;
     std::lock_guard<decltype(fetch_mutex)> lock{fetch_mutex};
 
+    // Overlay instance disks reference prepared images as their qcow2 backing files, so
+    // expiring those would corrupt every instance created from them.
+    if (use_backing_image())
+        return;
+
     for (const auto& record : prepared_image_records)
     {
         // Expire source images if they aren't persistent and haven't been accessed in 14 days
@@ -491,7 +1089,7 @@ void mp::DefaultVMImageVault::prune_expired_images()
                 mpl::Level::info, category,
                 fmt::format("Source image {} is expired. Removing it from the cache.", record.second.query.release));
             expired_keys.push_back(record.first);
-            delete_image_dir(record.second.image.image_path);
+            trash_image_dir(record.second.image.image_path);
         }
     }
 
@@ -506,7 +1104,7 @@ void mp::DefaultVMImageVault::prune_expired_images()
             mpl::log(mpl::Level::info, category,
                      fmt::format("Source image {} is no longer valid. Removing it from the cache.",
                                  entry.absoluteFilePath()));
-            delete_image_dir(entry.absoluteFilePath());
+            trash_image_dir(entry.absoluteFilePath());
         }
     }
 
@@ -514,6 +1112,18 @@ void mp::DefaultVMImageVault::prune_expired_images()
         prepared_image_records.erase(key);
 
     persist_image_records();
+
+#ifdef Q_OS_LINUX
+    // Boot artifacts whose link count dropped to one are referenced by no image or
+    // instance any more and can go
+    const QDir artifacts_dir{cache_dir.filePath(boot_artifacts_dir_name)};
+    for (const auto& entry : artifacts_dir.entryInfoList(QDir::Files))
+    {
+        struct stat st;
+        if (::stat(entry.absoluteFilePath().toUtf8().constData(), &st) == 0 && st.st_nlink == 1)
+            QFile::remove(entry.absoluteFilePath());
+    }
+#endif
 }
 
 void mp::DefaultVMImageVault::update_images(const FetchType& fetch_type, const PrepareAction& prepare,
@@ -522,6 +1132,7 @@ void mp::DefaultVMImageVault::update_images(const FetchType& fetch_type, const P
     mpl::log(mpl::Level::debug, category, "Checking for images to update…");
 
     std::vector<decltype(prepared_image_records)::key_type> keys_to_update;
+    std::vector<decltype(prepared_image_records)::key_type> keys_to_drop;
     for (const auto& record : prepared_image_records)
     {
         if (record.second.query.query_type == Query::Type::Alias &&
@@ -532,7 +1143,10 @@ void mp::DefaultVMImageVault::update_images(const FetchType& fetch_type, const P
                 auto info = info_for(record.second.query);
                 if (info.id.toStdString() != record.first)
                 {
-                    keys_to_update.push_back(record.first);
+                    if (use_backing_image() || image_in_use(record.first))
+                        keys_to_update.push_back(record.first);
+                    else
+                        keys_to_drop.push_back(record.first);
                 }
             }
             catch (const mp::UnsupportedImageException& e)
@@ -542,6 +1156,25 @@ void mp::DefaultVMImageVault::update_images(const FetchType& fetch_type, const P
         }
     }
 
+    // An updated source image only benefits future launches - instances keep their own
+    // copies. When nothing references the superseded image, downloading its replacement
+    // every night just burns bandwidth; drop the stale cache entry instead and let the
+    // next launch that wants the alias fetch the current image on demand.
+    if (!keys_to_drop.empty())
+    {
+        std::lock_guard<decltype(fetch_mutex)> lock{fetch_mutex};
+        for (const auto& key : keys_to_drop)
+        {
+            const auto& record = prepared_image_records[key];
+            mpl::log(mpl::Level::info, category,
+                     fmt::format("{} has a new image; deferring its download until it is next used",
+                                 record.query.release));
+            trash_image_dir(record.image.image_path);
+            prepared_image_records.erase(key);
+        }
+        persist_image_records();
+    }
+
     for (const auto& key : keys_to_update)
     {
         const auto& record = prepared_image_records[key];
@@ -552,7 +1185,7 @@ void mp::DefaultVMImageVault::update_images(const FetchType& fetch_type, const P
 
             // Remove old image
             std::lock_guard<decltype(fetch_mutex)> lock{fetch_mutex};
-            delete_image_dir(record.image.image_path);
+            trash_image_dir(record.image.image_path);
             prepared_image_records.erase(key);
             persist_image_records();
         }
@@ -564,6 +1197,14 @@ void mp::DefaultVMImageVault::update_images(const FetchType& fetch_type, const P
     }
 }
 
+bool mp::DefaultVMImageVault::image_in_use(const std::string& id) const
+{
+    return std::any_of(instance_image_records.cbegin(), instance_image_records.cend(),
+                       [&id](const std::pair<const std::string, VaultRecord>& entry) {
+                           return entry.second.image.id == id;
+                       });
+}
+
 mp::MemorySize mp::DefaultVMImageVault::minimum_image_size_for(const std::string& id)
 {
     auto prepared_image_entry = prepared_image_records.find(id);
@@ -591,6 +1232,8 @@ mp::VMImage mp::DefaultVMImageVault::download_and_prepare_source_image(
     const VMImageInfo& info, mp::optional<VMImage>& existing_source_image, const QDir& image_dir,
     const FetchType& fetch_type, const PrepareAction& prepare, const ProgressMonitor& monitor)
 {
+    const mp::StageTimer timer{"vault.fetch"}; // covers download, decode and hashing
+
     VMImage source_image;
     auto id = info.id;
 
@@ -613,27 +1256,103 @@ mp::VMImage mp::DefaultVMImageVault::download_and_prepare_source_image(
 
     mp::vault::DeleteOnException image_file{source_image.image_path};
 
+    QFuture<VMImage> kernel_and_initrd_future;
+
     try
     {
-        url_downloader->download_to(info.image_location, source_image.image_path, info.size, LaunchProgress::IMAGE,
-                                    monitor);
+        if (fetch_type == FetchType::ImageKernelAndInitrd)
+        {
+            // The kernel and initrd are independent of the image payload, so fetch them
+            // concurrently with the image download and join below, before the prepare step.
+            kernel_and_initrd_future = QtConcurrent::run(std::bind(&DefaultVMImageVault::fetch_kernel_and_initrd, this,
+                                                                   info, source_image, image_dir, monitor));
+        }
 
-        if (info.verify)
+        if (source_image.image_path.endsWith(".xz"))
         {
-            monitor(LaunchProgress::VERIFY, -1);
-            mp::vault::verify_image_download(source_image.image_path, id);
+            // Pipeline the fetch: downloaded chunks are fed straight into the xz decoder and
+            // the hash, so no intermediate compressed file is written and no extra read pass
+            // is needed for extraction or verification.
+            auto decoded_image_path = source_image.image_path;
+            decoded_image_path.remove(".xz");
+            mp::vault::DeleteOnException decoded_image_file{decoded_image_path};
+
+            QFile decoded_file{decoded_image_path};
+            if (!decoded_file.open(QIODevice::WriteOnly))
+                throw std::runtime_error(
+                    fmt::format("failed to open {} for writing", decoded_image_path));
+
+            Sha256Hash hash;
+            XzImageDecoder decoder;
+            DecodePipeline pipeline{[&hash, &decoder, &decoded_file](const QByteArray& chunk) {
+                hash.addData(chunk);
+                decoder.decode_chunk(chunk.constData(), chunk.size(), decoded_file);
+            }};
+
+            auto sink = [&pipeline](const QByteArray& chunk) { return pipeline.push(chunk); };
+
+            try
+            {
+                url_downloader->download_to_sink(info.image_location, info.size, LaunchProgress::IMAGE, monitor,
+                                                 sink);
+            }
+            catch (const DownloadException&)
+            {
+                pipeline.finish(); // rethrows the decode or hash failure that aborted the transfer
+                throw;
+            }
+
+            pipeline.finish();
+
+            if (info.verify)
+            {
+                monitor(LaunchProgress::VERIFY, -1);
+                if (QString{hash.result().toHex()} != id)
+                    throw std::runtime_error("Downloaded image hash does not match");
+            }
+
+            source_image.image_path = decoded_image_path;
         }
+        else if (info.verify)
+        {
+            // Hash the image as chunks arrive, so verification does not cost an extra
+            // full read of the downloaded file.
+            QFile image_qfile{source_image.image_path};
+            if (!image_qfile.open(QIODevice::WriteOnly | QIODevice::Truncate))
+                throw std::runtime_error(
+                    fmt::format("failed to open {} for writing", source_image.image_path));
+
+            Sha256Hash hash;
+            auto sink = [&](const QByteArray& chunk) {
+                hash.addData(chunk);
+                return image_qfile.write(chunk) >= 0;
+            };
+
+            url_downloader->download_to_sink(info.image_location, info.size, LaunchProgress::IMAGE, monitor, sink);
+            image_qfile.close();
 
-        if (fetch_type == FetchType::ImageKernelAndInitrd)
+            monitor(LaunchProgress::VERIFY, -1);
+            if (QString{hash.result().toHex()} != id)
+                throw std::runtime_error("Downloaded image hash does not match");
+        }
+        else
         {
-            source_image = fetch_kernel_and_initrd(info, source_image, image_dir, monitor);
+            url_downloader->download_to(info.image_location, source_image.image_path, info.size, LaunchProgress::IMAGE,
+                                        monitor);
         }
 
-        if (source_image.image_path.endsWith(".xz"))
+        if (fetch_type == FetchType::ImageKernelAndInitrd)
         {
-            source_image.image_path = mp::vault::extract_image(source_image.image_path, monitor, true);
+            const auto kernel_image = kernel_and_initrd_future.result();
+            source_image.kernel_path = kernel_image.kernel_path;
+            source_image.initrd_path = kernel_image.initrd_path;
         }
 
+        // qemu-img conversion is CPU and IO heavy; bound how many prepares run at once so
+        // several simultaneous launches of different images don't swamp the host.
+        prepare_slots.acquire();
+        QSemaphoreReleaser prepare_slot{prepare_slots};
+
         auto prepared_image = prepare(source_image);
         remove_source_images(source_image, prepared_image);
 
@@ -641,10 +1360,12 @@ mp::VMImage mp::DefaultVMImageVault::download_and_prepare_source_image(
     }
     catch (const AbortedDownloadException&)
     {
+        kernel_and_initrd_future.waitForFinished();
         throw;
     }
     catch (const std::exception& e)
     {
+        kernel_and_initrd_future.waitForFinished();
         throw CreateImageException(e.what());
     }
 }
@@ -656,9 +1377,38 @@ QString mp::DefaultVMImageVault::extract_image_from(const std::string& instance_
     const QDir output_dir{mp::utils::make_dir(instances_dir, name)};
     QFileInfo file_info{source_image.image_path};
     const auto image_name = file_info.fileName().remove(".xz");
-    const auto image_path = output_dir.filePath(image_name);
 
-    return mp::vault::extract_image(image_path, monitor);
+    // Decompressing xz is expensive, so decoded local images are kept under the cache dir,
+    // keyed on the source file's identity; further launches from the same file skip the
+    // decode and just take a (reflink where available) copy of the cached result.
+    const auto cache_key = QString::fromUtf8(QCryptographicHash::hash(QString{"%1|%2|%3"}
+                                                                          .arg(file_info.absoluteFilePath())
+                                                                          .arg(file_info.size())
+                                                                          .arg(file_info.lastModified().toMSecsSinceEpoch())
+                                                                          .toUtf8(),
+                                                                      QCryptographicHash::Sha256)
+                                                 .toHex()
+                                                 .left(12));
+    const QDir decoded_dir{mp::utils::make_dir(QDir{mp::utils::make_dir(cache_dir, "decoded-images")}, cache_key)};
+    const auto cached_path = decoded_dir.filePath(image_name);
+
+    if (!QFile::exists(cached_path))
+    {
+        const mp::TracedSpan span{fmt::format("vault decode: {}", file_info.fileName())};
+
+        // Decode to the side and rename, so a decode interrupted mid-way cannot be
+        // mistaken for a cached image on the next launch
+        const auto partial_path = cached_path + ".partial";
+        mp::vault::DeleteOnException partial_file{partial_path};
+
+        XzImageDecoder decoder{source_image.image_path};
+        decoder.decode_to(partial_path, monitor);
+
+        QFile::remove(cached_path);
+        QFile::rename(partial_path, cached_path);
+    }
+
+    return copy(cached_path, output_dir);
 }
 
 mp::VMImage mp::DefaultVMImageVault::image_instance_from(const std::string& instance_name,
@@ -667,9 +1417,21 @@ mp::VMImage mp::DefaultVMImageVault::image_instance_from(const std::string& inst
     auto name = QString::fromStdString(instance_name);
     auto output_dir = mp::utils::make_dir(instances_dir, name);
 
+    if (use_backing_image())
+    {
+        return {create_backed_image(prepared_image.image_path, output_dir),
+                link_or_copy(prepared_image.kernel_path, output_dir),
+                link_or_copy(prepared_image.initrd_path, output_dir),
+                prepared_image.id,
+                prepared_image.original_release,
+                prepared_image.current_release,
+                prepared_image.release_date,
+                {}};
+    }
+
     return {copy(prepared_image.image_path, output_dir),
-            copy(prepared_image.kernel_path, output_dir),
-            copy(prepared_image.initrd_path, output_dir),
+            link_or_copy(prepared_image.kernel_path, output_dir),
+            link_or_copy(prepared_image.initrd_path, output_dir),
             prepared_image.id,
             prepared_image.original_release,
             prepared_image.current_release,
@@ -689,10 +1451,78 @@ mp::VMImage mp::DefaultVMImageVault::fetch_kernel_and_initrd(const VMImageInfo&
     url_downloader->download_to(info.kernel_location, image.kernel_path, -1, LaunchProgress::KERNEL, monitor);
     url_downloader->download_to(info.initrd_location, image.initrd_path, -1, LaunchProgress::INITRD, monitor);
 
+    image.kernel_path = dedupe_boot_artifact(image.kernel_path);
+    image.initrd_path = dedupe_boot_artifact(image.initrd_path);
+
     return image;
 }
 
-mp::optional<QFuture<mp::VMImage>> mp::DefaultVMImageVault::get_image_future(const std::string& id)
+// Folds a freshly downloaded kernel/initrd into the content-addressed boot artifact
+// cache: the blob's canonical copy lives under boot-artifacts/<hash>-<name> and the
+// download becomes a hard link to it, so identical artifacts fetched for different
+// images share one copy on disk (and every instance link_or_copy further links to the
+// same inode). On failure the download is simply kept as is.
+QString mp::DefaultVMImageVault::dedupe_boot_artifact(const QString& file_path)
+{
+#ifdef Q_OS_LINUX
+    if (file_path.isEmpty())
+        return file_path;
+
+    const auto hash = mp::vault::compute_image_hash(file_path);
+    const QDir artifacts_dir{mp::utils::make_dir(cache_dir, boot_artifacts_dir_name)};
+    const auto canonical_path = artifacts_dir.filePath(hash.left(12) + "-" + QFileInfo{file_path}.fileName());
+
+    if (!QFileInfo::exists(canonical_path))
+    {
+        // different filesystem or no link support; leave the download alone
+        if (::link(file_path.toUtf8().constData(), canonical_path.toUtf8().constData()) != 0)
+            return file_path;
+    }
+    else
+    {
+        QFile::remove(file_path);
+        if (::link(canonical_path.toUtf8().constData(), file_path.toUtf8().constData()) != 0 &&
+            !QFile::copy(canonical_path, file_path))
+            throw std::runtime_error(fmt::format("Failed to materialize boot artifact {}", file_path));
+    }
+#endif
+
+    return file_path;
+}
+
+mp::DefaultVMImageVault::FetchProgressFanout::FetchProgressFanout(const ProgressMonitor& leader)
+{
+    listeners.push_back({true, leader});
+}
+
+void mp::DefaultVMImageVault::FetchProgressFanout::attach(const ProgressMonitor& follower)
+{
+    std::lock_guard<std::mutex> lock{mutex};
+
+    if (last_report) // catch the new follower up before the next report comes in
+        follower(last_report->first, last_report->second);
+
+    listeners.push_back({true, follower});
+}
+
+bool mp::DefaultVMImageVault::FetchProgressFanout::report(int download_type, int progress)
+{
+    std::lock_guard<std::mutex> lock{mutex};
+    last_report = std::make_pair(download_type, progress);
+
+    auto any_active = false;
+    for (auto& listener : listeners)
+    {
+        if (listener.active)
+            listener.active = listener.monitor(download_type, progress);
+
+        any_active = any_active || listener.active;
+    }
+
+    return any_active;
+}
+
+mp::optional<mp::DefaultVMImageVault::ImageFetch> mp::DefaultVMImageVault::get_in_progress_fetch(const std::string& id)
 {
     auto it = in_progress_image_fetches.find(id);
     if (it != in_progress_image_fetches.end())
@@ -703,28 +1533,47 @@ mp::optional<QFuture<mp::VMImage>> mp::DefaultVMImageVault::get_image_future(con
     return mp::nullopt;
 }
 
+// Expects the caller NOT to hold fetch_mutex: the records mutex only covers the map
+// updates, while the disk-heavy instantiation runs under the image id's shard lock, so
+// launches of different images finalize concurrently.
 mp::VMImage mp::DefaultVMImageVault::finalize_image_records(const Query& query, const VMImage& prepared_image,
                                                             const std::string& id)
 {
-    VMImage vm_image;
+    std::lock_guard<std::mutex> shard_lock{shard_for(id)};
+
+    // Do not save the instance name for prepared images
+    Query prepared_query{query};
+    prepared_query.name = "";
+
+    {
+        // Refresh the prepared record before the instantiation below, so the image
+        // cannot expire (and be trashed) while it is being copied from. The scrubber's
+        // baseline hash carries over as long as the image on disk is the same one.
+        std::lock_guard<decltype(fetch_mutex)> lock{fetch_mutex};
+        auto& record = prepared_image_records[id];
+        auto disk_hash = record.image.image_path == prepared_image.image_path ? record.disk_hash : QString{};
+        record = {prepared_image, prepared_query, std::chrono::system_clock::now(), std::move(disk_hash)};
+        persist_image_records();
+    }
 
+    VMImage vm_image;
     if (!query.name.empty())
     {
         vm_image = image_instance_from(query.name, prepared_image);
+
+        std::lock_guard<decltype(fetch_mutex)> lock{fetch_mutex};
         instance_image_records[query.name] = {vm_image, query, std::chrono::system_clock::now()};
+        persist_instance_records();
     }
 
-    // Do not save the instance name for prepared images
-    Query prepared_query{query};
-    prepared_query.name = "";
-    prepared_image_records[id] = {prepared_image, prepared_query, std::chrono::system_clock::now()};
-
-    persist_instance_records();
-    persist_image_records();
-
     return vm_image;
 }
 
+std::mutex& mp::DefaultVMImageVault::shard_for(const std::string& id)
+{
+    return shard_mutexes[std::hash<std::string>{}(id) % shard_mutexes.size()];
+}
+
 mp::VMImageInfo mp::DefaultVMImageVault::get_kernel_query_info(const std::string& name)
 {
     Query kernel_query{name, "default", false, "", Query::Type::Alias};
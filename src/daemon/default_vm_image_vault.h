@@ -27,9 +27,17 @@
 
 #include <QDir>
 #include <QFuture>
+#include <QSemaphore>
 
+#include <array>
+#include <condition_variable>
+#include <deque>
+#include <memory>
 #include <mutex>
+#include <thread>
 #include <unordered_map>
+#include <utility>
+#include <vector>
 
 namespace multipass
 {
@@ -41,6 +49,9 @@ public:
     multipass::VMImage image;
     multipass::Query query;
     std::chrono::system_clock::time_point last_accessed;
+    // SHA256 of the prepared image as it sits on disk; empty until the scrubber
+    // baselines it (the recorded download hash predates the prepare step)
+    QString disk_hash;
 };
 class DefaultVMImageVault final : public BaseVMImageVault
 {
@@ -51,6 +62,7 @@ public:
 
     VMImage fetch_image(const FetchType& fetch_type, const Query& query, const PrepareAction& prepare,
                         const ProgressMonitor& monitor) override;
+    VMImage clone_instance_image(const std::string& source_name, const std::string& destination_name) override;
     void remove(const std::string& name) override;
     bool has_record_for(const std::string& name) override;
     void prune_expired_images() override;
@@ -67,11 +79,47 @@ private:
                                const ProgressMonitor& monitor);
     VMImage fetch_kernel_and_initrd(const VMImageInfo& info, const VMImage& source_image, const QDir& image_dir,
                                     const ProgressMonitor& monitor);
-    optional<QFuture<VMImage>> get_image_future(const std::string& id);
+    // Relays the one real fetch's progress to every launch waiting on the same image;
+    // the fetch only aborts once every attached client has cancelled
+    class FetchProgressFanout
+    {
+    public:
+        explicit FetchProgressFanout(const ProgressMonitor& leader);
+
+        void attach(const ProgressMonitor& follower);
+        bool report(int download_type, int progress);
+
+    private:
+        struct Listener
+        {
+            bool active;
+            ProgressMonitor monitor;
+        };
+
+        std::mutex mutex;
+        optional<std::pair<int, int>> last_report;
+        std::vector<Listener> listeners;
+    };
+
+    struct ImageFetch
+    {
+        QFuture<VMImage> future;
+        std::shared_ptr<FetchProgressFanout> progress;
+    };
+
+    optional<ImageFetch> get_in_progress_fetch(const std::string& id);
     VMImage finalize_image_records(const Query& query, const VMImage& prepared_image, const std::string& id);
     VMImageInfo get_kernel_query_info(const std::string& name);
+    bool image_in_use(const std::string& id) const;
     void persist_image_records();
     void persist_instance_records();
+    std::mutex& shard_for(const std::string& id);
+    void scrub_main();
+    void scrub_images();
+    void enqueue_reclaim(const QString& path);
+    void reclaim_main();
+    void trash_image_dir(const Path& image_path);
+    QString dedupe_boot_artifact(const QString& file_path);
 
     URLDownloader* const url_downloader;
     const QDir cache_dir;
@@ -80,10 +128,33 @@ private:
     const QDir images_dir;
     const days days_to_expire;
     std::mutex fetch_mutex;
+    // Finalizing a fetch (instantiating the image for an instance) is disk-heavy; it runs
+    // under its image id's shard lock instead of fetch_mutex, so launches of different
+    // images finalize in parallel while two launches of the same image stay serialized.
+    std::array<std::mutex, 16> shard_mutexes;
+    QSemaphore prepare_slots; // caps concurrent image prepare (qemu-img) jobs
 
     std::unordered_map<std::string, VaultRecord> prepared_image_records;
     std::unordered_map<std::string, VaultRecord> instance_image_records;
-    std::unordered_map<std::string, QFuture<VMImage>> in_progress_image_fetches;
+    std::unordered_map<std::string, ImageFetch> in_progress_image_fetches;
+
+    // Removed instance and expired image directories are renamed into the trash and
+    // unlinked by these workers, so removal and pruning return in the time of a rename
+    // however large the disks are; anything still in the trash at startup is swept back
+    // into the queue.
+    std::mutex reclaim_mutex;
+    std::condition_variable reclaim_cv;
+    std::deque<QString> reclaim_queue;
+    bool reclaim_stopping{false};
+    std::vector<std::thread> reclaim_workers;
+
+    // The scrubber periodically re-hashes the prepared images at idle I/O priority and
+    // quarantines any that no longer match their baseline, so disk or memory corruption
+    // costs a re-download on the next launch instead of a mysteriously failing boot.
+    std::mutex scrub_mutex;
+    std::condition_variable scrub_cv;
+    bool scrub_stopping{false};
+    std::thread scrub_worker;
 };
 }
 #endif // MULTIPASS_DEFAULT_VM_IMAGE_VAULT_H
@@ -53,8 +53,9 @@ mp::DelayedShutdownTimer::DelayedShutdownTimer(VirtualMachine* virtual_machine,
 
 mp::DelayedShutdownTimer::~DelayedShutdownTimer()
 {
-    if (shutdown_timer.isActive())
+    if (active)
     {
+        MP_SHUTDOWN_SCHEDULER.cancel(task_id);
         try
         {
             if (ssh_session)
@@ -89,32 +90,14 @@ void mp::DelayedShutdownTimer::start(const std::chrono::milliseconds delay)
         write_shutdown_message(ssh_session, std::chrono::duration_cast<std::chrono::minutes>(delay),
                                virtual_machine->vm_name);
 
+        this->delay = delay;
         time_remaining = delay;
-        std::chrono::minutes time_elapsed{1};
-        QObject::connect(&shutdown_timer, &QTimer::timeout, [this, delay, time_elapsed]() mutable {
-            time_remaining = delay - time_elapsed;
-
-            if (time_remaining <= std::chrono::minutes(5) ||
-                time_remaining % std::chrono::minutes(5) == std::chrono::minutes::zero())
-            {
-                write_shutdown_message(ssh_session, std::chrono::duration_cast<std::chrono::minutes>(time_remaining),
-                                       virtual_machine->vm_name);
-            }
-
-            if (time_elapsed >= delay)
-            {
-                shutdown_timer.stop();
-                shutdown_instance();
-            }
-            else
-            {
-                time_elapsed += std::chrono::minutes(1);
-            }
-        });
+        time_elapsed = std::chrono::minutes(1);
 
         virtual_machine->state = VirtualMachine::State::delayed_shutdown;
 
-        shutdown_timer.start(delay < std::chrono::minutes(1) ? delay : std::chrono::minutes(1));
+        active = true;
+        schedule_next_tick(delay < std::chrono::minutes(1) ? delay : std::chrono::minutes(1));
     }
     else
     {
@@ -123,6 +106,34 @@ void mp::DelayedShutdownTimer::start(const std::chrono::milliseconds delay)
     }
 }
 
+void mp::DelayedShutdownTimer::schedule_next_tick(const std::chrono::milliseconds interval)
+{
+    task_id = MP_SHUTDOWN_SCHEDULER.schedule(interval, [this] { on_tick(); });
+}
+
+void mp::DelayedShutdownTimer::on_tick()
+{
+    time_remaining = delay - time_elapsed;
+
+    if (time_remaining <= std::chrono::minutes(5) ||
+        time_remaining % std::chrono::minutes(5) == std::chrono::minutes::zero())
+    {
+        write_shutdown_message(ssh_session, std::chrono::duration_cast<std::chrono::minutes>(time_remaining),
+                               virtual_machine->vm_name);
+    }
+
+    if (time_elapsed >= delay)
+    {
+        active = false;
+        shutdown_instance();
+    }
+    else
+    {
+        time_elapsed += std::chrono::minutes(1);
+        schedule_next_tick(std::chrono::minutes(1));
+    }
+}
+
 std::chrono::seconds mp::DelayedShutdownTimer::get_time_remaining()
 {
     return std::chrono::duration_cast<std::chrono::minutes>(time_remaining);
@@ -0,0 +1,178 @@
+/*
+ * Copyright (C) 2021 Canonical, Ltd.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; version 3.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "instance_state_mirror.h"
+
+#include <multipass/format.h>
+#include <multipass/logging/log.h>
+
+#include <atomic>
+#include <cstring>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <unistd.h>
+
+namespace mp = multipass;
+namespace mpl = multipass::logging;
+
+namespace
+{
+constexpr auto category = "state mirror";
+constexpr std::uint32_t mirror_magic = 0x4d50534d; // "MPSM"
+constexpr std::uint32_t max_slots = 1024;          // ~72KiB all told; plenty of instances
+constexpr std::size_t max_name_len = 63;           // valid hostnames fit with room to spare
+
+struct Header
+{
+    std::uint32_t magic;
+    std::uint32_t slot_count;
+};
+} // namespace
+
+struct mp::InstanceStateMirror::Slot
+{
+    std::uint32_t in_use;
+    std::uint32_t state;
+    char name[max_name_len + 1];
+};
+
+namespace
+{
+constexpr std::size_t mirror_size = sizeof(Header) + max_slots * sizeof(mp::InstanceStateMirror::Slot);
+
+auto atomic_at(std::uint32_t& word)
+{
+    static_assert(sizeof(std::atomic<std::uint32_t>) == sizeof(std::uint32_t), "unexpected atomic layout");
+    return reinterpret_cast<std::atomic<std::uint32_t>*>(&word);
+}
+} // namespace
+
+mp::InstanceStateMirror::InstanceStateMirror(const QString& path)
+{
+    fd = ::open(path.toStdString().c_str(), O_RDWR | O_CREAT | O_CLOEXEC, 0644);
+    if (fd < 0 || ::ftruncate(fd, mirror_size) < 0)
+    {
+        mpl::log(mpl::Level::warning, category,
+                 fmt::format("could not set up state mirror at '{}'; crash recovery will rely on the journal alone",
+                             path));
+        if (fd >= 0)
+        {
+            ::close(fd);
+            fd = -1;
+        }
+        return;
+    }
+
+    mapped = ::mmap(nullptr, mirror_size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    if (mapped == MAP_FAILED)
+    {
+        mapped = nullptr;
+        ::close(fd);
+        fd = -1;
+        return;
+    }
+
+    auto header = static_cast<Header*>(mapped);
+    if (header->magic != mirror_magic || header->slot_count != max_slots)
+    {
+        // fresh or incompatible file; initialise and start with no stored states
+        std::memset(mapped, 0, mirror_size);
+        header->magic = mirror_magic;
+        header->slot_count = max_slots;
+    }
+
+    // index surviving slots so new recordings update them in place
+    auto slots = reinterpret_cast<Slot*>(static_cast<char*>(mapped) + sizeof(Header));
+    for (std::uint32_t i = 0; i < max_slots; ++i)
+    {
+        if (slots[i].in_use && slots[i].name[max_name_len] == '\0')
+            slot_indices.emplace(slots[i].name, i);
+    }
+}
+
+mp::InstanceStateMirror::~InstanceStateMirror()
+{
+    if (mapped != nullptr)
+        ::munmap(mapped, mirror_size);
+    if (fd >= 0)
+        ::close(fd);
+}
+
+std::unordered_map<std::string, mp::VirtualMachine::State> mp::InstanceStateMirror::stored_states() const
+{
+    std::unordered_map<std::string, VirtualMachine::State> states;
+    if (mapped == nullptr)
+        return states;
+
+    auto slots = reinterpret_cast<const Slot*>(static_cast<const char*>(mapped) + sizeof(Header));
+    for (std::uint32_t i = 0; i < max_slots; ++i)
+    {
+        if (slots[i].in_use && slots[i].name[max_name_len] == '\0')
+            states.emplace(slots[i].name, static_cast<VirtualMachine::State>(slots[i].state));
+    }
+
+    return states;
+}
+
+auto mp::InstanceStateMirror::slot_for(const std::string& name) -> Slot*
+{
+    if (mapped == nullptr || name.size() > max_name_len)
+        return nullptr;
+
+    auto slots = reinterpret_cast<Slot*>(static_cast<char*>(mapped) + sizeof(Header));
+
+    auto indexed = slot_indices.find(name);
+    if (indexed != slot_indices.end())
+        return &slots[indexed->second];
+
+    for (std::uint32_t i = 0; i < max_slots; ++i)
+    {
+        if (!slots[i].in_use)
+        {
+            std::memset(slots[i].name, 0, sizeof(slots[i].name));
+            std::memcpy(slots[i].name, name.data(), name.size());
+            slot_indices[name] = i;
+            return &slots[i];
+        }
+    }
+
+    return nullptr; // mirror full; those instances fall back to the journal
+}
+
+void mp::InstanceStateMirror::record(const std::string& name, VirtualMachine::State state)
+{
+    auto slot = slot_for(name);
+    if (slot == nullptr)
+        return;
+
+    // state first, then publish with a release store; a kill between the two just leaves
+    // the previous state visible, never a torn one
+    atomic_at(slot->state)->store(static_cast<std::uint32_t>(state), std::memory_order_relaxed);
+    atomic_at(slot->in_use)->store(1, std::memory_order_release);
+}
+
+void mp::InstanceStateMirror::forget(const std::string& name)
+{
+    auto indexed = slot_indices.find(name);
+    if (indexed == slot_indices.end())
+        return;
+
+    auto slots = reinterpret_cast<Slot*>(static_cast<char*>(mapped) + sizeof(Header));
+    atomic_at(slots[indexed->second].in_use)->store(0, std::memory_order_release);
+    slot_indices.erase(indexed);
+}
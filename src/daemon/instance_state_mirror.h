@@ -0,0 +1,61 @@
+/*
+ * Copyright (C) 2021 Canonical, Ltd.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; version 3.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#ifndef MULTIPASS_INSTANCE_STATE_MIRROR_H
+#define MULTIPASS_INSTANCE_STATE_MIRROR_H
+
+#include <multipass/virtual_machine.h>
+
+#include <QString>
+
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+
+namespace multipass
+{
+// Last-known instance states mirrored into a preallocated memory-mapped file. Each
+// transition is a couple of atomic stores into an already-resident page, so there is no
+// write that a SIGKILL (OOM killer included) can interrupt halfway; a restarted daemon
+// reads back the exact states without probing the instances. This complements the state
+// journal: the journal is the readable record, the mirror closes the journal's
+// open-write-close window.
+class InstanceStateMirror
+{
+public:
+    explicit InstanceStateMirror(const QString& path);
+    ~InstanceStateMirror();
+
+    InstanceStateMirror(const InstanceStateMirror&) = delete;
+    InstanceStateMirror& operator=(const InstanceStateMirror&) = delete;
+
+    // States found in the file as it was left by the previous run
+    std::unordered_map<std::string, VirtualMachine::State> stored_states() const;
+
+    void record(const std::string& name, VirtualMachine::State state);
+    void forget(const std::string& name);
+
+private:
+    struct Slot;
+    Slot* slot_for(const std::string& name);
+
+    int fd{-1};
+    void* mapped{nullptr};
+    std::unordered_map<std::string, std::uint32_t> slot_indices;
+};
+} // namespace multipass
+#endif // MULTIPASS_INSTANCE_STATE_MIRROR_H
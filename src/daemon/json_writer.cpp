@@ -21,6 +21,7 @@
 
 #include <QFile>
 #include <QJsonDocument>
+#include <QSaveFile>
 
 namespace mp = multipass;
 
@@ -28,7 +29,21 @@ void mp::write_json(const QJsonObject& root, QString file_name)
 {
     QJsonDocument doc{root};
     auto raw_json = doc.toJson();
-    QFile db_file{file_name};
-    db_file.open(QIODevice::ReadWrite | QIODevice::Truncate);
-    db_file.write(raw_json);
+
+    // The databases are rewritten far more often than they change; leave the file
+    // untouched when the serialized bytes are identical
+    {
+        QFile db_file{file_name};
+        if (db_file.size() == raw_json.size() && db_file.open(QIODevice::ReadOnly) && db_file.readAll() == raw_json)
+            return;
+    }
+
+    // Write-to-temporary plus atomic rename: a crash mid-write leaves the previous
+    // database intact instead of a truncated file
+    QSaveFile db_file{file_name};
+    if (db_file.open(QIODevice::WriteOnly))
+    {
+        db_file.write(raw_json);
+        db_file.commit();
+    }
 }
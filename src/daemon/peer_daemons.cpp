@@ -0,0 +1,166 @@
+/*
+ * Copyright (C) 2021 Canonical, Ltd.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; version 3.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "peer_daemons.h"
+
+#include <multipass/format.h>
+#include <multipass/logging/log.h>
+
+#include <QString>
+
+#include <algorithm>
+#include <chrono>
+#include <future>
+
+namespace mp = multipass;
+namespace mpl = multipass::logging;
+
+namespace
+{
+constexpr auto category = "peers";
+// Aggregation calls answer from the peers' own caches; anything slower than this is
+// treated as unreachable, so one dead host cannot stall every list
+constexpr auto peer_reply_deadline = std::chrono::seconds(5);
+// Mirror of the local admission bounds, so a peer is only suggested when the launch
+// would actually be admitted there
+constexpr long long peer_memory_reserve_bytes = 1LL << 30;
+constexpr auto peer_cpu_overcommit_factor = 4;
+
+template <typename Reply, typename OpenStream>
+std::unique_ptr<Reply> collect_streamed_reply(const std::string& address, OpenStream open_stream)
+{
+    grpc::ClientContext context;
+    context.set_deadline(std::chrono::system_clock::now() + peer_reply_deadline);
+
+    auto reader = open_stream(context);
+    auto collected = std::make_unique<Reply>();
+    Reply chunk;
+    while (reader->Read(&chunk))
+        collected->MergeFrom(chunk);
+
+    const auto status = reader->Finish();
+    if (!status.ok())
+    {
+        mpl::log(mpl::Level::warning, category,
+                 fmt::format("peer {} did not answer: {}", address, status.error_message()));
+        return nullptr;
+    }
+
+    return collected;
+}
+} // namespace
+
+mp::PeerDaemons::PeerDaemons()
+{
+    // Peer channels are plaintext, like the local-address probe the daemon already
+    // makes at startup; federation is meant for a trusted lab network
+    const auto spec = QString::fromUtf8(qgetenv("MULTIPASS_PEER_DAEMONS"));
+    for (const auto& part : spec.split(',', QString::SkipEmptyParts))
+    {
+        const auto address = part.trimmed().toStdString();
+        if (address.empty())
+            continue;
+
+        auto channel = grpc::CreateChannel(address, grpc::InsecureChannelCredentials());
+        peers.push_back(Peer{address, mp::Rpc::NewStub(channel)});
+        mpl::log(mpl::Level::info, category, fmt::format("federating with peer daemon at {}", address));
+    }
+}
+
+std::vector<std::pair<std::string, mp::ListReply>> mp::PeerDaemons::fetch_lists(const ListRequest& request) const
+{
+    std::vector<std::future<std::unique_ptr<ListReply>>> pending;
+    pending.reserve(peers.size());
+    for (const auto& peer : peers)
+        pending.push_back(std::async(std::launch::async, [&peer, &request] {
+            return collect_streamed_reply<ListReply>(peer.address, [&peer, &request](grpc::ClientContext& context) {
+                return peer.stub->list(&context, request);
+            });
+        }));
+
+    std::vector<std::pair<std::string, ListReply>> replies;
+    for (size_t i = 0; i < peers.size(); ++i)
+        if (auto reply = pending[i].get())
+            replies.emplace_back(peers[i].address, std::move(*reply));
+
+    return replies;
+}
+
+std::vector<std::pair<std::string, mp::InfoReply>> mp::PeerDaemons::fetch_infos(const InfoRequest& request) const
+{
+    std::vector<std::future<std::unique_ptr<InfoReply>>> pending;
+    pending.reserve(peers.size());
+    for (const auto& peer : peers)
+        pending.push_back(std::async(std::launch::async, [&peer, &request] {
+            return collect_streamed_reply<InfoReply>(peer.address, [&peer, &request](grpc::ClientContext& context) {
+                return peer.stub->info(&context, request);
+            });
+        }));
+
+    std::vector<std::pair<std::string, InfoReply>> replies;
+    for (size_t i = 0; i < peers.size(); ++i)
+        if (auto reply = pending[i].get())
+            replies.emplace_back(peers[i].address, std::move(*reply));
+
+    return replies;
+}
+
+std::string mp::PeerDaemons::best_peer_for(int cpus, long long memory_bytes) const
+{
+    InfoRequest request;
+    // No per-instance field is named this, so peers answer with just the headroom
+    // chunk and skip all the per-instance work
+    request.add_fields("host_resources");
+
+    std::string best;
+    long long best_free = -1;
+    for (const auto& reply : fetch_infos(request))
+    {
+        const auto& resources = reply.second.host_resources();
+        if (resources.memory_total() == 0)
+            continue; // the peer does not know its own envelope; don't guess
+
+        const auto free_memory = static_cast<long long>(resources.memory_total()) -
+                                 static_cast<long long>(resources.memory_committed());
+        const auto cpus_fit = resources.cpus_committed() + cpus <= peer_cpu_overcommit_factor * resources.cpus_total();
+        if (cpus_fit && free_memory >= memory_bytes + peer_memory_reserve_bytes && free_memory > best_free)
+        {
+            best = reply.first;
+            best_free = free_memory;
+        }
+    }
+
+    return best;
+}
+
+grpc::Status mp::PeerDaemons::relay_launch(const std::string& address, const LaunchRequest& request,
+                                           grpc::ServerWriter<LaunchReply>* server) const
+{
+    const auto peer =
+        std::find_if(peers.begin(), peers.end(), [&address](const Peer& peer) { return peer.address == address; });
+    if (peer == peers.end())
+        return grpc::Status{grpc::StatusCode::INTERNAL, fmt::format("no such peer: {}", address), ""};
+
+    grpc::ClientContext context; // no deadline; a remote launch legitimately takes minutes
+    auto reader = peer->stub->launch(&context, request);
+
+    LaunchReply chunk;
+    while (reader->Read(&chunk))
+        server->Write(chunk);
+
+    return reader->Finish();
+}
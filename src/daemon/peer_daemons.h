@@ -0,0 +1,72 @@
+/*
+ * Copyright (C) 2021 Canonical, Ltd.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; version 3.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#ifndef MULTIPASS_PEER_DAEMONS_H
+#define MULTIPASS_PEER_DAEMONS_H
+
+#include <multipass/rpc/multipass.grpc.pb.h>
+
+#include <grpcpp/grpcpp.h>
+
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace multipass
+{
+// Channels to the other daemons of a small federation, read once at startup from the
+// MULTIPASS_PEER_DAEMONS environment variable (a comma-separated list of gRPC
+// addresses). A daemon with peers configured acts as a router: list and info fan out
+// to every peer in parallel and fold the remote instances into the local reply, and a
+// launch the local host cannot admit is relayed to the peer advertising the most
+// headroom.
+class PeerDaemons
+{
+public:
+    PeerDaemons();
+
+    bool empty() const
+    {
+        return peers.empty();
+    }
+
+    // One merged streamed reply per reachable peer, gathered in parallel; a peer that
+    // does not answer within the deadline is logged and left out rather than stalling
+    // the caller.
+    std::vector<std::pair<std::string, ListReply>> fetch_lists(const ListRequest& request) const;
+    std::vector<std::pair<std::string, InfoReply>> fetch_infos(const InfoRequest& request) const;
+
+    // The address of the peer advertising the most free memory that still admits the
+    // given request, or empty if none does
+    std::string best_peer_for(int cpus, long long memory_bytes) const;
+
+    // Stream the given launch through to a peer, forwarding every reply fragment to
+    // the waiting client; blocks for as long as the remote launch runs
+    grpc::Status relay_launch(const std::string& address, const LaunchRequest& request,
+                              grpc::ServerWriter<LaunchReply>* server) const;
+
+private:
+    struct Peer
+    {
+        std::string address;
+        std::unique_ptr<Rpc::Stub> stub;
+    };
+    std::vector<Peer> peers;
+};
+} // namespace multipass
+#endif // MULTIPASS_PEER_DAEMONS_H
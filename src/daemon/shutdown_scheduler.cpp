@@ -0,0 +1,83 @@
+/*
+ * Copyright (C) 2021 Canonical, Ltd.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; version 3.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include <multipass/shutdown_scheduler.h>
+
+#include <algorithm>
+#include <vector>
+
+namespace mp = multipass;
+
+mp::ShutdownScheduler::ShutdownScheduler(const Singleton<ShutdownScheduler>::PrivatePass& pass)
+    : Singleton<ShutdownScheduler>::Singleton{pass}
+{
+    tick_timer.setSingleShot(true);
+    QObject::connect(&tick_timer, &QTimer::timeout, [this] { tick(); });
+}
+
+mp::ShutdownScheduler::TaskId mp::ShutdownScheduler::schedule(std::chrono::milliseconds delay,
+                                                              std::function<void()> task)
+{
+    auto id = ++last_id;
+    tasks.emplace(std::chrono::steady_clock::now() + delay, ScheduledTask{id, std::move(task)});
+    arm();
+
+    return id;
+}
+
+void mp::ShutdownScheduler::cancel(TaskId id)
+{
+    for (auto entry = tasks.begin(); entry != tasks.end(); ++entry)
+    {
+        if (entry->second.id == id)
+        {
+            tasks.erase(entry);
+            arm();
+            return;
+        }
+    }
+}
+
+void mp::ShutdownScheduler::tick()
+{
+    // Due tasks move out before running: a task may schedule or cancel others
+    std::vector<std::function<void()>> due;
+    const auto now = std::chrono::steady_clock::now();
+    while (!tasks.empty() && tasks.begin()->first <= now)
+    {
+        due.push_back(std::move(tasks.begin()->second.task));
+        tasks.erase(tasks.begin());
+    }
+
+    for (auto& task : due)
+        task();
+
+    arm();
+}
+
+void mp::ShutdownScheduler::arm()
+{
+    if (tasks.empty())
+    {
+        tick_timer.stop();
+        return;
+    }
+
+    const auto time_to_next = std::chrono::duration_cast<std::chrono::milliseconds>(
+        tasks.begin()->first - std::chrono::steady_clock::now());
+    tick_timer.start(std::max(time_to_next, std::chrono::milliseconds::zero()));
+}
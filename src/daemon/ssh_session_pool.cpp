@@ -0,0 +1,74 @@
+/*
+ * Copyright (C) 2021 Canonical, Ltd.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; version 3.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "ssh_session_pool.h"
+
+#include <multipass/logging/log.h>
+
+#include <multipass/format.h>
+
+namespace mp = multipass;
+namespace mpl = multipass::logging;
+
+namespace
+{
+constexpr auto category = "ssh pool";
+} // namespace
+
+mp::SSHSessionPool::SSHSessionPool(const SSHKeyProvider& key_provider) : key_provider{key_provider}
+{
+}
+
+mp::SSHSessionPool::Handle mp::SSHSessionPool::session_for(const std::string& name, const std::string& host, int port,
+                                                           const std::string& username)
+{
+    Entry* entry;
+    {
+        std::lock_guard<std::mutex> pool_lock{pool_mutex};
+        auto& slot = entries[name];
+        if (!slot)
+            slot = std::make_unique<Entry>();
+        entry = slot.get();
+    }
+
+    std::unique_lock<std::mutex> lock{entry->in_use};
+    if (!entry->session || !ssh_is_connected(*entry->session))
+    {
+        if (entry->session)
+            mpl::log(mpl::Level::debug, category, fmt::format("Reconnecting ssh session for \"{}\"", name));
+        entry->session = std::make_unique<SSHSession>(host, port, username, key_provider);
+    }
+
+    return Handle{*entry->session, std::move(lock)};
+}
+
+void mp::SSHSessionPool::drop_session_for(const std::string& name)
+{
+    std::unique_ptr<Entry> entry;
+    {
+        std::lock_guard<std::mutex> pool_lock{pool_mutex};
+        auto it = entries.find(name);
+        if (it == entries.end())
+            return;
+        entry = std::move(it->second);
+        entries.erase(it);
+    }
+
+    // Wait for any user to finish with the session before tearing it down
+    std::lock_guard<std::mutex> lock{entry->in_use};
+    entry->session.reset();
+}
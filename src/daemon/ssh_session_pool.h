@@ -0,0 +1,70 @@
+/*
+ * Copyright (C) 2021 Canonical, Ltd.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; version 3.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#ifndef MULTIPASS_SSH_SESSION_POOL_H
+#define MULTIPASS_SSH_SESSION_POOL_H
+
+#include <multipass/ssh/ssh_session.h>
+
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+
+namespace multipass
+{
+class SSHKeyProvider;
+
+// Keeps one live SSHSession per instance so repeated guest operations reuse the
+// established transport instead of paying a full handshake each time. Dead sessions are
+// reconnected transparently on acquisition.
+class SSHSessionPool
+{
+public:
+    // Grants exclusive use of a pooled session for as long as the handle is held.
+    class Handle
+    {
+    public:
+        Handle(SSHSession& session, std::unique_lock<std::mutex> lock)
+            : session{session}, lock{std::move(lock)}
+        {
+        }
+
+        SSHSession& session;
+
+    private:
+        std::unique_lock<std::mutex> lock;
+    };
+
+    explicit SSHSessionPool(const SSHKeyProvider& key_provider);
+
+    Handle session_for(const std::string& name, const std::string& host, int port, const std::string& username);
+    void drop_session_for(const std::string& name);
+
+private:
+    struct Entry
+    {
+        std::unique_ptr<SSHSession> session;
+        std::mutex in_use;
+    };
+
+    const SSHKeyProvider& key_provider;
+    std::mutex pool_mutex;
+    std::unordered_map<std::string, std::unique_ptr<Entry>> entries;
+};
+} // namespace multipass
+#endif // MULTIPASS_SSH_SESSION_POOL_H
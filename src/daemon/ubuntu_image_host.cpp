@@ -27,9 +27,11 @@
 #include <multipass/exceptions/unsupported_image_exception.h>
 #include <multipass/exceptions/unsupported_remote_exception.h>
 
+#include <QCryptographicHash>
 #include <QUrl>
 
 #include <algorithm>
+#include <future>
 #include <unordered_set>
 
 namespace mp = multipass;
@@ -38,13 +40,12 @@ namespace
 {
 constexpr auto index_path = "streams/v1/index.json";
 
-auto download_manifest(const QString& host_url, mp::URLDownloader* url_downloader)
+auto download_manifest_json(const QString& host_url, mp::URLDownloader* url_downloader)
 {
     auto json_index = url_downloader->download({host_url + index_path});
     auto index = mp::SimpleStreamsIndex::fromJson(json_index);
 
-    auto json_manifest = url_downloader->download({host_url + index.manifest_path});
-    return mp::SimpleStreamsManifest::fromJson(json_manifest, host_url);
+    return url_downloader->download({host_url + index.manifest_path});
 }
 
 mp::VMImageInfo with_location_fully_resolved(const QString& host_url, const mp::VMImageInfo& info)
@@ -81,6 +82,11 @@ mp::UbuntuVMImageHost::UbuntuVMImageHost(std::vector<std::pair<std::string, std:
 
 mp::optional<mp::VMImageInfo> mp::UbuntuVMImageHost::info_for(const Query& query)
 {
+    update_manifests();
+
+    if (const auto* cached = cached_resolution(query.remote_name, query.release, query.allow_unsupported))
+        return *cached;
+
     auto images = all_info_for(query);
 
     // If more than one match and query is a hash, throw an exception
@@ -88,7 +94,10 @@ mp::optional<mp::VMImageInfo> mp::UbuntuVMImageHost::info_for(const Query& query
         throw std::runtime_error(fmt::format("Too many images matching \"{}\"", query.release));
     // If query is an alias, choose the first one returned if more than one
     else if (images.size() != 0)
+    {
+        cache_resolution(query.remote_name, query.release, query.allow_unsupported, images.front().second);
         return images.front().second;
+    }
     else
         return nullopt;
 }
@@ -142,9 +151,15 @@ std::vector<std::pair<std::string, mp::VMImageInfo>> mp::UbuntuVMImageHost::all_
         {
             std::unordered_set<std::string> found_hashes;
 
-            for (const auto& entry : manifest->products)
+            // the manifest keeps ids sorted, so all hashes sharing the prefix form one contiguous range
+            auto it = std::lower_bound(
+                manifest->sorted_ids.cbegin(), manifest->sorted_ids.cend(), key,
+                [](const std::pair<QString, const VMImageInfo*>& entry, const QString& k) { return entry.first < k; });
+
+            for (; it != manifest->sorted_ids.cend() && it->first.startsWith(key); ++it)
             {
-                if (entry.id.startsWith(key) && (entry.supported || query.allow_unsupported) &&
+                const auto& entry = *it->second;
+                if ((entry.supported || query.allow_unsupported) &&
                     found_hashes.find(entry.id.toStdString()) == found_hashes.end())
                 {
                     images.push_back(std::make_pair(
@@ -163,12 +178,10 @@ mp::VMImageInfo mp::UbuntuVMImageHost::info_for_full_hash_impl(const std::string
 {
     for (const auto& manifest : manifests)
     {
-        for (const auto& product : manifest.second->products)
+        const auto it = manifest.second->image_records.find(QString::fromStdString(full_hash));
+        if (it != manifest.second->image_records.end() && it.value()->id.toStdString() == full_hash)
         {
-            if (product.id.toStdString() == full_hash)
-            {
-                return with_location_fully_resolved(QString::fromStdString(remote_url_from(manifest.first)), product);
-            }
+            return with_location_fully_resolved(QString::fromStdString(remote_url_from(manifest.first)), *it.value());
         }
     }
 
@@ -226,18 +239,53 @@ std::vector<std::string> mp::UbuntuVMImageHost::supported_remotes()
 
 void mp::UbuntuVMImageHost::fetch_manifests()
 {
+    // The per-remote fetches are network bound, so fan them out concurrently and join below,
+    // making the total latency that of the slowest remote rather than the sum of all of them.
+    std::vector<std::pair<std::string, std::future<QByteArray>>> fetches;
+
     for (const auto& remote : remotes)
     {
         try
         {
             check_remote_is_supported(remote.first);
+        }
+        catch (const mp::UnsupportedRemoteException&)
+        {
+            continue;
+        }
 
-            manifests.emplace_back(
-                std::make_pair(remote.first, download_manifest(QString::fromStdString(remote.second), url_downloader)));
+        fetches.emplace_back(remote.first, std::async(std::launch::async, [this, &remote] {
+                                 return download_manifest_json(QString::fromStdString(remote.second), url_downloader);
+                             }));
+    }
+
+    for (auto& fetch : fetches)
+    {
+        try
+        {
+            const auto json = fetch.second.get();
+            const auto checksum = QCryptographicHash::hash(json, QCryptographicHash::Sha256);
+
+            // Manifests rarely change between refreshes; reparsing a multi-MB document each
+            // time is wasted work, so reuse the previous parse when the bytes are identical.
+            auto retired = retired_manifests.find(fetch.first);
+            if (retired != retired_manifests.end() && manifest_checksums[fetch.first] == checksum)
+            {
+                manifests.emplace_back(std::make_pair(fetch.first, std::move(retired->second)));
+            }
+            else
+            {
+                manifests.emplace_back(std::make_pair(
+                    fetch.first,
+                    SimpleStreamsManifest::fromJson(json, QString::fromStdString(remote_url_from(fetch.first)))));
+                manifest_checksums[fetch.first] = checksum;
+            }
+
+            retired_manifests.erase(fetch.first);
         }
         catch (mp::EmptyManifestException& /* e */)
         {
-            on_manifest_empty(fmt::format("Did not find any supported products in \"{}\"", remote.first));
+            on_manifest_empty(fmt::format("Did not find any supported products in \"{}\"", fetch.first));
         }
         catch (mp::GenericManifestException& e)
         {
@@ -247,15 +295,14 @@ void mp::UbuntuVMImageHost::fetch_manifests()
         {
             on_manifest_update_failure(e.what());
         }
-        catch (const mp::UnsupportedRemoteException&)
-        {
-            continue;
-        }
     }
 }
 
 void mp::UbuntuVMImageHost::clear()
 {
+    for (auto& manifest : manifests)
+        retired_manifests[manifest.first] = std::move(manifest.second);
+
     manifests.clear();
 }
 
@@ -24,6 +24,7 @@
 #include <QString>
 
 #include <string>
+#include <unordered_map>
 #include <utility>
 #include <vector>
 
@@ -55,6 +56,9 @@ private:
     SimpleStreamsManifest* manifest_from(const std::string& remote);
     const VMImageInfo* match_alias(const QString& key, const SimpleStreamsManifest& manifest) const;
     std::vector<std::pair<std::string, std::unique_ptr<SimpleStreamsManifest>>> manifests;
+    // Parsed manifests kept across refreshes, reused whenever a remote's bytes are unchanged
+    std::unordered_map<std::string, std::unique_ptr<SimpleStreamsManifest>> retired_manifests;
+    std::unordered_map<std::string, QByteArray> manifest_checksums;
     URLDownloader* const url_downloader;
     std::vector<std::pair<std::string, std::string>> remotes;
     std::string remote_url_from(const std::string& remote_name);
@@ -19,7 +19,8 @@
 
 #include <multipass/cloud_init_iso.h>
 
-#include <QFile>
+#include <QCryptographicHash>
+#include <QSaveFile>
 
 #include <array>
 #include <cctype>
@@ -97,9 +98,10 @@ void set_at(T& t, SizeType offset, const V& value)
 }
 
 template <typename T>
-void write(const T& t, QFile& f)
+void write(const T& t, std::vector<uint8_t>& image, size_t& pos)
 {
-    f.write(reinterpret_cast<const char*>(t.data.data()), t.data.size());
+    std::copy(std::begin(t.data), std::end(t.data), image.begin() + pos);
+    pos += t.data.size();
 }
 
 template <size_t size>
@@ -365,18 +367,9 @@ Size num_blocks(Size num_bytes)
     return ((num_bytes + logical_block_size - 1) / logical_block_size);
 }
 
-void seek_to_next_block(QFile& f)
+void seek_to_next_block(size_t& pos)
 {
-    const auto next_block_pos = num_blocks(f.pos()) * logical_block_size;
-    f.seek(next_block_pos);
-}
-
-void pad_to_end(QFile& f)
-{
-    seek_to_next_block(f);
-    f.seek(f.pos() - 1);
-    char end = 0;
-    f.write(&end, 1);
+    pos = num_blocks(pos) * logical_block_size;
 }
 } // namespace
 
@@ -385,15 +378,23 @@ void mp::CloudInitIso::add_file(const std::string& name, const std::string& data
     files.push_back(FileEntry{name, data});
 }
 
-void mp::CloudInitIso::write_to(const Path& path)
+std::string mp::CloudInitIso::content_hash() const
 {
-    QFile f{path};
-    if (!f.open(QIODevice::WriteOnly))
-        throw std::runtime_error{"failed to open file for writing during cloud-init generation"};
+    QCryptographicHash hash{QCryptographicHash::Sha256};
+    for (const auto& entry : files)
+    {
+        hash.addData(entry.name.data(), entry.name.size());
+        hash.addData("", 1); // keep name/data boundaries from aliasing
+        hash.addData(entry.data.data(), entry.data.size());
+        hash.addData("", 1);
+    }
+    return hash.result().toHex().toStdString();
+}
 
+void mp::CloudInitIso::write_to(const Path& path)
+{
     const uint32_t num_reserved_bytes = 32768u;
     const uint32_t num_reserved_blocks = num_blocks(num_reserved_bytes);
-    f.seek(num_reserved_bytes);
 
     PrimaryVolumeDescriptor prim_desc;
     JolietVolumeDescriptor joliet_desc;
@@ -443,35 +444,50 @@ void mp::CloudInitIso::write_to(const Path& path)
         current_block_index += num_blocks(entry.data.size());
     }
 
-    write(prim_desc, f);
-    write(joliet_desc, f);
-    write(VolumeDescriptorSetTerminator(), f);
+    // The volume is assembled in one zero-filled buffer of its final size, so block padding
+    // comes for free and the image hits the disk in a single write
+    std::vector<uint8_t> image(volume_size * logical_block_size, 0u);
+    size_t pos = num_reserved_bytes;
+
+    write(prim_desc, image, pos);
+    write(joliet_desc, image, pos);
+    write(VolumeDescriptorSetTerminator(), image, pos);
 
-    write(root_path, f);
-    seek_to_next_block(f);
-    write(joliet_root_path, f);
-    seek_to_next_block(f);
+    write(root_path, image, pos);
+    seek_to_next_block(pos);
+    write(joliet_root_path, image, pos);
+    seek_to_next_block(pos);
 
-    write(root_record, f);
-    write(root_parent_record, f);
+    write(root_record, image, pos);
+    write(root_parent_record, image, pos);
     for (const auto& iso_record : iso_file_records)
     {
-        write(iso_record, f);
+        write(iso_record, image, pos);
     }
-    seek_to_next_block(f);
+    seek_to_next_block(pos);
 
-    write(joliet_root_record, f);
-    write(joliet_root_parent_record, f);
+    write(joliet_root_record, image, pos);
+    write(joliet_root_parent_record, image, pos);
     for (const auto& joliet_record : joliet_file_records)
     {
-        write(joliet_record, f);
+        write(joliet_record, image, pos);
     }
-    seek_to_next_block(f);
+    seek_to_next_block(pos);
 
     for (const auto& entry : files)
     {
-        f.write(entry.data.data(), entry.data.size());
-        seek_to_next_block(f);
+        std::copy(entry.data.begin(), entry.data.end(), image.begin() + pos);
+        pos += entry.data.size();
+        seek_to_next_block(pos);
     }
-    pad_to_end(f);
+
+    // QSaveFile stages the image in a temporary and renames it into place on commit, so a
+    // crash mid-write cannot leave a half-written ISO behind
+    QSaveFile f{path};
+    if (!f.open(QIODevice::WriteOnly))
+        throw std::runtime_error{"failed to open file for writing during cloud-init generation"};
+
+    if (f.write(reinterpret_cast<const char*>(image.data()), image.size()) != static_cast<qint64>(image.size()) ||
+        !f.commit())
+        throw std::runtime_error{"failed to write file during cloud-init generation"};
 }
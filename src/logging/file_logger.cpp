@@ -0,0 +1,139 @@
+/*
+ * Copyright (C) 2021 Canonical, Ltd.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; version 3.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include <multipass/logging/file_logger.h>
+
+#include <multipass/format.h>
+
+#include <QByteArray>
+#include <QDateTime>
+#include <QDir>
+#include <QFile>
+
+#include <thread>
+
+namespace mpl = multipass::logging;
+
+namespace
+{
+constexpr auto current_log_name = "multipassd.log";
+constexpr auto rotated_suffix = ".z"; // qCompress (zlib) payload; decompress with qUncompress
+constexpr long long max_segment_bytes = 32ll * 1024 * 1024;
+constexpr int max_rotated_segments = 5;
+
+mpl::Level level_from_name(const std::string& name, mpl::Level fallback)
+{
+    for (const auto level : {mpl::Level::error, mpl::Level::warning, mpl::Level::info, mpl::Level::debug,
+                             mpl::Level::trace})
+        if (name == mpl::as_string(level).c_str())
+            return level;
+
+    return fallback;
+}
+
+// Compresses a rotated segment in place and drops the oldest ones; runs detached, so
+// the logging path never waits on compression or directory scans
+void compress_and_prune(const QString& log_directory, const QString& rotated_path)
+{
+    {
+        QFile rotated{rotated_path};
+        if (rotated.open(QIODevice::ReadOnly))
+        {
+            QFile compressed{rotated_path + rotated_suffix};
+            if (compressed.open(QIODevice::WriteOnly | QIODevice::Truncate))
+            {
+                compressed.write(qCompress(rotated.readAll(), 1));
+                rotated.remove();
+            }
+        }
+    }
+
+    auto old_segments = QDir{log_directory}.entryList({QString{"multipassd-*.log%1"}.arg(rotated_suffix)},
+                                                      QDir::Files, QDir::Name);
+    while (old_segments.size() > max_rotated_segments)
+        QFile::remove(QDir{log_directory}.filePath(old_segments.takeFirst()));
+}
+} // namespace
+
+mpl::FileLogger::FileLogger(UPtr upstream, const QString& log_directory, Level file_level,
+                            const std::string& category_levels)
+    : Logger{file_level}, upstream{std::move(upstream)}, log_directory{log_directory}, file_level{file_level}
+{
+    for (const auto& entry : QString::fromStdString(category_levels).split(';', QString::SkipEmptyParts))
+    {
+        const auto parts = entry.split('=');
+        if (parts.size() == 2 && !parts[0].isEmpty())
+            category_overrides.emplace(parts[0].toStdString(), level_from_name(parts[1].toStdString(), file_level));
+    }
+
+    QDir{log_directory}.mkpath(".");
+    current = std::fopen(QDir{log_directory}.filePath(current_log_name).toStdString().c_str(), "a");
+    if (current != nullptr)
+        current_bytes = std::ftell(current);
+}
+
+mpl::FileLogger::~FileLogger()
+{
+    std::lock_guard<std::mutex> lock{mutex};
+    if (current != nullptr)
+        std::fclose(current);
+}
+
+void mpl::FileLogger::log(Level level, CString category, CString message) const
+{
+    if (upstream)
+        upstream->log(level, category, message);
+
+    const auto override_it = category_overrides.find(category.c_str());
+    const auto effective = override_it != category_overrides.end() ? override_it->second : file_level;
+    if (level > effective)
+        return;
+
+    fmt::memory_buffer line;
+    fmt::format_to(line, "[{}] [{}] [{}] {}\n", timestamp(), as_string(level).c_str(), category.c_str(),
+                   message.c_str());
+
+    std::lock_guard<std::mutex> lock{mutex};
+    if (current == nullptr)
+        return;
+
+    std::fwrite(line.data(), 1, line.size(), current);
+    current_bytes += line.size();
+
+    // stdio's buffering soaks up the chatter; only messages someone may be tailing for
+    // are pushed out straight away
+    if (level <= Level::warning)
+        std::fflush(current);
+
+    if (current_bytes >= max_segment_bytes)
+        rotate();
+}
+
+void mpl::FileLogger::rotate() const
+{
+    std::fclose(current);
+    current = nullptr;
+    current_bytes = 0;
+
+    const auto rotated_path = QDir{log_directory}.filePath(
+        QString{"multipassd-%1.log"}.arg(QDateTime::currentDateTime().toString("yyyyMMdd-hhmmsszzz")));
+    QFile::rename(QDir{log_directory}.filePath(current_log_name), rotated_path);
+
+    std::thread{compress_and_prune, log_directory, rotated_path}.detach();
+
+    current = std::fopen(QDir{log_directory}.filePath(current_log_name).toStdString().c_str(), "a");
+}
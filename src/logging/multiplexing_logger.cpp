@@ -17,21 +17,88 @@
 
 #include <multipass/logging/multiplexing_logger.h>
 
+#include <multipass/format.h>
+
 #include <algorithm>
 
 namespace mpl = multipass::logging;
 
+namespace
+{
+constexpr std::size_t max_queued_entries = 4096;
+} // namespace
+
 multipass::logging::MultiplexingLogger::MultiplexingLogger(UPtr system_logger)
-    : Logger{system_logger->get_logging_level()}, system_logger{std::move(system_logger)}
+    : Logger{system_logger->get_logging_level()},
+      system_logger{std::move(system_logger)},
+      worker{&MultiplexingLogger::worker_main, this}
+{
+}
+
+mpl::MultiplexingLogger::~MultiplexingLogger()
 {
+    {
+        std::lock_guard<std::mutex> lock{queue_mutex};
+        stopping = true;
+    }
+    queue_cv.notify_all();
+    worker.join(); // the worker drains whatever is queued before exiting
 }
 
 void mpl::MultiplexingLogger::log(mpl::Level level, CString category, CString message) const
 {
-    std::shared_lock<decltype(mutex)> lock{mutex};
-    system_logger->log(level, category, message);
-    for (auto logger : loggers)
-        logger->log(level, category, message);
+    {
+        // Client loggers stream to the requesting client and must run on its handler's
+        // thread; only the system sink is deferred to the worker
+        std::shared_lock<decltype(mutex)> lock{mutex};
+        for (auto logger : loggers)
+            logger->log(level, category, message);
+    }
+
+    {
+        std::lock_guard<std::mutex> lock{queue_mutex};
+        if (queue.size() >= max_queued_entries)
+        {
+            ++dropped_entries;
+            return;
+        }
+
+        queue.push_back({level, category.c_str(), message.c_str()});
+    }
+    queue_cv.notify_one();
+}
+
+void mpl::MultiplexingLogger::worker_main()
+{
+    std::unique_lock<std::mutex> lock{queue_mutex};
+    while (true)
+    {
+        queue_cv.wait(lock, [this] { return !queue.empty() || stopping; });
+
+        while (!queue.empty())
+        {
+            auto entry = std::move(queue.front());
+            queue.pop_front();
+
+            lock.unlock();
+            system_logger->log(entry.level, entry.category, entry.message);
+            lock.lock();
+        }
+
+        if (dropped_entries)
+        {
+            auto dropped = dropped_entries;
+            dropped_entries = 0;
+
+            lock.unlock();
+            system_logger->log(Level::warning, "logger",
+                               fmt::format("dropped {} messages on log queue overflow", dropped));
+            lock.lock();
+        }
+
+        if (stopping && queue.empty())
+            return;
+    }
 }
 
 void mpl::MultiplexingLogger::add_logger(const Logger* logger)
@@ -38,6 +38,7 @@ namespace
 {
 constexpr auto category = "metrics";
 constexpr auto saved_metrics_file = "saved_metrics.json";
+constexpr auto metrics_journal_file = "metrics_journal.json";
 
 void post_request(const QUrl& metrics_url, const QByteArray& body)
 {
@@ -72,22 +73,47 @@ void post_request(const QUrl& metrics_url, const QByteArray& body)
 
 auto load_saved_metrics(const mp::Path& data_path)
 {
-    QFile metrics_file{QDir(data_path).filePath(saved_metrics_file)};
+    QJsonArray metrics;
 
-    if (!metrics_file.exists())
-        return QJsonArray();
+    QFile metrics_file{QDir(data_path).filePath(saved_metrics_file)};
+    if (metrics_file.exists())
+    {
+        metrics_file.open(QIODevice::ReadOnly);
+        metrics = QJsonDocument::fromJson(metrics_file.readAll()).array();
+    }
 
-    metrics_file.open(QIODevice::ReadOnly);
-    auto metrics = QJsonDocument::fromJson(metrics_file.readAll()).array();
+    QFile journal_file{QDir(data_path).filePath(metrics_journal_file)};
+    if (journal_file.exists())
+    {
+        journal_file.open(QIODevice::ReadOnly);
+        while (!journal_file.atEnd())
+        {
+            auto entry = QJsonDocument::fromJson(journal_file.readLine()).object();
+            if (!entry.isEmpty())
+                metrics.push_back(entry);
+        }
+    }
 
     return metrics;
 }
 
-void persist_metrics(const QByteArray& metrics, const mp::Path& data_path)
+// Appending one line per metric keeps enqueueing cheap; the journal is folded back into
+// the saved metrics file whenever the sender persists a full snapshot.
+void journal_metric(const QJsonObject& metric, const mp::Path& data_path)
+{
+    QFile journal_file{QDir(data_path).filePath(metrics_journal_file)};
+    journal_file.open(QIODevice::WriteOnly | QIODevice::Append);
+    journal_file.write(QJsonDocument(metric).toJson(QJsonDocument::Compact));
+    journal_file.write("\n");
+}
+
+void persist_metrics(const QJsonArray& metrics, const mp::Path& data_path)
 {
     QFile metrics_file{QDir(data_path).filePath(saved_metrics_file)};
     metrics_file.open(QIODevice::WriteOnly);
-    metrics_file.write(metrics);
+    metrics_file.write(QJsonDocument(metrics).toJson(QJsonDocument::Compact));
+
+    QFile::remove(QDir(data_path).filePath(metrics_journal_file));
 }
 } // namespace
 
@@ -112,6 +138,15 @@ mp::MetricsProvider::MetricsProvider(const QUrl& url, const QString& unique_id,
               if (!metrics_available && !metrics_failed)
                   continue;
 
+              if (metrics_available)
+              {
+                  // Linger briefly so a burst of metrics goes out as a single POST
+                  metrics_cv.wait_for(lock, std::chrono::seconds(10), [&] { return !running; });
+
+                  if (!running)
+                      return;
+              }
+
               auto saved_metrics(metric_batches);
               auto body = QJsonDocument(metric_batches).toJson(QJsonDocument::Compact);
               lock.unlock();
@@ -145,7 +180,7 @@ mp::MetricsProvider::MetricsProvider(const QUrl& url, const QString& unique_id,
                       timeout = std::chrono::seconds::zero();
                   }
 
-                  persist_metrics(QJsonDocument(metric_batches).toJson(QJsonDocument::Compact), data_path);
+                  persist_metrics(metric_batches, data_path);
               }
               catch (const std::exception& e)
               {
@@ -223,7 +258,7 @@ void mp::MetricsProvider::update_and_notify_sender(const QJsonObject& metric)
     {
         std::lock_guard<std::mutex> lck(metrics_mutex);
         metric_batches.push_back(metric);
-        persist_metrics(QJsonDocument(metric_batches).toJson(QJsonDocument::Compact), data_path);
+        journal_metric(metric, data_path);
         metrics_available = true;
     }
     metrics_cv.notify_one();
@@ -0,0 +1,302 @@
+/*
+ * Copyright (C) 2021 Canonical, Ltd.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; version 3.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "indexed_network_cache.h"
+
+#include <multipass/format.h>
+#include <multipass/logging/log.h>
+
+#include <QBuffer>
+#include <QDataStream>
+#include <QDir>
+#include <QFile>
+#include <QUrl>
+
+#include <map>
+#include <mutex>
+
+namespace mp = multipass;
+namespace mpl = multipass::logging;
+
+namespace
+{
+constexpr auto category = "network cache";
+constexpr auto index_file_name = "index.cache";
+constexpr auto bodies_file_name = "bodies.cache";
+
+// Only small simplestreams manifests and the like go through the cache (image payloads
+// bypass it), so rather than implementing eviction the whole store is wiped when the
+// body log outgrows this.
+constexpr qint64 max_body_log_size = 50 * 1024 * 1024;
+
+enum class Op : quint8
+{
+    insert = 1,
+    remove = 2,
+    update = 3
+};
+} // namespace
+
+class mp::IndexedNetworkCache::Store
+{
+public:
+    explicit Store(const QString& cache_dir)
+        : index_path{QDir{cache_dir}.filePath(index_file_name)},
+          bodies_path{QDir{cache_dir}.filePath(bodies_file_name)}
+    {
+        QDir{}.mkpath(cache_dir);
+        load();
+    }
+
+    static std::shared_ptr<Store> for_dir(const QString& cache_dir)
+    {
+        static std::mutex mutex;
+        static std::map<QString, std::weak_ptr<Store>> stores;
+
+        std::lock_guard<std::mutex> lock{mutex};
+        auto store = stores[cache_dir].lock();
+        if (!store)
+        {
+            store = std::make_shared<Store>(cache_dir);
+            stores[cache_dir] = store;
+        }
+        return store;
+    }
+
+    qint64 size() const
+    {
+        std::lock_guard<std::mutex> lock{mutex};
+        return body_log_size;
+    }
+
+    QIODevice* data(const QUrl& url)
+    {
+        std::lock_guard<std::mutex> lock{mutex};
+        const auto it = entries.constFind(url);
+        if (it == entries.cend())
+            return nullptr;
+
+        QFile bodies{bodies_path};
+        if (!bodies.open(QIODevice::ReadOnly) || !bodies.seek(it->offset))
+            return nullptr;
+
+        auto buffer = std::make_unique<QBuffer>();
+        buffer->setData(bodies.read(it->size));
+        if (buffer->data().size() != it->size)
+            return nullptr;
+
+        buffer->open(QIODevice::ReadOnly);
+        return buffer.release();
+    }
+
+    bool metadata(const QUrl& url, QNetworkCacheMetaData& out) const
+    {
+        std::lock_guard<std::mutex> lock{mutex};
+        const auto it = entries.constFind(url);
+        if (it == entries.cend())
+            return false;
+
+        out = it->metadata;
+        return true;
+    }
+
+    void insert(const QNetworkCacheMetaData& metadata, const QByteArray& body)
+    {
+        std::lock_guard<std::mutex> lock{mutex};
+        if (body_log_size + body.size() > max_body_log_size)
+            wipe();
+
+        QFile bodies{bodies_path};
+        if (!bodies.open(QIODevice::WriteOnly | QIODevice::Append))
+            return;
+
+        const auto offset = bodies.size();
+        if (bodies.write(body) != body.size())
+        {
+            bodies.resize(offset);
+            return;
+        }
+
+        Entry entry{metadata, offset, body.size()};
+        if (journal(Op::insert, metadata.url(), entry))
+        {
+            entries.insert(metadata.url(), entry);
+            body_log_size = offset + body.size();
+        }
+    }
+
+    bool remove(const QUrl& url)
+    {
+        std::lock_guard<std::mutex> lock{mutex};
+        const auto it = entries.find(url);
+        if (it == entries.end())
+            return false;
+
+        journal(Op::remove, url, *it); // the body stays in the log until the next wipe
+        entries.erase(it);
+        return true;
+    }
+
+    void update(const QNetworkCacheMetaData& metadata)
+    {
+        std::lock_guard<std::mutex> lock{mutex};
+        const auto it = entries.find(metadata.url());
+        if (it == entries.end())
+            return;
+
+        it->metadata = metadata; // the body is unchanged, so its offset is reused
+        journal(Op::update, metadata.url(), *it);
+    }
+
+    void clear()
+    {
+        std::lock_guard<std::mutex> lock{mutex};
+        wipe();
+    }
+
+private:
+    struct Entry
+    {
+        QNetworkCacheMetaData metadata;
+        qint64 offset;
+        qint64 size;
+    };
+
+    void load()
+    {
+        body_log_size = QFile{bodies_path}.size();
+
+        QFile index{index_path};
+        if (!index.open(QIODevice::ReadOnly))
+            return;
+
+        QDataStream stream{&index};
+        while (!stream.atEnd())
+        {
+            quint8 op;
+            QUrl url;
+            Entry entry;
+            stream >> op >> url >> entry.metadata >> entry.offset >> entry.size;
+
+            // A torn tail record from a crash mid-append is simply dropped
+            if (stream.status() != QDataStream::Ok)
+                break;
+
+            if (op == static_cast<quint8>(Op::remove))
+                entries.remove(url);
+            else if (entry.offset >= 0 && entry.size >= 0 && entry.offset + entry.size <= body_log_size)
+                entries.insert(url, entry);
+        }
+
+        mpl::log(mpl::Level::debug, category,
+                 fmt::format("loaded {} cached responses from {}", entries.size(), index_path));
+    }
+
+    bool journal(Op op, const QUrl& url, const Entry& entry)
+    {
+        QFile index{index_path};
+        if (!index.open(QIODevice::WriteOnly | QIODevice::Append))
+            return false;
+
+        const auto mark = index.size();
+        QDataStream stream{&index};
+        stream << static_cast<quint8>(op) << url << entry.metadata << entry.offset << entry.size;
+        if (stream.status() != QDataStream::Ok)
+        {
+            index.resize(mark);
+            return false;
+        }
+        return true;
+    }
+
+    void wipe()
+    {
+        entries.clear();
+        QFile{index_path}.resize(0);
+        QFile{bodies_path}.resize(0);
+        body_log_size = 0;
+    }
+
+    const QString index_path;
+    const QString bodies_path;
+    QHash<QUrl, Entry> entries;
+    qint64 body_log_size{0};
+    mutable std::mutex mutex;
+};
+
+mp::IndexedNetworkCache::IndexedNetworkCache(const QString& cache_dir) : store{Store::for_dir(cache_dir)}
+{
+}
+
+mp::IndexedNetworkCache::~IndexedNetworkCache()
+{
+    qDeleteAll(pending.keyBegin(), pending.keyEnd());
+}
+
+qint64 mp::IndexedNetworkCache::cacheSize() const
+{
+    return store->size();
+}
+
+QIODevice* mp::IndexedNetworkCache::data(const QUrl& url)
+{
+    return store->data(url);
+}
+
+void mp::IndexedNetworkCache::insert(QIODevice* device)
+{
+    const auto it = pending.find(device);
+    if (it == pending.end())
+        return;
+
+    store->insert(*it, static_cast<QBuffer*>(device)->data());
+    pending.erase(it);
+    delete device;
+}
+
+QNetworkCacheMetaData mp::IndexedNetworkCache::metaData(const QUrl& url)
+{
+    QNetworkCacheMetaData metadata;
+    store->metadata(url, metadata);
+    return metadata;
+}
+
+QIODevice* mp::IndexedNetworkCache::prepare(const QNetworkCacheMetaData& metadata)
+{
+    if (!metadata.isValid() || !metadata.url().isValid() || !metadata.saveToDisk())
+        return nullptr;
+
+    auto buffer = std::make_unique<QBuffer>();
+    buffer->open(QIODevice::ReadWrite);
+    pending.insert(buffer.get(), metadata);
+    return buffer.release();
+}
+
+bool mp::IndexedNetworkCache::remove(const QUrl& url)
+{
+    return store->remove(url);
+}
+
+void mp::IndexedNetworkCache::updateMetaData(const QNetworkCacheMetaData& metadata)
+{
+    store->update(metadata);
+}
+
+void mp::IndexedNetworkCache::clear()
+{
+    store->clear();
+}
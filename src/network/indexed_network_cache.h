@@ -0,0 +1,56 @@
+/*
+ * Copyright (C) 2021 Canonical, Ltd.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; version 3.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#ifndef MULTIPASS_INDEXED_NETWORK_CACHE_H
+#define MULTIPASS_INDEXED_NETWORK_CACHE_H
+
+#include <QAbstractNetworkCache>
+#include <QHash>
+#include <QNetworkCacheMetaData>
+
+#include <memory>
+
+namespace multipass
+{
+// HTTP cache with all entry metadata held in memory, backed by an append-only index
+// journal and a single body log: a hit is a hash lookup plus one positioned read, where
+// QNetworkDiskCache opens and parses a metadata file per entry. Journal replay at load
+// makes crash recovery trivial (a torn tail record is simply dropped). Managers on
+// different threads each get their own instance; the backing store is shared per
+// directory and internally locked.
+class IndexedNetworkCache : public QAbstractNetworkCache
+{
+public:
+    explicit IndexedNetworkCache(const QString& cache_dir);
+    ~IndexedNetworkCache();
+
+    qint64 cacheSize() const override;
+    QIODevice* data(const QUrl& url) override;
+    void insert(QIODevice* device) override;
+    QNetworkCacheMetaData metaData(const QUrl& url) override;
+    QIODevice* prepare(const QNetworkCacheMetaData& metadata) override;
+    bool remove(const QUrl& url) override;
+    void updateMetaData(const QNetworkCacheMetaData& metadata) override;
+    void clear() override;
+
+private:
+    class Store;
+    std::shared_ptr<Store> store;
+    QHash<QIODevice*, QNetworkCacheMetaData> pending;
+};
+} // namespace multipass
+#endif // MULTIPASS_INDEXED_NETWORK_CACHE_H
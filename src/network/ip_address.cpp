@@ -17,7 +17,9 @@
 
 #include <multipass/ip_address.h>
 
+#include <algorithm>
 #include <sstream>
+#include <stdexcept>
 
 namespace mp = multipass;
 
@@ -121,3 +123,105 @@ mp::IPAddress mp::IPAddress::operator+(int value) const
 {
     return mp::IPAddress(as_uint32() + value);
 }
+
+namespace
+{
+int first_set_bit(uint64_t word) // word must not be zero
+{
+#ifdef __GNUC__
+    return __builtin_ctzll(word);
+#else
+    auto bit = 0;
+    while ((word & 1ULL) == 0)
+        word >>= 1, ++bit;
+    return bit;
+#endif
+}
+} // namespace
+
+mp::SubnetIndex::SubnetIndex(const IPAddress& first, const IPAddress& last)
+    : first_value{first.as_uint32()}, last_value{last.as_uint32()}
+{
+    if (first_value > last_value)
+        throw std::invalid_argument("invalid address range");
+
+    words.resize((last_value - first_value) / 64 + 1, 0);
+}
+
+void mp::SubnetIndex::mark_in_use(const IPAddress& address)
+{
+    const auto value = address.as_uint32();
+    if (contains(value))
+        words[(value - first_value) / 64] |= 1ULL << ((value - first_value) % 64);
+}
+
+void mp::SubnetIndex::mark_free(const IPAddress& address)
+{
+    const auto value = address.as_uint32();
+    if (contains(value))
+        words[(value - first_value) / 64] &= ~(1ULL << ((value - first_value) % 64));
+}
+
+void mp::SubnetIndex::clear()
+{
+    std::fill(words.begin(), words.end(), 0);
+}
+
+bool mp::SubnetIndex::in_use(const IPAddress& address) const
+{
+    const auto value = address.as_uint32();
+    return contains(value) && words[(value - first_value) / 64] & 1ULL << ((value - first_value) % 64);
+}
+
+int mp::SubnetIndex::num_in_use() const
+{
+    auto count = 0;
+    for (auto word : words)
+        while (word)
+        {
+            word &= word - 1;
+            ++count;
+        }
+    return count;
+}
+
+int mp::SubnetIndex::capacity() const
+{
+    return words.empty() ? 0 : last_value - first_value + 1;
+}
+
+mp::optional<mp::IPAddress> mp::SubnetIndex::first_free() const
+{
+    for (size_t i = 0; i < words.size(); ++i)
+    {
+        const auto free_bits = ~words[i];
+        if (free_bits == 0)
+            continue;
+
+        const auto value = first_value + i * 64 + first_set_bit(free_bits);
+        if (value <= last_value)
+            return IPAddress{static_cast<uint32_t>(value)};
+    }
+
+    return nullopt;
+}
+
+std::vector<mp::IPAddress> mp::SubnetIndex::addresses_in_use() const
+{
+    std::vector<IPAddress> addresses;
+    for (size_t i = 0; i < words.size(); ++i)
+    {
+        auto word = words[i];
+        while (word)
+        {
+            addresses.push_back(IPAddress{static_cast<uint32_t>(first_value + i * 64 + first_set_bit(word))});
+            word &= word - 1;
+        }
+    }
+    return addresses;
+}
+
+bool mp::SubnetIndex::contains(uint32_t value) const
+{
+    return !words.empty() && value >= first_value && value <= last_value;
+}
@@ -19,6 +19,7 @@
 
 #include <multipass/exceptions/http_local_socket_exception.h>
 #include <multipass/format.h>
+#include <multipass/network_access_manager.h>
 
 #include <vector>
 
@@ -30,6 +31,9 @@ namespace
 {
 constexpr int len = 65536;
 constexpr int max_bytes = 32768;
+// Request bodies stream in larger chunks: on multi-GB image uploads this keeps the
+// syscall and chunk-framing overhead low while memory use stays constant
+constexpr int max_upload_bytes = 1048576;
 
 // Status code mapping based on
 // https://github.com/qt/qtbase/blob/dev/src/network/access/qhttpthreaddelegate.cpp
@@ -83,12 +87,17 @@ QNetworkReply::NetworkError statusCodeFromHttp(int httpStatusCode)
 } // namespace
 
 mp::LocalSocketReply::LocalSocketReply(LocalSocketUPtr local_socket, const QNetworkRequest& request,
-                                       QIODevice* outgoingData)
-    : QNetworkReply(), local_socket{std::move(local_socket)}, reply_data{QByteArray(len, '\0')}
+                                       QIODevice* outgoingData, SocketRecycler socket_recycler)
+    : QNetworkReply(),
+      local_socket{std::move(local_socket)},
+      socket_recycler{std::move(socket_recycler)},
+      reply_data{QByteArray(len, '\0')}
 {
     open(QIODevice::ReadOnly);
 
     QObject::connect(this->local_socket.get(), &QLocalSocket::readyRead, this, &LocalSocketReply::read_reply);
+    QObject::connect(this->local_socket.get(), &QLocalSocket::disconnected, this,
+                     &LocalSocketReply::on_socket_disconnected);
 
     send_request(request, outgoingData);
 }
@@ -129,6 +138,15 @@ qint64 mp::LocalSocketReply::readData(char* data, qint64 maxSize)
         memcpy(data, content_data.constData() + offset, number);
         offset += number;
 
+        // Release consumed body data, so callers streaming a large payload as it
+        // arrives don't accumulate the whole of it in memory
+        constexpr qint64 trim_threshold = 1024 * 1024;
+        if (offset >= trim_threshold)
+        {
+            content_data.remove(0, offset);
+            offset = 0;
+        }
+
         return number;
     }
 
@@ -211,10 +229,15 @@ void mp::LocalSocketReply::send_request(const QNetworkRequest& request, QIODevic
 
             outgoingData->open(QIODevice::ReadOnly);
             std::vector<char> data_buffer;
-            data_buffer.reserve(max_bytes);
+            data_buffer.reserve(max_upload_bytes);
+
+            const auto report_progress =
+                request.attribute(mp::upload_progress_attribute).value<mp::UploadProgressCallback>();
+            const auto total_bytes = outgoingData->size();
+            qint64 bytes_sent{0};
 
             int bytes_read{0};
-            while ((bytes_read = outgoingData->read(data_buffer.data(), max_bytes)) > 0)
+            while ((bytes_read = outgoingData->read(data_buffer.data(), max_upload_bytes)) > 0)
             {
                 if (is_chunked && !local_socket_write(QByteArray::number(bytes_read, 16) + "\r\n"))
                     return;
@@ -226,6 +249,10 @@ void mp::LocalSocketReply::send_request(const QNetworkRequest& request, QIODevic
                     return;
 
                 local_socket->waitForBytesWritten();
+
+                bytes_sent += bytes_read;
+                if (report_progress)
+                    report_progress(bytes_sent, total_bytes);
             }
 
             if (bytes_read < 0)
@@ -248,45 +275,171 @@ void mp::LocalSocketReply::send_request(const QNetworkRequest& request, QIODevic
 
 void mp::LocalSocketReply::read_reply()
 {
-    auto data_ptr = reply_data.data();
-    int bytes_read{0};
-
-    do
+    // A response can arrive across any number of reads; accumulate what is available and
+    // advance the parser, emitting body data incrementally rather than waiting for the
+    // whole payload to be buffered.
+    qint64 bytes_read{0};
+    while ((bytes_read = local_socket->read(reply_data.data(), len)) > 0)
     {
-        bytes_read = local_socket->read(reply_data.data(), len);
+        parse_buffer.append(reply_data.constData(), bytes_read);
+    }
 
-        data_ptr += bytes_read;
-    } while (bytes_read > 0);
+    if (parse_state == ParseState::headers && !parse_headers())
+        return;
 
-    parse_reply();
+    if (parse_state == ParseState::body)
+        decode_body();
+}
 
-    setFinished(true);
-    emit finished();
+void mp::LocalSocketReply::on_socket_disconnected()
+{
+    // Delimits the body of responses carrying neither Content-Length nor chunked encoding
+    if (!isFinished())
+    {
+        if (parse_state == ParseState::body && !chunked_transfer_encoding && content_length < 0)
+            finish_reply();
+        else
+        {
+            setError(QNetworkReply::RemoteHostClosedError, "Connection closed mid-response");
+            emit error(QNetworkReply::RemoteHostClosedError);
+            finish_reply();
+        }
+    }
 }
 
-void mp::LocalSocketReply::parse_reply()
+bool mp::LocalSocketReply::parse_headers()
 {
-    auto reply_lines = reply_data.split('\n');
+    const auto header_end = parse_buffer.indexOf("\r\n\r\n");
+    if (header_end < 0)
+        return false; // headers not complete yet
+
+    const auto header_block = parse_buffer.left(header_end);
+    parse_buffer.remove(0, header_end + 4);
+
+    auto reply_lines = header_block.split('\n');
     auto it = reply_lines.constBegin();
 
     parse_status(*it);
 
+    if (error() == QNetworkReply::ProtocolFailure)
+    {
+        finish_reply();
+        return false;
+    }
+
     for (++it; it != reply_lines.constEnd(); ++it)
     {
         if ((*it).contains("Transfer-Encoding") && (*it).contains("chunked"))
             chunked_transfer_encoding = true;
 
-        if ((*it).isEmpty() || (*it).startsWith('\r'))
+        if ((*it).contains("Connection") && (*it).contains("close"))
+            connection_close = true;
+
+        if ((*it).toLower().startsWith("content-length:"))
+            content_length = (*it).mid(15).trimmed().toLongLong();
+    }
+
+    parse_state = ParseState::body;
+    return true;
+}
+
+void mp::LocalSocketReply::decode_body()
+{
+    if (!chunked_transfer_encoding)
+    {
+        if (!parse_buffer.isEmpty())
+        {
+            append_body_data(parse_buffer.constData(), parse_buffer.size());
+            parse_buffer.clear();
+        }
+
+        if (content_length >= 0 && body_bytes_received >= content_length)
+            finish_reply();
+
+        return;
+    }
+
+    // Decode as many complete chunks as are buffered; partial chunks wait for more data
+    for (;;)
+    {
+        if (awaiting_chunk_terminator)
+        {
+            if (parse_buffer.size() < 2)
+                return;
+
+            parse_buffer.remove(0, 2);
+            awaiting_chunk_terminator = false;
+        }
+
+        if (current_chunk_remaining == 0)
         {
-            // Advance to the body
-            // Chunked transfer encoding also includes a line with the amount of
-            // bytes (in hex) in the chunk. We just skip it for now.
-            it = chunked_transfer_encoding ? it + 2 : it + 1;
+            const auto line_end = parse_buffer.indexOf("\r\n");
+            if (line_end < 0)
+                return;
 
-            content_data = (*it).trimmed();
+            bool ok{false};
+            const auto chunk_size = parse_buffer.left(line_end).trimmed().toLongLong(&ok, 16);
+            parse_buffer.remove(0, line_end + 2);
 
-            break;
+            if (!ok || chunk_size < 0)
+            {
+                setError(QNetworkReply::ProtocolFailure, "Malformed chunked encoding from server");
+                emit error(QNetworkReply::ProtocolFailure);
+                finish_reply();
+                return;
+            }
+
+            if (chunk_size == 0)
+            {
+                finish_reply();
+                return;
+            }
+
+            current_chunk_remaining = chunk_size;
+        }
+
+        const auto take = qMin(current_chunk_remaining, static_cast<qint64>(parse_buffer.size()));
+        if (take > 0)
+        {
+            append_body_data(parse_buffer.constData(), take);
+            parse_buffer.remove(0, take);
+            current_chunk_remaining -= take;
         }
+
+        if (current_chunk_remaining > 0)
+            return;
+
+        awaiting_chunk_terminator = true;
+    }
+}
+
+void mp::LocalSocketReply::append_body_data(const char* data, qint64 size)
+{
+    content_data.append(data, size);
+    body_bytes_received += size;
+    emit readyRead();
+}
+
+void mp::LocalSocketReply::finish_reply()
+{
+    if (isFinished())
+        return;
+
+    recycle_socket_if_reusable();
+
+    setFinished(true);
+    emit finished();
+}
+
+void mp::LocalSocketReply::recycle_socket_if_reusable()
+{
+    // HTTP/1.1 keeps the connection open by default; hand the socket back for reuse
+    // unless the server asked to close it or something is still pending on the wire
+    if (socket_recycler && error() == QNetworkReply::NoError && !connection_close &&
+        local_socket->bytesAvailable() == 0)
+    {
+        QObject::disconnect(local_socket.get(), nullptr, this, nullptr);
+        socket_recycler(std::move(local_socket));
     }
 }
 
@@ -24,17 +24,20 @@
 #include <QNetworkRequest>
 #include <QString>
 
+#include <functional>
 #include <memory>
 
 namespace multipass
 {
 using LocalSocketUPtr = std::unique_ptr<QLocalSocket>;
+using SocketRecycler = std::function<void(LocalSocketUPtr)>;
 
 class LocalSocketReply : public QNetworkReply
 {
     Q_OBJECT
 public:
-    LocalSocketReply(LocalSocketUPtr local_socket, const QNetworkRequest& request, QIODevice* outgoingData);
+    LocalSocketReply(LocalSocketUPtr local_socket, const QNetworkRequest& request, QIODevice* outgoingData,
+                     SocketRecycler socket_recycler = SocketRecycler());
     LocalSocketReply();
     virtual ~LocalSocketReply();
 
@@ -47,17 +50,36 @@ protected:
 
 private slots:
     void read_reply();
+    void on_socket_disconnected();
 
 private:
     void send_request(const QNetworkRequest& request, QIODevice* outgoingData);
-    void parse_reply();
+    bool parse_headers();
+    void decode_body();
+    void append_body_data(const char* data, qint64 size);
     void parse_status(const QByteArray& status);
     bool local_socket_write(const QByteArray& data);
+    void finish_reply();
+    void recycle_socket_if_reusable();
+
+    enum class ParseState
+    {
+        headers,
+        body
+    };
 
     LocalSocketUPtr local_socket;
+    SocketRecycler socket_recycler;
     QByteArray reply_data;
+    QByteArray parse_buffer;
     qint64 offset{0};
+    ParseState parse_state{ParseState::headers};
+    qint64 content_length{-1};
+    qint64 body_bytes_received{0};
+    qint64 current_chunk_remaining{0};
+    bool awaiting_chunk_terminator{false};
     bool chunked_transfer_encoding{false};
+    bool connection_close{false};
 };
 } // namespace multipass
 
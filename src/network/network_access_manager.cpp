@@ -27,6 +27,45 @@ mp::NetworkAccessManager::NetworkAccessManager(QObject* parent) : QNetworkAccess
 {
 }
 
+mp::NetworkAccessManager::~NetworkAccessManager() = default;
+
+mp::LocalSocketUPtr mp::NetworkAccessManager::checkout_socket(const QString& socket_path)
+{
+    auto& idle = idle_sockets[socket_path.toStdString()];
+    while (!idle.empty())
+    {
+        auto candidate = std::move(idle.back());
+        idle.pop_back();
+
+        // The server may have dropped the connection while it sat idle
+        if (candidate->state() == QLocalSocket::ConnectedState && candidate->bytesAvailable() == 0)
+            return candidate;
+    }
+
+    auto local_socket = std::make_unique<QLocalSocket>();
+
+    local_socket->connectToServer(socket_path);
+    if (!local_socket->waitForConnected(5000))
+    {
+        throw LocalSocketConnectionException(
+            fmt::format("Cannot connect to {}: {}", socket_path, local_socket->errorString()));
+    }
+
+    return local_socket;
+}
+
+void mp::NetworkAccessManager::recycle_socket(const QString& socket_path, LocalSocketUPtr socket)
+{
+    constexpr auto max_idle_sockets = std::size_t{4};
+
+    if (socket && socket->state() == QLocalSocket::ConnectedState)
+    {
+        auto& idle = idle_sockets[socket_path.toStdString()];
+        if (idle.size() < max_idle_sockets)
+            idle.push_back(std::move(socket));
+    }
+}
+
 QNetworkReply* mp::NetworkAccessManager::createRequest(QNetworkAccessManager::Operation operation,
                                                        const QNetworkRequest& orig_request, QIODevice* device)
 {
@@ -47,14 +86,9 @@ QNetworkReply* mp::NetworkAccessManager::createRequest(QNetworkAccessManager::Op
 
         const auto socket_path = QUrl(url_parts[0]).path();
 
-        LocalSocketUPtr local_socket = std::make_unique<QLocalSocket>();
-
-        local_socket->connectToServer(socket_path);
-        if (!local_socket->waitForConnected(5000))
-        {
-            throw LocalSocketConnectionException(
-                fmt::format("Cannot connect to {}: {}", socket_path, local_socket->errorString()));
-        }
+        // Reuse an idle keep-alive connection when one is available, so chatty control
+        // paths don't pay connect+teardown per request
+        auto local_socket = checkout_socket(socket_path);
 
         const auto server_path = url_parts[1];
         QNetworkRequest request{orig_request};
@@ -65,7 +99,10 @@ QNetworkReply* mp::NetworkAccessManager::createRequest(QNetworkAccessManager::Op
         request.setUrl(url);
 
         // The caller needs to be responsible for freeing the allocated memory
-        return new LocalSocketReply(std::move(local_socket), request, device);
+        return new LocalSocketReply(std::move(local_socket), request, device,
+                                    [this, socket_path](LocalSocketUPtr socket) {
+                                        recycle_socket(socket_path, std::move(socket));
+                                    });
     }
     else
     {
@@ -17,6 +17,8 @@
 
 #include <multipass/url_downloader.h>
 
+#include "indexed_network_cache.h"
+
 #include <multipass/exceptions/aborted_download_exception.h>
 #include <multipass/exceptions/download_exception.h>
 #include <multipass/format.h>
@@ -25,13 +27,18 @@
 #include <QDir>
 #include <QEventLoop>
 #include <QFile>
+#include <QFileInfo>
 #include <QNetworkAccessManager>
-#include <QNetworkDiskCache>
 #include <QNetworkReply>
 #include <QTimer>
 #include <QUrl>
 
+#include <map>
 #include <memory>
+#include <numeric>
+#include <vector>
+
+#include <fcntl.h>
 
 namespace mp = multipass;
 namespace mpl = multipass::logging;
@@ -40,20 +47,93 @@ namespace
 {
 constexpr auto category = "url downloader";
 
-auto make_network_manager(const mp::Path& cache_dir_path)
+// Download priority plumbing: priorities are per thread (every transfer runs a local event
+// loop on its calling thread), while the count of in-flight interactive transfers is
+// shared, since all downloaders contend for the same link.
+thread_local bool background_priority{false};
+std::atomic<int> active_interactive_downloads{0};
+
+constexpr auto background_read_buffer_size = qint64{256 * 1024}; // caps the sender via TCP backpressure
+constexpr auto background_resume_poll_interval = 500;            // ms between checks for a free link
+
+// A fresh multi-GB image is written once and only read back at launch time; dropping
+// pages behind the write cursor keeps the download from evicting memory that running
+// instances are using. Clean pages go immediately; still-dirty ones are skipped and
+// picked up by a later pass, once written back. Mirrors the xz decoder's write path.
+class CacheDroppingWriter
 {
-    auto manager = std::make_unique<QNetworkAccessManager>();
+public:
+    explicit CacheDroppingWriter(QFile& file, qint64 start_offset = 0)
+        : file{file}, region_start{start_offset}, bytes_written{start_offset}, last_dropped{start_offset}
+    {
+    }
 
-    if (!cache_dir_path.isEmpty())
+    qint64 write(const QByteArray& data)
     {
-        auto network_cache = new QNetworkDiskCache;
-        network_cache->setCacheDirectory(cache_dir_path);
+        const auto ret = file.write(data);
+        if (ret < 0)
+            return ret;
+
+        bytes_written += ret;
+        if (bytes_written - last_dropped >= drop_window)
+        {
+            file.flush();
+            ::posix_fadvise(file.handle(), region_start, bytes_written - region_start, POSIX_FADV_DONTNEED);
+            last_dropped = bytes_written;
+        }
+
+        return ret;
+    }
+
+private:
+    static constexpr qint64 drop_window = 8 * 1024 * 1024;
+
+    QFile& file;
+    const qint64 region_start;
+    qint64 bytes_written;
+    qint64 last_dropped;
+};
 
-        // Manager now owns network_cache and so it will delete it in its dtor
-        manager->setCache(network_cache);
+struct DownloadClassGuard
+{
+    DownloadClassGuard() : background{background_priority}
+    {
+        if (!background)
+            ++active_interactive_downloads;
     }
+    ~DownloadClassGuard()
+    {
+        if (!background)
+            --active_interactive_downloads;
+    }
+
+    const bool background;
+};
+
+// QNetworkAccessManager is thread-affine, so one manager cannot be shared between the
+// threads that download concurrently; instead each thread keeps a long-lived manager per
+// cache directory. Repeated calls (the image hosts' frequent last_modified probes in
+// particular) then reuse established keep-alive connections and the manager's proxy and
+// DNS results rather than re-resolving on a freshly constructed manager every time.
+QNetworkAccessManager* make_network_manager(const mp::Path& cache_dir_path)
+{
+    thread_local std::map<QString, std::unique_ptr<QNetworkAccessManager>> managers;
 
-    return manager;
+    auto& manager = managers[cache_dir_path];
+    if (manager == nullptr)
+    {
+        manager = std::make_unique<QNetworkAccessManager>();
+
+        if (!cache_dir_path.isEmpty())
+        {
+            auto network_cache = new mp::IndexedNetworkCache{cache_dir_path};
+
+            // Manager now owns network_cache and so it will delete it in its dtor
+            manager->setCache(network_cache);
+        }
+    }
+
+    return manager.get();
 }
 
 auto get_network_cache_data(QAbstractNetworkCache* network_cache, const QUrl& url)
@@ -64,32 +144,193 @@ auto get_network_cache_data(QAbstractNetworkCache* network_cache, const QUrl& ur
     return data;
 }
 
-template <typename ProgressAction, typename DownloadAction, typename ErrorAction, typename Time>
-QByteArray download(QNetworkAccessManager* manager, const Time& timeout, QUrl const& url, ProgressAction&& on_progress,
-                    DownloadAction&& on_download, ErrorAction&& on_error, const std::atomic_bool& abort_download)
+// Minimum size for which splitting the transfer into parallel ranged requests is worthwhile.
+constexpr int64_t min_ranged_download_size = 64 * 1024 * 1024;
+constexpr int num_download_streams = 4;
+
+// Returns the content length if the server advertises byte-range support, -1 otherwise.
+qint64 content_length_if_ranged(QNetworkAccessManager* manager, const QUrl& url)
 {
+    QEventLoop event_loop;
+
+    QNetworkRequest request{url};
+    request.setAttribute(QNetworkRequest::FollowRedirectsAttribute, true);
+
+    auto reply = manager->head(request);
+    QObject::connect(reply, &QNetworkReply::finished, &event_loop, &QEventLoop::quit);
+    event_loop.exec();
+    reply->deleteLater();
+
+    if (reply->error() != QNetworkReply::NoError || reply->rawHeader("Accept-Ranges") != "bytes")
+        return -1;
+
+    return reply->header(QNetworkRequest::ContentLengthHeader).toLongLong();
+}
+
+template <typename Time>
+void ranged_download(QNetworkAccessManager* manager, const Time& timeout, const QUrl& url, const QString& file_name,
+                     qint64 total_size, const int download_type, const mp::ProgressMonitor& monitor,
+                     const std::atomic_bool& abort_download)
+{
+    {
+        QFile file{file_name};
+        if (!file.open(QIODevice::ReadWrite | QIODevice::Truncate) || !file.resize(total_size))
+            throw mp::DownloadException{url.toString().toStdString(), file.errorString().toStdString()};
+    }
+
     QEventLoop event_loop;
     QTimer download_timeout;
     download_timeout.setInterval(timeout);
 
+    std::vector<std::unique_ptr<QFile>> part_files;
+    std::vector<std::unique_ptr<CacheDroppingWriter>> part_writers;
+    std::vector<QNetworkReply*> replies;
+    std::vector<qint64> received(num_download_streams, 0);
+    auto streams_left = num_download_streams;
+
+    const auto part_size = total_size / num_download_streams;
+
+    auto abort_all = [&replies] {
+        for (auto* reply : replies)
+            reply->abort();
+    };
+
+    for (int i = 0; i < num_download_streams; ++i)
+    {
+        const auto begin = i * part_size;
+        const auto end = (i == num_download_streams - 1) ? total_size - 1 : begin + part_size - 1;
+
+        auto part_file = std::make_unique<QFile>(file_name);
+        if (!part_file->open(QIODevice::ReadWrite) || !part_file->seek(begin))
+            throw mp::DownloadException{url.toString().toStdString(), part_file->errorString().toStdString()};
+
+        auto part_writer = std::make_unique<CacheDroppingWriter>(*part_file, begin);
+
+        QNetworkRequest request{url};
+        request.setRawHeader("Connection", "Keep-Alive");
+        request.setRawHeader("Range", QString("bytes=%1-%2").arg(begin).arg(end).toLatin1());
+        request.setAttribute(QNetworkRequest::FollowRedirectsAttribute, true);
+        request.setAttribute(QNetworkRequest::CacheLoadControlAttribute, QNetworkRequest::AlwaysNetwork);
+
+        auto reply = manager->get(request);
+        replies.push_back(reply);
+
+        QObject::connect(reply, &QNetworkReply::finished, [&event_loop, &streams_left] {
+            if (--streams_left == 0)
+                event_loop.quit();
+        });
+        QObject::connect(reply, &QNetworkReply::readyRead,
+                         [&abort_download, &abort_all, &download_timeout, reply, file = part_file.get(),
+                          writer = part_writer.get()] {
+                             if (abort_download)
+                             {
+                                 abort_all();
+                                 return;
+                             }
+
+                             download_timeout.start();
+                             if (writer->write(reply->readAll()) < 0)
+                             {
+                                 mpl::log(mpl::Level::error, category, "error writing image: {}",
+                                          file->errorString());
+                                 abort_all();
+                             }
+                         });
+        QObject::connect(reply, &QNetworkReply::downloadProgress,
+                         [&received, &monitor, &abort_all, total_size, download_type, i](qint64 bytes_received,
+                                                                                        qint64 /*bytes_total*/) {
+                             received[i] = bytes_received;
+                             const auto all_received = std::accumulate(received.begin(), received.end(), qint64{0});
+                             if (all_received == 0)
+                                 return;
+
+                             const auto progress = (100 * all_received + total_size / 2) / total_size;
+                             if (!monitor(download_type, progress))
+                                 abort_all();
+                         });
+
+        part_files.push_back(std::move(part_file));
+        part_writers.push_back(std::move(part_writer));
+    }
+
+    QObject::connect(&download_timeout, &QTimer::timeout, [&download_timeout, &abort_all] {
+        download_timeout.stop();
+        abort_all();
+    });
+
+    download_timeout.start();
+    event_loop.exec();
+
+    for (auto* reply : replies)
+    {
+        if (reply->error() != QNetworkReply::NoError)
+        {
+            const auto msg = reply->errorString().toStdString();
+            QFile::remove(file_name);
+
+            if (abort_download)
+                throw mp::AbortedDownloadException{msg};
+            else
+                throw mp::DownloadException{url.toString().toStdString(),
+                                            download_timeout.isActive() ? msg : "Network timeout"};
+        }
+    }
+}
+
+auto make_download_request(const QUrl& url)
+{
     QNetworkRequest request{url};
     request.setRawHeader("Connection", "Keep-Alive");
     request.setAttribute(QNetworkRequest::HttpPipeliningAllowedAttribute, true);
     request.setAttribute(QNetworkRequest::FollowRedirectsAttribute, true);
     request.setAttribute(QNetworkRequest::CacheLoadControlAttribute, QNetworkRequest::AlwaysNetwork);
+    return request;
+}
 
+template <typename ProgressAction, typename DownloadAction, typename ErrorAction, typename Time>
+QByteArray download(QNetworkAccessManager* manager, const Time& timeout, const QNetworkRequest& request,
+                    ProgressAction&& on_progress, DownloadAction&& on_download, ErrorAction&& on_error,
+                    const std::atomic_bool& abort_download)
+{
+    QEventLoop event_loop;
+    QTimer download_timeout;
+    download_timeout.setInterval(timeout);
+
+    const DownloadClassGuard download_class;
+
+    const auto url = request.url();
     auto reply = manager->get(request);
 
     QObject::connect(reply, &QNetworkReply::finished, &event_loop, &QEventLoop::quit);
     QObject::connect(reply, &QNetworkReply::downloadProgress, [&](qint64 bytes_received, qint64 bytes_total) {
         on_progress(reply, bytes_received, bytes_total);
     });
-    QObject::connect(reply, &QNetworkReply::readyRead, [&]() { on_download(reply, download_timeout); });
+    QObject::connect(reply, &QNetworkReply::readyRead, [&]() {
+        // A paused background transfer stops draining; once its read buffer fills, Qt stops
+        // reading the socket and the closed TCP window throttles the sender to nothing.
+        if (download_class.background && active_interactive_downloads.load() > 0)
+            return;
+
+        on_download(reply, download_timeout);
+    });
     QObject::connect(&download_timeout, &QTimer::timeout, [&]() {
         download_timeout.stop();
         reply->abort();
     });
 
+    QTimer resume_poll;
+    if (download_class.background)
+    {
+        reply->setReadBufferSize(background_read_buffer_size);
+        QObject::connect(&resume_poll, &QTimer::timeout, [&] {
+            if (active_interactive_downloads.load() > 0)
+                download_timeout.start(); // paused on purpose, so keep the timeout from firing
+            else if (reply->bytesAvailable() > 0)
+                on_download(reply, download_timeout);
+        });
+        resume_poll.start(background_resume_poll_interval);
+    }
+
     download_timeout.start();
     event_loop.exec();
     if (reply->error() != QNetworkReply::NoError)
@@ -124,8 +365,138 @@ void mp::URLDownloader::download_to(const QUrl& url, const QString& file_name, i
 {
     auto manager{make_network_manager(cache_dir_path)};
 
-    QFile file{file_name};
-    file.open(QIODevice::ReadWrite | QIODevice::Truncate);
+    // A background transfer keeps to a single stream; the parallel ranged path exists to
+    // fill the link, which is exactly what background traffic must not do
+    if (!background_priority && size >= min_ranged_download_size)
+    {
+        // Large transfers go over multiple connections when the server supports byte
+        // ranges, since a single stream is often per-connection bandwidth limited.
+        const auto content_length = content_length_if_ranged(manager, url);
+        if (content_length > 0)
+        {
+            ranged_download(manager, timeout, url, file_name, content_length, download_type, monitor,
+                            abort_download);
+            return;
+        }
+    }
+
+    // Partial content is kept in a .part file alongside the server's validator, so an
+    // interrupted fetch resumes with a Range request instead of starting over.
+    const QString part_file_name = file_name + ".part";
+    const QString meta_file_name = part_file_name + ".meta";
+
+    QByteArray validator;
+    try
+    {
+        validator = last_modified(url).toString(Qt::ISODate).toUtf8();
+    }
+    catch (const std::exception& e)
+    {
+        mpl::log(mpl::Level::debug, category,
+                 fmt::format("Cannot get a validator for {}: {}. Not resuming.", url.toString(), e.what()));
+    }
+
+    qint64 resume_offset = 0;
+    {
+        QFile meta_file{meta_file_name};
+        if (QFileInfo::exists(part_file_name) && !validator.isEmpty() && meta_file.open(QIODevice::ReadOnly) &&
+            meta_file.readAll() == validator)
+            resume_offset = QFileInfo{part_file_name}.size();
+    }
+
+    QFile file{part_file_name};
+    file.open(QIODevice::ReadWrite);
+    if (resume_offset > 0)
+    {
+        mpl::log(mpl::Level::info, category,
+                 fmt::format("Resuming download of {} at byte {}", url.toString(), resume_offset));
+        file.seek(resume_offset);
+    }
+    else
+    {
+        file.resize(0);
+    }
+
+    if (!validator.isEmpty())
+    {
+        QFile meta_file{meta_file_name};
+        if (meta_file.open(QIODevice::WriteOnly | QIODevice::Truncate))
+            meta_file.write(validator);
+    }
+
+    auto request = make_download_request(url);
+    if (resume_offset > 0)
+        request.setRawHeader("Range", QString("bytes=%1-").arg(resume_offset).toLatin1());
+
+    auto progress_monitor = [&monitor, download_type, size, resume_offset](QNetworkReply* reply, qint64 bytes_received,
+                                                                           qint64 bytes_total) {
+        bytes_received += resume_offset;
+        if (bytes_received == 0)
+            return;
+
+        if (bytes_total == -1 && size > 0)
+            bytes_total = size;
+        else if (bytes_total > 0)
+            bytes_total += resume_offset;
+
+        auto progress = (size < 0) ? size : (100 * bytes_received + bytes_total / 2) / bytes_total;
+        if (!monitor(download_type, progress))
+        {
+            reply->abort();
+        }
+    };
+
+    bool range_checked = false;
+    auto writer = std::make_unique<CacheDroppingWriter>(file, resume_offset);
+    auto on_download = [this, &file, &writer, &range_checked, resume_offset](QNetworkReply* reply,
+                                                                            QTimer& download_timeout) {
+        if (abort_download)
+        {
+            reply->abort();
+            return;
+        }
+
+        if (download_timeout.isActive())
+            download_timeout.stop();
+        else
+            return;
+
+        if (!range_checked)
+        {
+            range_checked = true;
+            if (resume_offset > 0 &&
+                reply->attribute(QNetworkRequest::HttpStatusCodeAttribute).toInt() != 206)
+            { // the server ignored our Range request; start over
+                file.resize(0);
+                file.seek(0);
+                writer = std::make_unique<CacheDroppingWriter>(file);
+            }
+        }
+
+        if (writer->write(reply->readAll()) < 0)
+        {
+            mpl::log(mpl::Level::error, category, "error writing image: {}", file.errorString());
+            reply->abort();
+        }
+        download_timeout.start();
+    };
+
+    // The partial file and its validator stay behind on failure, ready for the next attempt.
+    auto on_error = [] {};
+
+    ::download(manager, timeout, request, progress_monitor, on_download, on_error, abort_download);
+
+    file.close();
+    QFile::remove(file_name);
+    if (!file.rename(file_name))
+        throw mp::DownloadException{url.toString().toStdString(), file.errorString().toStdString()};
+    QFile::remove(meta_file_name);
+}
+
+void mp::URLDownloader::download_to_sink(const QUrl& url, int64_t size, const int download_type,
+                                         const mp::ProgressMonitor& monitor, const DataSink& sink)
+{
+    auto manager{make_network_manager(cache_dir_path)};
 
     auto progress_monitor = [&monitor, download_type, size](QNetworkReply* reply, qint64 bytes_received,
                                                             qint64 bytes_total) {
@@ -142,7 +513,7 @@ void mp::URLDownloader::download_to(const QUrl& url, const QString& file_name, i
         }
     };
 
-    auto on_download = [this, &file](QNetworkReply* reply, QTimer& download_timeout) {
+    auto on_download = [this, &sink](QNetworkReply* reply, QTimer& download_timeout) {
         if (abort_download)
         {
             reply->abort();
@@ -154,17 +525,15 @@ void mp::URLDownloader::download_to(const QUrl& url, const QString& file_name, i
         else
             return;
 
-        if (file.write(reply->readAll()) < 0)
+        if (!sink(reply->readAll()))
         {
-            mpl::log(mpl::Level::error, category, fmt::format("error writing image: {}", file.errorString()));
             reply->abort();
         }
         download_timeout.start();
     };
 
-    auto on_error = [&file]() { file.remove(); };
-
-    ::download(manager.get(), timeout, url, progress_monitor, on_download, on_error, abort_download);
+    ::download(manager, timeout, make_download_request(url), progress_monitor, on_download, [] {},
+               abort_download);
 }
 
 QByteArray mp::URLDownloader::download(const QUrl& url)
@@ -206,7 +575,8 @@ QByteArray mp::URLDownloader::download(const QUrl& url)
 
     try
     {
-        return ::download(manager.get(), timeout, url, [](QNetworkReply*, qint64, qint64) {}, on_download, [] {},
+        return ::download(manager, timeout, make_download_request(url), [](QNetworkReply*, qint64, qint64) {},
+                          on_download, [] {},
                           abort_download);
     }
     catch (const std::exception& e)
@@ -262,3 +632,13 @@ void mp::URLDownloader::abort_all_downloads()
 {
     abort_download = true;
 }
+
+mp::URLDownloader::BackgroundPriorityScope::BackgroundPriorityScope()
+{
+    background_priority = true;
+}
+
+mp::URLDownloader::BackgroundPriorityScope::~BackgroundPriorityScope()
+{
+    background_priority = false;
+}
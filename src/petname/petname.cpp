@@ -25,9 +25,9 @@
 namespace mp = multipass;
 namespace
 {
-constexpr auto num_names = std::extent<decltype(mp::petname::names)>::value;
-constexpr auto num_adverbs = std::extent<decltype(mp::petname::adverbs)>::value;
-constexpr auto num_adjectives = std::extent<decltype(mp::petname::adjectives)>::value;
+constexpr auto num_names = mp::petname::names.size();
+constexpr auto num_adverbs = mp::petname::adverbs.size();
+constexpr auto num_adjectives = mp::petname::adjectives.size();
 
 // Arbitrary but arrays should have at least 100 entries each
 static_assert(num_names >= 100, "");
@@ -63,18 +63,29 @@ mp::Petname::Petname(NumWords num_words, std::string separator)
 
 std::string mp::Petname::make_name()
 {
-    std::string name = multipass::petname::names[name_dist(engine)];
-    std::string adjective = multipass::petname::adjectives[adjective_dist(engine)];
-    std::string adverb = multipass::petname::adverbs[adverb_dist(engine)];
+    const auto name = multipass::petname::names[name_dist(engine)];
 
     switch(num_words)
     {
     case NumWords::ONE:
-        return name;
+        return std::string{name};
     case NumWords::TWO:
-        return adjective + separator + name;
+    {
+        const auto adjective = multipass::petname::adjectives[adjective_dist(engine)];
+
+        std::string result;
+        result.reserve(adjective.size() + separator.size() + name.size());
+        return result.append(adjective).append(separator).append(name);
+    }
     case NumWords::THREE:
-        return adverb + separator + adjective + separator + name;
+    {
+        const auto adjective = multipass::petname::adjectives[adjective_dist(engine)];
+        const auto adverb = multipass::petname::adverbs[adverb_dist(engine)];
+
+        std::string result;
+        result.reserve(adverb.size() + adjective.size() + 2 * separator.size() + name.size());
+        return result.append(adverb).append(separator).append(adjective).append(separator).append(name);
+    }
     default:
         throw std::invalid_argument("Invalid number of words chosen");
     }
@@ -51,10 +51,10 @@ public:
 
     void print_to(std::ostream& out)
     {
-        out << "const char* " << var_name << "[] =\n{\n";
+        out << "inline constexpr std::array<std::string_view, " << words.size() << "> " << var_name << " =\n{\n";
         for (auto const& w: words)
         {
-            out << "    \"" << w << "\",\n";
+            out << "    \"" << w << "\"sv,\n";
         }
         out << "};\n\n";
     }
@@ -80,8 +80,11 @@ try
     std::ofstream out(argv[4]);
 
     out << "//Auto Generated, any edits will be lost\n\n";
+    out << "#include <array>\n";
+    out << "#include <string_view>\n\n";
     out << "namespace multipass\n{\n";
     out << "namespace petname\n{\n";
+    out << "using namespace std::string_view_literals;\n\n";
 
     adjectives.print_to(out);
     adverbs.print_to(out);
@@ -0,0 +1,71 @@
+/*
+ * Copyright (C) 2021 Canonical, Ltd.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; version 3.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "libvirt_connection_manager.h"
+
+#include <algorithm>
+#include <stdexcept>
+
+namespace mp = multipass;
+
+namespace
+{
+constexpr auto initial_backoff = std::chrono::milliseconds{100};
+constexpr auto max_backoff = std::chrono::seconds{30};
+} // namespace
+
+mp::LibvirtConnectionManager::LibvirtConnectionManager(const mp::LibvirtWrapper::UPtr& libvirt_wrapper)
+    : libvirt_wrapper{libvirt_wrapper}, backoff_delay{initial_backoff}
+{
+}
+
+mp::LibvirtConnectionManager::Connection mp::LibvirtConnectionManager::borrow_connection()
+{
+    std::lock_guard<std::mutex> lock{connection_mutex};
+
+    if (!libvirt_wrapper)
+        throw std::runtime_error("The libvirt library is not loaded. Please ensure libvirt is installed and running.");
+
+    if (connection && libvirt_wrapper->virConnectIsAlive(connection.get()) == 1)
+        return connection;
+
+    // A stale connection closes once its last borrower lets go of it
+    connection.reset();
+
+    const auto now = std::chrono::steady_clock::now();
+    if (now < next_attempt)
+        throw std::runtime_error("Cannot connect to libvirtd: still backing off after a failed attempt.\n"
+                                 "Please ensure libvirt is installed and running.");
+
+    auto raw_connection = libvirt_wrapper->virConnectOpen("qemu:///system");
+    if (!raw_connection)
+    {
+        next_attempt = now + backoff_delay;
+        backoff_delay = std::min<std::chrono::milliseconds>(backoff_delay * 2, max_backoff);
+        throw std::runtime_error(
+            fmt::format("Cannot connect to libvirtd: {}\nPlease ensure libvirt is installed and running.",
+                        libvirt_wrapper->virGetLastErrorMessage()));
+    }
+
+    backoff_delay = initial_backoff;
+    auto close_connection = libvirt_wrapper->virConnectClose;
+    connection = Connection{raw_connection, [close_connection](virConnectPtr raw) {
+                                if (raw)
+                                    close_connection(raw);
+                            }};
+    return connection;
+}
@@ -0,0 +1,53 @@
+/*
+ * Copyright (C) 2021 Canonical, Ltd.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; version 3.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#ifndef MULTIPASS_LIBVIRT_CONNECTION_MANAGER_H
+#define MULTIPASS_LIBVIRT_CONNECTION_MANAGER_H
+
+#include "libvirt_wrapper.h"
+
+#include <chrono>
+#include <memory>
+#include <mutex>
+
+namespace multipass
+{
+// Hands out one shared connection to libvirtd for the whole backend: opening a
+// connection costs tens of milliseconds and serializes on libvirtd's auth handshake,
+// so factory and instance operations borrow this one instead of opening their own.
+// The connection is health-checked on each loan and lazily re-opened when libvirtd
+// drops it, with exponential backoff between failed attempts.
+class LibvirtConnectionManager
+{
+public:
+    using Connection = std::shared_ptr<virConnect>;
+
+    explicit LibvirtConnectionManager(const LibvirtWrapper::UPtr& libvirt_wrapper);
+
+    Connection borrow_connection(); // throws std::runtime_error when libvirtd is unreachable
+
+private:
+    // Needs to be a reference so testing can override the various libvirt functions
+    const LibvirtWrapper::UPtr& libvirt_wrapper;
+    Connection connection;
+    std::mutex connection_mutex;
+    std::chrono::steady_clock::time_point next_attempt{std::chrono::steady_clock::time_point::min()};
+    std::chrono::milliseconds backoff_delay;
+};
+} // namespace multipass
+
+#endif // MULTIPASS_LIBVIRT_CONNECTION_MANAGER_H
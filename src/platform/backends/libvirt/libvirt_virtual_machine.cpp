@@ -56,14 +56,15 @@ auto instance_mac_addr_for(virDomainPtr domain, const mp::LibvirtWrapper::UPtr&
     return mac_addr;
 }
 
-auto instance_ip_for(const std::string& mac_addr, const mp::LibvirtWrapper::UPtr& libvirt_wrapper)
+auto instance_ip_for(const std::string& mac_addr, mp::LibvirtConnectionManager& connection_manager,
+                     const mp::LibvirtWrapper::UPtr& libvirt_wrapper)
 {
     mp::optional<mp::IPAddress> ip_address;
 
-    mp::LibVirtVirtualMachine::ConnectionUPtr connection{nullptr, nullptr};
+    mp::LibvirtConnectionManager::Connection connection;
     try
     {
-        connection = mp::LibVirtVirtualMachine::open_libvirt_connection(libvirt_wrapper);
+        connection = connection_manager.borrow_connection();
     }
     catch (const std::exception&)
     {
@@ -241,17 +242,19 @@ bool domain_is_running(virDomainPtr domain, const mp::LibvirtWrapper::UPtr& libv
 
 mp::LibVirtVirtualMachine::LibVirtVirtualMachine(const mp::VirtualMachineDescription& desc,
                                                  const std::string& bridge_name, mp::VMStatusMonitor& monitor,
-                                                 const mp::LibvirtWrapper::UPtr& libvirt_wrapper)
+                                                 const mp::LibvirtWrapper::UPtr& libvirt_wrapper,
+                                                 mp::LibvirtConnectionManager& connection_manager)
     : BaseVirtualMachine{desc.vm_name},
       username{desc.ssh_username},
       desc{desc},
       monitor{&monitor},
       bridge_name{bridge_name},
-      libvirt_wrapper{libvirt_wrapper}
+      libvirt_wrapper{libvirt_wrapper},
+      connection_manager{connection_manager}
 {
     try
     {
-        initialize_domain_info(open_libvirt_connection(libvirt_wrapper).get());
+        initialize_domain_info(connection_manager.borrow_connection().get());
     }
     catch (const std::exception&)
     {
@@ -269,7 +272,7 @@ mp::LibVirtVirtualMachine::~LibVirtVirtualMachine()
 
 void mp::LibVirtVirtualMachine::start()
 {
-    auto connection = open_libvirt_connection(libvirt_wrapper);
+    auto connection = connection_manager.borrow_connection();
     DomainUPtr domain{nullptr, nullptr};
 
     if (state == VirtualMachine::State::unknown)
@@ -320,7 +323,7 @@ void mp::LibVirtVirtualMachine::stop()
 void mp::LibVirtVirtualMachine::shutdown()
 {
     std::unique_lock<decltype(state_mutex)> lock{state_mutex};
-    auto domain = domain_by_name_for(vm_name, open_libvirt_connection(libvirt_wrapper).get(), libvirt_wrapper);
+    auto domain = domain_by_name_for(vm_name, connection_manager.borrow_connection().get(), libvirt_wrapper);
     state = refresh_instance_state_for_domain(domain.get(), state, libvirt_wrapper);
     if (state == State::running || state == State::delayed_shutdown || state == State::unknown)
     {
@@ -352,7 +355,7 @@ void mp::LibVirtVirtualMachine::shutdown()
 
 void mp::LibVirtVirtualMachine::suspend()
 {
-    auto domain = domain_by_name_for(vm_name, open_libvirt_connection(libvirt_wrapper).get(), libvirt_wrapper);
+    auto domain = domain_by_name_for(vm_name, connection_manager.borrow_connection().get(), libvirt_wrapper);
     state = refresh_instance_state_for_domain(domain.get(), state, libvirt_wrapper);
     if (state == State::running || state == State::delayed_shutdown)
     {
@@ -382,7 +385,7 @@ mp::VirtualMachine::State mp::LibVirtVirtualMachine::current_state()
 {
     try
     {
-        auto connection = open_libvirt_connection(libvirt_wrapper);
+        auto connection = connection_manager.borrow_connection();
         auto domain = domain_by_name_for(vm_name, connection.get(), libvirt_wrapper);
         if (!domain)
             initialize_domain_info(connection.get());
@@ -405,7 +408,7 @@ int mp::LibVirtVirtualMachine::ssh_port()
 void mp::LibVirtVirtualMachine::ensure_vm_is_running()
 {
     auto is_vm_running = [this] {
-        auto domain = domain_by_name_for(vm_name, open_libvirt_connection(libvirt_wrapper).get(), libvirt_wrapper);
+        auto domain = domain_by_name_for(vm_name, connection_manager.borrow_connection().get(), libvirt_wrapper);
         return domain_is_running(domain.get(), libvirt_wrapper);
     };
 
@@ -414,7 +417,9 @@ void mp::LibVirtVirtualMachine::ensure_vm_is_running()
 
 std::string mp::LibVirtVirtualMachine::ssh_hostname(std::chrono::milliseconds timeout)
 {
-    auto get_ip = [this]() -> optional<IPAddress> { return instance_ip_for(mac_addr, libvirt_wrapper); };
+    auto get_ip = [this]() -> optional<IPAddress> {
+        return instance_ip_for(mac_addr, connection_manager, libvirt_wrapper);
+    };
 
     return mp::backend::ip_address_for(this, get_ip, timeout);
 }
@@ -428,7 +433,7 @@ std::string mp::LibVirtVirtualMachine::management_ipv4()
 {
     if (!management_ip)
     {
-        auto result = instance_ip_for(mac_addr, libvirt_wrapper);
+        auto result = instance_ip_for(mac_addr, connection_manager, libvirt_wrapper);
         if (result)
             management_ip.emplace(result.value());
         else
@@ -18,6 +18,7 @@
 #ifndef MULTIPASS_LIBVIRT_VIRTUAL_MACHINE_H
 #define MULTIPASS_LIBVIRT_VIRTUAL_MACHINE_H
 
+#include "libvirt_connection_manager.h"
 #include "libvirt_wrapper.h"
 
 #include <shared/base_virtual_machine.h>
@@ -36,7 +37,8 @@ public:
     using NetworkUPtr = std::unique_ptr<virNetwork, decltype(virNetworkFree)*>;
 
     LibVirtVirtualMachine(const VirtualMachineDescription& desc, const std::string& bridge_name,
-                          VMStatusMonitor& monitor, const LibvirtWrapper::UPtr& libvirt_wrapper);
+                          VMStatusMonitor& monitor, const LibvirtWrapper::UPtr& libvirt_wrapper,
+                          LibvirtConnectionManager& connection_manager);
     ~LibVirtVirtualMachine();
 
     void start() override;
@@ -66,6 +68,8 @@ private:
     const std::string& bridge_name;
     // Needs to be a reference so testing can override the various libvirt functions
     const LibvirtWrapper::UPtr& libvirt_wrapper;
+    // The factory's shared connection; borrowing it spares a connect per operation
+    LibvirtConnectionManager& connection_manager;
     bool update_suspend_status{true};
 };
 } // namespace multipass
@@ -21,6 +21,7 @@
 #include <multipass/logging/log.h>
 #include <multipass/utils.h>
 #include <multipass/virtual_machine_description.h>
+#include <multipass/vm_status_monitor.h>
 #include <shared/linux/backend_utils.h>
 
 #include <multipass/format.h>
@@ -52,12 +53,13 @@ auto generate_libvirt_bridge_xml_config(const mp::Path& data_dir, const std::str
                        bridge_name, subnet, subnet, subnet);
 }
 
-std::string enable_libvirt_network(const mp::Path& data_dir, const mp::LibvirtWrapper::UPtr& libvirt_wrapper)
+std::string enable_libvirt_network(const mp::Path& data_dir, mp::LibvirtConnectionManager& connection_manager,
+                                   const mp::LibvirtWrapper::UPtr& libvirt_wrapper)
 {
-    mp::LibVirtVirtualMachine::ConnectionUPtr connection{nullptr, nullptr};
+    mp::LibvirtConnectionManager::Connection connection;
     try
     {
-        connection = mp::LibVirtVirtualMachine::open_libvirt_connection(libvirt_wrapper);
+        connection = connection_manager.borrow_connection();
     }
     catch (const std::exception&)
     {
@@ -109,9 +111,12 @@ mp::LibVirtVirtualMachineFactory::LibVirtVirtualMachineFactory(const mp::Path& d
                                                                const std::string& libvirt_object_path)
     : libvirt_wrapper{make_libvirt_wrapper(libvirt_object_path)},
       data_dir{data_dir},
-      bridge_name{enable_libvirt_network(data_dir, libvirt_wrapper)},
+      connection_manager{libvirt_wrapper},
+      bridge_name{enable_libvirt_network(data_dir, connection_manager, libvirt_wrapper)},
       libvirt_object_path{libvirt_object_path}
 {
+    if (libvirt_wrapper)
+        register_lifecycle_events();
 }
 
 mp::LibVirtVirtualMachineFactory::LibVirtVirtualMachineFactory(const mp::Path& data_dir)
@@ -123,16 +128,29 @@ mp::VirtualMachine::UPtr mp::LibVirtVirtualMachineFactory::create_virtual_machin
                                                                                   VMStatusMonitor& monitor)
 {
     if (bridge_name.empty())
-        bridge_name = enable_libvirt_network(data_dir, libvirt_wrapper);
+        bridge_name = enable_libvirt_network(data_dir, connection_manager, libvirt_wrapper);
 
-    return std::make_unique<mp::LibVirtVirtualMachine>(desc, bridge_name, monitor, libvirt_wrapper);
+    // There is only ever one monitor - the daemon; remember it so lifecycle events can
+    // reach it without a factory/instance round trip
+    event_monitor = &monitor;
+
+    return std::make_unique<mp::LibVirtVirtualMachine>(desc, bridge_name, monitor, libvirt_wrapper,
+                                                       connection_manager);
 }
 
 mp::LibVirtVirtualMachineFactory::~LibVirtVirtualMachineFactory()
 {
+    if (event_loop_thread.joinable())
+    {
+        event_loop_running = false;
+        libvirt_wrapper->virConnectDomainEventDeregisterAny(event_connection.get(), lifecycle_callback_id);
+        event_connection.reset(); // closing the connection wakes the default event loop
+        event_loop_thread.join();
+    }
+
     if (bridge_name == multipass_bridge_name)
     {
-        auto connection = LibVirtVirtualMachine::open_libvirt_connection(libvirt_wrapper);
+        auto connection = connection_manager.borrow_connection();
         mp::LibVirtVirtualMachine::NetworkUPtr network{
             libvirt_wrapper->virNetworkLookupByName(connection.get(), "default"), libvirt_wrapper->virNetworkFree};
 
@@ -142,7 +160,7 @@ mp::LibVirtVirtualMachineFactory::~LibVirtVirtualMachineFactory()
 
 void mp::LibVirtVirtualMachineFactory::remove_resources_for(const std::string& name)
 {
-    auto connection = LibVirtVirtualMachine::open_libvirt_connection(libvirt_wrapper);
+    auto connection = connection_manager.borrow_connection();
 
     libvirt_wrapper->virDomainUndefine(libvirt_wrapper->virDomainLookupByName(connection.get(), name.c_str()));
 }
@@ -168,10 +186,86 @@ void mp::LibVirtVirtualMachineFactory::hypervisor_health_check()
     if (!libvirt_wrapper)
         libvirt_wrapper = make_libvirt_wrapper(libvirt_object_path);
 
-    LibVirtVirtualMachine::open_libvirt_connection(libvirt_wrapper);
+    connection_manager.borrow_connection();
 
     if (bridge_name.empty())
-        bridge_name = enable_libvirt_network(data_dir, libvirt_wrapper);
+        bridge_name = enable_libvirt_network(data_dir, connection_manager, libvirt_wrapper);
+
+    if (!event_connection)
+        register_lifecycle_events();
+}
+
+void mp::LibVirtVirtualMachineFactory::register_lifecycle_events()
+{
+    try
+    {
+        // The default event implementation has to be in place before the connection
+        // carrying the subscription is opened. The subscription gets its own connection,
+        // apart from the shared one: a reconnect there would silently drop it.
+        libvirt_wrapper->virEventRegisterDefaultImpl();
+        event_connection = LibVirtVirtualMachine::open_libvirt_connection(libvirt_wrapper);
+
+        lifecycle_callback_id = libvirt_wrapper->virConnectDomainEventRegisterAny(
+            event_connection.get(), nullptr, VIR_DOMAIN_EVENT_ID_LIFECYCLE,
+            VIR_DOMAIN_EVENT_CALLBACK(&LibVirtVirtualMachineFactory::on_domain_lifecycle_event), this, nullptr);
+
+        if (lifecycle_callback_id < 0)
+        {
+            mpl::log(mpl::Level::debug, logging_category,
+                     "libvirt lifecycle events unavailable; falling back to state polling");
+            event_connection.reset();
+            return;
+        }
+
+        event_loop_running = true;
+        event_loop_thread = std::thread{[this] {
+            while (event_loop_running)
+            {
+                if (libvirt_wrapper->virEventRunDefaultImpl() < 0)
+                    break;
+            }
+        }};
+
+        mpl::log(mpl::Level::debug, logging_category, "subscribed to libvirt domain lifecycle events");
+    }
+    catch (const std::exception& e)
+    {
+        mpl::log(mpl::Level::debug, logging_category,
+                 fmt::format("could not subscribe to libvirt lifecycle events: {}", e.what()));
+        event_connection.reset();
+    }
+}
+
+int mp::LibVirtVirtualMachineFactory::on_domain_lifecycle_event(virConnectPtr /*connection*/, virDomainPtr domain,
+                                                                int event, int detail, void* opaque)
+{
+    auto factory = static_cast<LibVirtVirtualMachineFactory*>(opaque);
+    auto monitor = factory->event_monitor.load();
+    if (!monitor)
+        return 0;
+
+    const auto* name = factory->libvirt_wrapper->virDomainGetName(domain);
+    if (!name)
+        return 0;
+
+    // Only events with an unambiguous instance state analogue are forwarded; anything
+    // else (shutdown in progress, transient pauses) waits for the terminal event. The
+    // monitor ignores names it does not know, so other domains on the host are harmless.
+    switch (event)
+    {
+    case VIR_DOMAIN_EVENT_STARTED:
+    case VIR_DOMAIN_EVENT_RESUMED:
+        monitor->persist_state_for(name, VirtualMachine::State::running);
+        break;
+    case VIR_DOMAIN_EVENT_STOPPED:
+        monitor->persist_state_for(name, detail == VIR_DOMAIN_EVENT_STOPPED_SAVED ? VirtualMachine::State::suspended
+                                                                                  : VirtualMachine::State::off);
+        break;
+    default:
+        break;
+    }
+
+    return 0;
 }
 
 QString mp::LibVirtVirtualMachineFactory::get_backend_version_string()
@@ -179,7 +273,7 @@ QString mp::LibVirtVirtualMachineFactory::get_backend_version_string()
     try
     {
         unsigned long libvirt_version;
-        auto connection = LibVirtVirtualMachine::open_libvirt_connection(libvirt_wrapper);
+        auto connection = connection_manager.borrow_connection();
 
         if (libvirt_wrapper->virConnectGetVersion(connection.get(), &libvirt_version) == 0 && libvirt_version != 0)
         {
@@ -17,12 +17,16 @@
 #ifndef MULTIPASS_LIBVIRT_VIRTUAL_MACHINE_FACTORY_H
 #define MULTIPASS_LIBVIRT_VIRTUAL_MACHINE_FACTORY_H
 
+#include "libvirt_connection_manager.h"
+#include "libvirt_virtual_machine.h"
 #include "libvirt_wrapper.h"
 
 #include <shared/base_virtual_machine_factory.h>
 
+#include <atomic>
 #include <memory>
 #include <string>
+#include <thread>
 
 namespace multipass
 {
@@ -47,9 +51,22 @@ public:
     LibvirtWrapper::UPtr libvirt_wrapper;
 
 private:
+    void register_lifecycle_events();
+    static int on_domain_lifecycle_event(virConnectPtr connection, virDomainPtr domain, int event, int detail,
+                                         void* opaque);
+
     const Path data_dir;
+    LibvirtConnectionManager connection_manager;
     std::string bridge_name;
     const std::string libvirt_object_path;
+
+    // A long-lived connection carrying the domain lifecycle event subscription; events
+    // reach the status monitor as they happen, instead of waiting for the next state poll
+    LibVirtVirtualMachine::ConnectionUPtr event_connection{nullptr, nullptr};
+    int lifecycle_callback_id{-1};
+    std::thread event_loop_thread;
+    std::atomic<bool> event_loop_running{false};
+    std::atomic<VMStatusMonitor*> event_monitor{nullptr};
 };
 } // namespace multipass
 
@@ -54,6 +54,7 @@ mp::LibvirtWrapper::LibvirtWrapper(const std::string& filename)
     : handle{open_libvirt_handle(filename)},
       virConnectOpen{reinterpret_cast<virConnectOpen_t>(get_symbol_address_for("virConnectOpen", handle))},
       virConnectClose{reinterpret_cast<virConnectClose_t>(get_symbol_address_for("virConnectClose", handle))},
+      virConnectIsAlive{reinterpret_cast<virConnectIsAlive_t>(get_symbol_address_for("virConnectIsAlive", handle))},
       virConnectGetCapabilities{
           reinterpret_cast<virConnectGetCapabilities_t>(get_symbol_address_for("virConnectGetCapabilities", handle))},
       virConnectGetVersion{
@@ -87,6 +88,15 @@ mp::LibvirtWrapper::LibvirtWrapper(const std::string& filename)
           reinterpret_cast<virDomainManagedSave_t>(get_symbol_address_for("virDomainManagedSave", handle))},
       virDomainHasManagedSaveImage{reinterpret_cast<virDomainHasManagedSaveImage_t>(
           get_symbol_address_for("virDomainHasManagedSaveImage", handle))},
+      virDomainGetName{reinterpret_cast<virDomainGetName_t>(get_symbol_address_for("virDomainGetName", handle))},
+      virEventRegisterDefaultImpl{reinterpret_cast<virEventRegisterDefaultImpl_t>(
+          get_symbol_address_for("virEventRegisterDefaultImpl", handle))},
+      virEventRunDefaultImpl{
+          reinterpret_cast<virEventRunDefaultImpl_t>(get_symbol_address_for("virEventRunDefaultImpl", handle))},
+      virConnectDomainEventRegisterAny{reinterpret_cast<virConnectDomainEventRegisterAny_t>(
+          get_symbol_address_for("virConnectDomainEventRegisterAny", handle))},
+      virConnectDomainEventDeregisterAny{reinterpret_cast<virConnectDomainEventDeregisterAny_t>(
+          get_symbol_address_for("virConnectDomainEventDeregisterAny", handle))},
       virGetLastErrorMessage{
           reinterpret_cast<virGetLastErrorMessage_t>(get_symbol_address_for("virGetLastErrorMessage", handle))}
 {
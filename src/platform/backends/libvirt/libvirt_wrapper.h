@@ -59,6 +59,7 @@ class LibvirtWrapper
 private:
     typedef virConnectPtr (*virConnectOpen_t)(const char* name);
     typedef int (*virConnectClose_t)(virConnectPtr conn);
+    typedef int (*virConnectIsAlive_t)(virConnectPtr conn);
     typedef char* (*virConnectGetCapabilities_t)(virConnectPtr conn);
     typedef int (*virConnectGetVersion_t)(virConnectPtr conn, unsigned long* hvVer);
     typedef virNetworkPtr (*virNetworkLookupByName_t)(virConnectPtr conn, const char* name);
@@ -82,6 +83,13 @@ private:
     typedef int (*virDomainShutdown_t)(virDomainPtr domain);
     typedef int (*virDomainManagedSave_t)(virDomainPtr domain, unsigned int flags);
     typedef int (*virDomainHasManagedSaveImage_t)(virDomainPtr domain, unsigned int flags);
+    typedef const char* (*virDomainGetName_t)(virDomainPtr domain);
+    typedef int (*virEventRegisterDefaultImpl_t)();
+    typedef int (*virEventRunDefaultImpl_t)();
+    typedef int (*virConnectDomainEventRegisterAny_t)(virConnectPtr conn, virDomainPtr domain, int eventID,
+                                                      virConnectDomainEventGenericCallback cb, void* opaque,
+                                                      virFreeCallback freecb);
+    typedef int (*virConnectDomainEventDeregisterAny_t)(virConnectPtr conn, int callbackID);
     typedef const char* (*virGetLastErrorMessage_t)();
 
     void* handle{nullptr};
@@ -94,6 +102,7 @@ public:
 
     virConnectOpen_t virConnectOpen;
     virConnectClose_t virConnectClose;
+    virConnectIsAlive_t virConnectIsAlive;
     virConnectGetCapabilities_t virConnectGetCapabilities;
     virConnectGetVersion_t virConnectGetVersion;
     virNetworkLookupByName_t virNetworkLookupByName;
@@ -116,6 +125,11 @@ public:
     virDomainShutdown_t virDomainShutdown;
     virDomainManagedSave_t virDomainManagedSave;
     virDomainHasManagedSaveImage_t virDomainHasManagedSaveImage;
+    virDomainGetName_t virDomainGetName;
+    virEventRegisterDefaultImpl_t virEventRegisterDefaultImpl;
+    virEventRunDefaultImpl_t virEventRunDefaultImpl;
+    virConnectDomainEventRegisterAny_t virConnectDomainEventRegisterAny;
+    virConnectDomainEventDeregisterAny_t virConnectDomainEventDeregisterAny;
     virGetLastErrorMessage_t virGetLastErrorMessage;
 };
 } // namespace multipass
@@ -0,0 +1,350 @@
+/*
+ * Copyright (C) 2021 Canonical, Ltd.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; version 3.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "lxd_operation_multiplexer.h"
+#include "lxd_request.h"
+
+#include <multipass/format.h>
+#include <multipass/logging/log.h>
+
+#include <QJsonDocument>
+
+#include <cstring>
+#include <random>
+
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+namespace mp = multipass;
+namespace mpl = multipass::logging;
+
+namespace
+{
+constexpr auto category = "lxd event stream";
+
+constexpr uint8_t opcode_continuation = 0x0;
+constexpr uint8_t opcode_text = 0x1;
+constexpr uint8_t opcode_close = 0x8;
+constexpr uint8_t opcode_ping = 0x9;
+constexpr uint8_t opcode_pong = 0xA;
+
+std::string socket_path_from(const QUrl& base_url)
+{
+    // Follows the transport's unix:///path/to/socket@path/in/server convention
+    const auto url_parts = base_url.toString().split('@');
+    if (url_parts.count() != 2)
+        return {};
+
+    return QUrl(url_parts[0]).path().toStdString();
+}
+
+bool read_exactly(int fd, char* buffer, size_t size, const std::atomic<bool>& stopping)
+{
+    size_t total{0};
+    while (total < size)
+    {
+        auto bytes_read = ::recv(fd, buffer + total, size - total, 0);
+        if (bytes_read > 0)
+        {
+            total += bytes_read;
+        }
+        else if (bytes_read < 0 && (errno == EAGAIN || errno == EWOULDBLOCK || errno == EINTR))
+        {
+            if (stopping)
+                return false;
+        }
+        else
+        {
+            return false; // closed or broken stream
+        }
+    }
+
+    return true;
+}
+
+bool write_all(int fd, const char* buffer, size_t size)
+{
+    size_t total{0};
+    while (total < size)
+    {
+        auto bytes_written = ::send(fd, buffer + total, size - total, MSG_NOSIGNAL);
+        if (bytes_written > 0)
+            total += bytes_written;
+        else if (bytes_written < 0 && errno != EINTR)
+            return false;
+    }
+
+    return true;
+}
+
+// Client frames must be masked per RFC 6455; only used for the tiny pong replies
+bool write_masked_frame(int fd, uint8_t opcode, const QByteArray& payload)
+{
+    std::random_device random_source;
+    uint8_t mask[4];
+    for (auto& byte : mask)
+        byte = static_cast<uint8_t>(random_source());
+
+    QByteArray frame;
+    frame.append(static_cast<char>(0x80 | opcode));
+    frame.append(static_cast<char>(0x80 | static_cast<uint8_t>(payload.size()))); // pings carry at most 125 bytes
+    frame.append(reinterpret_cast<const char*>(mask), 4);
+    for (int i = 0; i < payload.size(); ++i)
+        frame.append(static_cast<char>(payload[i] ^ mask[i % 4]));
+
+    return write_all(fd, frame.constData(), frame.size());
+}
+} // namespace
+
+mp::optional<QJsonObject> mp::LXDOperationMultiplexer::Subscription::next_update(std::chrono::milliseconds timeout)
+{
+    std::unique_lock<std::mutex> lock{mutex};
+    update_available.wait_for(lock, timeout, [this] { return !updates.empty() || stream_ended; });
+
+    if (updates.empty())
+        return mp::nullopt;
+
+    auto update = std::move(updates.front());
+    updates.pop_front();
+    return update;
+}
+
+mp::LXDOperationMultiplexer::LXDOperationMultiplexer(const QUrl& base_url) : socket_path{socket_path_from(base_url)}
+{
+}
+
+mp::LXDOperationMultiplexer::~LXDOperationMultiplexer()
+{
+    {
+        std::lock_guard<std::mutex> lock{state_mutex};
+        stopping = true;
+        if (socket_fd >= 0)
+            ::shutdown(socket_fd, SHUT_RDWR); // unblocks the listener's read
+    }
+
+    if (listener_thread.joinable())
+        listener_thread.join();
+}
+
+mp::LXDOperationMultiplexer::SubscriptionPtr mp::LXDOperationMultiplexer::subscribe(const QString& operation_id)
+{
+    if (!ensure_listening())
+        return nullptr;
+
+    auto subscription = std::make_shared<Subscription>();
+
+    std::lock_guard<std::mutex> lock{state_mutex};
+    if (!listening)
+        return nullptr;
+
+    subscriptions[operation_id.toStdString()] = subscription;
+    return subscription;
+}
+
+void mp::LXDOperationMultiplexer::unsubscribe(const QString& operation_id)
+{
+    std::lock_guard<std::mutex> lock{state_mutex};
+    subscriptions.erase(operation_id.toStdString());
+}
+
+bool mp::LXDOperationMultiplexer::ensure_listening()
+{
+    std::lock_guard<std::mutex> lock{state_mutex};
+
+    if (listening)
+        return true;
+
+    if (listener_failed || socket_path.empty())
+        return false;
+
+    sockaddr_un address{};
+    address.sun_family = AF_UNIX;
+    if (socket_path.size() >= sizeof(address.sun_path))
+    {
+        listener_failed = true;
+        return false;
+    }
+    std::strncpy(address.sun_path, socket_path.c_str(), sizeof(address.sun_path) - 1);
+
+    auto fd = ::socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0);
+    if (fd < 0 || ::connect(fd, reinterpret_cast<sockaddr*>(&address), sizeof(address)) != 0)
+    {
+        if (fd >= 0)
+            ::close(fd);
+        listener_failed = true;
+        return false;
+    }
+
+    // Bounded reads, so a quiet stream still lets the listener notice a shutdown request
+    timeval timeout{1, 0};
+    ::setsockopt(fd, SOL_SOCKET, SO_RCVTIMEO, &timeout, sizeof(timeout));
+    ::setsockopt(fd, SOL_SOCKET, SO_SNDTIMEO, &timeout, sizeof(timeout));
+
+    std::random_device random_source;
+    QByteArray key_bytes;
+    for (int i = 0; i < 16; ++i)
+        key_bytes.append(static_cast<char>(random_source()));
+
+    const auto handshake = fmt::format("GET /1.0/events?project={}&type=operation HTTP/1.1\r\n"
+                                       "Host: {}\r\n"
+                                       "Upgrade: websocket\r\n"
+                                       "Connection: Upgrade\r\n"
+                                       "Sec-WebSocket-Key: {}\r\n"
+                                       "Sec-WebSocket-Version: 13\r\n\r\n",
+                                       mp::lxd_project_name, mp::lxd_project_name, key_bytes.toBase64().toStdString());
+
+    QByteArray response;
+    char byte;
+    if (!write_all(fd, handshake.c_str(), handshake.size()))
+    {
+        ::close(fd);
+        listener_failed = true;
+        return false;
+    }
+
+    while (!response.endsWith("\r\n\r\n"))
+    {
+        if (!read_exactly(fd, &byte, 1, stopping) || response.size() > 8192)
+        {
+            ::close(fd);
+            listener_failed = true;
+            return false;
+        }
+        response.append(byte);
+    }
+
+    if (!response.startsWith("HTTP/1.1 101"))
+    {
+        mpl::log(mpl::Level::debug, category,
+                 fmt::format("events websocket refused: {}", response.left(response.indexOf("\r\n")).toStdString()));
+        ::close(fd);
+        listener_failed = true;
+        return false;
+    }
+
+    socket_fd = fd;
+    listening = true;
+    listener_thread = std::thread{[this] { listen(); }};
+
+    mpl::log(mpl::Level::debug, category, "listening for LXD operation events");
+    return true;
+}
+
+void mp::LXDOperationMultiplexer::listen()
+{
+    QByteArray message;
+
+    while (true)
+    {
+        char header[2];
+        if (!read_exactly(socket_fd, header, 2, stopping))
+            break;
+
+        const auto fin = (header[0] & 0x80) != 0;
+        const auto opcode = static_cast<uint8_t>(header[0] & 0x0F);
+        uint64_t payload_length = static_cast<uint8_t>(header[1]) & 0x7F;
+
+        if (payload_length == 126)
+        {
+            char extended[2];
+            if (!read_exactly(socket_fd, extended, 2, stopping))
+                break;
+            payload_length = (static_cast<uint64_t>(static_cast<uint8_t>(extended[0])) << 8) |
+                             static_cast<uint8_t>(extended[1]);
+        }
+        else if (payload_length == 127)
+        {
+            char extended[8];
+            if (!read_exactly(socket_fd, extended, 8, stopping))
+                break;
+            payload_length = 0;
+            for (const auto byte : extended)
+                payload_length = (payload_length << 8) | static_cast<uint8_t>(byte);
+        }
+
+        QByteArray payload(static_cast<int>(payload_length), '\0');
+        if (payload_length > 0 && !read_exactly(socket_fd, payload.data(), payload_length, stopping))
+            break;
+
+        if (opcode == opcode_close)
+            break;
+
+        if (opcode == opcode_ping)
+        {
+            write_masked_frame(socket_fd, opcode_pong, payload);
+        }
+        else if (opcode == opcode_text || opcode == opcode_continuation)
+        {
+            message.append(payload);
+            if (fin)
+            {
+                dispatch(message);
+                message.clear();
+            }
+        }
+    }
+
+    end_stream();
+}
+
+void mp::LXDOperationMultiplexer::dispatch(const QByteArray& event_payload)
+{
+    const auto event = QJsonDocument::fromJson(event_payload).object();
+    if (event["type"].toString() != "operation")
+        return;
+
+    const auto operation = event["metadata"].toObject();
+    const auto id = operation["id"].toString().toStdString();
+
+    std::lock_guard<std::mutex> lock{state_mutex};
+    auto entry = subscriptions.find(id);
+    if (entry == subscriptions.end())
+        return;
+
+    auto& subscription = *entry->second;
+    {
+        std::lock_guard<std::mutex> subscription_lock{subscription.mutex};
+        subscription.updates.push_back(operation);
+    }
+    subscription.update_available.notify_all();
+}
+
+void mp::LXDOperationMultiplexer::end_stream()
+{
+    std::lock_guard<std::mutex> lock{state_mutex};
+
+    ::close(socket_fd);
+    socket_fd = -1;
+    listening = false;
+    // Stay on polling for the rest of this run rather than reconnecting in a loop
+    listener_failed = true;
+
+    for (auto& entry : subscriptions)
+    {
+        auto& subscription = *entry.second;
+        {
+            std::lock_guard<std::mutex> subscription_lock{subscription.mutex};
+            subscription.stream_ended = true;
+        }
+        subscription.update_available.notify_all();
+    }
+    subscriptions.clear();
+
+    if (!stopping)
+        mpl::log(mpl::Level::debug, category, "LXD operation event stream ended; falling back to polling");
+}
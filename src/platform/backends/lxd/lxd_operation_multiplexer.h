@@ -0,0 +1,85 @@
+/*
+ * Copyright (C) 2021 Canonical, Ltd.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; version 3.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#ifndef MULTIPASS_LXD_OPERATION_MULTIPLEXER_H
+#define MULTIPASS_LXD_OPERATION_MULTIPLEXER_H
+
+#include <multipass/optional.h>
+
+#include <QJsonObject>
+#include <QString>
+#include <QUrl>
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <unordered_map>
+
+namespace multipass
+{
+// Multiplexes LXD's /1.0/events websocket onto operation waiters: one listener
+// connection carries the updates for every in-flight operation, so N concurrent waits
+// cost one connection instead of N polling loops. When the stream cannot be
+// established, subscribe() returns nothing and callers fall back to polling.
+class LXDOperationMultiplexer
+{
+public:
+    class Subscription
+    {
+    public:
+        // Blocks until the next update for the subscribed operation arrives or the
+        // timeout expires; returns the operation body, or nullopt on timeout/stream end
+        optional<QJsonObject> next_update(std::chrono::milliseconds timeout);
+
+    private:
+        friend class LXDOperationMultiplexer;
+        std::mutex mutex;
+        std::condition_variable update_available;
+        std::deque<QJsonObject> updates;
+        bool stream_ended{false};
+    };
+    using SubscriptionPtr = std::shared_ptr<Subscription>;
+
+    explicit LXDOperationMultiplexer(const QUrl& base_url);
+    ~LXDOperationMultiplexer();
+
+    SubscriptionPtr subscribe(const QString& operation_id); // nullptr when events are unavailable
+    void unsubscribe(const QString& operation_id);
+
+private:
+    bool ensure_listening();
+    void listen();
+    void dispatch(const QByteArray& event_payload);
+    void end_stream();
+
+    const std::string socket_path;
+    std::thread listener_thread;
+    std::mutex state_mutex;
+    std::unordered_map<std::string, SubscriptionPtr> subscriptions;
+    int socket_fd{-1};
+    bool listening{false};
+    bool listener_failed{false};
+    std::atomic<bool> stopping{false};
+};
+} // namespace multipass
+
+#endif // MULTIPASS_LXD_OPERATION_MULTIPLEXER_H
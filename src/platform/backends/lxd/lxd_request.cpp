@@ -149,11 +149,14 @@ catch (const LXDRuntimeError& e)
 }
 
 const QJsonObject mp::lxd_request(mp::NetworkAccessManager* manager, const std::string& method, QUrl url,
-                                  QHttpMultiPart& multi_part, int timeout)
+                                  QHttpMultiPart& multi_part, const mp::UploadProgressCallback& on_progress,
+                                  int timeout)
 try
 {
-    auto handle_request = [manager, &multi_part](QNetworkRequest& request, const QByteArray& verb) {
+    auto handle_request = [manager, &multi_part, &on_progress](QNetworkRequest& request, const QByteArray& verb) {
         request.setRawHeader("Transfer-Encoding", "chunked");
+        if (on_progress)
+            request.setAttribute(mp::upload_progress_attribute, QVariant::fromValue(on_progress));
 
         return manager->sendCustomRequest(request, verb, &multi_part);
     };
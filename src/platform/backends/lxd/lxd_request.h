@@ -18,6 +18,7 @@
 #ifndef MULTIPASS_LXD_REQUEST_H
 #define MULTIPASS_LXD_REQUEST_H
 
+#include <multipass/network_access_manager.h>
 #include <multipass/optional.h>
 
 #include <QHttpMultiPart>
@@ -62,7 +63,8 @@ const QJsonObject lxd_request(NetworkAccessManager* manager, const std::string&
                               int timeout = 30000 /* in milliseconds */);
 
 const QJsonObject lxd_request(NetworkAccessManager* manager, const std::string& method, QUrl url,
-                              QHttpMultiPart& multi_part, int timeout = 30000 /* in milliseconds */);
+                              QHttpMultiPart& multi_part, const UploadProgressCallback& on_progress = nullptr,
+                              int timeout = 30000 /* in milliseconds */);
 
 const QJsonObject lxd_wait(NetworkAccessManager* manager, const QUrl& base_url, const QJsonObject& task_data,
                            int timeout /* in milliseconds */);
@@ -109,8 +109,8 @@ QJsonObject generate_base_vm_config(const multipass::VirtualMachineDescription&
     if (!desc.user_data_config.IsNull())
         config["user.user-data"] = QString::fromStdString(mpu::emit_cloud_config(desc.user_data_config));
 
-    if (!desc.network_data_config.IsNull())
-        config["user.network-config"] = QString::fromStdString(mpu::emit_cloud_config(desc.network_data_config));
+    if (!desc.network_data_config.empty())
+        config["user.network-config"] = QString::fromStdString(desc.network_data_config);
 
     return config;
 }
@@ -16,6 +16,7 @@
  */
 
 #include "lxd_vm_image_vault.h"
+#include "lxd_operation_multiplexer.h"
 #include "lxd_request.h"
 
 #include <multipass/exceptions/aborted_download_exception.h>
@@ -151,6 +152,7 @@ mp::LXDVMImageVault::LXDVMImageVault(std::vector<VMImageHost*> image_hosts, URLD
       url_downloader{downloader},
       manager{manager},
       base_url{base_url},
+      operation_multiplexer{base_url},
       template_path{QString("%1/%2-").arg(cache_dir_path).arg(QCoreApplication::applicationName())},
       days_to_expire{days_to_expire}
 {
@@ -250,7 +252,7 @@ mp::VMImage mp::LXDVMImageVault::fetch_image(const FetchType& fetch_type, const
 
             auto metadata_tarball_path = create_metadata_tarball(info, lxd_import_dir);
 
-            source_image.id = lxd_import_metadata_and_image(metadata_tarball_path, image_path);
+            source_image.id = lxd_import_metadata_and_image(metadata_tarball_path, image_path, monitor);
         }
         else
         {
@@ -456,41 +458,64 @@ void mp::LXDVMImageVault::poll_download_operation(const QJsonObject& json_reply,
     if (json_reply["metadata"].toObject()["class"] == QStringLiteral("task") &&
         json_reply["status_code"].toInt(-1) == 100)
     {
-        QUrl task_url(QString("%1/operations/%2")
-                          .arg(base_url.toString())
-                          .arg(json_reply["metadata"].toObject()["id"].toString()));
+        const auto operation_id = json_reply["metadata"].toObject()["id"].toString();
+        QUrl task_url(QString("%1/operations/%2").arg(base_url.toString()).arg(operation_id));
+
+        // One events subscription replaces the per-operation polling loop; the direct
+        // GET stays as a safety net for updates that raced the subscription, and as the
+        // only source when the events stream is unavailable
+        auto subscription = operation_multiplexer.subscribe(operation_id);
+        auto ticks_since_query{0};
+        auto download_progress{-1};
 
-        // Instead of polling, need to use websockets to get events
         while (true)
         {
             try
             {
-                auto task_reply = mp::lxd_request(manager, "GET", task_url);
+                QJsonObject operation_body;
 
-                if (task_reply["error_code"].toInt(-1) != 0)
+                if (subscription)
                 {
-                    mpl::log(mpl::Level::error, category, task_reply["error"].toString().toStdString());
-                    break;
+                    if (auto update = subscription->next_update(1s))
+                    {
+                        operation_body = *update;
+                        ticks_since_query = 0;
+                    }
                 }
 
-                auto status_code = task_reply["metadata"].toObject()["status_code"].toInt(-1);
-                if (status_code == 200)
+                if (operation_body.isEmpty() && (!subscription || ++ticks_since_query >= 5))
                 {
-                    break;
-                }
-                else
-                {
-                    auto download_progress = parse_percent_as_int(
-                        task_reply["metadata"].toObject()["metadata"].toObject()["download_progress"].toString());
+                    auto task_reply = mp::lxd_request(manager, "GET", task_url);
 
-                    if (!monitor(LaunchProgress::IMAGE, download_progress))
+                    if (task_reply["error_code"].toInt(-1) != 0)
                     {
-                        mp::lxd_request(manager, "DELETE", task_url);
-                        throw mp::AbortedDownloadException{"Download aborted"};
+                        mpl::log(mpl::Level::error, category, task_reply["error"].toString().toStdString());
+                        break;
                     }
 
-                    std::this_thread::sleep_for(1s);
+                    operation_body = task_reply["metadata"].toObject();
+                    ticks_since_query = 0;
                 }
+
+                if (!operation_body.isEmpty())
+                {
+                    if (operation_body["status_code"].toInt(-1) == 200)
+                        break;
+
+                    download_progress =
+                        parse_percent_as_int(operation_body["metadata"].toObject()["download_progress"].toString());
+                }
+
+                if (!monitor(LaunchProgress::IMAGE, download_progress))
+                {
+                    if (subscription)
+                        operation_multiplexer.unsubscribe(operation_id);
+                    mp::lxd_request(manager, "DELETE", task_url);
+                    throw mp::AbortedDownloadException{"Download aborted"};
+                }
+
+                if (!subscription)
+                    std::this_thread::sleep_for(1s);
             }
             // Implies the task is finished
             catch (const LXDNotFoundException&)
@@ -498,10 +523,14 @@ void mp::LXDVMImageVault::poll_download_operation(const QJsonObject& json_reply,
                 break;
             }
         }
+
+        if (subscription)
+            operation_multiplexer.unsubscribe(operation_id);
     }
 }
 
-std::string mp::LXDVMImageVault::lxd_import_metadata_and_image(const QString& metadata_path, const QString& image_path)
+std::string mp::LXDVMImageVault::lxd_import_metadata_and_image(const QString& metadata_path, const QString& image_path,
+                                                               const ProgressMonitor& monitor)
 {
     QHttpMultiPart lxd_multipart{QHttpMultiPart::FormDataType};
     QFileInfo metadata_info{metadata_path}, image_info{image_path};
@@ -529,7 +558,23 @@ std::string mp::LXDVMImageVault::lxd_import_metadata_and_image(const QString& me
     lxd_multipart.append(metadata_part);
     lxd_multipart.append(image_part);
 
-    auto json_reply = lxd_request(manager, "POST", QUrl(QString("%1/images").arg(base_url.toString())), lxd_multipart);
+    // The multipart body streams from the files in bounded chunks; report its progress
+    // so a multi-gigabyte push into LXD does not look like a hang
+    int last_percent{-1};
+    auto on_progress = [&monitor, &last_percent](qint64 bytes_sent, qint64 bytes_total) {
+        if (bytes_total > 0)
+        {
+            auto percent = static_cast<int>(bytes_sent * 100 / bytes_total);
+            if (percent != last_percent)
+            {
+                last_percent = percent;
+                monitor(LaunchProgress::IMAGE, percent);
+            }
+        }
+    };
+
+    auto json_reply = lxd_request(manager, "POST", QUrl(QString("%1/images").arg(base_url.toString())), lxd_multipart,
+                                  on_progress);
 
     auto task_reply = lxd_wait(manager, base_url, json_reply, 300000);
 
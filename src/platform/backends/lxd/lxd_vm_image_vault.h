@@ -18,6 +18,8 @@
 #ifndef MULTIPASS_LXD_VM_IMAGE_VAULT_H
 #define MULTIPASS_LXD_VM_IMAGE_VAULT_H
 
+#include "lxd_operation_multiplexer.h"
+
 #include <multipass/days.h>
 #include <multipass/query.h>
 #include <shared/base_vm_image_vault.h>
@@ -53,13 +55,15 @@ private:
                             const ProgressMonitor& monitor, const QString& last_used = QString());
     void url_download_image(const VMImageInfo& info, const QString& image_path, const ProgressMonitor& monitor);
     void poll_download_operation(const QJsonObject& json_reply, const ProgressMonitor& monitor);
-    std::string lxd_import_metadata_and_image(const QString& metadata_path, const QString& image_path);
+    std::string lxd_import_metadata_and_image(const QString& metadata_path, const QString& image_path,
+                                              const ProgressMonitor& monitor);
     std::string get_lxd_image_hash_for(const QString& id);
     QJsonArray retrieve_image_list();
 
     URLDownloader* const url_downloader;
     NetworkAccessManager* manager;
     const QUrl base_url;
+    LXDOperationMultiplexer operation_multiplexer;
     const QString template_path;
     const days days_to_expire;
 };
@@ -26,7 +26,17 @@
 
 #include <QDir>
 
+#include <cstdio>
+#include <cstring>
 #include <fstream>
+#include <mutex>
+#include <random>
+#include <stdexcept>
+
+#include <arpa/inet.h>
+#include <net/if.h>
+#include <sys/socket.h>
+#include <unistd.h>
 
 namespace mp = multipass;
 namespace mpl = multipass::logging;
@@ -41,19 +51,117 @@ auto make_dnsmasq_process(const mp::Path& data_dir, const QString& bridge_name,
     auto process_spec = std::make_unique<mp::DNSMasqProcessSpec>(data_dir, bridge_name, subnet, conf_file_path);
     return MP_PROCFACTORY.create_process(std::move(process_spec));
 }
+
+// Wire format of a BOOTP/DHCP message, followed by the options we send
+struct DHCPReleasePacket
+{
+    uint8_t op{1}; // BOOTREQUEST
+    uint8_t htype{1};
+    uint8_t hlen{6};
+    uint8_t hops{0};
+    uint32_t xid{0};
+    uint16_t secs{0};
+    uint16_t flags{0};
+    uint32_t ciaddr{0};
+    uint32_t yiaddr{0};
+    uint32_t siaddr{0};
+    uint32_t giaddr{0};
+    uint8_t chaddr[16]{};
+    uint8_t sname[64]{};
+    uint8_t file[128]{};
+    uint8_t cookie[4]{99, 130, 83, 99};
+    uint8_t options[10]{};
+};
+
+bool parse_hw_addr(const std::string& hw_addr, uint8_t* out)
+{
+    return std::sscanf(hw_addr.c_str(), "%hhx:%hhx:%hhx:%hhx:%hhx:%hhx", &out[0], &out[1], &out[2], &out[3], &out[4],
+                       &out[5]) == 6;
+}
+
+// Sends the DHCPRELEASE to dnsmasq directly instead of spawning dhcp_release(1) per
+// teardown: same packet, no process and no PATH dependency, so purging a fleet releases
+// all its leases in microseconds. dnsmasq matches on ciaddr and chaddr in the payload.
+bool send_dhcp_release(const QString& bridge_name, const mp::IPAddress& client_ip, const mp::IPAddress& server_ip,
+                       const std::string& hw_addr)
+{
+    DHCPReleasePacket packet;
+    if (!parse_hw_addr(hw_addr, packet.chaddr))
+        return false;
+
+    static std::mt19937 xid_gen{std::random_device{}()};
+    packet.xid = xid_gen();
+    packet.ciaddr = htonl(client_ip.as_uint32());
+
+    const auto server_addr = htonl(server_ip.as_uint32());
+    uint8_t* opt = packet.options;
+    *opt++ = 53; // DHCP message type
+    *opt++ = 1;
+    *opt++ = 7; // DHCPRELEASE
+    *opt++ = 54; // server identifier
+    *opt++ = 4;
+    std::memcpy(opt, &server_addr, 4);
+    opt += 4;
+    *opt++ = 255; // end
+
+    const auto sock = ::socket(AF_INET, SOCK_DGRAM | SOCK_CLOEXEC, 0);
+    if (sock < 0)
+        return false;
+
+    // dnsmasq only listens on the bridge; make sure the packet goes out there
+    const auto device = bridge_name.toUtf8();
+    ::setsockopt(sock, SOL_SOCKET, SO_BINDTODEVICE, device.constData(), device.size());
+
+    sockaddr_in dest{};
+    dest.sin_family = AF_INET;
+    dest.sin_port = htons(67);
+    dest.sin_addr.s_addr = server_addr;
+
+    const auto sent = ::sendto(sock, &packet, sizeof(packet), 0, reinterpret_cast<const sockaddr*>(&dest),
+                               sizeof(dest)) == sizeof(packet);
+    ::close(sock);
+
+    return sent;
+}
 } // namespace
 
 mp::DNSMasqServer::DNSMasqServer(const Path& data_dir, const QString& bridge_name, const std::string& subnet)
     : data_dir{data_dir},
       bridge_name{bridge_name},
       subnet{subnet},
-      conf_file{QDir(data_dir).absoluteFilePath("dnsmasq-XXXXXX.conf")}
+      conf_file{QDir(data_dir).absoluteFilePath("dnsmasq-XXXXXX.conf")},
+      lease_occupancy{mp::IPAddress{fmt::format("{}.2", subnet)}, mp::IPAddress{fmt::format("{}.254", subnet)}}
 {
     conf_file.open();
     conf_file.close();
 
     dnsmasq_cmd = make_dnsmasq_process(data_dir, bridge_name, subnet, conf_file.fileName());
+
+    // dnsmasq runs for the daemon's lifetime and nothing reads its channels, so drain
+    // them as data arrives; stderr has already been logged by the process logger by the
+    // time it is consumed here, and leaving it buffered would grow with every DHCP event
+    dnsmasq_cmd->stream_standard_output([](const QByteArray&) {});
+    dnsmasq_cmd->stream_standard_error([](const QByteArray&) {});
+
     start_dnsmasq();
+
+    // Keep an in-memory MAC->IP index of the lease file, refreshed on inotify events, so
+    // callers polling for an instance's IP during boot do not re-scan the file each time.
+    const auto lease_file_path = QDir(data_dir).filePath("dnsmasq.leases");
+    reload_lease_index();
+
+    lease_watcher.addPath(data_dir);
+    if (QFile::exists(lease_file_path))
+        lease_watcher.addPath(lease_file_path);
+
+    QObject::connect(&lease_watcher, &QFileSystemWatcher::fileChanged,
+                     [this](const QString&) { reload_lease_index(); });
+    QObject::connect(&lease_watcher, &QFileSystemWatcher::directoryChanged, [this, lease_file_path](const QString&) {
+        // dnsmasq may replace the lease file wholesale; re-arm the watch if so
+        if (QFile::exists(lease_file_path) && !lease_watcher.files().contains(lease_file_path))
+            lease_watcher.addPath(lease_file_path);
+        reload_lease_index();
+    });
 }
 
 mp::DNSMasqServer::~DNSMasqServer()
@@ -76,7 +184,7 @@ mp::DNSMasqServer::~DNSMasqServer()
     }
 }
 
-mp::optional<mp::IPAddress> mp::DNSMasqServer::get_ip_for(const std::string& hw_addr)
+void mp::DNSMasqServer::reload_lease_index()
 {
     // DNSMasq leases entries consist of:
     // <lease expiration> <mac addr> <ipv4> <name> * * *
@@ -84,14 +192,55 @@ mp::optional<mp::IPAddress> mp::DNSMasqServer::get_ip_for(const std::string& hw_
     const std::string delimiter{" "};
     const int hw_addr_idx{1};
     const int ipv4_idx{2};
+
+    std::unordered_map<std::string, std::string> new_index;
     std::ifstream leases_file{path};
     std::string line;
     while (getline(leases_file, line))
     {
         const auto fields = mp::utils::split(line, delimiter);
-        if (fields.size() > 2 && fields[hw_addr_idx] == hw_addr)
-            return mp::optional<mp::IPAddress>{fields[ipv4_idx]};
+        if (fields.size() > 2)
+            new_index[fields[hw_addr_idx]] = fields[ipv4_idx];
     }
+
+    std::lock_guard<std::mutex> lock{lease_mutex};
+    lease_index = std::move(new_index);
+
+    // Rebuild the occupancy bitmap alongside, and shout before the pool runs dry
+    lease_occupancy.clear();
+    for (const auto& entry : lease_index)
+    {
+        try
+        {
+            lease_occupancy.mark_in_use(mp::IPAddress{entry.second});
+        }
+        catch (const std::invalid_argument&)
+        {
+            // a mangled lease line; the index entry is equally useless, but harmless
+        }
+    }
+
+    if (!lease_occupancy.first_free())
+        mpl::log(mpl::Level::warning, "dnsmasq", fmt::format("DHCP range {}.2-{}.254 is fully leased", subnet, subnet));
+}
+
+mp::optional<mp::IPAddress> mp::DNSMasqServer::get_ip_for(const std::string& hw_addr)
+{
+    {
+        std::lock_guard<std::mutex> lock{lease_mutex};
+        auto it = lease_index.find(hw_addr);
+        if (it != lease_index.end())
+            return mp::optional<mp::IPAddress>{it->second};
+    }
+
+    // The watcher can miss events (e.g. a rename over the file); fall back to one rescan
+    reload_lease_index();
+
+    std::lock_guard<std::mutex> lock{lease_mutex};
+    auto it = lease_index.find(hw_addr);
+    if (it != lease_index.end())
+        return mp::optional<mp::IPAddress>{it->second};
+
     return mp::nullopt;
 }
 
@@ -104,28 +253,10 @@ void mp::DNSMasqServer::release_mac(const std::string& hw_addr)
         return;
     }
 
-    QProcess dhcp_release;
-    QObject::connect(&dhcp_release, &QProcess::errorOccurred, [&ip, &hw_addr](QProcess::ProcessError error) {
+    const mp::IPAddress server_ip{fmt::format("{}.1", subnet)};
+    if (!send_dhcp_release(bridge_name, *ip, server_ip, hw_addr))
         mpl::log(mpl::Level::warning, "dnsmasq",
-                 fmt::format("failed to release ip addr {} with mac {}: {}", ip.value().as_string(), hw_addr,
-                             utils::qenum_to_string(error)));
-    });
-
-    auto log_exit_status = [&ip, &hw_addr](int exit_code, QProcess::ExitStatus exit_status) {
-        if (exit_code == 0 && exit_status == QProcess::NormalExit)
-            return;
-
-        auto msg = fmt::format("failed to release ip addr {} with mac {}, exit_code: {}", ip.value().as_string(),
-                               hw_addr, exit_code);
-        mpl::log(mpl::Level::warning, "dnsmasq", msg);
-    };
-    QObject::connect(&dhcp_release, static_cast<void (QProcess::*)(int, QProcess::ExitStatus)>(&QProcess::finished),
-                     log_exit_status);
-
-    dhcp_release.start("dhcp_release", QStringList() << bridge_name << QString::fromStdString(ip.value().as_string())
-                                                     << QString::fromStdString(hw_addr));
-
-    dhcp_release.waitForFinished();
+                 fmt::format("failed to release ip addr {} with mac {}", ip.value().as_string(), hw_addr));
 }
 
 void mp::DNSMasqServer::check_dnsmasq_running()
@@ -22,10 +22,13 @@
 #include <multipass/optional.h>
 #include <multipass/path.h>
 
+#include <QFileSystemWatcher>
 #include <QTemporaryFile>
 
 #include <memory>
+#include <mutex>
 #include <string>
+#include <unordered_map>
 
 namespace multipass
 {
@@ -48,6 +51,7 @@ protected:
 
 private:
     void start_dnsmasq();
+    void reload_lease_index();
 
     const QString data_dir;
     const QString bridge_name;
@@ -55,6 +59,10 @@ private:
     std::unique_ptr<Process> dnsmasq_cmd;
     QMetaObject::Connection finish_connection;
     QTemporaryFile conf_file;
+    QFileSystemWatcher lease_watcher;
+    std::unordered_map<std::string, std::string> lease_index;
+    SubnetIndex lease_occupancy;
+    std::mutex lease_mutex;
 };
 } // namespace multipass
 #endif // MULTIPASS_DNSMASQ_SERVER_H
@@ -22,6 +22,8 @@
 #include <multipass/process/process.h>
 #include <shared/linux/process_factory.h>
 
+#include <vector>
+
 namespace mp = multipass;
 namespace mpl = multipass::logging;
 
@@ -46,8 +48,6 @@ const QString FORWARD{QStringLiteral("FORWARD")};
 const QString destination{QStringLiteral("--destination")};
 const QString delete_rule{QStringLiteral("--delete")};
 const QString in_interface{QStringLiteral("--in-interface")};
-const QString append_rule{QStringLiteral("--append")};
-const QString insert_rule{QStringLiteral("--insert")};
 const QString jump{QStringLiteral("--jump")};
 const QString match{QStringLiteral("--match")};
 const QString out_interface{QStringLiteral("--out-interface")};
@@ -85,16 +85,59 @@ auto multipass_iptables_comment(const QString& bridge_name)
     return QString("generated for Multipass network %1").arg(bridge_name);
 }
 
-void add_iptables_rule(const QString& table, const QString& chain, const QStringList& rule, bool append = false)
+struct IPTablesRule
+{
+    QString table;
+    QString chain;
+    QStringList rule;
+    bool append;
+};
+
+// Renders the batched rules in iptables-save format, one block per table. Tokens with
+// spaces (e.g. comments) are quoted for the iptables-restore parser.
+QString render_iptables_restore_input(const std::vector<IPTablesRule>& rules)
 {
-    auto process = MP_PROCFACTORY.create_process(
-        iptables, QStringList() << wait << dash_t << table << (append ? append_rule : insert_rule) << chain << rule);
+    QString payload;
+    for (const auto& table : {filter, nat, mangle})
+    {
+        payload += QString("*%1\n").arg(table);
+        for (const auto& entry : rules)
+        {
+            if (entry.table != table)
+                continue;
 
-    auto exit_state = process->execute();
+            QStringList tokens;
+            for (const auto& token : entry.rule)
+                tokens << (token.contains(' ') ? QString("\"%1\"").arg(token) : token);
 
-    if (!exit_state.completed_successfully())
+            payload += QString("%1 %2 %3\n")
+                           .arg(entry.append ? QStringLiteral("-A") : QStringLiteral("-I"))
+                           .arg(entry.chain)
+                           .arg(tokens.join(' '));
+        }
+        payload += QStringLiteral("COMMIT\n");
+    }
+
+    return payload;
+}
+
+// Applies all rules atomically in a single iptables-restore exec, instead of paying one
+// process spawn and kernel table lock per rule.
+void apply_iptables_rules(const std::vector<IPTablesRule>& rules)
+{
+    auto process = MP_PROCFACTORY.create_process(QStringLiteral("iptables-restore"),
+                                                 QStringList() << QStringLiteral("--noflush") << wait);
+
+    process->start();
+    if (!process->wait_for_started())
+        throw std::runtime_error("Failed to start iptables-restore");
+
+    process->write(render_iptables_restore_input(rules).toUtf8());
+    process->close_write_channel();
+
+    if (!process->wait_for_finished() || !process->process_state().completed_successfully())
         throw std::runtime_error(
-            fmt::format("Failed to set iptables rule for table {}: {}", table, process->read_all_standard_error()));
+            fmt::format("Failed to apply iptables rules: {}", process->read_all_standard_error()));
 }
 
 void delete_iptables_rule(const QString& table, const QStringList& chain_and_rule)
@@ -128,6 +171,10 @@ void set_iptables_rules(const QString& bridge_name, const QString& cidr, const Q
 {
     const QStringList comment_option{match, QStringLiteral("comment"), QStringLiteral("--comment"), comment};
 
+    std::vector<IPTablesRule> batch;
+    auto add_iptables_rule = [&batch](const QString& table, const QString& chain, const QStringList& rule,
+                                      bool append = false) { batch.push_back({table, chain, rule, append}); };
+
     // Setup basic iptables overrides for DHCP/DNS
     add_iptables_rule(filter, INPUT,
                       QStringList() << in_interface << bridge_name << protocol << udp << dport << port_67 << jump
@@ -206,6 +253,8 @@ void set_iptables_rules(const QString& bridge_name, const QString& cidr, const Q
                       QStringList() << out_interface << bridge_name << jump << REJECT << reject_with
                                     << icmp_port_unreachable << comment_option,
                       /*append=*/true);
+
+    apply_iptables_rules(batch);
 }
 
 void clear_iptables_rules_for(const QString& table, const QString& bridge_name, const QString& cidr,
@@ -0,0 +1,134 @@
+/*
+ * Copyright (C) 2021 Canonical, Ltd.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; version 3.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "qemu_guest_agent.h"
+
+#include <QDateTime>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QLocalSocket>
+
+#include <thread>
+
+namespace mp = multipass;
+
+namespace
+{
+constexpr auto ping_retry_delay = std::chrono::milliseconds(200);
+} // namespace
+
+mp::QemuGuestAgent::QemuGuestAgent(const QString& socket_path) : socket_path{socket_path}
+{
+}
+
+bool mp::QemuGuestAgent::ping(std::chrono::milliseconds timeout) const
+{
+    const auto deadline = std::chrono::steady_clock::now() + timeout;
+    auto time_left = [&deadline] {
+        return std::max<int>(
+            0, std::chrono::duration_cast<std::chrono::milliseconds>(deadline - std::chrono::steady_clock::now())
+                   .count());
+    };
+
+    QLocalSocket socket;
+    socket.connectToServer(socket_path);
+    if (!socket.waitForConnected(time_left()))
+        return false;
+
+    // guest-sync is the agent's liveness handshake: it flushes any stale data on the
+    // channel and echoes our token back, so a matching reply proves the agent is there
+    const auto sync_id = QDateTime::currentMSecsSinceEpoch();
+    const QJsonObject request{{"execute", "guest-sync"}, {"arguments", QJsonObject{{"id", sync_id}}}};
+    socket.write(QJsonDocument{request}.toJson(QJsonDocument::Compact) + "\n");
+    if (!socket.waitForBytesWritten(time_left()))
+        return false;
+
+    QByteArray response;
+    while (socket.waitForReadyRead(time_left()))
+    {
+        response += socket.readAll();
+        for (const auto& line : response.split('\n'))
+        {
+            const auto reply = QJsonDocument::fromJson(line).object();
+            if (reply.contains("return") && static_cast<qint64>(reply["return"].toDouble()) == sync_id)
+                return true;
+        }
+    }
+
+    return false;
+}
+
+bool mp::QemuGuestAgent::fstrim(std::chrono::milliseconds timeout) const
+{
+    const auto deadline = std::chrono::steady_clock::now() + timeout;
+    auto time_left = [&deadline] {
+        return std::max<int>(
+            0, std::chrono::duration_cast<std::chrono::milliseconds>(deadline - std::chrono::steady_clock::now())
+                   .count());
+    };
+
+    QLocalSocket socket;
+    socket.connectToServer(socket_path);
+    if (!socket.waitForConnected(time_left()))
+        return false;
+
+    // the same handshake ping() uses, so stale data on the shared channel cannot be
+    // mistaken for the trim's reply
+    const auto sync_id = QDateTime::currentMSecsSinceEpoch();
+    const QJsonObject sync{{"execute", "guest-sync"}, {"arguments", QJsonObject{{"id", sync_id}}}};
+    const QJsonObject trim{{"execute", "guest-fstrim"}};
+    socket.write(QJsonDocument{sync}.toJson(QJsonDocument::Compact) + "\n");
+    socket.write(QJsonDocument{trim}.toJson(QJsonDocument::Compact) + "\n");
+    if (!socket.waitForBytesWritten(time_left()))
+        return false;
+
+    auto synced = false;
+    QByteArray response;
+    while (socket.waitForReadyRead(time_left()))
+    {
+        response += socket.readAll();
+        auto lines = response.split('\n');
+        response = lines.takeLast(); // carry any partial line over to the next read
+
+        for (const auto& line : lines)
+        {
+            const auto reply = QJsonDocument::fromJson(line).object();
+            if (!synced)
+                synced = reply.contains("return") && static_cast<qint64>(reply["return"].toDouble()) == sync_id;
+            else if (reply.contains("return"))
+                return true;
+            else if (reply.contains("error"))
+                return false;
+        }
+    }
+
+    return false;
+}
+
+bool mp::QemuGuestAgent::wait_for_ping(std::chrono::milliseconds timeout) const
+{
+    const auto deadline = std::chrono::steady_clock::now() + timeout;
+    while (std::chrono::steady_clock::now() < deadline)
+    {
+        if (ping(std::chrono::seconds(1)))
+            return true;
+
+        std::this_thread::sleep_for(ping_retry_delay);
+    }
+
+    return false;
+}
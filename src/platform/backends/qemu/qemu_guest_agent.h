@@ -0,0 +1,50 @@
+/*
+ * Copyright (C) 2021 Canonical, Ltd.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; version 3.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#ifndef MULTIPASS_QEMU_GUEST_AGENT_H
+#define MULTIPASS_QEMU_GUEST_AGENT_H
+
+#include <QString>
+
+#include <chrono>
+
+namespace multipass
+{
+// Talks to the qemu-guest-agent inside an instance over its virtio-serial port's unix
+// socket: no network stack on either end, so a ping answers as soon as the guest is up.
+// Everything is best effort - a guest without the agent simply never answers.
+class QemuGuestAgent
+{
+public:
+    explicit QemuGuestAgent(const QString& socket_path);
+
+    // A guest-sync round trip; true iff the agent answered with our token
+    bool ping(std::chrono::milliseconds timeout) const;
+
+    // Retries ping until it succeeds or the deadline passes
+    bool wait_for_ping(std::chrono::milliseconds timeout) const;
+
+    // Asks the agent to fstrim every mounted filesystem, punching freed extents back to
+    // the image through the disk's discard support; can take a while on large disks, so
+    // be generous with the timeout. True iff the agent reported the trim done.
+    bool fstrim(std::chrono::milliseconds timeout) const;
+
+private:
+    const QString socket_path;
+};
+} // namespace multipass
+#endif // MULTIPASS_QEMU_GUEST_AGENT_H
@@ -18,6 +18,7 @@
 #include "qemu_virtual_machine.h"
 
 #include "dnsmasq_server.h"
+#include "qemu_guest_agent.h"
 #include "qemu_vm_process_spec.h"
 #include "qemu_vmstate_process_spec.h"
 #include <shared/linux/backend_utils.h>
@@ -26,7 +27,9 @@
 
 #include <multipass/logging/log.h>
 #include <multipass/process/process.h>
+#include <multipass/process/qemuimg_job_queue.h>
 #include <multipass/ssh/ssh_session.h>
+#include <multipass/tracing.h>
 #include <multipass/utils.h>
 #include <multipass/vm_status_monitor.h>
 
@@ -43,8 +46,15 @@
 #include <QStringList>
 #include <QSysInfo>
 #include <QTemporaryFile>
+#include <QTimer>
 
+#include <algorithm>
 #include <thread>
+#include <vector>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <unistd.h>
 
 namespace mp = multipass;
 namespace mpl = multipass::logging;
@@ -52,8 +62,112 @@ namespace mpl = multipass::logging;
 namespace
 {
 constexpr auto suspend_tag = "suspend";
+constexpr qint64 min_balloon_target_bytes = 536870912LL; // never squeeze a guest below 512M
 constexpr auto machine_type_key = "machine_type";
 constexpr auto arguments_key = "arguments";
+constexpr qint64 boot_profile_region_size = 1048576LL; // granularity of the boot access profile
+// Discarded guest blocks only shrink the image when the guest issues the trims; distros
+// run fstrim weekly at best, so a daily nudge keeps thin images close to live data
+constexpr auto fstrim_interval = std::chrono::hours{24};
+constexpr auto fstrim_timeout = std::chrono::minutes{5};
+
+QString boot_profile_path_for(const QString& image_path)
+{
+    return image_path + ".bootprofile";
+}
+
+QString suspend_profile_path_for(const QString& image_path)
+{
+    return image_path + ".suspendprofile";
+}
+
+// Asks the kernel to start reading the image regions named in the given profile, so the
+// disk warms up while the qemu process is still being set up. fadvise only queues
+// readahead, so this returns immediately; with no profile on disk it is a no-op.
+void preheat_image_regions(const QString& image_path, const QString& profile_path, const std::string& vm_name)
+{
+    QFile profile_file{profile_path};
+    if (!profile_file.open(QIODevice::ReadOnly))
+        return;
+
+    const auto profile = QJsonDocument::fromJson(profile_file.readAll()).object();
+    const auto region_size = static_cast<qint64>(profile["region_size"].toDouble());
+    const auto regions = profile["regions"].toArray();
+    if (region_size <= 0 || regions.isEmpty())
+        return;
+
+    auto fd = ::open(image_path.toStdString().c_str(), O_RDONLY | O_CLOEXEC);
+    if (fd < 0)
+        return;
+
+    for (const auto& region : regions)
+        ::posix_fadvise(fd, static_cast<qint64>(region.toDouble()) * region_size, region_size, POSIX_FADV_WILLNEED);
+
+    ::close(fd);
+
+    mpl::log(mpl::Level::debug, vm_name,
+             fmt::format("preheating {} image regions ({} MiB) from profile {}", regions.count(),
+                         regions.count() * region_size / 1048576, profile_path));
+}
+
+// Samples which image regions are resident in the page cache - after a boot these are
+// the ones it read, after a savevm the ones it wrote - and persists them next to the
+// image for the next start to preheat. Best effort: any failure just means no profile
+// this time.
+void record_resident_profile(const QString& image_path, const QString& profile_path, const std::string& vm_name)
+{
+    auto fd = ::open(image_path.toStdString().c_str(), O_RDONLY | O_CLOEXEC);
+    if (fd < 0)
+        return;
+
+    const auto image_size = ::lseek(fd, 0, SEEK_END);
+    if (image_size <= 0)
+    {
+        ::close(fd);
+        return;
+    }
+
+    auto* mapping = ::mmap(nullptr, image_size, PROT_READ, MAP_SHARED, fd, 0);
+    ::close(fd);
+    if (mapping == MAP_FAILED)
+        return;
+
+    const auto page_size = ::sysconf(_SC_PAGESIZE);
+    std::vector<unsigned char> page_resident((image_size + page_size - 1) / page_size);
+    auto failed = ::mincore(mapping, image_size, page_resident.data()) != 0;
+    ::munmap(mapping, image_size);
+    if (failed)
+        return;
+
+    // A region counts as hot if any page in it is resident
+    QJsonArray regions;
+    const auto pages_per_region = boot_profile_region_size / page_size;
+    for (qint64 region = 0; region * pages_per_region < static_cast<qint64>(page_resident.size()); ++region)
+    {
+        const auto begin = region * pages_per_region;
+        const auto end = std::min(begin + pages_per_region, static_cast<qint64>(page_resident.size()));
+        for (auto page = begin; page < end; ++page)
+        {
+            if (page_resident[page] & 1)
+            {
+                regions.append(region);
+                break;
+            }
+        }
+    }
+
+    QJsonObject profile;
+    profile["region_size"] = boot_profile_region_size;
+    profile["regions"] = regions;
+
+    QFile profile_file{profile_path};
+    if (profile_file.open(QIODevice::WriteOnly))
+        profile_file.write(QJsonDocument(profile).toJson(QJsonDocument::Compact));
+
+    mpl::log(mpl::Level::debug, vm_name,
+             fmt::format("recorded access profile: {} of {} image regions hot", regions.count(),
+                         (image_size + boot_profile_region_size - 1) / boot_profile_region_size));
+}
 
 bool use_cdrom_set(const QJsonObject& metadata)
 {
@@ -125,6 +239,54 @@ auto qmp_execute_json(const QString& cmd)
     return QJsonDocument(qmp).toJson();
 }
 
+auto balloon_qmp_json(qint64 target_bytes)
+{
+    auto qmp = QJsonDocument::fromJson(qmp_execute_json("balloon")).object();
+
+    QJsonObject arguments;
+    arguments.insert("value", target_bytes);
+    qmp.insert("arguments", arguments);
+
+    return QJsonDocument(qmp).toJson();
+}
+
+// savevm runs through the migration machinery, so the migration compression knobs
+// apply to suspend images as well
+auto migrate_capability_qmp_json(const QString& capability, bool enabled)
+{
+    auto qmp = QJsonDocument::fromJson(qmp_execute_json("migrate-set-capabilities")).object();
+
+    QJsonObject capability_entry;
+    capability_entry.insert("capability", capability);
+    capability_entry.insert("state", enabled);
+
+    QJsonArray capabilities;
+    capabilities.append(capability_entry);
+
+    QJsonObject arguments;
+    arguments.insert("capabilities", capabilities);
+    qmp.insert("arguments", arguments);
+
+    return QJsonDocument(qmp).toJson();
+}
+
+auto migrate_compress_parameters_qmp_json(int compress_level, int compress_threads)
+{
+    auto qmp = QJsonDocument::fromJson(qmp_execute_json("migrate-set-parameters")).object();
+
+    QJsonObject arguments;
+    arguments.insert("compress-level", compress_level);
+    arguments.insert("compress-threads", compress_threads);
+    qmp.insert("arguments", arguments);
+
+    return QJsonDocument(qmp).toJson();
+}
+
+int suspend_compress_threads()
+{
+    return std::min(4u, std::max(2u, std::thread::hardware_concurrency() / 2));
+}
+
 auto hmc_to_qmp_json(const QString& command_line)
 {
     auto qmp = QJsonDocument::fromJson(qmp_execute_json("human-monitor-command")).object();
@@ -212,6 +374,32 @@ mp::QemuVirtualMachine::QemuVirtualMachine(const VirtualMachineDescription& desc
                          delete_memory_snapshot = false;
                      },
                      Qt::QueuedConnection);
+
+    // The tick is a no-op unless the instance is running with a responsive guest agent,
+    // so the timer can just run for the machine's lifetime
+    QObject::connect(&fstrim_timer, &QTimer::timeout, this, &QemuVirtualMachine::trigger_fstrim);
+    fstrim_timer.start(fstrim_interval);
+}
+
+void mp::QemuVirtualMachine::trigger_fstrim()
+{
+    if (state != State::running || guest_agent_presence != GuestAgentPresence::present)
+        return;
+
+    if (fstrim_in_flight->exchange(true))
+        return;
+
+    // Trims can take a while on large disks; everything the worker needs is captured by
+    // value, so a trim outlasting the instance is harmless
+    std::thread{[name = vm_name, agent_socket = QemuVMProcessSpec::guest_agent_socket_path(desc.image.image_path),
+                 in_flight = fstrim_in_flight] {
+        const QemuGuestAgent agent{agent_socket};
+        if (agent.fstrim(fstrim_timeout))
+            mpl::log(mpl::Level::debug, name, "periodic fstrim completed");
+        else
+            mpl::log(mpl::Level::debug, name, "periodic fstrim did not complete");
+        *in_flight = false;
+    }}.detach();
 }
 
 mp::QemuVirtualMachine::~QemuVirtualMachine()
@@ -240,6 +428,8 @@ void mp::QemuVirtualMachine::start()
     if (state == State::running)
         return;
 
+    const mp::TracedSpan span{fmt::format("vm start: {}", vm_name)};
+
     if (state == State::suspending)
         throw std::runtime_error("cannot start the instance while suspending");
 
@@ -249,11 +439,22 @@ void mp::QemuVirtualMachine::start()
     {
         mpl::log(mpl::Level::info, vm_name, fmt::format("Resuming from a suspended state"));
 
+        // loadvm blocks until the whole memory image is read back; start streaming the
+        // regions savevm wrote while the process is still being set up, so the read
+        // mostly hits warm cache by the time qemu gets there
+        preheat_image_regions(desc.image.image_path, suspend_profile_path_for(desc.image.image_path), vm_name);
+
         update_shutdown_status = true;
         delete_memory_snapshot = true;
     }
     else
     {
+        // Start warming the image's hot regions while the process gets set up; a first
+        // boot after a daemon restart otherwise reads the qcow2 cold, which random
+        // access makes painful on spinning disks
+        preheat_image_regions(desc.image.image_path, boot_profile_path_for(desc.image.image_path), vm_name);
+        record_boot_profile_pending = true;
+
         monitor->update_metadata_for(vm_name, generate_metadata(vm_process->arguments()));
     }
 
@@ -277,6 +478,18 @@ void mp::QemuVirtualMachine::start()
         }
     }
 
+    if (!desc.cpuset.empty())
+    {
+        // Affinity is applied from the outside rather than through qemu options, so the
+        // command line (and with it the saved resume arguments) is the same with and
+        // without pinning
+        if (mp::utils::run_cmd_for_status("taskset", {"-a", "-p", "-c", QString::fromStdString(desc.cpuset),
+                                                      QString::number(vm_process->process_id())}))
+            mpl::log(mpl::Level::info, vm_name, fmt::format("pinned to host CPUs '{}'", desc.cpuset));
+        else
+            mpl::log(mpl::Level::warning, vm_name, fmt::format("could not pin to host CPUs '{}'", desc.cpuset));
+    }
+
     vm_process->write(qmp_execute_json("qmp_capabilities"));
 }
 
@@ -313,6 +526,11 @@ void mp::QemuVirtualMachine::suspend()
 {
     if ((state == State::running || state == State::delayed_shutdown) && vm_process->running())
     {
+        // Compress guest RAM on the way out; level 1 is plenty for the mostly-zero pages
+        // a typical guest holds, and the worker threads overlap compression with the
+        // writes. The resume side enables the matching capability on its command line.
+        vm_process->write(migrate_capability_qmp_json("compress", true));
+        vm_process->write(migrate_compress_parameters_qmp_json(1, suspend_compress_threads()));
         vm_process->write(hmc_to_qmp_json("savevm " + QString::fromStdString(suspend_tag)));
 
         if (update_shutdown_status)
@@ -321,9 +539,12 @@ void mp::QemuVirtualMachine::suspend()
             update_state();
 
             update_shutdown_status = false;
-            vm_process->wait_for_finished();
-            vm_process.reset(nullptr);
         }
+
+        // No waiting for the memory image here: the caller is acknowledged as soon as
+        // savevm is underway, so a fleet's suspends run in parallel. The QMP RESUME
+        // event completes the transition (see handle_qmp_event) and watchers see
+        // suspending -> suspended through the status monitor.
     }
     else if (state == State::off || state == State::suspended)
     {
@@ -332,6 +553,80 @@ void mp::QemuVirtualMachine::suspend()
     }
 }
 
+void mp::QemuVirtualMachine::reclaim_idle_memory()
+{
+    const auto allocation = static_cast<qint64>(desc.mem_size.in_bytes());
+    const auto target = allocation / 2;
+
+    if (memory_reclaimed || target < min_balloon_target_bytes || state != State::running || !vm_process ||
+        !vm_process->running())
+        return;
+
+    mpl::log(mpl::Level::info, vm_name, fmt::format("idle; ballooning down to {} of {} bytes", target, allocation));
+    vm_process->write(balloon_qmp_json(target));
+    memory_reclaimed = true;
+}
+
+void mp::QemuVirtualMachine::restore_reclaimed_memory()
+{
+    if (!memory_reclaimed)
+        return;
+
+    memory_reclaimed = false;
+    if (vm_process && vm_process->running())
+    {
+        mpl::log(mpl::Level::info, vm_name, "restoring ballooned memory");
+        vm_process->write(balloon_qmp_json(static_cast<qint64>(desc.mem_size.in_bytes())));
+    }
+}
+
+void mp::QemuVirtualMachine::take_snapshot(const std::string& snapshot_name)
+{
+    if (state != State::off && state != State::stopped)
+        throw std::runtime_error(fmt::format("instance \"{}\" must be stopped to take a snapshot", vm_name));
+
+    // the suspend machinery identifies a suspended instance by grepping the snapshot list
+    // for the suspend tag, so a user snapshot containing it would corrupt state detection
+    if (snapshot_name.find(suspend_tag) != std::string::npos)
+        throw std::runtime_error(
+            fmt::format("snapshot names containing \"{}\" are reserved for suspend state", suspend_tag));
+
+    auto result = MP_QEMUIMG_QUEUE.run(
+        std::make_unique<mp::QemuImgProcessSpec>(
+            QStringList{"snapshot", "-c", QString::fromStdString(snapshot_name), desc.image.image_path}, "",
+            desc.image.image_path),
+        mp::QemuImgJobQueue::Priority::interactive, mp::backend::image_resize_timeout);
+
+    if (!result.state.completed_successfully())
+        throw std::runtime_error(fmt::format("Cannot take snapshot: qemu-img failed ({}) with output:\n{}",
+                                             result.state.failure_message(), result.error_output));
+
+    mpl::log(mpl::Level::info, vm_name, fmt::format("took snapshot \"{}\"", snapshot_name));
+}
+
+void mp::QemuVirtualMachine::restore_snapshot(const std::string& snapshot_name)
+{
+    if (state != State::off && state != State::stopped)
+        throw std::runtime_error(fmt::format("instance \"{}\" must be stopped to restore a snapshot", vm_name));
+
+    auto result = MP_QEMUIMG_QUEUE.run(
+        std::make_unique<mp::QemuImgProcessSpec>(
+            QStringList{"snapshot", "-a", QString::fromStdString(snapshot_name), desc.image.image_path}, "",
+            desc.image.image_path),
+        mp::QemuImgJobQueue::Priority::interactive, mp::backend::image_resize_timeout);
+
+    if (!result.state.completed_successfully())
+        throw std::runtime_error(fmt::format("Cannot restore snapshot: qemu-img failed ({}) with output:\n{}",
+                                             result.state.failure_message(), result.error_output));
+
+    mpl::log(mpl::Level::info, vm_name, fmt::format("restored snapshot \"{}\"", snapshot_name));
+}
+
+std::string mp::QemuVirtualMachine::console_scrollback()
+{
+    return console_scrollback_buffer.contents();
+}
+
 mp::VirtualMachine::State mp::QemuVirtualMachine::current_state()
 {
     return state;
@@ -375,6 +670,7 @@ void mp::QemuVirtualMachine::on_shutdown()
     }
 
     management_ip = nullopt;
+    memory_reclaimed = false; // a fresh boot comes up with the balloon fully collapsed
     update_state();
     vm_process.reset(nullptr);
     lock.unlock();
@@ -437,14 +733,89 @@ std::string mp::QemuVirtualMachine::ipv6()
 
 void mp::QemuVirtualMachine::wait_until_ssh_up(std::chrono::milliseconds timeout)
 {
+    // The guest agent answers on its virtio-serial port before guest networking comes
+    // up, so waiting on its ping first spends the early boot window on one unix socket
+    // round trip instead of doomed TCP attempts. The outcome is remembered: a guest
+    // that never answered is not waited on again.
+    if (guest_agent_presence != GuestAgentPresence::absent)
+    {
+        const auto agent_socket = QemuVMProcessSpec::guest_agent_socket_path(desc.image.image_path);
+        if (QFile::exists(agent_socket))
+        {
+            const QemuGuestAgent agent{agent_socket};
+            const auto agent_budget = std::min(timeout, std::chrono::milliseconds{15000});
+            guest_agent_presence =
+                agent.wait_for_ping(agent_budget) ? GuestAgentPresence::present : GuestAgentPresence::absent;
+        }
+    }
+
     mp::utils::wait_until_ssh_up(this, timeout, std::bind(&QemuVirtualMachine::ensure_vm_is_running, this));
 
+    if (record_boot_profile_pending)
+    {
+        record_resident_profile(desc.image.image_path, boot_profile_path_for(desc.image.image_path), vm_name);
+        record_boot_profile_pending = false;
+    }
+
     if (delete_memory_snapshot)
     {
         emit on_delete_memory_snapshot();
     }
 }
 
+void mp::QemuVirtualMachine::handle_qmp_event(const QJsonObject& qmp_object)
+{
+    const auto event = qmp_object["event"];
+
+    if (event.isNull())
+        return;
+
+    mpl::log<mpl::Level::trace>(vm_name, "QMP event {}", event.toString());
+
+    if (event.toString() == "RESET" && state != State::restarting)
+    {
+        mpl::log(mpl::Level::info, vm_name, "VM restarting");
+        on_restart();
+    }
+    else if (event.toString() == "POWERDOWN")
+    {
+        mpl::log(mpl::Level::info, vm_name, "VM powering down");
+    }
+    else if (event.toString() == "SHUTDOWN")
+    {
+        mpl::log(mpl::Level::info, vm_name, "VM shut down");
+    }
+    else if (event.toString() == "STOP")
+    {
+        mpl::log(mpl::Level::info, vm_name, "VM suspending");
+    }
+    else if (event.toString() == "RESUME")
+    {
+        mpl::log(mpl::Level::info, vm_name, "VM suspended");
+        if (state == State::suspending || state == State::running)
+        {
+            vm_process->kill();
+
+            // The memory image savevm just wrote is still resident; record where it
+            // landed in the qcow2 so the resume can queue readahead over exactly
+            // those regions before loadvm goes looking for them
+            record_resident_profile(desc.image.image_path, suspend_profile_path_for(desc.image.image_path), vm_name);
+
+            on_suspend();
+
+            // suspend() no longer waits for the process; reap it from the event loop,
+            // once the signal emission this handler sits inside has unwound
+            QTimer::singleShot(0, this, [this] {
+                if (vm_process && !vm_process->running())
+                {
+                    vm_process->wait_for_finished();
+                    vm_process.reset(nullptr);
+                }
+            });
+        }
+    }
+}
+
 void mp::QemuVirtualMachine::initialize_vm_process()
 {
     vm_process = make_qemu_process(
@@ -457,44 +828,30 @@ void mp::QemuVirtualMachine::initialize_vm_process()
     });
 
     QObject::connect(vm_process.get(), &Process::ready_read_standard_output, [this]() {
-        auto qmp_output = vm_process->read_all_standard_output();
-        mpl::log(mpl::Level::debug, vm_name, fmt::format("QMP: {}", qmp_output));
-        auto qmp_object = QJsonDocument::fromJson(qmp_output.split('\n').first()).object();
-        auto event = qmp_object["event"];
+        // QMP messages are newline-delimited JSON, but a single read may carry several
+        // of them, or end mid-message; buffer and handle every complete line so no
+        // event is lost and state transitions track the monitor channel immediately.
+        qmp_buffer.append(vm_process->read_all_standard_output());
 
-        if (!event.isNull())
+        int newline_pos;
+        while ((newline_pos = qmp_buffer.indexOf('\n')) >= 0)
         {
-            if (event.toString() == "RESET" && state != State::restarting)
-            {
-                mpl::log(mpl::Level::info, vm_name, "VM restarting");
-                on_restart();
-            }
-            else if (event.toString() == "POWERDOWN")
-            {
-                mpl::log(mpl::Level::info, vm_name, "VM powering down");
-            }
-            else if (event.toString() == "SHUTDOWN")
-            {
-                mpl::log(mpl::Level::info, vm_name, "VM shut down");
-            }
-            else if (event.toString() == "STOP")
-            {
-                mpl::log(mpl::Level::info, vm_name, "VM suspending");
-            }
-            else if (event.toString() == "RESUME")
-            {
-                mpl::log(mpl::Level::info, vm_name, "VM suspended");
-                if (state == State::suspending || state == State::running)
-                {
-                    vm_process->kill();
-                    on_suspend();
-                }
-            }
+            const auto line = qmp_buffer.left(newline_pos);
+            qmp_buffer.remove(0, newline_pos + 1);
+
+            if (line.trimmed().isEmpty())
+                continue;
+
+            mpl::log(mpl::Level::debug, vm_name, fmt::format("QMP: {}", line));
+            console_scrollback_buffer.append(line.data(), line.size());
+            console_scrollback_buffer.append("\n", 1);
+            handle_qmp_event(QJsonDocument::fromJson(line).object());
         }
     });
 
     QObject::connect(vm_process.get(), &Process::ready_read_standard_error, [this]() {
         saved_error_msg = vm_process->read_all_standard_error().data();
+        console_scrollback_buffer.append(saved_error_msg.data(), saved_error_msg.size());
         mpl::log(mpl::Level::warning, vm_name, saved_error_msg);
     });
 
@@ -21,10 +21,15 @@
 #include <shared/base_virtual_machine.h>
 
 #include <multipass/process/process.h>
+#include <multipass/scrollback_buffer.h>
 #include <multipass/virtual_machine_description.h>
 
+#include <QJsonObject>
 #include <QObject>
 #include <QStringList>
+#include <QTimer>
+
+#include <atomic>
 
 namespace multipass
 {
@@ -52,6 +57,11 @@ public:
     void ensure_vm_is_running() override;
     void wait_until_ssh_up(std::chrono::milliseconds timeout) override;
     void update_state() override;
+    void reclaim_idle_memory() override;
+    void restore_reclaimed_memory() override;
+    void take_snapshot(const std::string& snapshot_name) override;
+    void restore_snapshot(const std::string& snapshot_name) override;
+    std::string console_scrollback() override;
 
 signals:
     void on_delete_memory_snapshot();
@@ -63,6 +73,8 @@ private:
     void on_suspend();
     void on_restart();
     void initialize_vm_process();
+    void handle_qmp_event(const QJsonObject& qmp_object);
+    void trigger_fstrim();
 
     const std::string tap_device_name;
     const VirtualMachineDescription desc;
@@ -71,7 +83,21 @@ private:
     const std::string username;
     DNSMasqServer* dnsmasq_server;
     VMStatusMonitor* monitor;
+    bool memory_reclaimed{false};
+    bool record_boot_profile_pending{false}; // sample the image's hot regions once ssh is up
+    enum class GuestAgentPresence
+    {
+        unknown,
+        present,
+        absent
+    };
+    GuestAgentPresence guest_agent_presence{GuestAgentPresence::unknown};
+    QTimer fstrim_timer; // periodic guest-fstrim, returning deleted guest data to the host
+    // shared with the worker thread running a trim, which may outlive the instance
+    std::shared_ptr<std::atomic<bool>> fstrim_in_flight = std::make_shared<std::atomic<bool>>(false);
     std::string saved_error_msg;
+    ScrollbackBuffer console_scrollback_buffer{64 * 1024}; // recent hypervisor output, bounded
+    QByteArray qmp_buffer; // partial QMP line carried over between reads
     bool update_shutdown_status{true};
     bool delete_memory_snapshot{false};
 };
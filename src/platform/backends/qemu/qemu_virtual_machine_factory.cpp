@@ -26,6 +26,7 @@
 #include <multipass/virtual_machine_description.h>
 
 #include <shared/linux/backend_utils.h>
+#include <shared/linux/netlink_ops.h>
 #include <shared/linux/process_factory.h>
 
 #include <QRegularExpression>
@@ -49,44 +50,69 @@ auto generate_tap_device_name(const std::string& vm_name)
     return tap_name;
 }
 
+// Device setup goes through rtnetlink/tun ioctls directly, one step at a time; any step
+// the kernel refuses falls back to shelling out to iproute2, so behaviour on exotic
+// setups is unchanged while the common path costs no process spawns.
 void create_virtual_switch(const std::string& subnet, const QString& bridge_name)
 {
     const QString dummy_name{bridge_name + "-dummy"};
+    const auto bridge = bridge_name.toStdString();
+    const auto dummy = dummy_name.toStdString();
 
-    if (!mp::utils::run_cmd_for_status("ip", {"addr", "show", bridge_name}))
+    if (!mp::netlink::link_exists(bridge))
     {
         const auto mac_address = mp::utils::generate_mac_address();
-        const auto cidr = fmt::format("{}.1/24", subnet);
+        const auto address = fmt::format("{}.1", subnet);
+        const auto cidr = fmt::format("{}/24", address);
         const auto broadcast = fmt::format("{}.255", subnet);
 
-        mp::utils::run_cmd_for_status("ip",
-                                      {"link", "add", dummy_name, "address", mac_address.c_str(), "type", "dummy"});
-        mp::utils::run_cmd_for_status("ip", {"link", "add", bridge_name, "type", "bridge"});
-        mp::utils::run_cmd_for_status("ip", {"link", "set", dummy_name, "master", bridge_name});
-        mp::utils::run_cmd_for_status(
-            "ip", {"address", "add", cidr.c_str(), "dev", bridge_name, "broadcast", broadcast.c_str()});
-        mp::utils::run_cmd_for_status("ip", {"link", "set", bridge_name, "up"});
+        if (!mp::netlink::create_dummy(dummy, mac_address))
+            mp::utils::run_cmd_for_status("ip",
+                                          {"link", "add", dummy_name, "address", mac_address.c_str(), "type", "dummy"});
+        if (!mp::netlink::create_bridge(bridge))
+            mp::utils::run_cmd_for_status("ip", {"link", "add", bridge_name, "type", "bridge"});
+        if (!mp::netlink::set_master(dummy, bridge))
+            mp::utils::run_cmd_for_status("ip", {"link", "set", dummy_name, "master", bridge_name});
+        if (!mp::netlink::add_address(bridge, address, 24, broadcast))
+            mp::utils::run_cmd_for_status(
+                "ip", {"address", "add", cidr.c_str(), "dev", bridge_name, "broadcast", broadcast.c_str()});
+        if (!mp::netlink::set_up(bridge))
+            mp::utils::run_cmd_for_status("ip", {"link", "set", bridge_name, "up"});
     }
 }
 
 void delete_virtual_switch(const QString& bridge_name)
 {
     const QString dummy_name{bridge_name + "-dummy"};
+    const auto bridge = bridge_name.toStdString();
 
-    if (mp::utils::run_cmd_for_status("ip", {"addr", "show", bridge_name}))
+    if (mp::netlink::link_exists(bridge))
     {
-        mp::utils::run_cmd_for_status("ip", {"link", "delete", bridge_name});
-        mp::utils::run_cmd_for_status("ip", {"link", "delete", dummy_name});
+        if (!mp::netlink::delete_link(bridge))
+            mp::utils::run_cmd_for_status("ip", {"link", "delete", bridge_name});
+        if (!mp::netlink::delete_link(dummy_name.toStdString()))
+            mp::utils::run_cmd_for_status("ip", {"link", "delete", dummy_name});
     }
 }
 
 void create_tap_device(const QString& tap_name, const QString& bridge_name)
 {
-    if (!mp::utils::run_cmd_for_status("ip", {"addr", "show", tap_name}))
+    const auto tap = tap_name.toStdString();
+
+    if (!mp::netlink::link_exists(tap))
     {
-        mp::utils::run_cmd_for_status("ip", {"tuntap", "add", tap_name, "mode", "tap"});
-        mp::utils::run_cmd_for_status("ip", {"link", "set", tap_name, "master", bridge_name});
-        mp::utils::run_cmd_for_status("ip", {"link", "set", tap_name, "up"});
+        // Multiqueue-capable taps let qemu spread virtio-net processing across vcpus; the
+        // netlink path (and, failing that, iproute2) falls back to a plain device where
+        // the kernel predates the flag
+        if (!mp::netlink::create_tap(tap))
+        {
+            if (!mp::utils::run_cmd_for_status("ip", {"tuntap", "add", tap_name, "mode", "tap", "multi_queue"}))
+                mp::utils::run_cmd_for_status("ip", {"tuntap", "add", tap_name, "mode", "tap"});
+        }
+        if (!mp::netlink::set_master(tap, bridge_name.toStdString()))
+            mp::utils::run_cmd_for_status("ip", {"link", "set", tap_name, "master", bridge_name});
+        if (!mp::netlink::set_up(tap))
+            mp::utils::run_cmd_for_status("ip", {"link", "set", tap_name, "up"});
     }
 }
 
@@ -23,6 +23,12 @@
 #include <multipass/snap_utils.h>
 #include <shared/linux/backend_utils.h>
 
+#include <QFile>
+
+#include <algorithm>
+#include <cstring>
+#include <thread>
+
 namespace mp = multipass;
 namespace mpl = multipass::logging;
 namespace mu = multipass::utils;
@@ -70,6 +76,74 @@ QStringList initial_qemu_arguments(const mp::VirtualMachineDescription& desc, co
     }
     return args;
 }
+
+bool vhost_net_available()
+{
+    return QFile::exists("/dev/vhost-net");
+}
+
+// Opt-in hugepage backing for guest RAM: MULTIPASS_HUGEPAGE_MEMORY=1 uses the default
+// hugetlbfs mount, any other non-empty value names the mount to use. Off by default --
+// qemu's anonymous guest memory already gets transparent hugepages where the host
+// enables them, explicit backing only pays off with a reserved pool.
+QString hugepage_mount()
+{
+    const auto env = qgetenv("MULTIPASS_HUGEPAGE_MEMORY");
+    if (env.isEmpty() || env == "0" || env.toLower() == "false")
+        return {};
+    if (env == "1" || env.toLower() == "true")
+        return QStringLiteral("/dev/hugepages");
+    return QString::fromUtf8(env);
+}
+
+// Free capacity of the host's hugepage pool, from /proc/meminfo
+qint64 free_hugepage_bytes()
+{
+    QFile meminfo{QStringLiteral("/proc/meminfo")};
+    if (!meminfo.open(QIODevice::ReadOnly))
+        return 0;
+
+    qint64 free_pages{0}, page_size_kb{0};
+    for (auto line = meminfo.readLine(); !line.isEmpty(); line = meminfo.readLine())
+    {
+        if (line.startsWith("HugePages_Free:"))
+            free_pages = line.mid(strlen("HugePages_Free:")).trimmed().toLongLong();
+        else if (line.startsWith("Hugepagesize:"))
+            page_size_kb = line.mid(strlen("Hugepagesize:")).split(' ').first().trimmed().toLongLong();
+    }
+
+    return free_pages * page_size_kb * 1024;
+}
+
+// CPU model profiles: host passthrough (the default) exposes the host's full feature set
+// (AVX2, AES-NI, ...) to the guest; the portable profile trades those for QEMU's baseline
+// model, whose suspended images can resume on different host silicon. Any other recorded
+// value is handed to -cpu verbatim.
+QString cpu_model_for(const mp::VirtualMachineDescription& desc)
+{
+    if (desc.cpu_model == "portable")
+        return QStringLiteral("qemu64");
+    if (desc.cpu_model.empty() || desc.cpu_model == "host")
+        return QStringLiteral("host");
+    return QString::fromStdString(desc.cpu_model);
+}
+
+// One virtio-net queue per vcpu, provided the tap device was created multiqueue-capable;
+// the kernel exposes the tap's creation flags through sysfs
+int tap_queue_count(const QString& tap_device_name, int num_cores)
+{
+    QFile tun_flags_file{QString("/sys/class/net/%1/tun_flags").arg(tap_device_name)};
+    if (!tun_flags_file.open(QIODevice::ReadOnly))
+        return 1;
+
+    bool ok{false};
+    const auto flags = tun_flags_file.readAll().trimmed().toUInt(&ok, 16);
+    constexpr auto iff_multi_queue = 0x0100u;
+    if (!ok || !(flags & iff_multi_queue))
+        return 1;
+
+    return num_cores;
+}
 } // namespace
 
 mp::QemuVMProcessSpec::QemuVMProcessSpec(const mp::VirtualMachineDescription& desc, const QString& tap_device_name,
@@ -98,6 +172,14 @@ QStringList mp::QemuVMProcessSpec::arguments() const
         // need to append extra arguments for resume
         args << "-loadvm" << resume_data->suspend_tag;
 
+        // Suspend images are written with migration compression; -loadvm runs before any
+        // QMP exchange, so the capability has to come up on the command line. Harmless
+        // for old, uncompressed suspend images.
+        args << "-global"
+             << "migration.x-compress=on";
+        const auto decompress_threads = std::min(4u, std::max(2u, std::thread::hardware_concurrency() / 2));
+        args << "-global" << QString("migration.x-decompress-threads=%1").arg(decompress_threads);
+
         QString machine_type = resume_data->machine_type;
         if (!machine_type.isEmpty())
         {
@@ -121,23 +203,59 @@ QStringList mp::QemuVMProcessSpec::arguments() const
              << "-drive" << QString("file=%1,if=none,format=qcow2,discard=unmap,id=hda").arg(desc.image.image_path)
              << "-device"
              << "scsi-hd,drive=hda,bus=scsi0.0";
-        // Number of cpu cores
-        args << "-smp" << QString::number(desc.num_cores);
+        // Number of cpu cores, spelled out as a flat single-socket topology so guests see
+        // the vcpus as cores sharing a package instead of one core per socket
+        args << "-smp" << QString("%1,sockets=1,cores=%1,threads=1").arg(desc.num_cores);
         // Memory to use for VM
         args << "-m" << mem_size;
-        // Create a virtual NIC in the VM
-        args << "-device"
-             << QString("virtio-net-pci,netdev=hostnet0,id=net0,mac=%1")
-                    .arg(QString::fromStdString(desc.default_mac_address));
+        // Hugepage backing when opted in and the remaining pool still fits this guest;
+        // an exhausted pool degrades to regular pages instead of failing the launch.
+        // -mem-prealloc takes the pages up front, keeping the accounting honest for
+        // whoever launches next.
+        const auto hugepages = hugepage_mount();
+        if (!hugepages.isEmpty())
+        {
+            if (free_hugepage_bytes() >= static_cast<qint64>(desc.mem_size.in_bytes()))
+                args << "-mem-path" << hugepages << "-mem-prealloc";
+            else
+                mpl::log(mpl::Level::warning, desc.vm_name,
+                         fmt::format("hugepage pool cannot fit {}MB; falling back to regular pages",
+                                     desc.mem_size.in_megabytes()));
+        }
+        // Create a virtual NIC in the VM, with in-kernel virtio processing and a queue per
+        // vcpu where the host and the tap device support them
+        const auto queues = tap_queue_count(tap_device_name, desc.num_cores);
+        auto net_device =
+            QString("virtio-net-pci,netdev=hostnet0,id=net0,mac=%1").arg(QString::fromStdString(desc.default_mac_address));
+        auto netdev = QString("tap,id=hostnet0,ifname=%1,script=no,downscript=no").arg(tap_device_name);
+        if (vhost_net_available())
+            netdev += ",vhost=on";
+        if (queues > 1)
+        {
+            netdev += QString(",queues=%1").arg(queues);
+            net_device += QString(",mq=on,vectors=%1").arg(2 * queues + 2);
+        }
+        args << "-device" << net_device;
         // Create tap device to connect to virtual bridge
-        args << "-netdev";
-        args << QString("tap,id=hostnet0,ifname=%1,script=no,downscript=no").arg(tap_device_name);
+        args << "-netdev" << netdev;
+        // Balloon device, letting the daemon reclaim RAM from idle instances
+        args << "-device"
+             << "virtio-balloon-pci,id=balloon0";
+        // Guest agent channel: a virtio-serial port the qemu-guest-agent in the guest
+        // answers on, exposed as a unix socket next to the image. Queries over it skip
+        // the network stack entirely; guests without the agent just leave it silent.
+        args << "-chardev"
+             << QString("socket,id=qga0,path=%1,server,nowait").arg(guest_agent_socket_path(desc.image.image_path))
+             << "-device"
+             << "virtio-serial-pci,id=virtio-serial0"
+             << "-device"
+             << "virtserialport,bus=virtio-serial0.0,chardev=qga0,name=org.qemu.guest_agent.0";
         // Control interface
         args << "-qmp"
              << "stdio";
-        // Pass host CPU flags to VM
-        args << "-cpu"
-             << "host";
+        // CPU model per the instance's profile; suspend images carry the resulting
+        // arguments, so resumes keep the model the image was written with
+        args << "-cpu" << cpu_model_for(desc);
         // No console
         args << "-chardev"
              // TODO Read and log machine output when verbose
@@ -194,6 +312,9 @@ profile %1 flags=(attach_disconnected) {
   owner @{PROC}/*/auxv r,
   @{PROC}/sys/vm/overcommit_memory r,
 
+  # hugepage-backed guest memory (opt-in)
+  owner /dev/hugepages/** rw,
+
   # access to firmware's etc (selectively chosen for multipass' usage)
   %3 r,
 
@@ -224,6 +345,9 @@ profile %1 flags=(attach_disconnected) {
   # Disk images
   %6 rwk,  # QCow2 filesystem image
   %7 rk,   # cloud-init ISO
+
+  # Guest agent channel socket
+  %8 rw,
 }
     )END");
 
@@ -245,7 +369,13 @@ profile %1 flags=(attach_disconnected) {
     }
 
     return profile_template.arg(apparmor_profile_name(), signal_peer, firmware, root_dir, program(),
-                                desc.image.image_path, desc.cloud_init_iso);
+                                desc.image.image_path, desc.cloud_init_iso,
+                                guest_agent_socket_path(desc.image.image_path));
+}
+
+QString mp::QemuVMProcessSpec::guest_agent_socket_path(const QString& image_path)
+{
+    return image_path + ".agent";
 }
 
 QString mp::QemuVMProcessSpec::identifier() const
@@ -38,6 +38,7 @@ public:
     };
 
     static QString default_machine_type();
+    static QString guest_agent_socket_path(const QString& image_path);
 
     explicit QemuVMProcessSpec(const VirtualMachineDescription& desc, const QString& tap_device_name,
                                const multipass::optional<ResumeData>& resume_data);
@@ -21,7 +21,9 @@
 #include <multipass/memory_size.h>
 #include <multipass/platform.h>
 #include <multipass/process/process.h>
+#include <multipass/process/qemuimg_job_queue.h>
 #include <multipass/process/qemuimg_process_spec.h>
+#include <multipass/stats_registry.h>
 #include <multipass/utils.h>
 
 #include <multipass/format.h>
@@ -29,6 +31,7 @@
 #include <shared/shared_backend_utils.h>
 
 #include <QCoreApplication>
+#include <QFile>
 #include <QJsonDocument>
 #include <QJsonObject>
 #include <QProcess>
@@ -54,6 +57,18 @@ namespace
 std::default_random_engine gen;
 std::uniform_int_distribution<int> dist{0, 255};
 
+// qcow2 images open with the magic "QFI\xfb" followed by a 4-byte big-endian version
+bool has_qcow2_magic(const mp::Path& image_path)
+{
+    QFile image_file{image_path};
+    if (!image_file.open(QIODevice::ReadOnly))
+        return false;
+
+    const auto header = image_file.read(8);
+    return header.size() == 8 && header.startsWith(QByteArrayLiteral("QFI\xfb")) &&
+           (header.at(7) == 2 || header.at(7) == 3);
+}
+
 bool subnet_used_locally(const std::string& subnet)
 {
     // CLI equivalent: ip -4 route show | grep -q ${SUBNET}
@@ -133,15 +148,13 @@ void mp::backend::resize_instance_image(const MemorySize& disk_space, const mp::
 {
     auto disk_size = QString::number(disk_space.in_bytes()); // format documented in `man qemu-img` (look for "size")
     QStringList qemuimg_parameters{{"resize", image_path, disk_size}};
-    auto qemuimg_process =
-        mp::platform::make_process(std::make_unique<mp::QemuImgProcessSpec>(qemuimg_parameters, "", image_path));
+    auto result = MP_QEMUIMG_QUEUE.run(std::make_unique<mp::QemuImgProcessSpec>(qemuimg_parameters, "", image_path),
+                                       mp::QemuImgJobQueue::Priority::interactive, mp::backend::image_resize_timeout);
 
-    auto process_state = qemuimg_process->execute(mp::backend::image_resize_timeout);
-    if (!process_state.completed_successfully())
+    if (!result.state.completed_successfully())
     {
         throw std::runtime_error(fmt::format("Cannot resize instance image: qemu-img failed ({}) with output:\n{}",
-                                             process_state.failure_message(),
-                                             qemuimg_process->read_all_standard_error()));
+                                             result.state.failure_message(), result.error_output));
     }
 }
 
@@ -151,33 +164,39 @@ mp::Path mp::backend::convert_to_qcow_if_necessary(const mp::Path& image_path)
     // TODO: we could support converting from other the image formats that qemu-img can deal with
     const auto qcow2_path{image_path + ".qcow2"};
 
+    // The overwhelmingly common case is an image that is qcow2 already; sniffing the
+    // header in-process spares a qemu-img spawn on every launch
+    if (has_qcow2_magic(image_path))
+        return image_path;
+
     auto qemuimg_info_spec =
         std::make_unique<mp::QemuImgProcessSpec>(QStringList{"info", "--output=json", image_path}, image_path);
-    auto qemuimg_info_process = MP_PROCFACTORY.create_process(std::move(qemuimg_info_spec));
+    auto info_result =
+        MP_QEMUIMG_QUEUE.run(std::move(qemuimg_info_spec), mp::QemuImgJobQueue::Priority::interactive);
 
-    auto process_state = qemuimg_info_process->execute();
-    if (!process_state.completed_successfully())
+    if (!info_result.state.completed_successfully())
     {
         throw std::runtime_error(fmt::format("Cannot read image format: qemu-img failed ({}) with output:\n{}",
-                                             process_state.failure_message(),
-                                             qemuimg_info_process->read_all_standard_error()));
+                                             info_result.state.failure_message(), info_result.error_output));
     }
 
-    auto image_info = qemuimg_info_process->read_all_standard_output();
-    auto image_record = QJsonDocument::fromJson(QString(image_info).toUtf8(), nullptr).object();
+    auto image_record = QJsonDocument::fromJson(QString(info_result.output).toUtf8(), nullptr).object();
 
     if (image_record["format"].toString() == "raw")
     {
+        const mp::StageTimer timer{"vault.convert"};
         auto qemuimg_convert_spec = std::make_unique<mp::QemuImgProcessSpec>(
             QStringList{"convert", "-p", "-O", "qcow2", image_path, qcow2_path}, image_path, qcow2_path);
-        auto qemuimg_convert_process = MP_PROCFACTORY.create_process(std::move(qemuimg_convert_spec));
-        process_state = qemuimg_convert_process->execute(mp::backend::image_resize_timeout);
+        // conversions come out of image preparation, which can happen behind the user's back
+        auto convert_result = MP_QEMUIMG_QUEUE.run(std::move(qemuimg_convert_spec),
+                                                   mp::QemuImgJobQueue::Priority::background,
+                                                   mp::backend::image_resize_timeout);
 
-        if (!process_state.completed_successfully())
+        if (!convert_result.state.completed_successfully())
         {
             throw std::runtime_error(
                 fmt::format("Failed to convert image format: qemu-img failed ({}) with output:\n{}",
-                            process_state.failure_message(), qemuimg_convert_process->read_all_standard_error()));
+                            convert_result.state.failure_message(), convert_result.error_output));
         }
         return qcow2_path;
     }
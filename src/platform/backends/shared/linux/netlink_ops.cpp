@@ -0,0 +1,257 @@
+/*
+ * Copyright (C) 2021 Canonical, Ltd.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; version 3.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "netlink_ops.h"
+
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+
+#include <arpa/inet.h>
+#include <fcntl.h>
+#include <linux/if_tun.h>
+#include <linux/rtnetlink.h>
+#include <net/if.h>
+#include <sys/ioctl.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+namespace mp = multipass;
+
+namespace
+{
+// A single request message: netlink header, family header, then attributes in place.
+// Everything we send fits well within one page.
+template <typename Msg>
+class NetlinkRequest
+{
+public:
+    NetlinkRequest(std::uint16_t type, std::uint16_t flags)
+    {
+        header()->nlmsg_len = NLMSG_LENGTH(sizeof(Msg));
+        header()->nlmsg_type = type;
+        header()->nlmsg_flags = flags;
+    }
+
+    nlmsghdr* header()
+    {
+        return reinterpret_cast<nlmsghdr*>(buf);
+    }
+
+    Msg* payload()
+    {
+        return static_cast<Msg*>(NLMSG_DATA(header()));
+    }
+
+    void add_attr(std::uint16_t type, const void* data, std::size_t len)
+    {
+        auto attr = reinterpret_cast<rtattr*>(buf + NLMSG_ALIGN(header()->nlmsg_len));
+        attr->rta_type = type;
+        attr->rta_len = RTA_LENGTH(len);
+        std::memcpy(RTA_DATA(attr), data, len);
+        header()->nlmsg_len = NLMSG_ALIGN(header()->nlmsg_len) + RTA_ALIGN(attr->rta_len);
+    }
+
+    rtattr* begin_nested(std::uint16_t type)
+    {
+        auto attr = reinterpret_cast<rtattr*>(buf + NLMSG_ALIGN(header()->nlmsg_len));
+        add_attr(type, nullptr, 0);
+        return attr;
+    }
+
+    void end_nested(rtattr* attr)
+    {
+        attr->rta_len = buf + NLMSG_ALIGN(header()->nlmsg_len) - reinterpret_cast<char*>(attr);
+    }
+
+private:
+    alignas(alignof(nlmsghdr)) char buf[1024] = {};
+};
+
+class RtnetlinkSocket
+{
+public:
+    RtnetlinkSocket() : fd{::socket(AF_NETLINK, SOCK_RAW | SOCK_CLOEXEC, NETLINK_ROUTE)}
+    {
+    }
+
+    ~RtnetlinkSocket()
+    {
+        if (fd >= 0)
+            ::close(fd);
+    }
+
+    RtnetlinkSocket(const RtnetlinkSocket&) = delete;
+    RtnetlinkSocket& operator=(const RtnetlinkSocket&) = delete;
+
+    // Sends the request and waits for the kernel's ack; true only on a clean ack
+    bool transact(nlmsghdr* request)
+    {
+        if (fd < 0)
+            return false;
+
+        request->nlmsg_flags |= NLM_F_ACK;
+        if (::send(fd, request, request->nlmsg_len, 0) < 0)
+            return false;
+
+        char reply_buf[4096];
+        const auto received = ::recv(fd, reply_buf, sizeof(reply_buf), 0);
+        if (received <= 0)
+            return false;
+
+        auto len = static_cast<int>(received);
+        for (auto reply = reinterpret_cast<nlmsghdr*>(reply_buf); NLMSG_OK(reply, len);
+             reply = NLMSG_NEXT(reply, len))
+        {
+            if (reply->nlmsg_type == NLMSG_ERROR)
+                return static_cast<const nlmsgerr*>(NLMSG_DATA(reply))->error == 0;
+        }
+
+        return false;
+    }
+
+private:
+    int fd;
+};
+
+bool parse_mac(const std::string& mac_address, unsigned char (&bytes)[6])
+{
+    return std::sscanf(mac_address.c_str(), "%2hhx:%2hhx:%2hhx:%2hhx:%2hhx:%2hhx", &bytes[0], &bytes[1], &bytes[2],
+                       &bytes[3], &bytes[4], &bytes[5]) == 6;
+}
+
+bool create_link(const std::string& name, const char* kind, const std::string& mac_address)
+{
+    NetlinkRequest<ifinfomsg> request{RTM_NEWLINK, NLM_F_REQUEST | NLM_F_CREATE | NLM_F_EXCL};
+    request.payload()->ifi_family = AF_UNSPEC;
+    request.add_attr(IFLA_IFNAME, name.c_str(), name.size() + 1);
+
+    if (!mac_address.empty())
+    {
+        unsigned char mac_bytes[6];
+        if (!parse_mac(mac_address, mac_bytes))
+            return false;
+        request.add_attr(IFLA_ADDRESS, mac_bytes, sizeof(mac_bytes));
+    }
+
+    auto linkinfo = request.begin_nested(IFLA_LINKINFO);
+    request.add_attr(IFLA_INFO_KIND, kind, std::strlen(kind));
+    request.end_nested(linkinfo);
+
+    return RtnetlinkSocket{}.transact(request.header());
+}
+
+bool make_persistent_tap(const std::string& name, short extra_flags)
+{
+    const auto fd = ::open("/dev/net/tun", O_RDWR | O_CLOEXEC);
+    if (fd < 0)
+        return false;
+
+    ifreq ifr{};
+    ifr.ifr_flags = IFF_TAP | IFF_NO_PI | extra_flags;
+    std::strncpy(ifr.ifr_name, name.c_str(), IFNAMSIZ - 1);
+
+    const auto ok = ::ioctl(fd, TUNSETIFF, &ifr) == 0 && ::ioctl(fd, TUNSETPERSIST, 1) == 0;
+    ::close(fd);
+    return ok;
+}
+} // namespace
+
+bool mp::netlink::link_exists(const std::string& name)
+{
+    return ::if_nametoindex(name.c_str()) != 0;
+}
+
+bool mp::netlink::create_bridge(const std::string& name)
+{
+    return create_link(name, "bridge", {});
+}
+
+bool mp::netlink::create_dummy(const std::string& name, const std::string& mac_address)
+{
+    return create_link(name, "dummy", mac_address);
+}
+
+bool mp::netlink::create_tap(const std::string& name)
+{
+    // Multiqueue-capable taps let qemu spread virtio-net processing across vcpus; fall
+    // back to a plain device on kernels without the flag
+    return make_persistent_tap(name, IFF_MULTI_QUEUE) || make_persistent_tap(name, 0);
+}
+
+bool mp::netlink::set_master(const std::string& name, const std::string& master)
+{
+    const auto index = ::if_nametoindex(name.c_str());
+    const std::uint32_t master_index = ::if_nametoindex(master.c_str());
+    if (index == 0 || master_index == 0)
+        return false;
+
+    NetlinkRequest<ifinfomsg> request{RTM_NEWLINK, NLM_F_REQUEST};
+    request.payload()->ifi_family = AF_UNSPEC;
+    request.payload()->ifi_index = index;
+    request.add_attr(IFLA_MASTER, &master_index, sizeof(master_index));
+
+    return RtnetlinkSocket{}.transact(request.header());
+}
+
+bool mp::netlink::add_address(const std::string& name, const std::string& address, int prefix_length,
+                              const std::string& broadcast)
+{
+    const auto index = ::if_nametoindex(name.c_str());
+    in_addr local{}, bcast{};
+    if (index == 0 || ::inet_pton(AF_INET, address.c_str(), &local) != 1 ||
+        ::inet_pton(AF_INET, broadcast.c_str(), &bcast) != 1)
+        return false;
+
+    NetlinkRequest<ifaddrmsg> request{RTM_NEWADDR, NLM_F_REQUEST | NLM_F_CREATE | NLM_F_EXCL};
+    request.payload()->ifa_family = AF_INET;
+    request.payload()->ifa_prefixlen = prefix_length;
+    request.payload()->ifa_index = index;
+    request.add_attr(IFA_LOCAL, &local, sizeof(local));
+    request.add_attr(IFA_ADDRESS, &local, sizeof(local));
+    request.add_attr(IFA_BROADCAST, &bcast, sizeof(bcast));
+
+    return RtnetlinkSocket{}.transact(request.header());
+}
+
+bool mp::netlink::set_up(const std::string& name)
+{
+    const auto index = ::if_nametoindex(name.c_str());
+    if (index == 0)
+        return false;
+
+    NetlinkRequest<ifinfomsg> request{RTM_NEWLINK, NLM_F_REQUEST};
+    request.payload()->ifi_family = AF_UNSPEC;
+    request.payload()->ifi_index = index;
+    request.payload()->ifi_flags = IFF_UP;
+    request.payload()->ifi_change = IFF_UP;
+
+    return RtnetlinkSocket{}.transact(request.header());
+}
+
+bool mp::netlink::delete_link(const std::string& name)
+{
+    const auto index = ::if_nametoindex(name.c_str());
+    if (index == 0)
+        return false;
+
+    NetlinkRequest<ifinfomsg> request{RTM_DELLINK, NLM_F_REQUEST};
+    request.payload()->ifi_family = AF_UNSPEC;
+    request.payload()->ifi_index = index;
+
+    return RtnetlinkSocket{}.transact(request.header());
+}
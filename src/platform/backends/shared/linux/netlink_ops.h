@@ -0,0 +1,41 @@
+/*
+ * Copyright (C) 2021 Canonical, Ltd.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; version 3.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#ifndef MULTIPASS_NETLINK_OPS_H
+#define MULTIPASS_NETLINK_OPS_H
+
+#include <string>
+
+namespace multipass
+{
+// Thin rtnetlink/tun clients for the link operations the backends need. Each call is a
+// handful of syscalls straight against the kernel instead of a process spawn per `ip`
+// invocation; all return false on failure so callers can fall back to iproute2.
+namespace netlink
+{
+bool link_exists(const std::string& name);
+bool create_bridge(const std::string& name);
+bool create_dummy(const std::string& name, const std::string& mac_address);
+bool create_tap(const std::string& name); // multi-queue where the kernel supports it; persistent
+bool set_master(const std::string& name, const std::string& master);
+bool add_address(const std::string& name, const std::string& address, int prefix_length,
+                 const std::string& broadcast);
+bool set_up(const std::string& name);
+bool delete_link(const std::string& name);
+} // namespace netlink
+} // namespace multipass
+#endif // MULTIPASS_NETLINK_OPS_H
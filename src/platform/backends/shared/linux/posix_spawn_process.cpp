@@ -0,0 +1,406 @@
+/*
+ * Copyright (C) 2021 Canonical, Ltd.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; version 3.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "posix_spawn_process.h"
+
+#include <multipass/format.h>
+#include <multipass/logging/log.h>
+
+#include <cerrno>
+#include <cstring>
+#include <vector>
+
+#include <fcntl.h>
+#include <poll.h>
+#include <signal.h>
+#include <spawn.h>
+#include <sys/syscall.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+namespace mp = multipass;
+namespace mpl = multipass::logging;
+
+namespace
+{
+int pidfd_open(pid_t pid)
+{
+#ifdef SYS_pidfd_open
+    return syscall(SYS_pidfd_open, pid, 0);
+#else
+    errno = ENOSYS;
+    return -1;
+#endif
+}
+
+// argv/envp want arrays of mutable char*; keep the backing bytes alive alongside
+class CStringArray
+{
+public:
+    void append(const QByteArray& string)
+    {
+        storage.push_back(string);
+    }
+
+    char** data()
+    {
+        pointers.clear();
+        for (auto& string : storage)
+            pointers.push_back(string.data());
+        pointers.push_back(nullptr);
+        return pointers.data();
+    }
+
+private:
+    std::vector<QByteArray> storage;
+    std::vector<char*> pointers;
+};
+
+bool poll_fd(int fd, short events, int msecs)
+{
+    pollfd poll_request{fd, events, 0};
+    return ::poll(&poll_request, 1, msecs) > 0;
+}
+} // namespace
+
+mp::PosixSpawnProcess::PosixSpawnProcess(std::shared_ptr<mp::ProcessSpec> spec) : process_spec{spec}
+{
+}
+
+mp::PosixSpawnProcess::~PosixSpawnProcess()
+{
+    if (running())
+    {
+        ::kill(pid, SIGKILL);
+        wait_for_finished(1000);
+    }
+
+    close_fds();
+}
+
+bool mp::PosixSpawnProcess::supported()
+{
+    // Exit notification hangs off a pidfd, so without pidfd_open the factory should
+    // stick to QProcess
+    static const auto have_pidfd = [] {
+        auto fd = pidfd_open(getpid());
+        if (fd >= 0)
+        {
+            ::close(fd);
+            return true;
+        }
+        return false;
+    }();
+
+    return have_pidfd;
+}
+
+QString mp::PosixSpawnProcess::program() const
+{
+    return process_spec->program();
+}
+
+QStringList mp::PosixSpawnProcess::arguments() const
+{
+    return process_spec->arguments();
+}
+
+QString mp::PosixSpawnProcess::working_directory() const
+{
+    return process_spec->working_directory();
+}
+
+QProcessEnvironment mp::PosixSpawnProcess::process_environment() const
+{
+    return process_spec->environment();
+}
+
+qint64 mp::PosixSpawnProcess::process_id() const
+{
+    return pid;
+}
+
+void mp::PosixSpawnProcess::start()
+{
+    int stdin_pipe[2], stdout_pipe[2], stderr_pipe[2];
+    if (::pipe2(stdin_pipe, O_CLOEXEC) || ::pipe2(stdout_pipe, O_CLOEXEC) || ::pipe2(stderr_pipe, O_CLOEXEC))
+    {
+        emit error_occurred(QProcess::FailedToStart, error_string());
+        return;
+    }
+
+    posix_spawn_file_actions_t file_actions;
+    posix_spawn_file_actions_init(&file_actions);
+    posix_spawn_file_actions_adddup2(&file_actions, stdin_pipe[0], STDIN_FILENO);
+    posix_spawn_file_actions_adddup2(&file_actions, stdout_pipe[1], STDOUT_FILENO);
+    posix_spawn_file_actions_adddup2(&file_actions,
+                                     channel_mode == QProcess::MergedChannels ? stdout_pipe[1] : stderr_pipe[1],
+                                     STDERR_FILENO);
+
+    posix_spawnattr_t attr;
+    posix_spawnattr_init(&attr);
+    sigset_t empty_mask;
+    sigemptyset(&empty_mask);
+    posix_spawnattr_setsigmask(&attr, &empty_mask);
+    posix_spawnattr_setflags(&attr, POSIX_SPAWN_SETSIGMASK);
+
+    CStringArray argv;
+    argv.append(process_spec->program().toLocal8Bit());
+    for (const auto& arg : process_spec->arguments())
+        argv.append(arg.toLocal8Bit());
+
+    CStringArray envp;
+    for (const auto& entry : process_spec->environment().toStringList())
+        envp.append(entry.toLocal8Bit());
+
+    const auto spawn_error = posix_spawnp(&pid, argv.data()[0], &file_actions, &attr, argv.data(), envp.data());
+
+    posix_spawnattr_destroy(&attr);
+    posix_spawn_file_actions_destroy(&file_actions);
+    ::close(stdin_pipe[0]);
+    ::close(stdout_pipe[1]);
+    ::close(stderr_pipe[1]);
+
+    if (spawn_error)
+    {
+        pid = -1;
+        ::close(stdin_pipe[1]);
+        ::close(stdout_pipe[0]);
+        ::close(stderr_pipe[0]);
+
+        exit_state.error = mp::ProcessState::Error{QProcess::FailedToStart, error_string()};
+        mpl::log(mpl::Level::error, qUtf8Printable(process_spec->program()),
+                 fmt::format("posix_spawn failed: {}", strerror(spawn_error)));
+        emit error_occurred(QProcess::FailedToStart, error_string());
+        return;
+    }
+
+    stdin_fd = stdin_pipe[1];
+    stdout_fd = stdout_pipe[0];
+    stderr_fd = stderr_pipe[0];
+    ::fcntl(stdout_fd, F_SETFL, O_NONBLOCK);
+    ::fcntl(stderr_fd, F_SETFL, O_NONBLOCK);
+
+    pidfd = pidfd_open(pid);
+    exit_notifier = std::make_unique<QSocketNotifier>(pidfd, QSocketNotifier::Read);
+    QObject::connect(exit_notifier.get(), &QSocketNotifier::activated, this, [this] { handle_child_exit(); });
+
+    stdout_notifier = std::make_unique<QSocketNotifier>(stdout_fd, QSocketNotifier::Read);
+    QObject::connect(stdout_notifier.get(), &QSocketNotifier::activated, this,
+                     [this] { read_available(stdout_fd, stdout_buffer, &Process::ready_read_standard_output); });
+
+    stderr_notifier = std::make_unique<QSocketNotifier>(stderr_fd, QSocketNotifier::Read);
+    QObject::connect(stderr_notifier.get(), &QSocketNotifier::activated, this, [this] {
+        const auto already_buffered = stderr_buffer.size();
+        read_available(stderr_fd, stderr_buffer, &Process::ready_read_standard_error);
+        if (stderr_buffer.size() > already_buffered)
+            mpl::log(process_spec->error_log_level(), qUtf8Printable(process_spec->program()),
+                     stderr_buffer.mid(already_buffered).toStdString());
+    });
+
+    mpl::log(mpl::Level::debug, qUtf8Printable(process_spec->program()),
+             fmt::format("[{}] spawned: {} {}", pid, qUtf8Printable(process_spec->program()),
+                         qUtf8Printable(process_spec->arguments().join(' '))));
+
+    emit state_changed(QProcess::Running);
+    emit started();
+}
+
+void mp::PosixSpawnProcess::terminate()
+{
+    if (running())
+        ::kill(pid, SIGTERM);
+}
+
+void mp::PosixSpawnProcess::kill()
+{
+    if (running())
+        ::kill(pid, SIGKILL);
+}
+
+bool mp::PosixSpawnProcess::wait_for_started(int msecs)
+{
+    // posix_spawn has no started handshake: a successful spawn is a started child. An
+    // unexecvable program surfaces as an exit, the way QProcess reports a FailedToStart.
+    return pid > 0;
+}
+
+bool mp::PosixSpawnProcess::wait_for_finished(int msecs)
+{
+    if (reaped)
+        return true;
+
+    if (pid <= 0 || !poll_fd(pidfd, POLLIN, msecs))
+        return false;
+
+    handle_child_exit();
+    return true;
+}
+
+bool mp::PosixSpawnProcess::wait_for_ready_read(int msecs)
+{
+    return stdout_fd >= 0 && poll_fd(stdout_fd, POLLIN, msecs);
+}
+
+bool mp::PosixSpawnProcess::running() const
+{
+    return pid > 0 && !reaped;
+}
+
+mp::ProcessState mp::PosixSpawnProcess::process_state() const
+{
+    return exit_state;
+}
+
+QString mp::PosixSpawnProcess::error_string() const
+{
+    return QString{"program: %1; error: %2"}.arg(process_spec->program(), QString::fromLocal8Bit(strerror(errno)));
+}
+
+QByteArray mp::PosixSpawnProcess::read_all_standard_output()
+{
+    read_available(stdout_fd, stdout_buffer, nullptr);
+    auto data = stdout_buffer;
+    stdout_buffer.clear();
+    return data;
+}
+
+QByteArray mp::PosixSpawnProcess::read_all_standard_error()
+{
+    read_available(stderr_fd, stderr_buffer, nullptr);
+    auto data = stderr_buffer;
+    stderr_buffer.clear();
+    return data;
+}
+
+qint64 mp::PosixSpawnProcess::write(const QByteArray& data)
+{
+    if (stdin_fd < 0)
+        return -1;
+
+    return ::write(stdin_fd, data.constData(), data.size());
+}
+
+void mp::PosixSpawnProcess::close_write_channel()
+{
+    if (stdin_fd >= 0)
+    {
+        ::close(stdin_fd);
+        stdin_fd = -1;
+    }
+}
+
+void mp::PosixSpawnProcess::set_process_channel_mode(QProcess::ProcessChannelMode mode)
+{
+    channel_mode = mode; // honoured at spawn time
+}
+
+mp::ProcessState mp::PosixSpawnProcess::execute(const int timeout)
+{
+    start();
+
+    if (exit_state.error)
+        return exit_state;
+
+    if (!wait_for_finished(timeout))
+    {
+        mpl::log(mpl::Level::error, qUtf8Printable(process_spec->program()), "timed out waiting to finish");
+        mp::ProcessState timeout_state;
+        timeout_state.error = mp::ProcessState::Error{QProcess::Timedout, error_string()};
+        return timeout_state;
+    }
+
+    return exit_state;
+}
+
+void mp::PosixSpawnProcess::setup_child_process()
+{
+    // no in-child hooks with posix_spawn; the factory keeps consumers needing them on QProcess
+}
+
+void mp::PosixSpawnProcess::read_available(int& fd, QByteArray& buffer, void (Process::*ready_signal)())
+{
+    if (fd < 0)
+        return;
+
+    char chunk[4096];
+    ssize_t bytes_read;
+    auto had_data = false;
+    while ((bytes_read = ::read(fd, chunk, sizeof(chunk))) > 0)
+    {
+        buffer.append(chunk, bytes_read);
+        had_data = true;
+    }
+
+    if (had_data && ready_signal)
+        emit(this->*ready_signal)();
+}
+
+void mp::PosixSpawnProcess::drain_pipes()
+{
+    // switch to blocking reads, the writer is gone so EOF is immediate
+    if (stdout_fd >= 0)
+        ::fcntl(stdout_fd, F_SETFL, 0);
+    if (stderr_fd >= 0)
+        ::fcntl(stderr_fd, F_SETFL, 0);
+
+    read_available(stdout_fd, stdout_buffer, &Process::ready_read_standard_output);
+    read_available(stderr_fd, stderr_buffer, &Process::ready_read_standard_error);
+}
+
+void mp::PosixSpawnProcess::handle_child_exit()
+{
+    if (reaped)
+        return;
+
+    int wait_status;
+    if (::waitpid(pid, &wait_status, 0) != pid)
+        return;
+
+    reaped = true;
+    if (exit_notifier)
+        exit_notifier->setEnabled(false);
+
+    drain_pipes();
+
+    if (WIFEXITED(wait_status))
+    {
+        exit_state.exit_code = WEXITSTATUS(wait_status);
+    }
+    else
+    {
+        exit_state.error = mp::ProcessState::Error{
+            QProcess::Crashed,
+            QString{"program: %1; error: killed by signal %2"}.arg(process_spec->program()).arg(WTERMSIG(wait_status))};
+        emit error_occurred(QProcess::Crashed, exit_state.error->message);
+    }
+
+    emit state_changed(QProcess::NotRunning);
+    emit finished(exit_state);
+}
+
+void mp::PosixSpawnProcess::close_fds()
+{
+    for (auto* fd : {&stdin_fd, &stdout_fd, &stderr_fd, &pidfd})
+    {
+        if (*fd >= 0)
+        {
+            ::close(*fd);
+            *fd = -1;
+        }
+    }
+}
@@ -0,0 +1,105 @@
+/*
+ * Copyright (C) 2021 Canonical, Ltd.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; version 3.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#ifndef MULTIPASS_POSIX_SPAWN_PROCESS_H
+#define MULTIPASS_POSIX_SPAWN_PROCESS_H
+
+#include <multipass/process/process.h>
+#include <multipass/process/process_spec.h>
+
+#include <QSocketNotifier>
+
+#include <memory>
+
+#include <sys/types.h>
+
+namespace multipass
+{
+
+// PosixSpawnProcess implements the Process interface on top of posix_spawn(3). Unlike
+// QProcess it does not fork() the parent, so spawning a helper does not pay for copying
+// the daemon's page tables, which gets expensive once the daemon's RSS grows. Child exit
+// is observed through a pidfd, so it cannot host children that need in-child setup
+// (apparmor transitions) nor a working directory; the factory falls back to BasicProcess
+// for those.
+
+class PosixSpawnProcess : public Process
+{
+    Q_OBJECT
+public:
+    PosixSpawnProcess(std::shared_ptr<ProcessSpec> spec);
+    virtual ~PosixSpawnProcess();
+
+    static bool supported(); // whether the host provides what async child tracking needs
+
+    QString program() const override;
+    QStringList arguments() const override;
+    QString working_directory() const override;
+    QProcessEnvironment process_environment() const override;
+    qint64 process_id() const override;
+
+    void start() override;
+    void terminate() override;
+    void kill() override;
+
+    bool wait_for_started(int msecs = 30000) override;
+    bool wait_for_finished(int msecs = 30000) override;
+    bool wait_for_ready_read(int msecs = 30000) override;
+
+    bool running() const override;
+    ProcessState process_state() const override;
+    QString error_string() const override;
+
+    QByteArray read_all_standard_output() override;
+    QByteArray read_all_standard_error() override;
+
+    qint64 write(const QByteArray& data) override;
+    void close_write_channel() override;
+    void set_process_channel_mode(QProcess::ProcessChannelMode mode) override;
+
+    ProcessState execute(const int timeout = 30000) override;
+
+protected:
+    void setup_child_process() override;
+
+private:
+    void read_available(int& fd, QByteArray& buffer, void (Process::*ready_signal)());
+    void drain_pipes();
+    void handle_child_exit();
+    void close_fds();
+
+    const std::shared_ptr<ProcessSpec> process_spec;
+    QProcess::ProcessChannelMode channel_mode{QProcess::SeparateChannels};
+
+    pid_t pid{-1};
+    int pidfd{-1};
+    int stdin_fd{-1};
+    int stdout_fd{-1};
+    int stderr_fd{-1};
+    std::unique_ptr<QSocketNotifier> exit_notifier;
+    std::unique_ptr<QSocketNotifier> stdout_notifier;
+    std::unique_ptr<QSocketNotifier> stderr_notifier;
+
+    QByteArray stdout_buffer;
+    QByteArray stderr_buffer;
+    bool reaped{false};
+    ProcessState exit_state;
+};
+
+} // namespace multipass
+
+#endif // MULTIPASS_POSIX_SPAWN_PROCESS_H
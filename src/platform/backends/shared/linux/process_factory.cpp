@@ -16,6 +16,7 @@
  */
 
 #include "process_factory.h"
+#include "posix_spawn_process.h"
 
 #include <multipass/exceptions/snap_environment_exception.h>
 #include <multipass/format.h>
@@ -115,7 +116,15 @@ std::unique_ptr<mp::Process> mp::ProcessFactory::create_process(std::unique_ptr<
     }
     else
     {
-        return std::make_unique<BasicProcess>(std::move(process_spec));
+        std::shared_ptr<ProcessSpec> spec = std::move(process_spec);
+
+        // Unconfined children with no working directory can skip QProcess's fork() of the
+        // whole daemon address space and go straight through posix_spawn
+        if (PosixSpawnProcess::supported() && spec->working_directory().isNull() &&
+            !qEnvironmentVariableIsSet("MULTIPASS_DISABLE_POSIX_SPAWN"))
+            return std::make_unique<PosixSpawnProcess>(spec);
+
+        return std::make_unique<BasicProcess>(spec);
     }
 }
 
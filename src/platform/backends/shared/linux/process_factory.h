@@ -39,6 +39,13 @@ public:
     virtual std::unique_ptr<Process> create_process(std::unique_ptr<ProcessSpec>&& process_spec) const;
     std::unique_ptr<Process> create_process(const QString& command, const QStringList& args = QStringList()) const;
 
+    // Whether children carrying a profile will actually be confined; some spawn
+    // strategies only make sense when they won't be
+    bool uses_apparmor() const
+    {
+        return apparmor.has_value();
+    }
+
 private:
     const multipass::optional<AppArmor> apparmor;
 };
@@ -40,6 +40,20 @@ QString serialise_id_map(const std::unordered_map<int, int>& id_map)
     return out;
 }
 
+// Lines of "source<TAB>target<TAB>gid_map<TAB>uid_map", consumed by sshfs_server; paths
+// may contain anything but tabs and newlines, which the mount validation already rejects
+QString serialise_extra_mounts(const std::vector<mp::SSHFSExtraMount>& mounts)
+{
+    QString out;
+    for (const auto& mount : mounts)
+    {
+        out += QString("%1\t%2\t%3\t%4\n")
+                   .arg(QString::fromStdString(mount.source_path), QString::fromStdString(mount.target_path),
+                        serialise_id_map(mount.gid_map), serialise_id_map(mount.uid_map));
+    }
+    return out;
+}
+
 QByteArray gen_hash(const std::string& path)
 {
     // need to return unique name for each mount.  The target directory string will be unique,
@@ -71,6 +85,10 @@ QProcessEnvironment mp::SSHFSServerProcessSpec::environment() const
 {
     QProcessEnvironment env = QProcessEnvironment::systemEnvironment();
     env.insert("KEY", QString::fromStdString(config.private_key));
+    if (!config.extra_mounts.empty())
+        env.insert("EXTRA_MOUNTS", serialise_extra_mounts(config.extra_mounts));
+    if (!config.sshfs_exec_line.empty())
+        env.insert("SSHFS_EXEC_LINE", QString::fromStdString(config.sshfs_exec_line));
     return env;
 }
 
@@ -118,7 +136,7 @@ profile %1 flags=(attach_disconnected) {
     # allow full access just to this user-specified source directory on the host
     %4/ rw,
     %4/** rwlk,
-}
+%5}
     )END");
 
     /* Customisations depending on if running inside snap or not */
@@ -139,8 +157,16 @@ profile %1 flags=(attach_disconnected) {
         signal_peer = "unconfined";
     }
 
+    // a consolidated server serves several shares, each of which needs the same access
+    QString extra_mount_rules;
+    for (const auto& mount : config.extra_mounts)
+    {
+        const auto source = QString::fromStdString(mount.source_path);
+        extra_mount_rules += QString("    %1/ rw,\n    %1/** rwlk,\n").arg(source);
+    }
+
     return profile_template.arg(apparmor_profile_name(), signal_peer, root_dir,
-                                QString::fromStdString(config.source_path));
+                                QString::fromStdString(config.source_path), extra_mount_rules);
 }
 
 QString mp::SSHFSServerProcessSpec::identifier() const
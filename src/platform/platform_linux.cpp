@@ -38,6 +38,16 @@
 #include "shared/sshfs_server_process_spec.h"
 #include <disabled_update_prompt.h>
 
+#include <QCoreApplication>
+
+#include <cerrno>
+#include <mutex>
+
+#include <linux/netlink.h>
+#include <linux/rtnetlink.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
 namespace mp = multipass;
 namespace mpl = multipass::logging;
 namespace mu = multipass::utils;
@@ -59,11 +69,82 @@ mp::NetworkInterfaceInfo get_network(const QDir& net_dir)
 
     return mp::NetworkInterfaceInfo{net_dir.dirName().toStdString(), std::move(type), std::move(description)};
 }
+
+// Caches the /sys walk behind a netlink link subscription: the scan is redone only after
+// the kernel reports a link change, so a steady host answers repeat queries from memory
+// while hotplug still shows up on the very next call
+class NetworkInterfaceCache
+{
+public:
+    std::map<std::string, mp::NetworkInterfaceInfo> interfaces_info()
+    {
+        const std::lock_guard<std::mutex> lock{mutex};
+
+        if (!subscribed)
+        {
+            subscribe();
+            subscribed = true;
+        }
+
+        if (netlink_fd < 0) // without netlink there is no way to observe changes; scan every time
+            return scan();
+
+        if (!cache_valid || drain_link_events())
+        {
+            cached_info = scan();
+            cache_valid = true;
+        }
+
+        return cached_info;
+    }
+
+private:
+    static std::map<std::string, mp::NetworkInterfaceInfo> scan()
+    {
+        return mp::platform::detail::get_network_interfaces_from(QDir{QStringLiteral("/sys/class/net")});
+    }
+
+    void subscribe()
+    {
+        netlink_fd = ::socket(AF_NETLINK, SOCK_RAW | SOCK_NONBLOCK | SOCK_CLOEXEC, NETLINK_ROUTE);
+        if (netlink_fd < 0)
+            return;
+
+        sockaddr_nl addr{};
+        addr.nl_family = AF_NETLINK;
+        addr.nl_groups = RTMGRP_LINK;
+        if (::bind(netlink_fd, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) < 0)
+        {
+            ::close(netlink_fd);
+            netlink_fd = -1;
+        }
+    }
+
+    bool drain_link_events()
+    {
+        char buffer[4096];
+        auto events_seen = false;
+        while (::recv(netlink_fd, buffer, sizeof(buffer), 0) > 0)
+            events_seen = true; // only link messages are subscribed, so any payload means change
+
+        if (errno == ENOBUFS) // overran the socket buffer, so events were dropped; assume change
+            events_seen = true;
+
+        return events_seen;
+    }
+
+    std::mutex mutex;
+    std::map<std::string, mp::NetworkInterfaceInfo> cached_info;
+    bool cache_valid{false};
+    bool subscribed{false};
+    int netlink_fd{-1};
+};
 } // namespace
 
 std::map<std::string, mp::NetworkInterfaceInfo> mp::platform::Platform::get_network_interfaces_info() const
 {
-    return detail::get_network_interfaces_from(QDir{QStringLiteral("/sys/class/net")});
+    static NetworkInterfaceCache cache;
+    return cache.interfaces_info();
 }
 
 bool mp::platform::Platform::is_alias_supported(const std::string& alias, const std::string& remote)
@@ -176,6 +257,18 @@ std::unique_ptr<mp::Process> mp::platform::make_sshfs_server_process(const mp::S
     return MP_PROCFACTORY.create_process(std::make_unique<mp::SSHFSServerProcessSpec>(config));
 }
 
+std::unique_ptr<mp::Process> mp::platform::make_pooled_sshfs_server_process()
+{
+    // A pre-spawned server cannot run under the per-mount AppArmor profile, which is
+    // pinned at exec around the one directory being shared; confined setups keep cold
+    // spawns and pay the exec per mount
+    if (MP_PROCFACTORY.uses_apparmor())
+        return nullptr;
+
+    return MP_PROCFACTORY.create_process(QCoreApplication::applicationDirPath() + "/sshfs_server",
+                                         QStringList{QStringLiteral("--pooled")});
+}
+
 std::unique_ptr<mp::Process> mp::platform::make_process(std::unique_ptr<mp::ProcessSpec>&& process_spec)
 {
     return MP_PROCFACTORY.create_process(std::move(process_spec));
@@ -19,8 +19,11 @@
 #include "new_release_monitor.h"
 
 #include <multipass/rpc/multipass.grpc.pb.h>
+#include <multipass/standard_paths.h>
 #include <multipass/version.h>
 
+#include <QDir>
+
 namespace mp = multipass;
 
 namespace
@@ -30,7 +33,9 @@ constexpr auto notify_user_frequency = std::chrono::hours(6);
 } // namespace
 
 mp::DefaultUpdatePrompt::DefaultUpdatePrompt()
-    : monitor{std::make_unique<NewReleaseMonitor>(mp::version_string, ::new_release_check_frequency)},
+    : monitor{std::make_unique<NewReleaseMonitor>(
+          mp::version_string, ::new_release_check_frequency, NewReleaseMonitor::default_update_url,
+          QDir{MP_STDPATHS.writableLocation(StandardPaths::CacheLocation)}.filePath("latest-release.json"))},
       last_shown{std::chrono::system_clock::now() - notify_user_frequency} // so we show update message soon after start
 {
 }
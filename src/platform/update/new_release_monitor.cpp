@@ -23,6 +23,7 @@
 
 #include <semver200.h>
 
+#include <QFile>
 #include <QJsonDocument>
 #include <QJsonObject>
 #include <QThread>
@@ -101,11 +102,15 @@ private:
 };
 
 mp::NewReleaseMonitor::NewReleaseMonitor(const QString& current_version,
-                                         std::chrono::steady_clock::duration refresh_rate, const QString& update_url)
-    : current_version(current_version), update_url(update_url)
+                                         std::chrono::steady_clock::duration refresh_rate, const QString& update_url,
+                                         const QString& cache_file_path)
+    : current_version(current_version), update_url(update_url), cache_file_path(cache_file_path)
 {
     qRegisterMetaType<multipass::NewReleaseInfo>(); // necessary to allow custom type be passed in signal/slot
 
+    // Serve the last known release info right away; the refresher replaces it in the
+    // background on its own schedule, so replies never wait on the network
+    load_cached_release();
     check_for_new_release();
 
     refresh_timer.setInterval(std::chrono::duration_cast<std::chrono::milliseconds>(refresh_rate));
@@ -117,10 +122,17 @@ mp::NewReleaseMonitor::~NewReleaseMonitor() = default;
 
 mp::optional<mp::NewReleaseInfo> mp::NewReleaseMonitor::get_new_release() const
 {
+    std::lock_guard<std::mutex> lock{release_mutex};
     return new_release;
 }
 
 void mp::NewReleaseMonitor::latest_release_found(const NewReleaseInfo& latest_release)
+{
+    apply_release_if_newer(latest_release);
+    persist_cached_release(latest_release);
+}
+
+void mp::NewReleaseMonitor::apply_release_if_newer(const NewReleaseInfo& latest_release)
 {
     try
     {
@@ -129,6 +141,7 @@ void mp::NewReleaseMonitor::latest_release_found(const NewReleaseInfo& latest_re
         if (version::Semver200_version(current_version.toStdString()) <
             version::Semver200_version(latest_release.version.toStdString()))
         {
+            std::lock_guard<std::mutex> lock{release_mutex};
             new_release = latest_release;
             mpl::log(mpl::Level::info, "update",
                      fmt::format("A New Multipass release is available: {}", qUtf8Printable(new_release->version)));
@@ -142,6 +155,44 @@ void mp::NewReleaseMonitor::latest_release_found(const NewReleaseInfo& latest_re
     }
 }
 
+void mp::NewReleaseMonitor::load_cached_release()
+{
+    if (cache_file_path.isEmpty())
+        return;
+
+    QFile cache_file{cache_file_path};
+    if (!cache_file.open(QIODevice::ReadOnly))
+        return;
+
+    const auto manifest = QJsonDocument::fromJson(cache_file.readAll()).object();
+    if (!manifest.contains(::json_tag_name) || !manifest.contains(::json_html_url))
+        return;
+
+    NewReleaseInfo release;
+    release.version = manifest[::json_tag_name].toString();
+    release.url = manifest[::json_html_url].toString();
+    release.title = manifest[::json_title].toString();
+    release.description = manifest[::json_description].toString();
+
+    apply_release_if_newer(release);
+}
+
+void mp::NewReleaseMonitor::persist_cached_release(const NewReleaseInfo& latest_release)
+{
+    if (cache_file_path.isEmpty())
+        return;
+
+    QJsonObject manifest;
+    manifest[::json_tag_name] = latest_release.version;
+    manifest[::json_html_url] = QString::fromUtf8(latest_release.url.toEncoded());
+    manifest[::json_title] = latest_release.title;
+    manifest[::json_description] = latest_release.description;
+
+    QFile cache_file{cache_file_path};
+    if (cache_file.open(QIODevice::WriteOnly))
+        cache_file.write(QJsonDocument(manifest).toJson(QJsonDocument::Compact));
+}
+
 void mp::NewReleaseMonitor::check_for_new_release()
 {
     if (!worker_thread)
@@ -26,6 +26,8 @@
 #include <QString>
 #include <QTimer>
 
+#include <mutex>
+
 namespace multipass
 {
 class LatestReleaseChecker;
@@ -47,17 +49,22 @@ public:
     static constexpr auto default_update_url = "https://multipass.run/static/latest-release.json";
 
     NewReleaseMonitor(const QString& current_version, std::chrono::steady_clock::duration refresh_rate,
-                      const QString& update_url = default_update_url);
+                      const QString& update_url = default_update_url, const QString& cache_file_path = QString());
     ~NewReleaseMonitor();
 
-    optional<NewReleaseInfo> get_new_release() const;
+    optional<NewReleaseInfo> get_new_release() const; // cache-only, never blocks on the network
 
 private slots:
     void check_for_new_release();
     void latest_release_found(const NewReleaseInfo& latest_release);
 
 private:
-    const QString current_version, update_url;
+    void apply_release_if_newer(const NewReleaseInfo& latest_release);
+    void load_cached_release();
+    void persist_cached_release(const NewReleaseInfo& latest_release);
+
+    const QString current_version, update_url, cache_file_path;
+    mutable std::mutex release_mutex; // RPC handler threads read while the refresher writes
     optional<NewReleaseInfo> new_release;
     QTimer refresh_timer;
 
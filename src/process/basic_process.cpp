@@ -76,9 +76,20 @@ mp::BasicProcess::BasicProcess(std::shared_ptr<mp::ProcessSpec> spec) : process_
         // This copies the implementation of QProcess::readAllStandardError() replacing the read with peek.
         auto original = process.readChannel();
         process.setReadChannel(QProcess::StandardError);
-        QByteArray data = process.peek(process.bytesAvailable());
+        auto available = process.bytesAvailable();
+        if (stderr_bytes_logged > available) // a consumer drained the buffer; what remains is all new
+            stderr_bytes_logged = 0;
+        QByteArray data = process.peek(available);
         process.setReadChannel(original);
-        mpl::log(process_spec->error_log_level(), qUtf8Printable(process_spec->program()), qUtf8Printable(data));
+
+        // Only the bytes that arrived since the last event get logged; re-logging the
+        // whole retained buffer made long-lived chatty children quadratic in log volume
+        if (data.size() > stderr_bytes_logged)
+        {
+            mpl::log(process_spec->error_log_level(), qUtf8Printable(process_spec->program()),
+                     qUtf8Printable(data.mid(stderr_bytes_logged)));
+            stderr_bytes_logged = data.size();
+        }
     });
 }
 
@@ -216,8 +227,8 @@ void mp::BasicProcess::handle_started()
     pid = process.processId(); // save this, so we know it even after finished
     const auto& program = qUtf8Printable(process_spec->program());
 
-    mpl::log(mpl::Level::debug, program,
-             fmt::format("[{}] started: {} {}", pid, program, qUtf8Printable(process_spec->arguments().join(' '))));
+    mpl::log(mpl::Level::debug, program, "[{}] started: {} {}", pid, program,
+             qUtf8Printable(process_spec->arguments().join(' ')));
 
     emit mp::Process::started();
 }
@@ -0,0 +1,81 @@
+/*
+ * Copyright (C) 2021 Canonical, Ltd.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; version 3.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include <multipass/process/process.h>
+
+namespace mp = multipass;
+
+namespace
+{
+constexpr int max_record_size = 64 * 1024;
+
+// Appends the new data to the carried partial record and dispatches every complete one.
+// Records end at '\n' or '\r', so qemu-img's carriage-return progress updates arrive as
+// they are painted; a record outgrowing the cap is flushed in chunks, keeping the carry
+// buffer bounded no matter what the child writes.
+void dispatch_records(QByteArray& carry, const QByteArray& data, const mp::Process::LineCallback& callback)
+{
+    carry.append(data);
+
+    int start = 0;
+    for (int i = 0; i < carry.size(); ++i)
+    {
+        if (carry[i] == '\n' || carry[i] == '\r')
+        {
+            callback(carry.mid(start, i + 1 - start));
+            start = i + 1;
+        }
+    }
+
+    carry.remove(0, start);
+    if (carry.size() >= max_record_size)
+    {
+        callback(carry);
+        carry.clear();
+    }
+}
+} // namespace
+
+void mp::Process::stream_standard_output(LineCallback callback)
+{
+    auto carry = std::make_shared<QByteArray>();
+    connect(this, &Process::ready_read_standard_output,
+            [this, carry, callback] { dispatch_records(*carry, read_all_standard_output(), callback); });
+    connect(this, &Process::finished, [this, carry, callback](const ProcessState&) {
+        dispatch_records(*carry, read_all_standard_output(), callback);
+        if (!carry->isEmpty()) // the child's last record may lack a terminator
+        {
+            callback(*carry);
+            carry->clear();
+        }
+    });
+}
+
+void mp::Process::stream_standard_error(LineCallback callback)
+{
+    auto carry = std::make_shared<QByteArray>();
+    connect(this, &Process::ready_read_standard_error,
+            [this, carry, callback] { dispatch_records(*carry, read_all_standard_error(), callback); });
+    connect(this, &Process::finished, [this, carry, callback](const ProcessState&) {
+        dispatch_records(*carry, read_all_standard_error(), callback);
+        if (!carry->isEmpty())
+        {
+            callback(*carry);
+            carry->clear();
+        }
+    });
+}
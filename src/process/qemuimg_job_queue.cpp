@@ -0,0 +1,100 @@
+/*
+ * Copyright (C) 2021 Canonical, Ltd.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; version 3.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include <multipass/logging/log.h>
+#include <multipass/platform.h>
+#include <multipass/process/qemuimg_job_queue.h>
+
+#include <multipass/format.h>
+
+#include <QRunnable>
+
+#include <algorithm>
+#include <future>
+#include <thread>
+
+namespace mp = multipass;
+namespace mpl = multipass::logging;
+
+namespace
+{
+constexpr auto category = "qemu-img-queue";
+
+// qemu-img jobs are disk bound, so running one per core just thrashes the spindle or
+// the SSD's write cache; a couple in flight keeps the disk busy without seek storms
+auto max_concurrent_jobs()
+{
+    return std::max(2u, std::thread::hardware_concurrency() / 4);
+}
+
+class QemuImgJob : public QRunnable
+{
+public:
+    QemuImgJob(std::unique_ptr<mp::QemuImgProcessSpec>&& spec, int timeout,
+               std::promise<mp::QemuImgJobQueue::Result>&& promise, mp::Process::LineCallback output_line_callback)
+        : spec{std::move(spec)},
+          timeout{timeout},
+          promise{std::move(promise)},
+          output_line_callback{std::move(output_line_callback)}
+    {
+    }
+
+    void run() override
+    {
+        mp::QemuImgJobQueue::Result result;
+        auto process = mp::platform::make_process(std::move(spec));
+
+        // Streaming drains output as it is produced, so a long convert neither buffers
+        // its whole output in memory nor delays progress records until the end
+        if (output_line_callback)
+            process->stream_standard_output(output_line_callback);
+
+        result.state = process->execute(timeout);
+        result.output = process->read_all_standard_output();
+        result.error_output = process->read_all_standard_error();
+
+        promise.set_value(std::move(result));
+    }
+
+private:
+    std::unique_ptr<mp::QemuImgProcessSpec> spec;
+    const int timeout;
+    std::promise<mp::QemuImgJobQueue::Result> promise;
+    const mp::Process::LineCallback output_line_callback;
+};
+} // namespace
+
+mp::QemuImgJobQueue::QemuImgJobQueue(const Singleton<QemuImgJobQueue>::PrivatePass& pass)
+    : Singleton<QemuImgJobQueue>::Singleton{pass}
+{
+    job_pool.setMaxThreadCount(max_concurrent_jobs());
+    mpl::log(mpl::Level::debug, category,
+             fmt::format("running at most {} qemu-img jobs", job_pool.maxThreadCount()));
+}
+
+mp::QemuImgJobQueue::Result mp::QemuImgJobQueue::run(std::unique_ptr<mp::QemuImgProcessSpec>&& spec, Priority priority,
+                                                     int timeout, mp::Process::LineCallback output_line_callback)
+{
+    std::promise<Result> promise;
+    auto future = promise.get_future();
+
+    // QRunnable rather than QtConcurrent, to get a say in the queue order
+    job_pool.start(new QemuImgJob{std::move(spec), timeout, std::move(promise), std::move(output_line_callback)},
+                   static_cast<int>(priority));
+
+    return future.get();
+}
@@ -26,6 +26,8 @@
 #include <multipass/exceptions/manifest_exceptions.h>
 #include <multipass/utils.h>
 
+#include <algorithm>
+
 namespace mp = multipass;
 
 namespace
@@ -166,17 +168,23 @@ std::unique_ptr<mp::SimpleStreamsManifest> mp::SimpleStreamsManifest::fromJson(c
     if (products.empty())
         throw mp::EmptyManifestException("No supported products found.");
 
-    QMap<QString, const VMImageInfo*> map;
+    QHash<QString, const VMImageInfo*> map;
+    std::vector<std::pair<QString, const VMImageInfo*>> sorted_ids;
+    sorted_ids.reserve(products.size());
 
     for (const auto& product : products)
     {
         map[product.id] = &product;
+        sorted_ids.emplace_back(product.id, &product);
         for (const auto& alias : product.aliases)
         {
             map[alias] = &product;
         }
     }
 
+    std::sort(sorted_ids.begin(), sorted_ids.end(),
+              [](const auto& a, const auto& b) { return a.first < b.first; });
+
     return std::unique_ptr<SimpleStreamsManifest>(
-        new SimpleStreamsManifest{updated, std::move(products), std::move(map)});
+        new SimpleStreamsManifest{updated, std::move(products), std::move(map), std::move(sorted_ids)});
 }
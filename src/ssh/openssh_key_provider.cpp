@@ -67,12 +67,23 @@ void mp::OpenSSHKeyProvider::KeyDeleter::operator()(ssh_key key)
 }
 
 mp::OpenSSHKeyProvider::OpenSSHKeyProvider(const mp::Path& cache_dir)
-    : ssh_key_dir{mp::utils::make_dir(cache_dir, "ssh-keys")}, priv_key{get_priv_key(ssh_key_dir)}
+    : ssh_key_dir{mp::utils::make_dir(cache_dir, "ssh-keys")},
+      pending_key{std::async(std::launch::async, [key_dir = ssh_key_dir] { return get_priv_key(key_dir); })}
 {
 }
 
+const mp::OpenSSHKeyProvider::KeyUPtr& mp::OpenSSHKeyProvider::key() const
+{
+    std::lock_guard<std::mutex> lock{key_mutex};
+    if (pending_key.valid())
+        priv_key = pending_key.get();
+    return priv_key;
+}
+
 std::string mp::OpenSSHKeyProvider::private_key_as_base64() const
 {
+    key(); // ensure generation has finished and the key file exists
+
     QFile key_file{ssh_key_dir.filePath("id_rsa")};
     auto opened = key_file.open(QIODevice::ReadOnly);
     if (!opened)
@@ -85,17 +96,25 @@ std::string mp::OpenSSHKeyProvider::private_key_as_base64() const
 
 std::string mp::OpenSSHKeyProvider::public_key_as_base64() const
 {
-    char* base64{nullptr};
-    auto ret = ssh_pki_export_pubkey_base64(priv_key.get(), &base64);
-    std::unique_ptr<char, decltype(std::free)*> base64_output{base64, std::free};
+    const auto& priv = key();
 
-    if (ret != SSH_OK)
-        throw std::runtime_error("unable to export public key as base64");
+    std::lock_guard<std::mutex> lock{key_mutex};
+    if (public_key_cache.empty())
+    {
+        char* base64{nullptr};
+        auto ret = ssh_pki_export_pubkey_base64(priv.get(), &base64);
+        std::unique_ptr<char, decltype(std::free)*> base64_output{base64, std::free};
+
+        if (ret != SSH_OK)
+            throw std::runtime_error("unable to export public key as base64");
+
+        public_key_cache = base64;
+    }
 
-    return {base64};
+    return public_key_cache;
 }
 
 ssh_key mp::OpenSSHKeyProvider::private_key() const
 {
-    return priv_key.get();
+    return key().get();
 }
@@ -24,8 +24,22 @@
 #include <multipass/format.h>
 
 #include <array>
+#include <cerrno>
+#include <cstring>
+#include <deque>
+#include <functional>
+#include <unordered_set>
+#include <vector>
+
 #include <fcntl.h>
 
+#ifdef Q_OS_LINUX
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+#include <QDir>
+#include <QDirIterator>
 #include <QFile>
 
 namespace mp = multipass;
@@ -34,10 +48,14 @@ namespace
 {
 // TODO: For push/pull, use actual file permissions
 constexpr int file_mode = 0664;
+constexpr int dir_mode = 0775;
 constexpr auto max_transfer = 65536u;
+constexpr auto max_in_flight_reads = 64u; // mirrors OpenSSH sftp's outstanding-request window
 const std::string stream_file_name{"stream_output.dat"};
 
 using SFTPFileUPtr = std::unique_ptr<sftp_file_struct, int (*)(sftp_file)>;
+using SFTPDirUPtr = std::unique_ptr<sftp_dir_struct, int (*)(sftp_dir)>;
+using SFTPAttributesUPtr = std::unique_ptr<sftp_attributes_struct, void (*)(sftp_attributes)>;
 
 mp::SFTPSessionUPtr make_sftp_session(ssh_session session)
 {
@@ -49,6 +67,112 @@ mp::SFTPSessionUPtr make_sftp_session(ssh_session session)
     return sftp;
 }
 
+// Downloads with a window of outstanding read requests so round trips overlap; replies
+// are consumed in issue order, keeping the sink strictly sequential. A short reply would
+// leave a gap before the already-issued requests, so any gap is filled synchronously.
+void pipelined_pull(sftp_session sftp, SSHSession& ssh_session, sftp_file file, uint64_t total_size,
+                    const std::function<void(const char*, std::size_t)>& sink)
+{
+    struct PendingRead
+    {
+        int id;
+        uint64_t offset;
+        std::size_t length;
+    };
+
+    std::deque<PendingRead> outstanding;
+    std::vector<char> data(max_transfer);
+    uint64_t next_offset = 0;
+
+    while (next_offset < total_size || !outstanding.empty())
+    {
+        while (next_offset < total_size && outstanding.size() < max_in_flight_reads)
+        {
+            auto length = static_cast<std::size_t>(std::min<uint64_t>(max_transfer, total_size - next_offset));
+
+            sftp_seek64(file, next_offset);
+            auto id = sftp_async_read_begin(file, length);
+            if (id < 0)
+                mp::SSH::throw_on_error(sftp, ssh_session, "[sftp pull] read request failed", sftp_get_error);
+
+            outstanding.push_back({id, next_offset, length});
+            next_offset += length;
+        }
+
+        auto request = outstanding.front();
+        outstanding.pop_front();
+
+        std::size_t received = 0;
+        auto r = sftp_async_read(file, data.data(), request.length, request.id);
+        while (r > 0)
+        {
+            sink(data.data(), r);
+            received += r;
+
+            if (received == request.length)
+                break;
+
+            sftp_seek64(file, request.offset + received);
+            r = sftp_read(file, data.data(), request.length - received);
+        }
+
+        if (r < 0)
+            mp::SSH::throw_on_error(sftp, ssh_session, "[sftp pull] read failed", sftp_get_error);
+
+        if (received < request.length)
+            throw std::runtime_error("[sftp pull] remote file truncated during transfer");
+    }
+}
+
+#ifdef Q_OS_LINUX
+// Uploads only the source's allocated extents, seeking the remote file past the holes so
+// the server, which writes at the requested offsets, recreates them instead of storing
+// zeros. Returns false when the source filesystem cannot report holes, in which case the
+// caller streams the file densely.
+bool push_data_extents(sftp_session sftp, mp::SSHSession& session, sftp_file file, const std::string& remote_path,
+                       int source_fd, off_t size)
+{
+    auto data_start = ::lseek(source_fd, 0, SEEK_DATA);
+    if (data_start < 0 && errno == EINVAL)
+        return false;
+
+    std::array<char, max_transfer> data;
+    while (data_start >= 0)
+    {
+        const auto hole_start = ::lseek(source_fd, data_start, SEEK_HOLE);
+        if (hole_start < 0 || ::lseek(source_fd, data_start, SEEK_SET) < 0)
+            throw std::runtime_error(fmt::format("[sftp push] error seeking file: {}", std::strerror(errno)));
+
+        sftp_seek64(file, data_start);
+        auto remaining = hole_start - data_start;
+        while (remaining > 0)
+        {
+            const auto r = ::read(source_fd, data.data(), std::min<off_t>(remaining, data.size()));
+            if (r <= 0)
+                throw std::runtime_error(fmt::format("[sftp push] error reading file: {}", std::strerror(errno)));
+
+            sftp_write(file, data.data(), r);
+            mp::SSH::throw_on_error(sftp, session, "[sftp push] remote write failed", sftp_get_error);
+            remaining -= r;
+        }
+
+        data_start = ::lseek(source_fd, hole_start, SEEK_DATA);
+    }
+
+    if (errno != ENXIO) // ENXIO just means there is no data past the last extent
+        throw std::runtime_error(fmt::format("[sftp push] error seeking file: {}", std::strerror(errno)));
+
+    // A trailing hole leaves the remote file short of the source size; set it explicitly
+    sftp_attributes_struct attributes{};
+    attributes.size = size;
+    attributes.flags = SSH_FILEXFER_ATTR_SIZE;
+    sftp_setstat(sftp, remote_path.c_str(), &attributes);
+    mp::SSH::throw_on_error(sftp, session, "[sftp push] set size failed", sftp_get_error);
+
+    return true;
+}
+#endif
+
 std::string full_destination(const std::string& destination_path, const std::string& filename)
 {
     if (destination_path.empty())
@@ -83,6 +207,37 @@ void mp::SFTPClient::push_file(const std::string& source_path, const std::string
         sftp_open(sftp.get(), full_destination_path.c_str(), O_WRONLY | O_CREAT | O_TRUNC, file_mode), sftp_close};
     SSH::throw_on_error(sftp, *ssh_session, "[sftp push] open failed", sftp_get_error);
 
+#ifdef Q_OS_LINUX
+    // Cloud images and VM disks are heavily sparse; transfer just the data extents when
+    // the source filesystem can report them, so the upload does actual-usage I/O
+    {
+        const auto source_fd = ::open(source_path.c_str(), O_RDONLY | O_CLOEXEC);
+        if (source_fd < 0)
+            throw std::runtime_error(
+                fmt::format("[sftp push] error opening file for reading: {}", std::strerror(errno)));
+
+        struct stat st
+        {
+        };
+        bool pushed = false;
+        try
+        {
+            pushed = ::fstat(source_fd, &st) == 0 &&
+                     push_data_extents(sftp.get(), *ssh_session, file_handle.get(), full_destination_path, source_fd,
+                                       st.st_size);
+        }
+        catch (...)
+        {
+            ::close(source_fd);
+            throw;
+        }
+        ::close(source_fd);
+
+        if (pushed)
+            return;
+    }
+#endif
+
     QFile source(QString::fromStdString(source_path));
     if (!source.open(QIODevice::ReadOnly))
         throw std::runtime_error(fmt::format("[sftp push] error opening file for reading: {}", source.errorString()));
@@ -114,19 +269,140 @@ void mp::SFTPClient::pull_file(const std::string& source_path, const std::string
     SFTPFileUPtr file_handle{sftp_open(sftp.get(), source_path.c_str(), O_RDONLY, file_mode), sftp_close};
     SSH::throw_on_error(sftp, *ssh_session, "[sftp pull] open failed", sftp_get_error);
 
-    std::array<char, max_transfer> data;
-    while (true)
+    std::unique_ptr<sftp_attributes_struct, void (*)(sftp_attributes)> attributes{sftp_fstat(file_handle.get()),
+                                                                                  sftp_attributes_free};
+    if (attributes == nullptr)
+        SSH::throw_on_error(sftp, *ssh_session, "[sftp pull] stat failed", sftp_get_error);
+
+    // All-zero chunks are seeked over rather than written, leaving holes, so pulling a
+    // sparse artifact does not inflate it; the final resize recreates a trailing hole
+    static const std::array<char, max_transfer> zeroes{};
+    uint64_t offset = 0;
+    pipelined_pull(sftp.get(), *ssh_session, file_handle.get(), attributes->size,
+                   [&destination, &offset](const char* data, std::size_t size) {
+                       if (size > zeroes.size() || std::memcmp(data, zeroes.data(), size) != 0)
+                           if (!destination.seek(offset) || destination.write(data, size) == -1)
+                               throw std::runtime_error(
+                                   fmt::format("[sftp pull] error writing to file: {}", destination.errorString()));
+                       offset += size;
+                   });
+
+    if (!destination.resize(offset))
+        throw std::runtime_error(fmt::format("[sftp pull] error writing to file: {}", destination.errorString()));
+}
+
+void mp::SFTPClient::push_dir(const std::string& source_path, const std::string& destination_path)
+{
+    QDir source_dir{QString::fromStdString(source_path)};
+    if (!source_dir.exists())
+        throw std::runtime_error(fmt::format("[sftp push] source directory \"{}\" does not exist", source_path));
+
+    std::string base;
+    if (!destination_path.empty() && is_remote_dir(destination_path))
+        base = fmt::format("{}/{}", destination_path, source_dir.dirName());
+    else
+        base = destination_path.empty() ? source_dir.dirName().toStdString() : destination_path;
+
+    make_remote_dir_tree(base);
+
+    // One session and one walk for the whole tree; each file transfer reuses the
+    // connection, avoiding a client+ssh setup per file
+    std::unordered_set<std::string> created_dirs{base};
+    QDirIterator it{source_dir.path(), QDir::Files | QDir::Dirs | QDir::NoDotAndDotDot | QDir::Hidden,
+                    QDirIterator::Subdirectories};
+    while (it.hasNext())
     {
-        auto r = sftp_read(file_handle.get(), data.data(), data.size());
+        it.next();
+        auto remote_path = fmt::format("{}/{}", base, source_dir.relativeFilePath(it.filePath()));
+
+        if (it.fileInfo().isDir())
+        {
+            if (created_dirs.insert(remote_path).second)
+                make_remote_dir_tree(remote_path);
+        }
+        else if (it.fileInfo().isFile())
+        {
+            auto parent = remote_path.substr(0, remote_path.find_last_of('/'));
+            if (created_dirs.insert(parent).second)
+                make_remote_dir_tree(parent);
+
+            push_file(it.filePath().toStdString(), remote_path);
+        }
+    }
+}
 
-        if (r == 0)
-            break;
+void mp::SFTPClient::pull_dir(const std::string& source_path, const std::string& destination_path)
+{
+    auto source_name = mp::utils::filename_for(source_path);
 
-        if (r < 0)
-            SSH::throw_on_error(sftp, *ssh_session, "[sftp pull] read failed", sftp_get_error);
+    std::string base;
+    if (!destination_path.empty() && mp::utils::is_dir(destination_path))
+        base = fmt::format("{}/{}", destination_path, source_name);
+    else
+        base = destination_path.empty() ? source_name : destination_path;
+
+    if (!QDir{}.mkpath(QString::fromStdString(base)))
+        throw std::runtime_error(fmt::format("[sftp pull] cannot create directory \"{}\"", base));
+
+    std::deque<std::pair<std::string, std::string>> pending_dirs{{source_path, base}};
+    while (!pending_dirs.empty())
+    {
+        auto [remote_dir, local_dir] = pending_dirs.front();
+        pending_dirs.pop_front();
+
+        SFTPDirUPtr dir{sftp_opendir(sftp.get(), remote_dir.c_str()), sftp_closedir};
+        if (dir == nullptr)
+            SSH::throw_on_error(sftp, *ssh_session, "[sftp pull] open dir failed", sftp_get_error);
+
+        while (SFTPAttributesUPtr entry{sftp_readdir(sftp.get(), dir.get()), sftp_attributes_free})
+        {
+            const std::string entry_name{entry->name};
+            if (entry_name == "." || entry_name == "..")
+                continue;
+
+            auto remote_path = fmt::format("{}/{}", remote_dir, entry_name);
+            auto local_path = fmt::format("{}/{}", local_dir, entry_name);
+
+            if (entry->type == SSH_FILEXFER_TYPE_DIRECTORY)
+            {
+                if (!QDir{}.mkpath(QString::fromStdString(local_path)))
+                    throw std::runtime_error(fmt::format("[sftp pull] cannot create directory \"{}\"", local_path));
+                pending_dirs.emplace_back(remote_path, local_path);
+            }
+            else if (entry->type == SSH_FILEXFER_TYPE_REGULAR)
+            {
+                pull_file(remote_path, local_path);
+            }
+            // symlinks and special files are skipped
+        }
+
+        if (!sftp_dir_eof(dir.get()))
+            SSH::throw_on_error(sftp, *ssh_session, "[sftp pull] read dir failed", sftp_get_error);
+    }
+}
 
-        if (destination.write(data.data(), r) == -1)
-            throw std::runtime_error(fmt::format("[sftp pull] error writing to file: {}", destination.errorString()));
+bool mp::SFTPClient::is_remote_dir(const std::string& path)
+{
+    SFTPAttributesUPtr attributes{sftp_stat(sftp.get(), path.c_str()), sftp_attributes_free};
+
+    return attributes != nullptr && attributes->type == SSH_FILEXFER_TYPE_DIRECTORY;
+}
+
+void mp::SFTPClient::make_remote_dir_tree(const std::string& path)
+{
+    // mkdir -p: create each missing component, tolerating ones that already exist
+    for (auto separator = path.find('/', 1);; separator = path.find('/', separator + 1))
+    {
+        auto prefix = path.substr(0, separator);
+        if (!prefix.empty() && !is_remote_dir(prefix))
+        {
+            sftp_mkdir(sftp.get(), prefix.c_str(), dir_mode);
+            if (!is_remote_dir(prefix))
+                SSH::throw_on_error(sftp, *ssh_session, "[sftp push] mkdir failed", sftp_get_error);
+        }
+
+        if (separator == std::string::npos)
+            break;
     }
 }
 
@@ -151,17 +427,11 @@ void mp::SFTPClient::stream_file(const std::string& source_path, std::ostream& c
     SFTPFileUPtr file_handle{sftp_open(sftp.get(), source_path.c_str(), O_RDONLY, file_mode), sftp_close};
     SSH::throw_on_error(sftp, *ssh_session, "[sftp pull] open failed", sftp_get_error);
 
-    std::array<char, max_transfer> data;
-    while (true)
-    {
-        auto r = sftp_read(file_handle.get(), data.data(), data.size());
-
-        if (r == 0)
-            break;
-
-        if (r < 0)
-            SSH::throw_on_error(sftp, *ssh_session, "[sftp pull] read failed", sftp_get_error);
+    std::unique_ptr<sftp_attributes_struct, void (*)(sftp_attributes)> attributes{sftp_fstat(file_handle.get()),
+                                                                                  sftp_attributes_free};
+    if (attributes == nullptr)
+        SSH::throw_on_error(sftp, *ssh_session, "[sftp pull] stat failed", sftp_get_error);
 
-        cout << data.data();
-    }
+    pipelined_pull(sftp.get(), *ssh_session, file_handle.get(), attributes->size,
+                   [&cout](const char* data, std::size_t size) { cout.write(data, size); });
 }
@@ -21,10 +21,50 @@
 
 #include "ssh_client_key_provider.h"
 
+#include <libssh/callbacks.h>
+
+#include <unistd.h>
+
 namespace mp = multipass;
 
 namespace
 {
+// Relays channel output straight from libssh's buffer to the local fd. The stock
+// ssh_connector covers the same direction, but stages every byte through an internal
+// buffer first; writing from the data callback skips that copy, and consuming eagerly
+// keeps the remote window open, which is what bulk throughput hinges on. A short write
+// is fine: only the written bytes are reported consumed, the rest stays in the channel
+// buffer for the next round.
+class StreamRelay
+{
+public:
+    StreamRelay(ssh_channel channel, int out_fd, int err_fd) : channel{channel}, out_fd{out_fd}, err_fd{err_fd}
+    {
+        ssh_callbacks_init(&cb);
+        cb.channel_data_function = channel_data_cb;
+        cb.userdata = this;
+        ssh_add_channel_callbacks(channel, &cb);
+    }
+
+    ~StreamRelay()
+    {
+        ssh_remove_channel_callbacks(channel, &cb);
+    }
+
+private:
+    static int channel_data_cb(ssh_session, ssh_channel, void* data, uint32_t len, int is_stderr, void* userdata)
+    {
+        auto relay = static_cast<StreamRelay*>(userdata);
+        auto written = ::write(is_stderr ? relay->err_fd : relay->out_fd, data, len);
+        return written < 0 ? 0 : written;
+    }
+
+    ssh_channel channel;
+    const int out_fd;
+    const int err_fd;
+    ssh_channel_callbacks_struct cb{};
+};
+
 mp::SSHClient::ChannelUPtr make_channel(ssh_session session)
 {
     mp::SSHClient::ChannelUPtr channel{ssh_channel_new(session), ssh_channel_free};
@@ -78,17 +118,8 @@ void mp::SSHClient::handle_ssh_events()
     ssh_connector_set_in_fd(connector_in.get(), fileno(stdin));
     ssh_event_add_connector(event.get(), connector_in.get());
 
-    // stdout
-    ConnectorUPtr connector_out{ssh_connector_new(*ssh_session), ssh_connector_free};
-    ssh_connector_set_out_fd(connector_out.get(), fileno(stdout));
-    ssh_connector_set_in_channel(connector_out.get(), channel.get(), SSH_CONNECTOR_STDOUT);
-    ssh_event_add_connector(event.get(), connector_out.get());
-
-    // stderr
-    ConnectorUPtr connector_err{ssh_connector_new(*ssh_session), ssh_connector_free};
-    ssh_connector_set_out_fd(connector_err.get(), fileno(stderr));
-    ssh_connector_set_in_channel(connector_err.get(), channel.get(), SSH_CONNECTOR_STDERR);
-    ssh_event_add_connector(event.get(), connector_err.get());
+    // stdout/stderr, written from the channel callback without an intermediate buffer
+    StreamRelay output_relay{channel.get(), fileno(stdout), fileno(stderr)};
 
     while (ssh_channel_is_open(channel.get()) && !ssh_channel_is_eof(channel.get()))
     {
@@ -96,6 +127,4 @@ void mp::SSHClient::handle_ssh_events()
     }
 
     ssh_event_remove_connector(event.get(), connector_in.get());
-    ssh_event_remove_connector(event.get(), connector_out.get());
-    ssh_event_remove_connector(event.get(), connector_err.get());
 }
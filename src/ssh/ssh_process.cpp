@@ -24,7 +24,7 @@
 #include <libssh/callbacks.h>
 
 #include <array>
-#include <sstream>
+#include <vector>
 
 #include <cerrno>
 #include <cstring>
@@ -111,7 +111,39 @@ std::string mp::SSHProcess::read_std_error()
     return read_stream(StreamType::err);
 }
 
+void mp::SSHProcess::drain_std_output(const OutputSink& sink)
+{
+    drain_stream(StreamType::out, sink);
+}
+
+void mp::SSHProcess::drain_std_error(const OutputSink& sink)
+{
+    drain_stream(StreamType::err, sink);
+}
+
 std::string mp::SSHProcess::read_stream(StreamType type, int timeout)
+{
+    // Collect fixed-size chunks and assemble once at the end; appending straight to one
+    // growing buffer re-copies everything on each reallocation, which hurts when a guest
+    // command emits tens of MB, and peaks at roughly twice the output size
+    std::vector<std::string> chunks;
+    std::size_t total_size{0};
+    drain_stream(type,
+                 [&chunks, &total_size](const char* data, std::size_t size) {
+                     chunks.emplace_back(data, size);
+                     total_size += size;
+                 },
+                 timeout);
+
+    std::string output;
+    output.reserve(total_size);
+    for (const auto& chunk : chunks)
+        output.append(chunk);
+
+    return output;
+}
+
+void mp::SSHProcess::drain_stream(StreamType type, const OutputSink& sink, int timeout)
 {
     mpl::log(mpl::Level::debug, category,
              fmt::format("{}:{} {}(type = {}, timeout = {}): ", __FILE__, __LINE__, __FUNCTION__,
@@ -121,11 +153,10 @@ std::string mp::SSHProcess::read_stream(StreamType type, int timeout)
     {
         mpl::log(mpl::Level::debug, category,
                  fmt::format("{}:{} {}(): channel closed", __FILE__, __LINE__, __FUNCTION__));
-        return std::string();
+        return;
     }
 
-    std::stringstream output;
-    std::array<char, 256> buffer;
+    std::array<char, 65536> buffer; // channel packets come in up to 32K; don't make the copy loop the bottleneck
     int num_bytes{0};
     const bool is_std_err = type == StreamType::err;
     do
@@ -140,17 +171,17 @@ std::string mp::SSHProcess::read_stream(StreamType type, int timeout)
             {
                 mpl::log(mpl::Level::debug, category,
                          fmt::format("{}:{} {}(): channel closed", __FILE__, __LINE__, __FUNCTION__));
-                return output.str();
+                return;
             }
 
             throw std::runtime_error(fmt::format("error while reading ssh channel for remote process '{}'"
                                                  " - error: {}",
                                                  cmd, num_bytes));
         }
-        output.write(buffer.data(), num_bytes);
-    } while (num_bytes > 0);
 
-    return output.str();
+        if (num_bytes > 0)
+            sink(buffer.data(), static_cast<std::size_t>(num_bytes));
+    } while (num_bytes > 0);
 }
 
 ssh_channel mp::SSHProcess::release_channel()
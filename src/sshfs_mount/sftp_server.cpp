@@ -16,6 +16,7 @@
  */
 
 #include <multipass/sshfs_mount/sftp_server.h>
+#include <multipass/stats_registry.h>
 
 #include <multipass/cli/client_platform.h>
 #include <multipass/exceptions/exitless_sshprocess_exception.h>
@@ -30,12 +31,37 @@
 #include <QDir>
 #include <QFile>
 
+#include <algorithm>
+
+#if defined(__linux__) && __has_include(<linux/io_uring.h>)
+#define MULTIPASS_SFTP_HAVE_IO_URING
+#include <linux/io_uring.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <sys/uio.h>
+#include <unistd.h>
+
+#include <array>
+#include <cerrno>
+#include <cstdint>
+#include <cstring>
+#include <unordered_set>
+#endif
+
 namespace mp = multipass;
 namespace mpl = multipass::logging;
 
 namespace
 {
 constexpr auto category = "sftp server";
+// long enough to absorb a stat storm, short enough that host-side edits show up promptly
+constexpr auto attr_cache_ttl = std::chrono::seconds{1};
+constexpr auto max_attr_cache_entries = size_t{16384};
+// small on purpose: reopen-heavy workloads cycle through a handful of hot files, and each
+// parked entry pins a host fd
+constexpr auto max_parked_handles = size_t{32};
+// read-only opens of files up to this size pull the whole content into the read cache
+constexpr auto small_file_preload_limit = qint64{64} * 1024;
 using SftpHandleUPtr = std::unique_ptr<ssh_string_struct, void (*)(ssh_string)>;
 using namespace std::literals::chrono_literals;
 
@@ -52,6 +78,35 @@ enum Permissions
     exec_other = 01
 };
 
+auto to_sorted_flat_map(const std::unordered_map<int, int>& map)
+{
+    mp::SftpServer::IdMap flat{map.begin(), map.end()};
+    std::sort(flat.begin(), flat.end());
+    return flat;
+}
+
+// The reverse table is keyed by what the instance sees, so entries whose mapped id is the
+// default placeholder are recorded under the default id they end up presented as.
+auto to_reversed_flat_map(const std::unordered_map<int, int>& map, const int default_host_id)
+{
+    mp::SftpServer::IdMap flat;
+    flat.reserve(map.size());
+    for (const auto& entry : map)
+        flat.emplace_back(entry.second == mp::default_id ? default_host_id : entry.second, entry.first);
+    std::sort(flat.begin(), flat.end());
+    return flat;
+}
+
+const int* lookup_id(const mp::SftpServer::IdMap& map, const int id)
+{
+    auto it = std::lower_bound(map.begin(), map.end(), id,
+                               [](const std::pair<int, int>& entry, const int id) { return entry.first < id; });
+    if (it != map.end() && it->first == id)
+        return &it->second;
+
+    return nullptr;
+}
+
 auto make_sftp_session(ssh_session session, ssh_channel channel)
 {
     mp::SftpServer::SftpSessionUptr sftp_server_session{sftp_server_new(session, channel), sftp_free};
@@ -84,6 +139,33 @@ int reply_unsupported(sftp_client_message msg)
     return sftp_reply_status(msg, SSH_FX_OP_UNSUPPORTED, "Unsupported message");
 }
 
+const char* message_type_name(uint8_t type)
+{
+    switch (type)
+    {
+    case SFTP_REALPATH: return "realpath";
+    case SFTP_OPENDIR: return "opendir";
+    case SFTP_MKDIR: return "mkdir";
+    case SFTP_RMDIR: return "rmdir";
+    case SFTP_LSTAT: return "lstat";
+    case SFTP_STAT: return "stat";
+    case SFTP_FSTAT: return "fstat";
+    case SFTP_READDIR: return "readdir";
+    case SFTP_CLOSE: return "close";
+    case SFTP_OPEN: return "open";
+    case SFTP_READ: return "read";
+    case SFTP_WRITE: return "write";
+    case SFTP_RENAME: return "rename";
+    case SFTP_REMOVE: return "remove";
+    case SFTP_SETSTAT: return "setstat";
+    case SFTP_FSETSTAT: return "fsetstat";
+    case SFTP_READLINK: return "readlink";
+    case SFTP_SYMLINK: return "symlink";
+    case SFTP_EXTENDED: return "extended";
+    default: return "unknown";
+    }
+}
+
 fmt::memory_buffer& operator<<(fmt::memory_buffer& buf, const char* v)
 {
     fmt::format_to(buf, v);
@@ -252,6 +334,288 @@ auto create_sshfs_process(mp::SSHSession& session, const std::string& sshfs_exec
 }
 } // namespace
 
+#ifdef MULTIPASS_SFTP_HAVE_IO_URING
+
+// Write-behind queue backed by io_uring, driven through raw syscalls since liburing is
+// not among our dependencies. Coalesced write-cache flushes are handed to the kernel and
+// the reply goes out before the data reaches the disk; completions are reaped before any
+// dependent read, fstat or close through flush_write_cache_for(). At most one operation
+// is kept in flight per file handle, so overlapping flushes cannot reorder.
+class mp::UringWriteQueue
+{
+public:
+    // Returns null when the kernel lacks io_uring or seccomp forbids it, in which case
+    // callers stick to synchronous writes
+    static std::unique_ptr<UringWriteQueue> make();
+    ~UringWriteQueue();
+
+    // Drains the handle's previous operation, then submits the buffer; the returned
+    // status reports that previous operation, matching the write cache's deferred-error
+    // contract.
+    bool submit(int fd, void* id, qint64 offset, std::vector<char>&& buffer);
+
+    // Waits for the handle's outstanding operation, if any; returns whether everything
+    // completed for the handle since the last drain succeeded.
+    bool drain(void* id);
+
+private:
+    static constexpr unsigned queue_depth = 8;
+
+    struct Pending
+    {
+        std::vector<char> buffer;
+        struct iovec iov;
+        qint64 offset;
+        void* id;
+        int fd;
+    };
+
+    UringWriteQueue() = default;
+    bool init();
+    int enter(unsigned to_submit, unsigned min_complete, unsigned flags) const;
+    bool reap_locked(bool wait);
+    void finish(unsigned slot, long long res);
+    bool drain_locked(void* id);
+
+    int ring_fd{-1};
+    void* sq_ring{MAP_FAILED};
+    void* cq_ring{MAP_FAILED};
+    io_uring_sqe* sqes{nullptr};
+    size_t sq_ring_bytes{0};
+    size_t cq_ring_bytes{0};
+    size_t sqes_bytes{0};
+    unsigned* sq_head{nullptr};
+    unsigned* sq_tail{nullptr};
+    unsigned sq_mask{0};
+    unsigned* sq_array{nullptr};
+    unsigned* cq_head{nullptr};
+    unsigned* cq_tail{nullptr};
+    unsigned cq_mask{0};
+    io_uring_cqe* cqes{nullptr};
+
+    std::array<std::unique_ptr<Pending>, queue_depth> slots;
+    std::unordered_set<void*> failed_ids;
+    std::mutex mutex;
+};
+
+std::unique_ptr<mp::UringWriteQueue> mp::UringWriteQueue::make()
+{
+    auto queue = std::unique_ptr<UringWriteQueue>{new UringWriteQueue{}};
+    if (!queue->init())
+        return nullptr;
+
+    mpl::log(mpl::Level::debug, category, "using io_uring write-behind for mount flushes");
+    return queue;
+}
+
+bool mp::UringWriteQueue::init()
+{
+    io_uring_params params{};
+    ring_fd = static_cast<int>(syscall(__NR_io_uring_setup, queue_depth, &params));
+    if (ring_fd < 0)
+        return false;
+
+    sq_ring_bytes = params.sq_off.array + params.sq_entries * sizeof(unsigned);
+    cq_ring_bytes = params.cq_off.cqes + params.cq_entries * sizeof(io_uring_cqe);
+    sqes_bytes = params.sq_entries * sizeof(io_uring_sqe);
+
+    sq_ring = mmap(nullptr, sq_ring_bytes, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, ring_fd,
+                   IORING_OFF_SQ_RING);
+    cq_ring = mmap(nullptr, cq_ring_bytes, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, ring_fd,
+                   IORING_OFF_CQ_RING);
+    const auto sqes_map =
+        mmap(nullptr, sqes_bytes, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, ring_fd, IORING_OFF_SQES);
+    if (sq_ring == MAP_FAILED || cq_ring == MAP_FAILED || sqes_map == MAP_FAILED)
+        return false; // the destructor unmaps whatever did succeed
+
+    sqes = static_cast<io_uring_sqe*>(sqes_map);
+    const auto sq_base = static_cast<char*>(sq_ring);
+    sq_head = reinterpret_cast<unsigned*>(sq_base + params.sq_off.head);
+    sq_tail = reinterpret_cast<unsigned*>(sq_base + params.sq_off.tail);
+    sq_mask = *reinterpret_cast<unsigned*>(sq_base + params.sq_off.ring_mask);
+    sq_array = reinterpret_cast<unsigned*>(sq_base + params.sq_off.array);
+    const auto cq_base = static_cast<char*>(cq_ring);
+    cq_head = reinterpret_cast<unsigned*>(cq_base + params.cq_off.head);
+    cq_tail = reinterpret_cast<unsigned*>(cq_base + params.cq_off.tail);
+    cq_mask = *reinterpret_cast<unsigned*>(cq_base + params.cq_off.ring_mask);
+    cqes = reinterpret_cast<io_uring_cqe*>(cq_base + params.cq_off.cqes);
+    return true;
+}
+
+mp::UringWriteQueue::~UringWriteQueue()
+{
+    std::lock_guard<std::mutex> lock{mutex};
+    while (std::any_of(slots.begin(), slots.end(), [](const auto& op) { return op != nullptr; }))
+        if (!reap_locked(true))
+            break;
+
+    if (sqes != nullptr)
+        munmap(sqes, sqes_bytes);
+    if (cq_ring != MAP_FAILED)
+        munmap(cq_ring, cq_ring_bytes);
+    if (sq_ring != MAP_FAILED)
+        munmap(sq_ring, sq_ring_bytes);
+    if (ring_fd >= 0)
+        close(ring_fd);
+}
+
+int mp::UringWriteQueue::enter(unsigned to_submit, unsigned min_complete, unsigned flags) const
+{
+    int ret;
+    do
+        ret = static_cast<int>(syscall(__NR_io_uring_enter, ring_fd, to_submit, min_complete, flags, nullptr, 0));
+    while (ret < 0 && (errno == EINTR || errno == EAGAIN || errno == EBUSY));
+    return ret;
+}
+
+// Consumes the slot regardless of outcome; a short write is completed synchronously here
+// so that success always means the whole buffer made it out.
+void mp::UringWriteQueue::finish(unsigned slot, long long res)
+{
+    const auto op = std::move(slots[slot]);
+    if (op == nullptr)
+        return;
+
+    auto ok = res >= 0;
+    auto done = ok ? static_cast<size_t>(res) : size_t{0};
+    while (ok && done < op->buffer.size())
+    {
+        const auto r = pwrite(op->fd, op->buffer.data() + done, op->buffer.size() - done,
+                              static_cast<off_t>(op->offset) + static_cast<off_t>(done));
+        if (r > 0)
+            done += static_cast<size_t>(r);
+        else if (r < 0 && errno == EINTR)
+            continue;
+        else
+            ok = false;
+    }
+
+    if (!ok)
+        failed_ids.insert(op->id);
+}
+
+bool mp::UringWriteQueue::reap_locked(bool wait)
+{
+    const auto head = __atomic_load_n(cq_head, __ATOMIC_RELAXED);
+    if (head == __atomic_load_n(cq_tail, __ATOMIC_ACQUIRE))
+    {
+        if (!wait || enter(0, 1, IORING_ENTER_GETEVENTS) < 0)
+            return false;
+        if (head == __atomic_load_n(cq_tail, __ATOMIC_ACQUIRE))
+            return false;
+    }
+
+    const auto& cqe = cqes[head & cq_mask];
+    finish(static_cast<unsigned>(cqe.user_data), cqe.res);
+    __atomic_store_n(cq_head, head + 1, __ATOMIC_RELEASE);
+    return true;
+}
+
+bool mp::UringWriteQueue::drain_locked(void* id)
+{
+    const auto outstanding = [this, id] {
+        return std::any_of(slots.begin(), slots.end(),
+                           [id](const auto& op) { return op != nullptr && op->id == id; });
+    };
+
+    while (outstanding())
+        if (!reap_locked(true))
+        {
+            // waiting failed; fail the handle rather than hang on a wedged ring
+            for (auto& op : slots)
+                if (op != nullptr && op->id == id)
+                    op.reset();
+            failed_ids.insert(id);
+            break;
+        }
+
+    return failed_ids.erase(id) == 0;
+}
+
+bool mp::UringWriteQueue::submit(int fd, void* id, qint64 offset, std::vector<char>&& buffer)
+{
+    std::lock_guard<std::mutex> lock{mutex};
+    const auto ok = drain_locked(id);
+
+    const auto find_slot = [this]() -> unsigned {
+        for (unsigned i = 0; i < queue_depth; ++i)
+            if (slots[i] == nullptr)
+                return i;
+        return queue_depth;
+    };
+
+    auto slot = find_slot();
+    while (slot == queue_depth)
+    {
+        if (!reap_locked(true))
+            return false;
+        slot = find_slot();
+    }
+
+    auto op = std::make_unique<Pending>();
+    op->buffer = std::move(buffer);
+    op->iov.iov_base = op->buffer.data();
+    op->iov.iov_len = op->buffer.size();
+    op->offset = offset;
+    op->id = id;
+    op->fd = fd;
+
+    const auto tail = __atomic_load_n(sq_tail, __ATOMIC_RELAXED);
+    const auto index = tail & sq_mask;
+    auto& sqe = sqes[index];
+    std::memset(&sqe, 0, sizeof(sqe));
+    sqe.opcode = IORING_OP_WRITEV; // oldest write opcode, available wherever the ring is
+    sqe.fd = fd;
+    sqe.addr = reinterpret_cast<std::uintptr_t>(&op->iov);
+    sqe.len = 1;
+    sqe.off = static_cast<std::uint64_t>(offset);
+    sqe.user_data = slot;
+    sq_array[index] = index;
+    slots[slot] = std::move(op);
+    __atomic_store_n(sq_tail, tail + 1, __ATOMIC_RELEASE);
+
+    if (enter(1, 0, 0) < 0)
+    {
+        // the kernel never consumed the entry (we only submit on enter); take it back and
+        // write synchronously instead
+        __atomic_store_n(sq_tail, tail, __ATOMIC_RELEASE);
+        finish(slot, 0);
+    }
+
+    return ok;
+}
+
+bool mp::UringWriteQueue::drain(void* id)
+{
+    std::lock_guard<std::mutex> lock{mutex};
+    return drain_locked(id);
+}
+
+#else // MULTIPASS_SFTP_HAVE_IO_URING
+
+// On platforms without io_uring the queue never materializes and the write cache flushes
+// synchronously, as before.
+class mp::UringWriteQueue
+{
+public:
+    static std::unique_ptr<UringWriteQueue> make()
+    {
+        return nullptr;
+    }
+
+    bool submit(int, void*, qint64, std::vector<char>&&)
+    {
+        return true;
+    }
+
+    bool drain(void*)
+    {
+        return true;
+    }
+};
+
+#endif // MULTIPASS_SFTP_HAVE_IO_URING
+
 mp::SftpServer::SftpServer(SSHSession&& session, const std::string& source, const std::string& target,
                            const std::unordered_map<int, int>& gid_map, const std::unordered_map<int, int>& uid_map,
                            int default_uid, int default_gid, const std::string& sshfs_exec_line)
@@ -261,8 +625,11 @@ mp::SftpServer::SftpServer(SSHSession&& session, const std::string& source, cons
       sftp_server_session{make_sftp_session(ssh_session, sshfs_process->release_channel())},
       source_path{source},
       target_path{target},
-      gid_map{gid_map},
-      uid_map{uid_map},
+      uring_queue{UringWriteQueue::make()},
+      gid_map{to_sorted_flat_map(gid_map)},
+      uid_map{to_sorted_flat_map(uid_map)},
+      reverse_gid_map{to_reversed_flat_map(gid_map, default_gid)},
+      reverse_uid_map{to_reversed_flat_map(uid_map, default_uid)},
       default_uid{default_uid},
       default_gid{default_gid},
       sshfs_exec_line{sshfs_exec_line}
@@ -304,14 +671,8 @@ int mp::SftpServer::mapped_uid_for(const int uid)
     if (uid == mp::no_id_info_available)
         return default_uid;
 
-    auto map = uid_map.find(uid);
-    if (map != uid_map.end())
-    {
-        if (map->second == mp::default_id)
-            return default_uid;
-        else
-            return map->second;
-    }
+    if (const auto* mapped = lookup_id(uid_map, uid))
+        return *mapped == mp::default_id ? default_uid : *mapped;
 
     return uid;
 }
@@ -321,22 +682,120 @@ int mp::SftpServer::mapped_gid_for(const int gid)
     if (gid == mp::no_id_info_available)
         return default_gid;
 
-    auto map = gid_map.find(gid);
-    if (map != gid_map.end())
+    if (const auto* mapped = lookup_id(gid_map, gid))
+        return *mapped == mp::default_id ? default_gid : *mapped;
+
+    return gid;
+}
+
+int mp::SftpServer::reverse_uid_for(const int uid)
+{
+    if (const auto* host_uid = lookup_id(reverse_uid_map, uid))
+        return *host_uid;
+
+    return uid;
+}
+
+int mp::SftpServer::reverse_gid_for(const int gid)
+{
+    if (const auto* host_gid = lookup_id(reverse_gid_map, gid))
+        return *host_gid;
+
+    return gid;
+}
+
+QFileInfo mp::SftpServer::cached_file_info_for(const std::string& path)
+{
     {
-        if (map->second == mp::default_id)
-            return default_gid;
-        else
-            return map->second;
+        std::lock_guard<std::mutex> lock{attr_cache_mutex};
+        const auto entry = attr_cache.find(path);
+        if (entry != attr_cache.end() && std::chrono::steady_clock::now() - entry->second.stamp < attr_cache_ttl)
+            return entry->second.info;
     }
 
-    return gid;
+    QFileInfo info{QString::fromStdString(path)};
+    remember_attrs_for(info);
+    return info;
+}
+
+void mp::SftpServer::remember_attrs_for(const QFileInfo& info)
+{
+    // Touch everything attr_from needs while still on this thread, so the copy the cache
+    // keeps already holds the results and later hits do no filesystem work at all.
+    info.size();
+    info.permissions();
+    info.ownerId();
+    info.groupId();
+    info.lastRead();
+    info.lastModified();
+    info.isSymLink();
+    info.isDir();
+
+    std::lock_guard<std::mutex> lock{attr_cache_mutex};
+    if (attr_cache.size() >= max_attr_cache_entries) // everything in here expires within the TTL anyway
+        attr_cache.clear();
+    attr_cache[info.filePath().toStdString()] = {info, std::chrono::steady_clock::now()};
+}
+
+void mp::SftpServer::invalidate_attrs_for(const std::string& path)
+{
+    std::lock_guard<std::mutex> lock{attr_cache_mutex};
+    attr_cache.erase(path);
+}
+
+void mp::SftpServer::park_handle(std::unique_ptr<QFile> file)
+{
+    if (parked_handles.size() >= max_parked_handles)
+        parked_handles.pop_front(); // least recently closed goes first
+
+    auto path = file->fileName().toStdString();
+    auto mode = file->openMode();
+    parked_handles.push_back({std::move(path), mode, std::move(file)});
+}
+
+std::unique_ptr<QFile> mp::SftpServer::take_parked_handle(const std::string& path, QIODevice::OpenMode mode)
+{
+    // scan from the most recently parked entry; the deque is small
+    for (auto it = parked_handles.rbegin(); it != parked_handles.rend(); ++it)
+    {
+        if (it->path == path && it->mode == mode)
+        {
+            auto file = std::move(it->file);
+            parked_handles.erase(std::next(it).base());
+            return file;
+        }
+    }
+    return nullptr;
+}
+
+void mp::SftpServer::evict_parked_handles_for(const std::string& path)
+{
+    parked_handles.erase(std::remove_if(parked_handles.begin(), parked_handles.end(),
+                                        [&path](const ParkedHandle& parked) { return parked.path == path; }),
+                         parked_handles.end());
+}
+
+mp::MountStats mp::SftpServer::stats() const
+{
+    MountStats snapshot;
+    snapshot.read_ops = io_counters.read_ops.load(std::memory_order_relaxed);
+    snapshot.read_bytes = io_counters.read_bytes.load(std::memory_order_relaxed);
+    snapshot.read_usecs = io_counters.read_usecs.load(std::memory_order_relaxed);
+    snapshot.write_ops = io_counters.write_ops.load(std::memory_order_relaxed);
+    snapshot.write_bytes = io_counters.write_bytes.load(std::memory_order_relaxed);
+    snapshot.write_usecs = io_counters.write_usecs.load(std::memory_order_relaxed);
+    snapshot.other_ops = io_counters.other_ops.load(std::memory_order_relaxed);
+    snapshot.other_usecs = io_counters.other_usecs.load(std::memory_order_relaxed);
+    return snapshot;
 }
 
 void mp::SftpServer::process_message(sftp_client_message msg)
 {
     int ret = 0;
     const auto type = sftp_client_message_get_type(msg);
+    mpl::log<mpl::Level::trace>(category, "processing message type {}", static_cast<int>(type));
+    MP_STATS.count(fmt::format("sftp.{}", message_type_name(type)));
+    const auto start = std::chrono::steady_clock::now();
     switch (type)
     {
     case SFTP_REALPATH:
@@ -393,16 +852,186 @@ void mp::SftpServer::process_message(sftp_client_message msg)
         ret = handle_extended(msg);
         break;
     default:
-        mpl::log(mpl::Level::warning, category, fmt::format("Unknown message: {}", static_cast<int>(type)));
+        mpl::log(mpl::Level::warning, category, "Unknown message: {}", static_cast<int>(type));
         ret = reply_unsupported(msg);
     }
     if (ret != 0)
-        mpl::log(mpl::Level::error, category, fmt::format("error occurred when replying to client: {}", ret));
+        mpl::log(mpl::Level::error, category, "error occurred when replying to client: {}", ret);
+
+    // Attribute the time and bytes to the per-mount counters; bytes are the requested
+    // lengths, which only differ from the served ones on errors and at end of file
+    const auto elapsed = static_cast<std::uint64_t>(
+        std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start).count());
+    if (type == SFTP_READ)
+    {
+        ++io_counters.read_ops;
+        io_counters.read_bytes += msg->len;
+        io_counters.read_usecs += elapsed;
+    }
+    else if (type == SFTP_WRITE)
+    {
+        ++io_counters.write_ops;
+        io_counters.write_bytes += ssh_string_len(msg->data);
+        io_counters.write_usecs += elapsed;
+    }
+    else
+    {
+        ++io_counters.other_ops;
+        io_counters.other_usecs += elapsed;
+    }
+}
+
+void mp::SftpServer::start_worker_threads()
+{
+    const auto num_workers = std::max(2u, std::min(4u, std::thread::hardware_concurrency()));
+    for (auto i = 0u; i < num_workers; ++i)
+        workers.emplace_back([this] { worker_main(); });
+}
+
+void mp::SftpServer::stop_worker_threads()
+{
+    {
+        std::lock_guard<std::mutex> lock{work_mutex};
+        workers_stopping = true;
+    }
+    work_cv.notify_all();
+    for (auto& worker : workers)
+        worker.join();
+    workers.clear();
+}
+
+void mp::SftpServer::worker_main()
+{
+    std::unique_lock<std::mutex> lock{work_mutex};
+    while (!workers_stopping)
+    {
+        // Pick the oldest queued request whose handle has no request in flight, so requests
+        // for different handles overlap while per-handle ordering is preserved.
+        auto it = std::find_if(work_queue.begin(), work_queue.end(),
+                               [this](const auto& task) { return busy_handles.count(task.first) == 0; });
+        if (it == work_queue.end())
+        {
+            work_cv.wait(lock);
+            continue;
+        }
+
+        auto handle = it->first;
+        auto msg = std::move(it->second);
+        work_queue.erase(it);
+        busy_handles.insert(handle);
+        ++in_flight;
+
+        lock.unlock();
+        process_message(msg.get());
+        lock.lock();
+
+        busy_handles.erase(handle);
+        --in_flight;
+        work_cv.notify_all();
+        if (work_queue.empty() && in_flight == 0)
+            idle_cv.notify_all();
+    }
+}
+
+void mp::SftpServer::dispatch(void* handle, MsgUPtr msg)
+{
+    {
+        std::lock_guard<std::mutex> lock{work_mutex};
+        work_queue.emplace_back(handle, std::move(msg));
+    }
+    work_cv.notify_one();
+}
+
+void mp::SftpServer::drain_dispatched_work()
+{
+    std::unique_lock<std::mutex> lock{work_mutex};
+    idle_cv.wait(lock, [this] { return work_queue.empty() && in_flight == 0; });
+}
+
+bool mp::SftpServer::flush_write_cache(QFile* file, void* id, WriteCache& cache)
+{
+    if (cache.buffer.empty())
+        return true;
+
+    if (uring_queue)
+    {
+        // Hand the coalesced buffer to the kernel and return; the status reported here is
+        // that of the handle's previous in-flight flush, keeping the cache's
+        // deferred-error contract.
+        const auto offset = cache.start_offset;
+        auto buffer = std::move(cache.buffer);
+        cache.buffer.clear();
+        return uring_queue->submit(file->handle(), id, offset, std::move(buffer));
+    }
+
+    auto ok = file->seek(cache.start_offset);
+
+    const char* data_ptr = cache.buffer.data();
+    auto len = cache.buffer.size();
+    while (ok && len > 0)
+    {
+        auto r = file->write(data_ptr, len);
+        if (r < 0)
+        {
+            ok = false;
+            break;
+        }
+
+        data_ptr += r;
+        len -= static_cast<size_t>(r);
+    }
+
+    if (ok)
+        file->flush();
+
+    cache.buffer.clear();
+    return ok;
+}
+
+bool mp::SftpServer::flush_write_cache_for(void* id)
+{
+    WriteCache* cache;
+    {
+        std::lock_guard<std::mutex> cache_lock{write_cache_mutex};
+        auto it = write_caches.find(id);
+        if (it == write_caches.end())
+            return !uring_queue || uring_queue->drain(id);
+        cache = &it->second;
+    }
+
+    auto file = open_file_handles.find(id);
+    if (file == open_file_handles.end())
+        return !cache->failed;
+
+    auto ok = flush_write_cache(file->second.get(), id, *cache);
+    if (uring_queue) // wait for the submitted data before anything depends on it
+        ok = uring_queue->drain(id) && ok;
+    ok = ok && !cache->failed;
+    cache->failed = false;
+    return ok;
+}
+
+// Writes are acknowledged before they reach the disk, so buffers still cached when the
+// message loop ends - or when a session is discarded for rebuilding - must be flushed
+// here; the handles they belong to may never see the close that would otherwise do it
+void mp::SftpServer::flush_all_write_caches()
+{
+    std::vector<void*> ids;
+    {
+        std::lock_guard<std::mutex> cache_lock{write_cache_mutex};
+        ids.reserve(write_caches.size());
+        for (const auto& entry : write_caches)
+            ids.push_back(entry.first);
+    }
+
+    for (auto id : ids)
+        if (!flush_write_cache_for(id))
+            mpl::log(mpl::Level::warning, category, "failed to flush cached writes at session end");
 }
 
 void mp::SftpServer::run()
 {
-    using MsgUPtr = std::unique_ptr<sftp_client_message_struct, decltype(sftp_client_message_free)*>;
+    start_worker_threads();
 
     while (true)
     {
@@ -434,6 +1063,8 @@ void mp::SftpServer::run()
                     ssh_session.exec(fmt::format("sudo umount {}", mount_path));
                 }
 
+                drain_dispatched_work();
+                flush_all_write_caches(); // already-acked data must not die with the old session
                 sshfs_process =
                     create_sshfs_process(ssh_session, sshfs_exec_line, mp::utils::escape_char(source_path, '"'),
                                          mp::utils::escape_char(target_path, '"'));
@@ -447,8 +1078,23 @@ void mp::SftpServer::run()
             }
         }
 
-        process_message(msg);
+        const auto type = sftp_client_message_get_type(msg);
+        if (type == SFTP_READ || type == SFTP_WRITE || type == SFTP_READDIR)
+        {
+            dispatch(sftp_handle(sftp_server_session.get(), msg->handle), std::move(client_msg));
+        }
+        else
+        {
+            // Handle-table and directory-state mutations stay on this thread; wait for
+            // outstanding data requests so they never race with an open/close/rename.
+            drain_dispatched_work();
+            process_message(msg);
+        }
     }
+
+    drain_dispatched_work();
+    flush_all_write_caches();
+    stop_worker_threads();
 }
 
 void mp::SftpServer::stop()
@@ -461,13 +1107,33 @@ int mp::SftpServer::handle_close(sftp_client_message msg)
 {
     const auto id = sftp_handle(sftp_server_session.get(), msg->handle);
 
-    auto erased = open_file_handles.erase(id);
+    {
+        std::lock_guard<std::mutex> cache_lock{read_cache_mutex};
+        read_caches.erase(id);
+    }
+
+    // Flush any coalesced writes so errors are reported before the handle goes away
+    const auto flushed = flush_write_cache_for(id);
+    {
+        std::lock_guard<std::mutex> cache_lock{write_cache_mutex};
+        write_caches.erase(id);
+    }
+
+    auto erased = size_t{0};
+    auto file_entry = open_file_handles.find(id);
+    if (file_entry != open_file_handles.end())
+    {
+        if (flushed) // a handle whose writes failed is not worth reusing
+            park_handle(std::move(file_entry->second));
+        open_file_handles.erase(file_entry);
+        ++erased;
+    }
     erased += open_dir_handles.erase(id);
     if (erased == 0)
         return reply_bad_handle(msg, "close");
 
     sftp_handle_remove(sftp_server_session.get(), id);
-    return reply_ok(msg);
+    return flushed ? reply_ok(msg) : reply_failure(msg);
 }
 
 int mp::SftpServer::handle_fstat(sftp_client_message msg)
@@ -476,6 +1142,8 @@ int mp::SftpServer::handle_fstat(sftp_client_message msg)
     if (file == nullptr)
         return reply_bad_handle(msg, "fstat");
 
+    flush_write_cache_for(sftp_handle(msg->sftp, msg->handle));
+
     QFileInfo file_info(*file);
 
     if (file_info.isSymLink())
@@ -495,6 +1163,8 @@ int mp::SftpServer::handle_mkdir(sftp_client_message msg)
     if (!dir.mkdir(filename))
         return reply_failure(msg);
 
+    invalidate_attrs_for(filename);
+
     if (!QFile::setPermissions(filename, to_qt_permissions(msg->attr->permissions)))
         return reply_failure(msg);
 
@@ -503,9 +1173,8 @@ int mp::SftpServer::handle_mkdir(sftp_client_message msg)
     auto ret = mp::platform::chown(filename, parent_dir.ownerId(), parent_dir.groupId());
     if (ret < 0)
     {
-        mpl::log(mpl::Level::error, category,
-                 fmt::format("failed to chown '{}' to owner:{} and group:{}\n", filename, parent_dir.ownerId(),
-                             parent_dir.groupId()));
+        mpl::log(mpl::Level::error, category, "failed to chown '{}' to owner:{} and group:{}\n", filename,
+                 parent_dir.ownerId(), parent_dir.groupId());
         return reply_failure(msg);
     }
     return reply_ok(msg);
@@ -521,9 +1190,45 @@ int mp::SftpServer::handle_rmdir(sftp_client_message msg)
     if (!dir.rmdir(filename))
         return reply_failure(msg);
 
+    invalidate_attrs_for(filename);
+
     return reply_ok(msg);
 }
 
+// For read-only opens of small files, pull the whole content into the handle's read
+// cache right away: the READ(s) that follow are answered from memory, so the guest's
+// open+read+close of a node_modules-style tree costs one host disk access per file
+// instead of interleaving I/O with every message. The sftp protocol (and the guest's
+// stock sshfs) still sees the usual three messages; only the host-side work collapses.
+void mp::SftpServer::preload_small_file(QFile& file)
+{
+    const auto size = file.size();
+    if (size <= 0 || size > small_file_preload_limit)
+        return;
+
+    ReadCache* cache;
+    {
+        std::lock_guard<std::mutex> cache_lock{read_cache_mutex};
+        cache = &read_caches[&file];
+    }
+
+    cache->buffer.resize(size);
+    const auto r = file.read(cache->buffer.data(), size);
+    if (r > 0)
+    {
+        cache->buffer_offset = 0;
+        cache->buffer_size = r;
+        cache->expected_offset = r;
+        cache->holds_eof = r == size;
+    }
+    else
+    {
+        *cache = ReadCache{}; // unreadable after all; the read path reports the error
+    }
+
+    file.seek(0);
+}
+
 int mp::SftpServer::handle_open(sftp_client_message msg)
 {
     const auto filename = sftp_client_message_get_filename(msg);
@@ -555,6 +1260,28 @@ int mp::SftpServer::handle_open(sftp_client_message msg)
     if (flags & SSH_FXF_TRUNC)
         mode |= QIODevice::Truncate;
 
+    // A truncating open must hit the filesystem; anything else can reuse a handle parked
+    // on a previous close of the same path with the same flags.
+    if (!(mode & QIODevice::Truncate))
+    {
+        if (auto parked_file = take_parked_handle(filename, mode))
+        {
+            if (!(mode & QIODevice::Append))
+                parked_file->seek(0);
+
+            if (mode & QIODevice::WriteOnly)
+                invalidate_attrs_for(filename);
+            else if (mode == QIODevice::ReadOnly)
+                preload_small_file(*parked_file);
+
+            SftpHandleUPtr sftp_handle{sftp_handle_alloc(sftp_server_session.get(), parked_file.get()),
+                                       ssh_string_free};
+            open_file_handles.emplace(parked_file.get(), std::move(parked_file));
+
+            return sftp_reply_handle(msg, sftp_handle.get());
+        }
+    }
+
     auto file = std::make_unique<QFile>(filename);
 
     auto exists = QFileInfo(filename).isSymLink() || file->exists();
@@ -572,13 +1299,17 @@ int mp::SftpServer::handle_open(sftp_client_message msg)
         auto ret = mp::platform::chown(filename, current_dir.ownerId(), current_dir.groupId());
         if (ret < 0)
         {
-            mpl::log(mpl::Level::error, category,
-                     fmt::format("failed to chown '{}' to owner:{} and group:{}\n", filename, current_dir.ownerId(),
-                                 current_dir.groupId()));
+            mpl::log(mpl::Level::error, category, "failed to chown '{}' to owner:{} and group:{}\n", filename,
+                     current_dir.ownerId(), current_dir.groupId());
             return reply_failure(msg);
         }
     }
 
+    if (mode & QIODevice::WriteOnly)
+        invalidate_attrs_for(filename); // creation/truncation made any cached attrs stale
+    else if (mode == QIODevice::ReadOnly)
+        preload_small_file(*file);
+
     SftpHandleUPtr sftp_handle{sftp_handle_alloc(sftp_server_session.get(), file.get()), ssh_string_free};
     open_file_handles.emplace(file.get(), std::move(file));
 
@@ -601,6 +1332,14 @@ int mp::SftpServer::handle_opendir(sftp_client_message msg)
     auto entry_list =
         std::make_unique<QFileInfoList>(dir.entryInfoList(QDir::AllEntries | QDir::System | QDir::Hidden));
 
+    // Stat the whole listing in one sweep here; QFileInfo caches the results, so the
+    // readdir replies are built from memory instead of interleaving a stat per entry.
+    for (auto& entry : *entry_list)
+    {
+        entry.size();
+        entry.isSymLink();
+    }
+
     SftpHandleUPtr sftp_handle{sftp_handle_alloc(sftp_server_session.get(), entry_list.get()), ssh_string_free};
     open_dir_handles.emplace(entry_list.get(), std::move(entry_list));
 
@@ -611,16 +1350,82 @@ int mp::SftpServer::handle_read(sftp_client_message msg)
 {
     auto file = handle_from(msg, open_file_handles);
     if (file == nullptr)
+    {
+        std::lock_guard<std::mutex> reply_lock{reply_mutex};
         return reply_bad_handle(msg, "read");
+    }
+
+    // Make any coalesced writes on this handle visible before reading
+    flush_write_cache_for(sftp_handle(msg->sftp, msg->handle));
 
-    const auto max_packet_size = 65536u;
+    // Matches the -o max_read passed to the guest's sshfs; each round trip carries
+    // four times the protocol's customary 64K
+    const auto max_packet_size = 262144u;
+    const auto readahead_size = qint64{1} << 20;
     const auto len = std::min(msg->len, max_packet_size);
+    const qint64 offset = msg->offset;
+
+    ReadCache* cache;
+    {
+        std::lock_guard<std::mutex> cache_lock{read_cache_mutex};
+        cache = &read_caches[sftp_handle(msg->sftp, msg->handle)];
+    }
+
+    // Fully cached? Serve straight from the readahead buffer. A buffer known to reach
+    // EOF (a preloaded small file) also answers shorter tails and EOF probes from memory.
+    const auto cache_end = cache->buffer_offset + cache->buffer_size;
+    if (offset >= cache->buffer_offset && (offset + len <= cache_end || (cache->holds_eof && offset < cache_end)))
+    {
+        const auto reply_len = std::min(static_cast<qint64>(len), cache_end - offset);
+        cache->expected_offset = offset + reply_len;
+
+        std::lock_guard<std::mutex> reply_lock{reply_mutex};
+        return sftp_reply_data(msg, cache->buffer.data() + (offset - cache->buffer_offset), reply_len);
+    }
+
+    if (cache->holds_eof && offset >= cache_end)
+    {
+        std::lock_guard<std::mutex> reply_lock{reply_mutex};
+        return sftp_reply_status(msg, SSH_FX_EOF, "End of file");
+    }
+
+    if (offset == cache->expected_offset)
+    {
+        // Sequential access: read well ahead of the request so the next requests are
+        // served from memory instead of one disk round trip each.
+        cache->buffer.resize(readahead_size);
+        file->seek(offset);
+        auto r = file->read(cache->buffer.data(), readahead_size);
+
+        if (r > 0)
+        {
+            cache->buffer_offset = offset;
+            cache->buffer_size = r;
+            cache->holds_eof = false; // a readahead fill need not reach EOF
+            const auto reply_len = std::min(static_cast<qint64>(len), r);
+            cache->expected_offset = offset + reply_len;
+
+            std::lock_guard<std::mutex> reply_lock{reply_mutex};
+            return sftp_reply_data(msg, cache->buffer.data(), reply_len);
+        }
+
+        *cache = ReadCache{};
+
+        std::lock_guard<std::mutex> reply_lock{reply_mutex};
+        if (r < 0)
+            return sftp_reply_status(msg, SSH_FX_FAILURE, file->errorString().toStdString().c_str());
+        return sftp_reply_status(msg, SSH_FX_EOF, "End of file");
+    }
 
+    // Random access: plain read, but remember where a sequential run would continue
     std::vector<char> data;
     data.reserve(len);
 
-    file->seek(msg->offset);
+    file->seek(offset);
     auto r = file->read(data.data(), len);
+    cache->expected_offset = r > 0 ? offset + r : -1;
+
+    std::lock_guard<std::mutex> reply_lock{reply_mutex};
     if (r < 0)
         return sftp_reply_status(msg, SSH_FX_FAILURE, file->errorString().toStdString().c_str());
     else if (r == 0)
@@ -633,17 +1438,26 @@ int mp::SftpServer::handle_readdir(sftp_client_message msg)
 {
     auto dir_entries = handle_from(msg, open_dir_handles);
     if (dir_entries == nullptr)
+    {
+        std::lock_guard<std::mutex> reply_lock{reply_mutex};
         return reply_bad_handle(msg, "readdir");
+    }
 
     if (dir_entries->empty())
+    {
+        std::lock_guard<std::mutex> reply_lock{reply_mutex};
         return sftp_reply_status(msg, SSH_FX_EOF, nullptr);
+    }
 
-    const auto max_num_entries_per_packet = 50;
+    // Match OpenSSH's sftp-server: pack as many names as fit comfortably in a reply,
+    // so enumerating large directories costs O(entries/batch) round trips.
+    const auto max_num_entries_per_packet = 100;
     const auto num_entries = std::min(dir_entries->size(), max_num_entries_per_packet);
 
     for (int i = 0; i < num_entries; i++)
     {
         const QFileInfo entry = dir_entries->takeFirst();
+        remember_attrs_for(entry); // a readdir is usually chased by stats of every entry
         const auto filename = entry.fileName().toStdString();
         sftp_attributes_struct attr{};
         if (entry.isSymLink())
@@ -660,6 +1474,7 @@ int mp::SftpServer::handle_readdir(sftp_client_message msg)
         sftp_reply_names_add(msg, filename.c_str(), longname.data(), &attr);
     }
 
+    std::lock_guard<std::mutex> reply_lock{reply_mutex};
     return sftp_reply_names(msg);
 }
 
@@ -696,6 +1511,9 @@ int mp::SftpServer::handle_remove(sftp_client_message msg)
 
     if (!QFile::remove(filename))
         return reply_failure(msg);
+
+    invalidate_attrs_for(filename);
+    evict_parked_handles_for(filename); // parked fds would resurrect the deleted inode
     return reply_ok(msg);
 }
 
@@ -721,6 +1539,11 @@ int mp::SftpServer::handle_rename(sftp_client_message msg)
     if (!QFile::rename(source, target))
         return reply_failure(msg);
 
+    invalidate_attrs_for(source);
+    invalidate_attrs_for(target);
+    evict_parked_handles_for(source);
+    evict_parked_handles_for(target);
+
     return reply_ok(msg);
 }
 
@@ -765,10 +1588,13 @@ int mp::SftpServer::handle_setstat(sftp_client_message msg)
 
     if (msg->attr->flags & SSH_FILEXFER_ATTR_UIDGID)
     {
-        if (mp::platform::chown(filename.toStdString().c_str(), msg->attr->uid, msg->attr->gid) < 0)
+        if (mp::platform::chown(filename.toStdString().c_str(), reverse_uid_for(msg->attr->uid),
+                                reverse_gid_for(msg->attr->gid)) < 0)
             return reply_failure(msg);
     }
 
+    invalidate_attrs_for(filename.toStdString());
+    evict_parked_handles_for(filename.toStdString()); // size/ownership changed under the parked fd
     return reply_ok(msg);
 }
 
@@ -778,7 +1604,7 @@ int mp::SftpServer::handle_stat(sftp_client_message msg, const bool follow)
     if (!validate_path(source_path, filename))
         return reply_perm_denied(msg);
 
-    QFileInfo file_info(filename);
+    auto file_info = cached_file_info_for(filename);
     if (!file_info.isSymLink() && !file_info.exists())
         return sftp_reply_status(msg, SSH_FX_NO_SUCH_FILE, "no such file");
 
@@ -812,14 +1638,15 @@ int mp::SftpServer::handle_symlink(sftp_client_message msg)
     if (!mp::platform::symlink(old_name, new_name, QFileInfo(old_name).isDir()))
         return reply_failure(msg);
 
+    invalidate_attrs_for(new_name);
+
     QFileInfo current_file(new_name);
     QFileInfo current_dir(current_file.path());
     auto ret = mp::platform::chown(new_name, current_dir.ownerId(), current_dir.groupId());
     if (ret < 0)
     {
-        mpl::log(mpl::Level::error, category,
-                 fmt::format("failed to chown '{}' to owner:{} and group:{}\n", new_name, current_dir.ownerId(),
-                             current_dir.groupId()));
+        mpl::log(mpl::Level::error, category, "failed to chown '{}' to owner:{} and group:{}\n", new_name,
+                 current_dir.ownerId(), current_dir.groupId());
         return reply_failure(msg);
     }
 
@@ -830,25 +1657,57 @@ int mp::SftpServer::handle_write(sftp_client_message msg)
 {
     auto file = handle_from(msg, open_file_handles);
     if (file == nullptr)
+    {
+        std::lock_guard<std::mutex> reply_lock{reply_mutex};
         return reply_bad_handle(msg, "write");
+    }
+
+    const auto id = sftp_handle(msg->sftp, msg->handle);
 
-    auto len = ssh_string_len(msg->data);
+    invalidate_attrs_for(file->fileName().toStdString());
+    {
+        // Writes invalidate any readahead for this handle
+        std::lock_guard<std::mutex> cache_lock{read_cache_mutex};
+        read_caches.erase(id);
+    }
+
+    const auto max_write_cache_size = size_t{4} << 20;
+    const auto len = ssh_string_len(msg->data);
     auto data_ptr = ssh_string_get_char(msg->data);
-    if (!file->seek(msg->offset))
+    const qint64 offset = msg->offset;
+
+    WriteCache* cache;
+    {
+        std::lock_guard<std::mutex> cache_lock{write_cache_mutex};
+        cache = &write_caches[id];
+    }
+
+    // Report a previously failed background flush on the next write for the handle
+    if (cache->failed)
+    {
+        cache->failed = false;
+
+        std::lock_guard<std::mutex> reply_lock{reply_mutex};
         return reply_failure(msg);
+    }
 
-    do
+    const auto contiguous =
+        !cache->buffer.empty() && offset == cache->start_offset + static_cast<qint64>(cache->buffer.size());
+
+    if (!contiguous && !cache->buffer.empty() && !flush_write_cache(file, id, *cache))
     {
-        auto r = file->write(data_ptr, len);
-        if (r < 0)
-            return reply_failure(msg);
+        std::lock_guard<std::mutex> reply_lock{reply_mutex};
+        return reply_failure(msg);
+    }
 
-        file->flush();
+    if (cache->buffer.empty())
+        cache->start_offset = offset;
+    cache->buffer.insert(cache->buffer.end(), data_ptr, data_ptr + len);
 
-        data_ptr += r;
-        len -= r;
-    } while (len > 0);
+    if (cache->buffer.size() >= max_write_cache_size)
+        cache->failed = !flush_write_cache(file, id, *cache);
 
+    std::lock_guard<std::mutex> reply_lock{reply_mutex};
     return reply_ok(msg);
 }
 
@@ -50,8 +50,14 @@ auto run_cmd(mp::SSHSession& session, std::string&& cmd)
     return ssh_process.read_std_output() + ssh_process.read_std_error();
 }
 
-auto get_sshfs_exec_and_options(mp::SSHSession& session)
+auto get_sshfs_exec_and_options(mp::SSHSession& session, const std::string& known_sshfs_exec)
 {
+    // A previous resolution (cached by the daemon per instance) is taken at face value;
+    // if it has gone stale the mount fails and the daemon drops it, so the next attempt
+    // probes afresh
+    if (!known_sshfs_exec.empty())
+        return known_sshfs_exec;
+
     std::string sshfs_exec;
 
     try
@@ -89,6 +95,10 @@ auto get_sshfs_exec_and_options(mp::SSHSession& session)
 
     sshfs_exec += " -o slave -o transform_symlinks -o allow_other -o Compression=no";
 
+    // Quadruple the bytes moved per sftp round trip over sshfs's ~64K default; the
+    // host-side server caps read replies to the same 256K (see SftpServer::handle_read)
+    sshfs_exec += " -o max_read=262144 -o max_write=262144";
+
     auto fuse_version_line = mp::utils::match_line_for(version_info, fuse_version_string);
     if (!fuse_version_line.empty())
     {
@@ -104,10 +114,12 @@ auto get_sshfs_exec_and_options(mp::SSHSession& session)
             mpl::log(mpl::Level::warning, category, fmt::format("Unable to parse the {}", fuse_version_string));
             mpl::log(mpl::Level::debug, category, fmt::format("Unable to parse the {}: {}", fuse_version_string, fuse_version_line));
         }
-        // The option was made the default in libfuse 3.0
+        // The options were made the default in libfuse 3.0 (and dropped there, so only
+        // pass them to older versions); big_writes lifts FUSE's 4K write cap and is the
+        // single largest throughput lever for sshfs on libfuse 2
         else if (version::Semver200_version(fuse_version) < version::Semver200_version("3.0.0"))
         {
-            sshfs_exec += " -o nonempty -o cache_timeout=3";
+            sshfs_exec += " -o nonempty -o big_writes -o cache_timeout=3";
         }
         else
         {
@@ -168,12 +180,13 @@ void set_owner_for(mp::SSHSession& session, const std::string& root, const std::
 }
 
 auto make_sftp_server(mp::SSHSession&& session, const std::string& source, const std::string& target,
-                      const std::unordered_map<int, int>& gid_map, const std::unordered_map<int, int>& uid_map)
+                      const std::unordered_map<int, int>& gid_map, const std::unordered_map<int, int>& uid_map,
+                      const std::string& known_sshfs_exec)
 {
     mpl::log(mpl::Level::debug, category,
              fmt::format("{}:{} {}(source = {}, target = {}, …): ", __FILE__, __LINE__, __FUNCTION__, source, target));
 
-    auto sshfs_exec_line = get_sshfs_exec_and_options(session);
+    auto sshfs_exec_line = get_sshfs_exec_and_options(session, known_sshfs_exec);
 
     // Split the path in existing and missing parts.
     const auto& [leading, missing] = get_path_split(session, target);
@@ -203,8 +216,10 @@ auto make_sftp_server(mp::SSHSession&& session, const std::string& source, const
 } // namespace
 
 mp::SshfsMount::SshfsMount(SSHSession&& session, const std::string& source, const std::string& target,
-                           const std::unordered_map<int, int>& gid_map, const std::unordered_map<int, int>& uid_map)
-    : sftp_server{make_sftp_server(std::move(session), source, target, gid_map, uid_map)}, sftp_thread{[this] {
+                           const std::unordered_map<int, int>& gid_map, const std::unordered_map<int, int>& uid_map,
+                           const std::string& known_sshfs_exec)
+    : sftp_server{make_sftp_server(std::move(session), source, target, gid_map, uid_map, known_sshfs_exec)},
+      sftp_thread{[this] {
           std::cout << "Connected" << std::endl;
           sftp_server->run();
           std::cout << "Stopped" << std::endl;
@@ -223,3 +238,18 @@ void mp::SshfsMount::stop()
     if (sftp_thread.joinable())
         sftp_thread.join();
 }
+
+mp::MountStats mp::SshfsMount::stats() const
+{
+    return sftp_server->stats();
+}
+
+const std::string& mp::SshfsMount::target() const
+{
+    return sftp_server->target();
+}
+
+const std::string& mp::SshfsMount::sshfs_exec_line() const
+{
+    return sftp_server->sshfs_exec();
+}
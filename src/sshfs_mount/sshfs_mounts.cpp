@@ -27,6 +27,8 @@
 
 #include <QEventLoop>
 
+#include <algorithm>
+
 namespace mp = multipass;
 namespace mpl = multipass::logging;
 
@@ -34,27 +36,29 @@ namespace
 {
 constexpr auto category = "sshfs-mounts";
 
-template <typename Signal>
-void start_and_block_until(mp::Process* process, Signal signal, std::function<bool(mp::Process* process)> ready_decider)
+QString serialise_id_map(const std::unordered_map<int, int>& id_map)
 {
-    QEventLoop event_loop;
-    auto stop_conn =
-        QObject::connect(process, &mp::Process::finished, [&event_loop](mp::ProcessState) { event_loop.quit(); });
-
-    auto running_conn = QObject::connect(process, signal, [process, ready_decider, &event_loop]() {
-        if (ready_decider(process))
-        {
-            event_loop.quit();
-        }
-    });
-
-    process->start();
-
-    // This blocks and waits either ready_decider to return true, or failure.
-    event_loop.exec();
+    QString out;
+    for (auto ids : id_map)
+        out += QString("%1:%2,").arg(ids.first).arg(ids.second);
+    return out;
+}
 
-    QObject::disconnect(stop_conn);
-    QObject::disconnect(running_conn);
+// One tab-separated line carrying what the command line and environment carry for a
+// cold-started server; mirrored by the --pooled branch of sshfs_server's main
+QByteArray pooled_config_line(const mp::SSHFSServerConfig& config)
+{
+    const QStringList fields{QString::fromStdString(config.host),
+                             QString::number(config.port),
+                             QString::fromStdString(config.username),
+                             QString::fromStdString(config.source_path),
+                             QString::fromStdString(config.target_path),
+                             serialise_id_map(config.uid_map),
+                             serialise_id_map(config.gid_map),
+                             QString::number(static_cast<int>(mpl::get_logging_level())),
+                             QString::fromStdString(config.private_key),
+                             QString::fromStdString(config.sshfs_exec_line)};
+    return (fields.join('\t') + '\n').toUtf8();
 }
 } // namespace
 
@@ -65,6 +69,15 @@ mp::SSHFSMounts::SSHFSMounts(const SSHKeyProvider& key_provider) : key(key_provi
 void mp::SSHFSMounts::start_mount(VirtualMachine* vm, const std::string& source_path, const std::string& target_path,
                                   const std::unordered_map<int, int>& gid_map,
                                   const std::unordered_map<int, int>& uid_map)
+{
+    wait_until_mount_ready(vm, launch_mount_process(vm, source_path, target_path, gid_map, uid_map));
+}
+
+mp::SSHFSMounts::PendingMountPtr mp::SSHFSMounts::launch_mount_process(VirtualMachine* vm,
+                                                                       const std::string& source_path,
+                                                                       const std::string& target_path,
+                                                                       const std::unordered_map<int, int>& gid_map,
+                                                                       const std::unordered_map<int, int>& uid_map)
 {
     mp::SSHFSServerConfig config;
     config.host = vm->ssh_hostname();
@@ -76,15 +89,67 @@ void mp::SSHFSMounts::start_mount(VirtualMachine* vm, const std::string& source_
     config.uid_map = uid_map;
     config.gid_map = gid_map;
     config.private_key = key;
+    config.sshfs_exec_line = sshfs_exec_lines[vm->vm_name];
+
+    return launch_process(vm, std::move(config));
+}
+
+mp::SSHFSMounts::PendingMountPtr mp::SSHFSMounts::launch_consolidated_mount_process(
+    VirtualMachine* vm, const std::vector<MountSpec>& mount_specs)
+{
+    mp::SSHFSServerConfig config;
+    config.host = vm->ssh_hostname();
+    config.port = vm->ssh_port();
+    config.username = vm->ssh_username();
+    config.instance = vm->vm_name;
+    config.target_path = mount_specs.front().target_path;
+    config.source_path = mount_specs.front().source_path;
+    config.uid_map = mount_specs.front().uid_map;
+    config.gid_map = mount_specs.front().gid_map;
+    config.private_key = key;
+    config.sshfs_exec_line = sshfs_exec_lines[vm->vm_name];
 
-    auto sshfs_server_process_t = mp::platform::make_sshfs_server_process(config);
-    // FIXME: ProcessFactory really should return qt_delete_later_unique_ptr<Process> as Process emits signals
-    // and the respective slots may be called on the event loop, but unique_ptr can delete the Process before
-    // the slots are fired, causing a crash.
-    mp::qt_delete_later_unique_ptr<mp::Process> sshfs_server_process(sshfs_server_process_t.release());
+    for (auto spec = std::next(mount_specs.begin()); spec != mount_specs.end(); ++spec)
+    {
+        config.extra_mounts.push_back({spec->source_path, spec->target_path, spec->gid_map, spec->uid_map});
+        consolidated_aliases[vm->vm_name][spec->target_path] = config.target_path;
+    }
+
+    mpl::log(mpl::Level::info, category,
+             fmt::format("consolidating {} mounts for \"{}\" into one sshfs_server", mount_specs.size(),
+                         vm->vm_name));
+
+    return launch_process(vm, std::move(config));
+}
+
+mp::SSHFSMounts::PendingMountPtr mp::SSHFSMounts::launch_process(VirtualMachine* vm, SSHFSServerConfig config)
+{
+    const auto source_path = config.source_path;
+    const auto target_path = config.target_path;
+
+    // A consolidated launch carries extra shares through the environment, which a warm
+    // server no longer has a say in; everything else can take the pre-spawned one
+    const auto can_prespawn = config.extra_mounts.empty();
+    auto pending = std::make_unique<PendingMount>();
+    bool prespawned = false;
+    if (can_prespawn)
+    {
+        pending->process = take_warm_server();
+        prespawned = pending->process != nullptr;
+    }
+    if (!prespawned)
+    {
+        auto sshfs_server_process_t = mp::platform::make_sshfs_server_process(config);
+        // FIXME: ProcessFactory really should return qt_delete_later_unique_ptr<Process> as Process emits signals
+        // and the respective slots may be called on the event loop, but unique_ptr can delete the Process before
+        // the slots are fired, causing a crash.
+        pending->process = mp::qt_delete_later_unique_ptr<mp::Process>(sshfs_server_process_t.release());
+    }
+    pending->target_path = target_path;
+    auto* sshfs_server_process = pending->process.get();
 
     QObject::connect(
-        sshfs_server_process.get(), &mp::Process::finished, this,
+        sshfs_server_process, &mp::Process::finished, this,
         [this, instance = vm->vm_name, target_path](mp::ProcessState exit_state) {
             if (exit_state.completed_successfully())
             {
@@ -100,41 +165,231 @@ void mp::SSHFSMounts::start_mount(VirtualMachine* vm, const std::string& source_
             }
 
             mount_processes[instance].erase(target_path);
+            output_buffers.erase(instance + target_path);
+
+            auto& aliases = consolidated_aliases[instance];
+            auto& stats = mount_stats[instance];
+            stats.erase(target_path);
+            for (auto alias = aliases.begin(); alias != aliases.end();)
+            {
+                if (alias->second == target_path)
+                {
+                    stats.erase(alias->first);
+                    alias = aliases.erase(alias);
+                }
+                else
+                {
+                    alias = std::next(alias);
+                }
+            }
         });
 
     QObject::connect(
-        sshfs_server_process.get(), &mp::Process::error_occurred, this,
-        [instance = vm->vm_name, target_path, process = sshfs_server_process.get()](QProcess::ProcessError error,
-                                                                                    QString error_string) {
+        sshfs_server_process, &mp::Process::error_occurred, this,
+        [instance = vm->vm_name, target_path](QProcess::ProcessError error, QString error_string) {
             mpl::log(mpl::Level::error, category,
                      fmt::format("There was an error with sshfs_server for instance \"{}\" with path '{}': {} - {}",
                                  instance, target_path, mp::utils::qenum_to_string(error), error_string));
         });
 
+    // Accumulate whatever the server prints until the magic "Connected" line shows up, and
+    // wake whichever event loop happens to be waiting on this mount at the time
+    pending->ready_conn =
+        QObject::connect(sshfs_server_process, &mp::Process::ready_read_standard_output, [raw = pending.get()] {
+            raw->output += raw->process->read_all_standard_output();
+            if (raw->output.contains("Connected")) // Magic string printed by sshfs_server
+                raw->connected = true;
+            if (raw->waiting_loop)
+                raw->waiting_loop->quit();
+        });
+
     mpl::log(mpl::Level::info, category, fmt::format("mounting {} => {} in {}", source_path, target_path, vm->vm_name));
-    mpl::log(mpl::Level::info, category,
-             fmt::format("process program '{}'", sshfs_server_process->program().toStdString()));
-    mpl::log(mpl::Level::info, category,
-             fmt::format("process arguments '{}'", sshfs_server_process->arguments().join(", ").toStdString()));
 
-    start_and_block_until(
-        sshfs_server_process.get(), &mp::Process::ready_read_standard_output, [](mp::Process* process) {
-            return process->read_all_standard_output().contains("Connected"); // Magic string printed by sshfs_server
-        });
+    if (prespawned)
+    {
+        mpl::log(mpl::Level::info, category, "handing the mount to a pre-spawned sshfs_server");
+        sshfs_server_process->write(pooled_config_line(config));
+    }
+    else
+    {
+        mpl::log(mpl::Level::info, category,
+                 fmt::format("process program '{}'", sshfs_server_process->program().toStdString()));
+        mpl::log(mpl::Level::info, category,
+                 fmt::format("process arguments '{}'", sshfs_server_process->arguments().join(", ").toStdString()));
+
+        sshfs_server_process->start();
+    }
+
+    if (can_prespawn)
+        replenish_warm_server(); // keep the next mount warm too
+
+    return pending;
+}
+
+mp::qt_delete_later_unique_ptr<mp::Process> mp::SSHFSMounts::take_warm_server()
+{
+    if (warm_servers.empty())
+        return nullptr;
+
+    auto warm = std::move(warm_servers.front());
+    warm_servers.pop_front();
+    QObject::disconnect(warm.exit_conn); // from here its exit is the mount's to handle
+    return std::move(warm.process);
+}
+
+void mp::SSHFSMounts::replenish_warm_server()
+{
+    if (!warm_servers.empty() || warm_spawning_unsupported)
+        return;
+
+    auto process = mp::platform::make_pooled_sshfs_server_process();
+    if (!process)
+    {
+        warm_spawning_unsupported = true;
+        return;
+    }
+
+    WarmServer warm;
+    warm.process = mp::qt_delete_later_unique_ptr<mp::Process>(process.release());
+    // A spare dying while parked (e.g. on a missing binary) just leaves the pool empty;
+    // the next mount cold-starts and tries to warm a new one
+    warm.exit_conn = QObject::connect(warm.process.get(), &mp::Process::finished, this,
+                                      [this, raw = warm.process.get()](mp::ProcessState exit_state) {
+                                          mpl::log(mpl::Level::warning, category,
+                                                   fmt::format("pre-spawned sshfs_server exited while parked: {}",
+                                                               exit_state.failure_message()));
+                                          warm_servers.erase(
+                                              std::remove_if(warm_servers.begin(), warm_servers.end(),
+                                                             [raw](const WarmServer& server) {
+                                                                 return server.process.get() == raw;
+                                                             }),
+                                              warm_servers.end());
+                                      });
+
+    warm.process->start();
+    warm_servers.push_back(std::move(warm));
+}
+
+void mp::SSHFSMounts::wait_until_mount_ready(VirtualMachine* vm, PendingMountPtr pending)
+{
+    auto* sshfs_server_process = pending->process.get();
+
+    if (!pending->connected && sshfs_server_process->running())
+    {
+        QEventLoop event_loop;
+        auto stop_conn = QObject::connect(sshfs_server_process, &mp::Process::finished,
+                                          [&event_loop](mp::ProcessState) { event_loop.quit(); });
+
+        pending->waiting_loop = &event_loop;
+
+        // This blocks and waits for either the server's handshake, or failure. Output from
+        // the other pending mounts is processed here too, so they make progress in parallel.
+        event_loop.exec();
+
+        pending->waiting_loop = nullptr;
+        QObject::disconnect(stop_conn);
+    }
+
+    QObject::disconnect(pending->ready_conn); // the readiness buffer dies with `pending`
 
     // Check in case sshfs_server stopped, usually due to an error
     auto process_state = sshfs_server_process->process_state();
     if (process_state.exit_code == 9) // Magic number returned by sshfs_server
     {
+        // whatever we knew about the instance's sshfs is evidently stale; probe afresh
+        update_sshfs_exec_line(vm->vm_name, {});
         throw mp::SSHFSMissingError();
     }
     else if (process_state.exit_code || process_state.error)
     {
+        update_sshfs_exec_line(vm->vm_name, {});
         throw std::runtime_error(
             fmt::format("{}: {}", process_state.failure_message(), sshfs_server_process->read_all_standard_error()));
     }
 
-    mount_processes[vm->vm_name][target_path] = std::move(sshfs_server_process);
+    // From here on the server's stdout carries the periodic MOUNT_STATS lines and the
+    // one-shot SSHFS_EXEC line; keep reading it for as long as the process lives. What
+    // already arrived during the handshake is handed over, not dropped with `pending`.
+    output_buffers[vm->vm_name + pending->target_path] = std::move(pending->output);
+    auto* process = pending->process.get();
+    QObject::connect(process, &mp::Process::ready_read_standard_output, this,
+                     [this, instance = vm->vm_name, target = pending->target_path, process] {
+                         auto& buffer = output_buffers[instance + target];
+                         buffer += process->read_all_standard_output();
+
+                         int newline;
+                         while ((newline = buffer.indexOf('\n')) >= 0)
+                         {
+                             ingest_server_output(instance, buffer.left(newline));
+                             buffer.remove(0, newline + 1);
+                         }
+                     });
+
+    // the handed-over buffer may already hold complete lines; don't wait for more output
+    {
+        auto& buffer = output_buffers[vm->vm_name + pending->target_path];
+        int newline;
+        while ((newline = buffer.indexOf('\n')) >= 0)
+        {
+            ingest_server_output(vm->vm_name, buffer.left(newline));
+            buffer.remove(0, newline + 1);
+        }
+    }
+
+    mount_processes[vm->vm_name][pending->target_path] = std::move(pending->process);
+}
+
+void mp::SSHFSMounts::ingest_server_output(const std::string& instance, const QByteArray& line)
+{
+    const auto fields = QString{line}.split('\t');
+    if (fields.count() == 2 && fields[0] == "SSHFS_EXEC")
+    {
+        update_sshfs_exec_line(instance, mp::utils::trim_end(fields[1].toStdString()));
+        return;
+    }
+
+    if (fields.count() != 10 || fields[0] != "MOUNT_STATS")
+        return; // the server also prints other things on stdout; ignore non-stats lines
+
+    MountStats stats;
+    stats.read_ops = fields[2].toULongLong();
+    stats.read_bytes = fields[3].toULongLong();
+    stats.read_usecs = fields[4].toULongLong();
+    stats.write_ops = fields[5].toULongLong();
+    stats.write_bytes = fields[6].toULongLong();
+    stats.write_usecs = fields[7].toULongLong();
+    stats.other_ops = fields[8].toULongLong();
+    stats.other_usecs = fields[9].toULongLong();
+
+    mount_stats[instance][fields[1].toStdString()] = stats;
+}
+
+void mp::SSHFSMounts::set_sshfs_exec_line(const std::string& instance, const std::string& exec_line)
+{
+    sshfs_exec_lines[instance] = exec_line;
+}
+
+void mp::SSHFSMounts::update_sshfs_exec_line(const std::string& instance, const std::string& exec_line)
+{
+    auto& cached = sshfs_exec_lines[instance];
+    if (cached != exec_line)
+    {
+        cached = exec_line;
+        emit sshfs_exec_line_learned(instance, exec_line);
+    }
+}
+
+mp::optional<mp::MountStats> mp::SSHFSMounts::stats_for(const std::string& instance, const std::string& target) const
+{
+    const auto instance_entry = mount_stats.find(instance);
+    if (instance_entry == mount_stats.end())
+        return mp::nullopt;
+
+    const auto target_entry = instance_entry->second.find(target);
+    if (target_entry == instance_entry->second.end())
+        return mp::nullopt;
+
+    return target_entry->second;
 }
 
 bool mp::SSHFSMounts::stop_mount(const std::string& instance, const std::string& path)
@@ -155,6 +410,21 @@ bool mp::SSHFSMounts::stop_mount(const std::string& instance, const std::string&
         sshfs_mount->terminate(); // TODO - if non-responsive, then kill()
         return true;
     }
+
+    const auto aliases_it = consolidated_aliases.find(instance);
+    if (aliases_it != consolidated_aliases.end())
+    {
+        const auto alias = aliases_it->second.find(path);
+        if (alias != aliases_it->second.end())
+        {
+            mpl::log(mpl::Level::warning, category,
+                     fmt::format("'{}' is served by the consolidated sshfs_server for '{}'; stopping it stops all of "
+                                 "its shares",
+                                 path, alias->second));
+            return stop_mount(instance, alias->second);
+        }
+    }
+
     return false;
 }
 
@@ -175,6 +445,7 @@ void mp::SSHFSMounts::stop_all_mounts_for_instance(const std::string& instance)
         }
     }
     mount_processes[instance].clear();
+    consolidated_aliases[instance].clear();
 }
 
 bool mp::SSHFSMounts::has_instance_already_mounted(const std::string& instance, const std::string& path) const
@@ -184,5 +455,7 @@ bool mp::SSHFSMounts::has_instance_already_mounted(const std::string& instance,
     {
         return true;
     }
-    return false;
+
+    auto aliases = consolidated_aliases.find(instance);
+    return aliases != consolidated_aliases.end() && aliases->second.find(path) != aliases->second.end();
 }
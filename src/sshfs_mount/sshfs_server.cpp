@@ -15,9 +15,15 @@
  *
  */
 
+#include <chrono>
+#include <condition_variable>
 #include <iostream>
 #include <memory>
+#include <mutex>
 #include <string>
+#include <thread>
+#include <utility>
+#include <vector>
 
 #include <QStringList>
 
@@ -63,31 +69,97 @@ unordered_map<int, int> deserialise_id_map(const char* in)
     }
     return id_map;
 }
+
+// Extra shares to serve from this process, one "source<TAB>target<TAB>gid_map<TAB>uid_map"
+// per line; see SSHFSServerProcessSpec for the producing side
+struct ExtraMount
+{
+    string source_path;
+    string target_path;
+    unordered_map<int, int> gid_map;
+    unordered_map<int, int> uid_map;
+};
+
+vector<ExtraMount> deserialise_extra_mounts(const QByteArray& in)
+{
+    vector<ExtraMount> mounts;
+    for (const auto& line : QString(in).split('\n', QString::SkipEmptyParts))
+    {
+        auto fields = line.split('\t');
+        if (fields.count() != 4)
+        {
+            cerr << "Incorrect extra mount syntax, ignored" << endl;
+            continue;
+        }
+        mounts.push_back({fields[0].toStdString(), fields[1].toStdString(),
+                          deserialise_id_map(fields[2].toStdString().c_str()),
+                          deserialise_id_map(fields[3].toStdString().c_str())});
+    }
+    return mounts;
+}
 } // namespace
 
 int main(int argc, char* argv[])
 {
-    if (argc != 9)
+    string priv_key_blob, host, username, source_path, target_path, known_sshfs_exec;
+    int port = 0;
+    unordered_map<int, int> uid_map, gid_map;
+    auto log_level = mpl::Level::info;
+
+    if (argc == 2 && string(argv[1]) == "--pooled")
     {
-        cerr << "Incorrect arguments" << endl;
-        exit(2);
-    }
+        // Pre-spawned by the daemon, so process startup is already paid by the time a
+        // mount needs serving; the config arrives as one tab-separated line on stdin,
+        // mirroring what the command line and environment carry for a cold start
+        string line;
+        if (!getline(cin, line))
+        {
+            cerr << "No pooled config received" << endl;
+            exit(2);
+        }
+
+        const auto fields = QString::fromStdString(line).split('\t');
+        if (fields.count() != 10)
+        {
+            cerr << "Incorrect pooled config" << endl;
+            exit(2);
+        }
 
-    const auto key = qgetenv("KEY");
-    if (key == nullptr)
+        host = fields[0].toStdString();
+        port = fields[1].toInt();
+        username = fields[2].toStdString();
+        source_path = fields[3].toStdString();
+        target_path = fields[4].toStdString();
+        uid_map = deserialise_id_map(fields[5].toStdString().c_str());
+        gid_map = deserialise_id_map(fields[6].toStdString().c_str());
+        log_level = static_cast<mpl::Level>(fields[7].toInt());
+        priv_key_blob = fields[8].toStdString();
+        known_sshfs_exec = fields[9].toStdString();
+    }
+    else if (argc == 9)
     {
-        cerr << "KEY not set" << endl;
+        const auto key = qgetenv("KEY");
+        if (key == nullptr)
+        {
+            cerr << "KEY not set" << endl;
+            exit(2);
+        }
+        priv_key_blob = string(key);
+        host = string(argv[1]);
+        port = atoi(argv[2]);
+        username = string(argv[3]);
+        source_path = string(argv[4]);
+        target_path = string(argv[5]);
+        uid_map = deserialise_id_map(argv[6]);
+        gid_map = deserialise_id_map(argv[7]);
+        log_level = static_cast<mpl::Level>(atoi(argv[8]));
+        known_sshfs_exec = string(qgetenv("SSHFS_EXEC_LINE"));
+    }
+    else
+    {
+        cerr << "Incorrect arguments" << endl;
         exit(2);
     }
-    const auto priv_key_blob = string(key);
-    const auto host = string(argv[1]);
-    const int port = atoi(argv[2]);
-    const auto username = string(argv[3]);
-    const auto source_path = string(argv[4]);
-    const auto target_path = string(argv[5]);
-    const unordered_map<int, int> uid_map = deserialise_id_map(argv[6]);
-    const unordered_map<int, int> gid_map = deserialise_id_map(argv[7]);
-    const mpl::Level log_level = static_cast<mpl::Level>(atoi(argv[8]));
 
     auto logger = mpp::make_logger(log_level);
     if (!logger)
@@ -102,12 +174,60 @@ int main(int argc, char* argv[])
         auto watchdog = mpp::make_quit_watchdog(); // called while there is only one thread
 
         mp::SSHSession session{host, port, username, mp::SSHClientKeyProvider{priv_key_blob}};
-        mp::SshfsMount sshfs_mount(move(session), source_path, target_path, gid_map, uid_map);
+        mp::SshfsMount sshfs_mount(move(session), source_path, target_path, gid_map, uid_map, known_sshfs_exec);
+
+        // Publish the resolved sshfs invocation; the daemon caches it per instance so
+        // later mount starts skip the guest-side probes
+        cout << "SSHFS_EXEC\t" << sshfs_mount.sshfs_exec_line() << endl;
+
+        // A consolidated server carries its instance's other shares too, each over its own
+        // session; they share nothing but the process. The first share's sshfs resolution
+        // holds for all of them, so the rest skip the probes either way.
+        vector<unique_ptr<mp::SshfsMount>> extra_sshfs_mounts;
+        for (const auto& mount : deserialise_extra_mounts(qgetenv("EXTRA_MOUNTS")))
+        {
+            mp::SSHSession extra_session{host, port, username, mp::SSHClientKeyProvider{priv_key_blob}};
+            extra_sshfs_mounts.push_back(std::make_unique<mp::SshfsMount>(move(extra_session), mount.source_path,
+                                                                          mount.target_path, mount.gid_map,
+                                                                          mount.uid_map, sshfs_mount.sshfs_exec_line()));
+        }
+
+        // Publish each share's cumulative I/O counters on stdout every few seconds; the
+        // daemon picks these lines up and serves them through `multipass info`
+        vector<pair<string, const mp::SshfsMount*>> reported_mounts{{target_path, &sshfs_mount}};
+        for (const auto& extra_mount : extra_sshfs_mounts)
+            reported_mounts.emplace_back(extra_mount->target(), extra_mount.get());
+
+        mutex stats_mutex;
+        condition_variable stats_cv;
+        bool stats_stopping = false;
+        thread stats_reporter{[&] {
+            unique_lock<std::mutex> lock{stats_mutex};
+            while (!stats_cv.wait_for(lock, chrono::seconds(5), [&stats_stopping] { return stats_stopping; }))
+            {
+                for (const auto& [target, mount] : reported_mounts)
+                {
+                    const auto stats = mount->stats();
+                    cout << "MOUNT_STATS	" << target << '	' << stats.read_ops << '	' << stats.read_bytes << '	'
+                         << stats.read_usecs << '	' << stats.write_ops << '	' << stats.write_bytes << '	'
+                         << stats.write_usecs << '	' << stats.other_ops << '	' << stats.other_usecs << endl;
+                }
+            }
+        }};
 
         // ssh lives on its own thread, use this thread to listen for quit signal
         if (int sig = watchdog())
             cout << "Received signal " << sig << ". Stopping" << endl;
 
+        {
+            lock_guard<std::mutex> lock{stats_mutex};
+            stats_stopping = true;
+        }
+        stats_cv.notify_all();
+        stats_reporter.join();
+
+        for (auto& extra_mount : extra_sshfs_mounts)
+            extra_mount->stop();
         sshfs_mount.stop();
         exit(0);
     }
@@ -15,107 +15,12 @@
  *
  */
 
-#include <multipass/exceptions/invalid_memory_size_exception.h>
 #include <multipass/memory_size.h>
-#include <multipass/utils.h>
-
-#include <multipass/format.h>
 
 namespace mp = multipass;
 
-namespace
-{
-constexpr auto kilo = 1024LL;
-constexpr auto mega = kilo * kilo;
-constexpr auto giga = mega * kilo;
-
-long long in_bytes(const std::string& mem_value)
-{
-    QRegExp matcher("(\\d+)([KMG])?B?", Qt::CaseInsensitive);
-
-    if (matcher.exactMatch(QString::fromStdString(mem_value)))
-    {
-        auto val = matcher.cap(1).toLongLong(); // value is in the second capture (1st one is the whole match)
-        const auto unit = matcher.cap(2);       // unit in the third capture (idem)
-        if (!unit.isEmpty())
-        {
-            switch (unit.at(0).toLower().toLatin1())
-            {
-            case 'g':
-                val *= giga;
-                break;
-            case 'm':
-                val *= mega;
-                break;
-            case 'k':
-                val *= kilo;
-                break;
-            default:
-                assert(false && "Shouldn't be here (invalid unit)");
-            }
-        }
-
-        return val;
-    }
-
-    throw mp::InvalidMemorySizeException{mem_value};
-}
-} // namespace
-
-mp::MemorySize::MemorySize() : bytes{0LL}
-{
-}
-
-mp::MemorySize::MemorySize(const std::string& val) : bytes{::in_bytes(val)}
-{
-}
-
-long long mp::MemorySize::in_bytes() const noexcept
-{
-    return bytes;
-}
-
-long long mp::MemorySize::in_kilobytes() const noexcept
-{
-    return bytes / kilo; // integer division to floor
-}
-
-long long mp::MemorySize::in_megabytes() const noexcept
-{
-    return bytes / mega; // integer division to floor
-}
-
-long long mp::MemorySize::in_gigabytes() const noexcept
-{
-    return bytes / giga; // integer division to floor
-}
-
-bool mp::operator==(const MemorySize& a, const MemorySize& b)
-{
-    return a.bytes == b.bytes;
-}
-
-bool mp::operator!=(const MemorySize& a, const MemorySize& b)
-{
-    return a.bytes != b.bytes;
-}
-
-bool mp::operator<(const MemorySize& a, const MemorySize& b)
-{
-    return a.bytes < b.bytes;
-}
-
-bool mp::operator>(const MemorySize& a, const MemorySize& b)
-{
-    return a.bytes > b.bytes;
-}
-
-bool mp::operator<=(const MemorySize& a, const MemorySize& b)
-{
-    return a.bytes <= b.bytes;
-}
-
-bool mp::operator>=(const MemorySize& a, const MemorySize& b)
+// Everything else lives in the header so it can be constexpr; only the std::string
+// entry point needs a home in a translation unit.
+mp::MemorySize::MemorySize(const std::string& val) : MemorySize{val.c_str()}
 {
-    return a.bytes >= b.bytes;
 }
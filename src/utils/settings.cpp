@@ -22,7 +22,10 @@
 #include <multipass/utils.h> // TODO move out
 
 #include <QDir>
+#include <QFile>
+#include <QFileSystemWatcher>
 #include <QKeySequence>
+#include <QObject>
 #include <QSettings>
 
 #include <algorithm>
@@ -53,7 +56,8 @@ std::map<QString, QString> make_defaults()
     auto ret = std::map<QString, QString>{{mp::petenv_key, petenv_name},
                                           {mp::driver_key, mp::platform::default_driver()},
                                           {mp::autostart_key, autostart_default},
-                                          {mp::hotkey_key, default_hotkey()}};
+                                          {mp::hotkey_key, default_hotkey()},
+                                          {mp::log_levels_key, ""}};
 
     for(const auto& [k, v] : mp::platform::extra_settings_defaults())
         ret.insert_or_assign(k, v);
@@ -112,20 +116,16 @@ void check_status(const QSettings& settings, const QString& attempted_operation)
                                      : QStringLiteral("access error (consider running with an administrative role)")};
 }
 
-QString checked_get(const QSettings& settings, const QString& key, const QString& fallback, std::mutex& mutex)
-{
-    std::lock_guard<std::mutex> lock{mutex};
-
+QString checked_get(const QSettings& settings, const QString& key, const QString& fallback)
+{ // expects the caller to hold the settings mutex
     auto ret = settings.value(key, fallback).toString();
 
     check_status(settings, QStringLiteral("read"));
     return ret;
 }
 
-void checked_set(QSettings& settings, const QString& key, const QString& val, std::mutex& mutex)
-{
-    std::lock_guard<std::mutex> lock{mutex};
-
+void checked_set(QSettings& settings, const QString& key, const QString& val)
+{ // expects the caller to hold the settings mutex
     settings.setValue(key, val);
 
     settings.sync(); // flush to confirm we can write
@@ -166,8 +166,21 @@ std::set<QString> multipass::Settings::keys() const
 QString mp::Settings::get(const QString& key) const
 {
     const auto& default_ret = get_default(key); // make sure the key is valid before reading from disk
+
+    std::lock_guard<std::mutex> lock{mutex};
+
+    auto it = cache.find(key);
+    if (it != cache.end())
+        return it->second;
+
     auto settings = persistent_settings(key);
-    return checked_get(*settings, key, default_ret, mutex);
+    auto ret = checked_get(*settings, key, default_ret);
+
+    // Only cache what the watcher can invalidate; until the file exists, keep reading disk
+    if (watch_file_for(key))
+        cache.emplace(key, ret);
+
+    return ret;
 }
 
 void mp::Settings::set(const QString& key, const QString& val)
@@ -176,6 +189,44 @@ void mp::Settings::set(const QString& key, const QString& val)
     set_aux(key, val);
 }
 
+void mp::Settings::monitor_external_changes(std::function<void()> handler)
+{
+    std::lock_guard<std::mutex> lock{mutex};
+    external_change_handler = std::move(handler);
+    watch_file_for(daemon_root);
+}
+
+bool mp::Settings::watch_file_for(const QString& key) const
+{ // expects the caller to hold the settings mutex
+    const auto filename = file_for(key);
+    if (watched_files.count(filename))
+        return true;
+
+    if (!QFile::exists(filename))
+        return false;
+
+    if (watcher == nullptr)
+    {
+        watcher = std::make_unique<QFileSystemWatcher>();
+        QObject::connect(watcher.get(), &QFileSystemWatcher::fileChanged, [this](const QString& path) {
+            std::function<void()> handler;
+            {
+                std::lock_guard<std::mutex> lock{mutex};
+                cache.clear();
+                watcher->addPath(path); // most editors replace the file, dropping the watch; re-arm it
+                handler = external_change_handler;
+            }
+
+            if (handler)
+                handler();
+        });
+    }
+
+    watcher->addPath(filename);
+    watched_files.insert(filename);
+    return true;
+}
+
 const QString& mp::Settings::get_default(const QString& key) const
 {
     try
@@ -211,5 +262,10 @@ void multipass::Settings::set_aux(const QString& key, QString val) // work with
         val = mp::platform::interpret_setting(key, val);
 
     auto settings = persistent_settings(key);
-    checked_set(*settings, key, val, mutex);
+
+    std::lock_guard<std::mutex> lock{mutex};
+    checked_set(*settings, key, val);
+
+    if (watch_file_for(key))
+        cache.insert_or_assign(key, val);
 }
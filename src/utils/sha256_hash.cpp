@@ -0,0 +1,77 @@
+/*
+ * Copyright (C) 2021 Canonical, Ltd.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; version 3.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include <multipass/sha256_hash.h>
+
+#include <openssl/evp.h>
+
+#include <stdexcept>
+#include <vector>
+
+namespace mp = multipass;
+
+struct mp::Sha256Hash::Impl
+{
+    std::unique_ptr<EVP_MD_CTX, decltype(EVP_MD_CTX_free)*> ctx{EVP_MD_CTX_new(), EVP_MD_CTX_free};
+};
+
+mp::Sha256Hash::Sha256Hash() : impl{std::make_unique<Impl>()}
+{
+    if (impl->ctx == nullptr || EVP_DigestInit_ex(impl->ctx.get(), EVP_sha256(), nullptr) != 1)
+        throw std::runtime_error("Failed to initialize SHA256 digest");
+}
+
+mp::Sha256Hash::~Sha256Hash() = default;
+
+void mp::Sha256Hash::addData(const char* data, int length)
+{
+    if (EVP_DigestUpdate(impl->ctx.get(), data, length) != 1)
+        throw std::runtime_error("Failed to update SHA256 digest");
+}
+
+void mp::Sha256Hash::addData(const QByteArray& data)
+{
+    addData(data.constData(), data.size());
+}
+
+bool mp::Sha256Hash::addData(QIODevice* device)
+{
+    if (device == nullptr || !device->isReadable())
+        return false;
+
+    std::vector<char> buffer(256 * 1024);
+    qint64 bytes_read;
+    while ((bytes_read = device->read(buffer.data(), buffer.size())) > 0)
+        addData(buffer.data(), static_cast<int>(bytes_read));
+
+    return bytes_read == 0; // -1 indicates a read error
+}
+
+QByteArray mp::Sha256Hash::result() const
+{
+    // Finalize a copy, so more data can still be added afterwards, as with QCryptographicHash
+    std::unique_ptr<EVP_MD_CTX, decltype(EVP_MD_CTX_free)*> ctx_copy{EVP_MD_CTX_new(), EVP_MD_CTX_free};
+    if (ctx_copy == nullptr || EVP_MD_CTX_copy_ex(ctx_copy.get(), impl->ctx.get()) != 1)
+        throw std::runtime_error("Failed to copy SHA256 digest state");
+
+    unsigned char digest[EVP_MAX_MD_SIZE];
+    unsigned int digest_len{0};
+    if (EVP_DigestFinal_ex(ctx_copy.get(), digest, &digest_len) != 1)
+        throw std::runtime_error("Failed to finalize SHA256 digest");
+
+    return QByteArray{reinterpret_cast<const char*>(digest), static_cast<int>(digest_len)};
+}
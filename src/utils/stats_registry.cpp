@@ -0,0 +1,104 @@
+/*
+ * Copyright (C) 2021 Canonical, Ltd.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; version 3.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include <multipass/stats_registry.h>
+
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QString>
+
+namespace mp = multipass;
+
+namespace
+{
+int bucket_for(uint64_t us)
+{
+    int bucket = 0;
+    while (us >>= 1)
+        ++bucket;
+    return bucket;
+}
+
+// Upper bound of the smallest bucket holding the requested quantile; one power of two of
+// resolution is plenty for spotting regressions between releases
+uint64_t percentile_from(const std::array<uint64_t, 64>& buckets, uint64_t samples, int percent)
+{
+    const auto target = (samples * percent + 99) / 100;
+    uint64_t seen = 0;
+    for (auto i = 0u; i < buckets.size(); ++i)
+    {
+        seen += buckets[i];
+        if (seen >= target)
+            return 1ull << (i + 1);
+    }
+    return 0;
+}
+} // namespace
+
+mp::StatsRegistry::StatsRegistry(const Singleton<StatsRegistry>::PrivatePass& pass)
+    : Singleton<StatsRegistry>::Singleton{pass}
+{
+}
+
+void mp::StatsRegistry::count(const std::string& name, uint64_t amount)
+{
+    const std::lock_guard<std::mutex> lock{mutex};
+    counters[name] += amount;
+}
+
+void mp::StatsRegistry::record(const std::string& name, std::chrono::microseconds elapsed)
+{
+    const auto us = static_cast<uint64_t>(elapsed.count());
+
+    const std::lock_guard<std::mutex> lock{mutex};
+    auto& histogram = histograms[name];
+    ++histogram.buckets[bucket_for(us)];
+    ++histogram.samples;
+    histogram.total_us += us;
+    histogram.max_us = std::max(histogram.max_us, us);
+}
+
+std::string mp::StatsRegistry::dump() const
+{
+    QJsonObject counters_json, histograms_json;
+
+    {
+        const std::lock_guard<std::mutex> lock{mutex};
+
+        for (const auto& counter : counters)
+            counters_json.insert(QString::fromStdString(counter.first), static_cast<qint64>(counter.second));
+
+        for (const auto& entry : histograms)
+        {
+            const auto& histogram = entry.second;
+            QJsonObject summary;
+            summary.insert("samples", static_cast<qint64>(histogram.samples));
+            summary.insert("mean_us", static_cast<qint64>(histogram.total_us / std::max<uint64_t>(1, histogram.samples)));
+            summary.insert("max_us", static_cast<qint64>(histogram.max_us));
+            summary.insert("p50_us", static_cast<qint64>(percentile_from(histogram.buckets, histogram.samples, 50)));
+            summary.insert("p90_us", static_cast<qint64>(percentile_from(histogram.buckets, histogram.samples, 90)));
+            summary.insert("p99_us", static_cast<qint64>(percentile_from(histogram.buckets, histogram.samples, 99)));
+            histograms_json.insert(QString::fromStdString(entry.first), summary);
+        }
+    }
+
+    QJsonObject stats;
+    stats.insert("counters", counters_json);
+    stats.insert("durations", histograms_json);
+
+    return QJsonDocument{stats}.toJson(QJsonDocument::Indented).toStdString();
+}
@@ -0,0 +1,81 @@
+/*
+ * Copyright (C) 2021 Canonical, Ltd.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; version 3.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include <multipass/tracing.h>
+
+#include <multipass/format.h>
+
+#include <QString>
+
+#include <cstdlib>
+#include <functional>
+#include <thread>
+
+namespace mp = multipass;
+
+namespace
+{
+// enough to hold every span of a handful of concurrent launches
+constexpr auto max_recent_spans = 512u;
+
+auto us_since(std::chrono::steady_clock::time_point earlier, std::chrono::steady_clock::time_point later)
+{
+    return std::chrono::duration_cast<std::chrono::microseconds>(later - earlier).count();
+}
+} // namespace
+
+mp::Tracer::Tracer(const Singleton<Tracer>::PrivatePass& pass) : Singleton<Tracer>::Singleton{pass}
+{
+    if (const auto* trace_path = std::getenv("MULTIPASS_TRACE_FILE"))
+    {
+        trace_file.open(trace_path, std::ios::out | std::ios::trunc);
+        // the viewers accept an unterminated event array, so events can just be appended
+        trace_file << "[\n";
+    }
+}
+
+void mp::Tracer::record(const std::string& name, std::chrono::steady_clock::time_point start,
+                        std::chrono::steady_clock::time_point end)
+{
+    const std::lock_guard<std::mutex> lock{mutex};
+
+    recent_spans.push_back({name, start, end});
+    if (recent_spans.size() > max_recent_spans)
+        recent_spans.pop_front();
+
+    if (trace_file.is_open())
+    {
+        const auto tid = std::hash<std::thread::id>{}(std::this_thread::get_id()) % 100000;
+        trace_file << fmt::format("{{\"name\": \"{}\", \"ph\": \"X\", \"ts\": {}, \"dur\": {}, \"pid\": 1, "
+                                  "\"tid\": {}}},\n",
+                                  name, us_since(std::chrono::steady_clock::time_point{}, start),
+                                  us_since(start, end), tid);
+        trace_file.flush();
+    }
+}
+
+std::vector<mp::Tracer::Span> mp::Tracer::spans_since(std::chrono::steady_clock::time_point t) const
+{
+    const std::lock_guard<std::mutex> lock{mutex};
+
+    std::vector<Span> spans;
+    for (const auto& span : recent_spans)
+        if (span.end >= t)
+            spans.push_back(span);
+
+    return spans;
+}
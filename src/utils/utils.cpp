@@ -24,6 +24,7 @@
 #include <multipass/settings.h>
 #include <multipass/ssh/ssh_session.h>
 #include <multipass/standard_paths.h>
+#include <multipass/tracing.h>
 #include <multipass/utils.h>
 
 #include <QDir>
@@ -31,6 +32,7 @@
 #include <QProcess>
 #include <QRegularExpression>
 #include <QStorageInfo>
+#include <QTcpSocket>
 #include <QUuid>
 #include <QtGlobal>
 
@@ -74,6 +76,13 @@ QString find_autostart_target(const QString& subdir, const QString& autostart_fi
 
     return target_path;
 }
+
+bool tcp_port_accepting(const std::string& host, int port, std::chrono::milliseconds timeout)
+{
+    QTcpSocket socket;
+    socket.connectToHost(QString::fromStdString(host), static_cast<quint16>(port));
+    return socket.waitForConnected(timeout.count());
+}
 } // namespace
 
 QDir mp::utils::base_dir(const QString& path)
@@ -208,37 +217,87 @@ bool mp::utils::valid_mac_address(const std::string& mac)
 void mp::utils::wait_until_ssh_up(VirtualMachine* virtual_machine, std::chrono::milliseconds timeout,
                                   std::function<void()> const& ensure_vm_is_running)
 {
+    using namespace std::literals::chrono_literals;
+
+    const mp::TracedSpan span{fmt::format("ssh up: {}", virtual_machine->vm_name)};
+
     mpl::log(mpl::Level::debug, virtual_machine->vm_name,
              fmt::format("Trying SSH on {}:{}", virtual_machine->ssh_hostname(), virtual_machine->ssh_port()));
-    auto action = [virtual_machine, &ensure_vm_is_running] {
+
+    std::default_random_engine jitter_gen{std::random_device{}()};
+    std::uniform_int_distribution<int> jitter_dist{0, 100};
+
+    const auto deadline = std::chrono::steady_clock::now() + timeout;
+    auto backoff = 100ms;
+    while (std::chrono::steady_clock::now() < deadline)
+    {
         ensure_vm_is_running();
-        try
-        {
-            mp::SSHSession session{virtual_machine->ssh_hostname(), virtual_machine->ssh_port()};
 
-            std::lock_guard<decltype(virtual_machine->state_mutex)> lock{virtual_machine->state_mutex};
-            virtual_machine->state = VirtualMachine::State::running;
-            virtual_machine->update_state();
-            return mp::utils::TimeoutAction::done;
-        }
-        catch (const std::exception&)
+        // A bare TCP probe spares half-booted guests from having to service (and reject) a full
+        // SSH handshake on every retry
+        if (tcp_port_accepting(virtual_machine->ssh_hostname(), virtual_machine->ssh_port(), 250ms))
         {
-            return mp::utils::TimeoutAction::retry;
+            try
+            {
+                mp::SSHSession session{virtual_machine->ssh_hostname(), virtual_machine->ssh_port()};
+
+                std::lock_guard<decltype(virtual_machine->state_mutex)> lock{virtual_machine->state_mutex};
+                virtual_machine->state = VirtualMachine::State::running;
+                virtual_machine->update_state();
+                return;
+            }
+            catch (const std::exception&)
+            {
+                // the port accepted but sshd is not quite there yet; back off and retry below
+            }
         }
-    };
-    auto on_timeout = [virtual_machine] {
-        std::lock_guard<decltype(virtual_machine->state_mutex)> lock{virtual_machine->state_mutex};
-        virtual_machine->state = VirtualMachine::State::unknown;
-        virtual_machine->update_state();
-        throw std::runtime_error(fmt::format("{}: timed out waiting for response", virtual_machine->vm_name));
-    };
 
-    mp::utils::try_action_for(on_timeout, timeout, action);
+        if (std::chrono::steady_clock::now() + backoff >= deadline)
+            break;
+
+        // Exponential backoff with jitter: quick off the mark for fast boots, gentle on slow
+        // ones, and instances started together drift apart instead of retrying in lock-step
+        std::this_thread::sleep_for(backoff + std::chrono::milliseconds{jitter_dist(jitter_gen)});
+        backoff = std::min<std::chrono::milliseconds>(backoff * 2, 2s);
+    }
+
+    std::lock_guard<decltype(virtual_machine->state_mutex)> lock{virtual_machine->state_mutex};
+    virtual_machine->state = VirtualMachine::State::unknown;
+    virtual_machine->update_state();
+    throw std::runtime_error(fmt::format("{}: timed out waiting for response", virtual_machine->vm_name));
 }
 
 void mp::utils::wait_for_cloud_init(mp::VirtualMachine* virtual_machine, std::chrono::milliseconds timeout,
                                     const mp::SSHKeyProvider& key_provider)
 {
+    const mp::TracedSpan span{fmt::format("cloud-init: {}", virtual_machine->vm_name)};
+
+    const auto deadline = std::chrono::steady_clock::now() + timeout;
+
+    // One guest-side wait instead of daemon-side polling: this exec returns the moment
+    // the guest writes its completion marker, so readiness is signalled rather than
+    // sampled and launch loses the poll quantum. Images too old to know --wait (and
+    // runs where cloud-init reports trouble) drop to the marker poll below, which
+    // stays the arbiter it always was.
+    try
+    {
+        virtual_machine->ensure_vm_is_running();
+        mp::SSHSession session{virtual_machine->ssh_hostname(), virtual_machine->ssh_port(),
+                               virtual_machine->ssh_username(), key_provider};
+
+        auto ssh_process = session.exec({"cloud-init status --wait > /dev/null 2>&1"});
+        if (ssh_process.exit_code(timeout) == 0)
+            return;
+    }
+    catch (const std::exception& e)
+    {
+        mpl::log(mpl::Level::warning, virtual_machine->vm_name,
+                 fmt::format("guest-side cloud-init wait failed ({}); falling back to polling", e.what()));
+    }
+
+    const auto remaining =
+        std::chrono::duration_cast<std::chrono::milliseconds>(deadline - std::chrono::steady_clock::now());
+
     auto action = [virtual_machine, &key_provider] {
         virtual_machine->ensure_vm_is_running();
         try
@@ -258,7 +317,7 @@ void mp::utils::wait_for_cloud_init(mp::VirtualMachine* virtual_machine, std::ch
         }
     };
     auto on_timeout = [] { throw std::runtime_error("timed out waiting for initialization to complete"); };
-    mp::utils::try_action_for(on_timeout, timeout, action);
+    mp::utils::try_action_for(on_timeout, std::max(remaining, std::chrono::milliseconds::zero()), action);
 }
 
 void mp::utils::install_sshfs_for(const std::string& name, mp::SSHSession& session,
@@ -448,6 +507,16 @@ void mp::utils::validate_server_address(const std::string& address)
         throw std::runtime_error(fmt::format("invalid port number in address '{}'", address));
 }
 
+QString mp::utils::heartbeat_file_path(const std::string& server_address)
+{
+    // only unix sockets have a local filesystem location to park the heartbeat next to
+    const auto tokens = mp::utils::split(server_address, ":");
+    if (tokens.size() != 2u || tokens[0] != "unix")
+        return {};
+
+    return QString::fromStdString(tokens[1]) + ".heartbeat";
+}
+
 std::string mp::utils::filename_for(const std::string& path)
 {
     return QFileInfo(QString::fromStdString(path)).fileName().toStdString();
@@ -15,11 +15,12 @@
  *
  */
 
+#include <multipass/sha256_hash.h>
+#include <multipass/stats_registry.h>
 #include <multipass/vm_image_host.h>
 #include <multipass/vm_image_vault.h>
 #include <multipass/xz_image_decoder.h>
 
-#include <QCryptographicHash>
 #include <QFileInfo>
 
 #include <stdexcept>
@@ -40,13 +41,15 @@ void mp::vault::delete_file(const mp::Path& path)
 
 QString mp::vault::compute_image_hash(const mp::Path& image_path)
 {
+    const mp::StageTimer timer{"vault.hash"};
+
     QFile image_file(image_path);
     if (!image_file.open(QFile::ReadOnly))
     {
         throw std::runtime_error("Cannot open image file for computing hash");
     }
 
-    QCryptographicHash hash(QCryptographicHash::Sha256);
+    mp::Sha256Hash hash;
     if (!hash.addData(&image_file))
     {
         throw std::runtime_error("Cannot read image file to compute hash");
@@ -23,6 +23,9 @@
 
 #include <vector>
 
+#include <fcntl.h>
+#include <sys/mman.h>
+
 namespace mp = multipass;
 
 namespace
@@ -61,6 +64,10 @@ mp::XzImageDecoder::XzImageDecoder(const Path& xz_file_path)
     xz_crc64_init();
 }
 
+mp::XzImageDecoder::XzImageDecoder() : XzImageDecoder{Path()}
+{
+}
+
 void mp::XzImageDecoder::decode_to(const Path& decoded_image_path, const ProgressMonitor& monitor)
 {
     if (!xz_file.open(QIODevice::ReadOnly))
@@ -70,6 +77,15 @@ void mp::XzImageDecoder::decode_to(const Path& decoded_image_path, const Progres
     if (!decoded_file.open(QIODevice::WriteOnly))
         throw std::runtime_error(fmt::format("failed to open {} for writing", decoded_file.fileName()));
 
+    const auto file_size = xz_file.size();
+
+    // Map the compressed file rather than read()ing it: the decoder then consumes
+    // pages straight from the page cache instead of copying them into a userspace
+    // buffer first, and the kernel gets told up front that the pass is sequential
+    const auto* mapped_input = file_size > 0 ? xz_file.map(0, file_size) : nullptr;
+    if (mapped_input)
+        ::madvise(const_cast<uchar*>(mapped_input), file_size, MADV_SEQUENTIAL);
+
     struct xz_buf decode_buf
     {
     };
@@ -79,19 +95,36 @@ void mp::XzImageDecoder::decode_to(const Path& decoded_image_path, const Progres
     read_data.reserve(max_size);
     write_data.reserve(max_size);
 
-    decode_buf.in = reinterpret_cast<unsigned char*>(read_data.data());
+    decode_buf.in = mapped_input ? mapped_input : reinterpret_cast<unsigned char*>(read_data.data());
     decode_buf.in_pos = 0;
-    decode_buf.in_size = 0;
+    decode_buf.in_size = mapped_input ? static_cast<size_t>(file_size) : 0;
     decode_buf.out = reinterpret_cast<unsigned char*>(write_data.data());
     decode_buf.out_pos = 0;
     decode_buf.out_size = max_size;
 
-    const auto file_size = xz_file.size();
     qint64 total_bytes_extracted{0};
 
+    // The decoded image is written once and read back much later, if at all; dropping
+    // its pages behind the write cursor keeps a multi-GB decode from evicting the
+    // cached vault images other launches are using. Clean pages go immediately; pages
+    // still dirty are skipped and picked up by a later pass, once written back.
+    qint64 bytes_written{0}, last_dropped{0};
+    constexpr qint64 drop_window = 8 * 1024 * 1024;
+    auto write_out = [&](qint64 out_bytes) {
+        decoded_file.write(write_data.data(), out_bytes);
+        bytes_written += out_bytes;
+
+        if (bytes_written - last_dropped >= drop_window)
+        {
+            decoded_file.flush();
+            ::posix_fadvise(decoded_file.handle(), 0, bytes_written, POSIX_FADV_DONTNEED);
+            last_dropped = bytes_written;
+        }
+    };
+
     while (true)
     {
-        if (decode_buf.in_pos == decode_buf.in_size)
+        if (!mapped_input && decode_buf.in_pos == decode_buf.in_size)
         {
             decode_buf.in_size = xz_file.read(read_data.data(), max_size);
             decode_buf.in_pos = 0;
@@ -99,17 +132,61 @@ void mp::XzImageDecoder::decode_to(const Path& decoded_image_path, const Progres
             auto progress = (total_bytes_extracted / (float)file_size) * 100;
             monitor(LaunchProgress::EXTRACT, progress);
         }
+        else if (mapped_input)
+        {
+            auto progress = (decode_buf.in_pos / (float)file_size) * 100;
+            monitor(LaunchProgress::EXTRACT, progress);
+        }
 
         if (!verify_decode(xz_dec_run(xz_decoder.get(), &decode_buf)))
         {
-            decoded_file.write(write_data.data(), decode_buf.out_pos);
+            write_out(decode_buf.out_pos);
             return;
         }
 
         if (decode_buf.out_pos == max_size)
         {
-            decoded_file.write(write_data.data(), decode_buf.out_pos);
+            write_out(decode_buf.out_pos);
             decode_buf.out_pos = 0;
         }
     }
 }
+
+bool mp::XzImageDecoder::decode_chunk(const char* data, qint64 size, QFile& decoded_file)
+{
+    if (stream_ended)
+        return false;
+
+    const auto max_size = 65536u;
+    if (chunk_out_buf.size() < max_size)
+        chunk_out_buf.resize(max_size);
+
+    struct xz_buf decode_buf
+    {
+    };
+    decode_buf.in = reinterpret_cast<const unsigned char*>(data);
+    decode_buf.in_pos = 0;
+    decode_buf.in_size = static_cast<size_t>(size);
+    decode_buf.out = reinterpret_cast<unsigned char*>(chunk_out_buf.data());
+    decode_buf.out_pos = 0;
+    decode_buf.out_size = max_size;
+
+    while (decode_buf.in_pos < decode_buf.in_size)
+    {
+        if (!verify_decode(xz_dec_run(xz_decoder.get(), &decode_buf)))
+        {
+            decoded_file.write(chunk_out_buf.data(), decode_buf.out_pos);
+            stream_ended = true;
+            return false;
+        }
+
+        if (decode_buf.out_pos == max_size)
+        {
+            decoded_file.write(chunk_out_buf.data(), decode_buf.out_pos);
+            decode_buf.out_pos = 0;
+        }
+    }
+
+    decoded_file.write(chunk_out_buf.data(), decode_buf.out_pos);
+    return true;
+}
@@ -42,6 +42,13 @@ int virConnectClose(virConnectPtr conn)
     return 0;
 }
 
+int virConnectIsAlive(virConnectPtr /*conn*/)
+{
+    // Reporting the shared connection dead makes every loan re-open it, so tests that
+    // override virConnectOpen keep taking effect mid-test
+    return 0;
+}
+
 char* virConnectGetCapabilities(virConnectPtr /*conn*/)
 {
     return strdup("");
@@ -53,6 +60,20 @@ int virConnectGetVersion(virConnectPtr /*conn*/, unsigned long* hvVer)
     return 0;
 }
 
+int virConnectDomainEventRegisterAny(virConnectPtr /*conn*/, virDomainPtr /*domain*/, int /*eventID*/,
+                                     virConnectDomainEventGenericCallback /*cb*/, void* /*opaque*/,
+                                     virFreeCallback /*freecb*/)
+{
+    // Refusing the subscription keeps the backend on its polling path, so tests do not
+    // spawn an event loop thread
+    return -1;
+}
+
+int virConnectDomainEventDeregisterAny(virConnectPtr /*conn*/, int /*callbackID*/)
+{
+    return 0;
+}
+
 int virDomainCreate(virDomainPtr /*domain*/)
 {
     return 0;
@@ -73,6 +94,11 @@ int virDomainFree(virDomainPtr /*domain*/)
     return 0;
 }
 
+const char* virDomainGetName(virDomainPtr /*domain*/)
+{
+    return "real";
+}
+
 int virDomainGetState(virDomainPtr /*domain*/, int* state, int* /*reason*/, unsigned int /*flags*/)
 {
     *state = VIR_DOMAIN_SHUTOFF;
@@ -110,6 +136,16 @@ int virDomainUndefine(virDomainPtr /*domain*/)
     return 0;
 }
 
+int virEventRegisterDefaultImpl()
+{
+    return 0;
+}
+
+int virEventRunDefaultImpl()
+{
+    return 0;
+}
+
 int virNetworkCreate(virNetworkPtr /*network*/)
 {
     return 0;
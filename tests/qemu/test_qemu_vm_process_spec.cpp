@@ -18,8 +18,10 @@
 #include <src/platform/backends/qemu/qemu_vm_process_spec.h>
 
 #include "tests/mock_environment_helpers.h"
+
 #include <gmock/gmock.h>
 
+#include <QFile>
 #include <QTemporaryDir>
 
 namespace mp = multipass;
@@ -48,6 +50,10 @@ TEST_F(TestQemuVMProcessSpec, default_arguments_correct)
 {
     mp::QemuVMProcessSpec spec(desc, tap_device_name, mp::nullopt);
 
+    auto netdev = QString{"tap,id=hostnet0,ifname=tap_device,script=no,downscript=no"};
+    if (QFile::exists("/dev/vhost-net"))
+        netdev += ",vhost=on";
+
     EXPECT_EQ(spec.arguments(), QStringList({"--enable-kvm",
                                              "-device",
                                              "virtio-scsi-pci,id=scsi0",
@@ -56,13 +62,22 @@ TEST_F(TestQemuVMProcessSpec, default_arguments_correct)
                                              "-device",
                                              "scsi-hd,drive=hda,bus=scsi0.0",
                                              "-smp",
-                                             "2",
+                                             "2,sockets=1,cores=2,threads=1",
                                              "-m",
                                              "3072M",
                                              "-device",
                                              "virtio-net-pci,netdev=hostnet0,id=net0,mac=00:11:22:33:44:55",
                                              "-netdev",
-                                             "tap,id=hostnet0,ifname=tap_device,script=no,downscript=no",
+                                             netdev,
+                                             "-device",
+                                             "virtio-balloon-pci,id=balloon0",
+                                             "-chardev",
+                                             "socket,id=qga0,path=/path/to/image.agent,server,nowait",
+                                             "-device",
+                                             "virtio-serial-pci,id=virtio-serial0",
+                                             "-device",
+                                             "virtserialport,bus=virtio-serial0.0,chardev=qga0,"
+                                             "name=org.qemu.guest_agent.0",
                                              "-qmp",
                                              "stdio",
                                              "-cpu",
@@ -176,6 +191,7 @@ TEST_F(TestQemuVMProcessSpec, apparmor_profile_includes_disk_images)
 
     EXPECT_TRUE(spec.apparmor_profile().contains("/path/to/image rwk,"));
     EXPECT_TRUE(spec.apparmor_profile().contains("/path/to/cloud_init.iso rk,"));
+    EXPECT_TRUE(spec.apparmor_profile().contains("/path/to/image.agent rw,"));
 }
 
 TEST_F(TestQemuVMProcessSpec, apparmor_profile_identifier)
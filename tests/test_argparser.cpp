@@ -36,7 +36,7 @@ struct TestVerbosity : public TestWithParam<int>
 TEST_P(TestVerbosity, test_various_vs)
 {
     std::ostringstream oss;
-    const auto cmds = std::vector<mp::cmd::Command::UPtr>{};
+    const auto cmds = std::vector<mp::cmd::LazyCommand>{};
     const auto v = GetParam();
     auto args = QStringList{"multipass_tests"};
 
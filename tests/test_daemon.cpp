@@ -227,7 +227,7 @@ class TestClient : public mp::Client
 public:
     explicit TestClient(mp::ClientConfig& context) : mp::Client{context}
     {
-        add_command<TestCreate>();
+        add_command<TestCreate>({"test_create"});
         sort_commands();
     }
 };
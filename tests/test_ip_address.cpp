@@ -75,3 +75,49 @@ TEST(IPAddress, supports_addition_operator)
     auto result_ip = an_ip + 4;
     EXPECT_THAT(result_ip, Eq(expected_ip));
 }
+
+TEST(SubnetIndex, finds_first_free_address)
+{
+    mp::SubnetIndex index{mp::IPAddress{"10.120.0.2"}, mp::IPAddress{"10.120.0.254"}};
+
+    EXPECT_THAT(index.first_free(), Eq(mp::optional<mp::IPAddress>{mp::IPAddress{"10.120.0.2"}}));
+
+    index.mark_in_use(mp::IPAddress{"10.120.0.2"});
+    index.mark_in_use(mp::IPAddress{"10.120.0.3"});
+
+    EXPECT_THAT(index.first_free(), Eq(mp::optional<mp::IPAddress>{mp::IPAddress{"10.120.0.4"}}));
+}
+
+TEST(SubnetIndex, tracks_marking_and_freeing)
+{
+    mp::SubnetIndex index{mp::IPAddress{"10.120.0.2"}, mp::IPAddress{"10.120.0.254"}};
+    mp::IPAddress an_ip{"10.120.0.42"};
+
+    EXPECT_FALSE(index.in_use(an_ip));
+    index.mark_in_use(an_ip);
+    EXPECT_TRUE(index.in_use(an_ip));
+    EXPECT_THAT(index.num_in_use(), Eq(1));
+
+    index.mark_free(an_ip);
+    EXPECT_FALSE(index.in_use(an_ip));
+    EXPECT_THAT(index.num_in_use(), Eq(0));
+}
+
+TEST(SubnetIndex, ignores_addresses_outside_the_range)
+{
+    mp::SubnetIndex index{mp::IPAddress{"10.120.0.2"}, mp::IPAddress{"10.120.0.254"}};
+
+    index.mark_in_use(mp::IPAddress{"10.121.0.7"});
+    EXPECT_THAT(index.num_in_use(), Eq(0));
+}
+
+TEST(SubnetIndex, reports_exhaustion)
+{
+    mp::SubnetIndex index{mp::IPAddress{"10.120.0.2"}, mp::IPAddress{"10.120.0.5"}};
+
+    for (auto i = 0; i < 4; ++i)
+        index.mark_in_use(mp::IPAddress{"10.120.0.2"} + i);
+
+    EXPECT_THAT(index.first_free(), Eq(mp::nullopt));
+    EXPECT_THAT(index.addresses_in_use().size(), Eq(4u));
+}